@@ -47,6 +47,22 @@ copy_bundle() const {
   return DCAST(AnimBundle, group.p());
 }
 
+/**
+ * Replaces each AnimChannelMatrixXfmTable in the bundle with an
+ * AnimChannelMatrixQuantized, which stores the same animation in a fraction
+ * of the memory, to within the indicated tolerances.  See the
+ * AnimChannelMatrixQuantized constructor for the meaning of the parameters.
+ *
+ * This modifies the bundle in place, so it should be done before the bundle
+ * is bound to a character.  If the bundle may be shared, for instance
+ * because it came from the ModelPool, call it on a copy_bundle() instead.
+ */
+void AnimBundle::
+quantize_channels(PN_stdfloat pos_tolerance, PN_stdfloat hpr_tolerance,
+                  PN_stdfloat scale_tolerance) {
+  r_quantize_channels(pos_tolerance, hpr_tolerance, scale_tolerance);
+}
+
 /**
  * Writes a one-line description of the bundle.
  */
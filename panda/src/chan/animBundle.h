@@ -35,6 +35,10 @@ PUBLISHED:
 
   PT(AnimBundle) copy_bundle() const;
 
+  void quantize_channels(PN_stdfloat pos_tolerance = 0.001f,
+                         PN_stdfloat hpr_tolerance = 0.05f,
+                         PN_stdfloat scale_tolerance = 0.001f);
+
   INLINE double get_base_frame_rate() const;
   INLINE int get_num_frames() const;
 
@@ -0,0 +1,718 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file animChannelMatrixQuantized.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#include "animChannelMatrixQuantized.h"
+#include "animChannelMatrixXfmTable.h"
+#include "config_chan.h"
+
+#include "compose_matrix.h"
+#include "indent.h"
+#include "datagram.h"
+#include "datagramIterator.h"
+#include "bamReader.h"
+#include "bamWriter.h"
+
+#include <algorithm>
+
+TypeHandle AnimChannelMatrixQuantized::_type_handle;
+
+// The three smallest components of a unit quaternion are each within this
+// range.
+static const PN_stdfloat quat_component_range = 0.70710678118654752440f;
+static const int quat_component_max = 0x7fff;
+
+/**
+ * Returns the angle in degrees of the rotation that takes one orientation to
+ * the other.  Both quaternions must be normalized.  This is formulated in
+ * terms of atan2 rather than acos so that it remains precise for the very
+ * small angles we are interested in here.
+ */
+static double
+angle_between(const LQuaternion &a, const LQuaternion &b) {
+  LQuaternion diff, sum;
+  if (a.dot(b) < 0.0f) {
+    diff = a + b;
+    sum = a - b;
+  } else {
+    diff = a - b;
+    sum = a + b;
+  }
+  return rad_2_deg(4.0 * atan2((double)diff.length(), (double)sum.length()));
+}
+
+/**
+ * Used only for bam loader.
+ */
+AnimChannelMatrixQuantized::
+AnimChannelMatrixQuantized() :
+  _num_frames(1)
+{
+  for (int i = 0; i < TT_num_tracks; ++i) {
+    _tracks[i]._frames = CPTA_ushort(get_class_type());
+    _tracks[i]._values = CPTA_ushort(get_class_type());
+  }
+  _tracks[TT_scale]._base.set(1.0f, 1.0f, 1.0f, 0.0f);
+  _tracks[TT_rotation]._base = LQuaternion::ident_quat();
+}
+
+/**
+ * Creates a new AnimChannelMatrixQuantized, just like this one, without
+ * copying any children.  The new copy is added to the indicated parent.
+ * Intended to be called by make_copy() only.
+ */
+AnimChannelMatrixQuantized::
+AnimChannelMatrixQuantized(AnimGroup *parent, const AnimChannelMatrixQuantized &copy) :
+  AnimChannelMatrix(parent, copy),
+  _num_frames(copy._num_frames)
+{
+  for (int i = 0; i < TT_num_tracks; ++i) {
+    _tracks[i] = copy._tracks[i];
+  }
+}
+
+/**
+ * Creates a new channel that reproduces the animation of the indicated
+ * AnimChannelMatrixXfmTable, and adds it to the indicated parent.  The
+ * children of the source channel are not copied.
+ *
+ * The tolerances specify the greatest error that may be introduced by
+ * omitting keyframes: pos_tolerance is in model units, hpr_tolerance in
+ * degrees, and scale_tolerance applies to both the scale and shear.  The 16-
+ * bit quantization may add a small error of its own, proportional to the
+ * range of motion of the channel.
+ */
+AnimChannelMatrixQuantized::
+AnimChannelMatrixQuantized(AnimGroup *parent,
+                           const AnimChannelMatrixXfmTable *source,
+                           PN_stdfloat pos_tolerance,
+                           PN_stdfloat hpr_tolerance,
+                           PN_stdfloat scale_tolerance) :
+  AnimChannelMatrix(parent, source->get_name()),
+  _num_frames(1)
+{
+  for (int i = 0; i < TT_num_tracks; ++i) {
+    _tracks[i]._frames = CPTA_ushort(get_class_type());
+    _tracks[i]._values = CPTA_ushort(get_class_type());
+  }
+  _tracks[TT_scale]._base.set(1.0f, 1.0f, 1.0f, 0.0f);
+  _tracks[TT_rotation]._base = LQuaternion::ident_quat();
+
+  static const char table_ids[num_matrix_components + 1] = "ijkabchprxyz";
+  CPTA_stdfloat tables[num_matrix_components];
+  for (int i = 0; i < num_matrix_components; ++i) {
+    tables[i] = source->get_table(table_ids[i]);
+    _num_frames = std::max(_num_frames, (int)tables[i].size());
+  }
+
+  // Frame numbers and key counts are stored in 16 bits, as are the table
+  // sizes in the bam file of the source channel, so a track that has a key
+  // on every frame may have no more than 0xffff frames.
+  nassertd(_num_frames <= 0xffff) {
+    _num_frames = 0xffff;
+  }
+
+  // Expand the tables into one value per frame for each track.
+  pvector<LVecBase3> scales(_num_frames), shears(_num_frames), positions(_num_frames);
+  pvector<LQuaternion> quats(_num_frames);
+  for (int f = 0; f < _num_frames; ++f) {
+    PN_stdfloat components[num_matrix_components];
+    for (int i = 0; i < num_matrix_components; ++i) {
+      if (tables[i].empty()) {
+        components[i] = (i < 3) ? 1.0f : 0.0f;
+      } else {
+        components[i] = tables[i][f % tables[i].size()];
+      }
+    }
+    scales[f].set(components[0], components[1], components[2]);
+    shears[f].set(components[3], components[4], components[5]);
+    positions[f].set(components[9], components[10], components[11]);
+
+    quats[f].set_hpr(LVecBase3(components[6], components[7], components[8]));
+    quats[f].normalize();
+
+    // Keep each quaternion in the same hemisphere as the previous one, so
+    // that we interpolate along the shortest path.
+    if (f > 0 && quats[f].dot(quats[f - 1]) < 0.0f) {
+      quats[f] = -quats[f];
+    }
+  }
+
+  encode_vector_track(_tracks[TT_scale], scales, scale_tolerance);
+  encode_vector_track(_tracks[TT_shear], shears, scale_tolerance);
+  encode_rotation_track(_tracks[TT_rotation], quats, hpr_tolerance);
+  encode_vector_track(_tracks[TT_pos], positions, pos_tolerance);
+}
+
+/**
+ *
+ */
+AnimChannelMatrixQuantized::
+~AnimChannelMatrixQuantized() {
+}
+
+/**
+ * Returns the total number of keys stored in the channel, counted over each
+ * of its scale, shear, rotation and translation components.  A component
+ * that is constant over the animation stores no keys.
+ */
+int AnimChannelMatrixQuantized::
+get_num_keys() const {
+  int num_keys = 0;
+  for (int i = 0; i < TT_num_tracks; ++i) {
+    num_keys += (int)_tracks[i]._frames.size();
+  }
+  return num_keys;
+}
+
+/**
+ * Returns the number of bytes of memory used by the channel, including the
+ * key tables.  This is intended for comparing the size of the channel to the
+ * AnimChannelMatrixXfmTable it was created from.
+ */
+size_t AnimChannelMatrixQuantized::
+get_data_size() const {
+  size_t size = sizeof(*this);
+  for (int i = 0; i < TT_num_tracks; ++i) {
+    size += (_tracks[i]._frames.size() + _tracks[i]._values.size()) * sizeof(unsigned short);
+  }
+  return size;
+}
+
+/**
+ * Returns true if the value has changed since the last call to has_changed().
+ * last_frame is the frame number of the last call; this_frame is the current
+ * frame number.
+ */
+bool AnimChannelMatrixQuantized::
+has_changed(int last_frame, double last_frac,
+            int this_frame, double this_frac) {
+  if (last_frame != this_frame) {
+    if (frames_differ(last_frame, this_frame)) {
+      return true;
+    }
+  }
+
+  if (last_frac != this_frac) {
+    // If we have some fractional changes, also check the next subsequent
+    // frame (since we'll be blending with that).
+    if (frames_differ(last_frame, this_frame + 1)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * Gets the value of the channel at the indicated frame.
+ */
+void AnimChannelMatrixQuantized::
+get_value(int frame, LMatrix4 &mat) {
+  int f = get_frame_index(frame);
+
+  LVecBase3 scale, shear, pos;
+  LQuaternion quat;
+  decode_vector(_tracks[TT_scale], f, scale);
+  decode_vector(_tracks[TT_shear], f, shear);
+  decode_rotation(_tracks[TT_rotation], f, quat);
+  decode_vector(_tracks[TT_pos], f, pos);
+
+  LMatrix3 rotate;
+  quat.extract_to_matrix(rotate);
+
+  LMatrix3 upper3;
+  upper3.set_scale_shear_mat(scale, shear);
+  upper3 *= rotate;
+  mat = LMatrix4(upper3, pos);
+}
+
+/**
+ * Gets the value of the channel at the indicated frame, without any scale or
+ * shear information.
+ */
+void AnimChannelMatrixQuantized::
+get_value_no_scale_shear(int frame, LMatrix4 &mat) {
+  int f = get_frame_index(frame);
+
+  LVecBase3 pos;
+  LQuaternion quat;
+  decode_rotation(_tracks[TT_rotation], f, quat);
+  decode_vector(_tracks[TT_pos], f, pos);
+
+  LMatrix3 rotate;
+  quat.extract_to_matrix(rotate);
+  mat = LMatrix4(rotate, pos);
+}
+
+/**
+ * Gets the scale value at the indicated frame.
+ */
+void AnimChannelMatrixQuantized::
+get_scale(int frame, LVecBase3 &scale) {
+  decode_vector(_tracks[TT_scale], get_frame_index(frame), scale);
+}
+
+/**
+ * Returns the h, p, and r components associated with the current frame.  As
+ * above, this only makes sense for a matrix-type channel.
+ */
+void AnimChannelMatrixQuantized::
+get_hpr(int frame, LVecBase3 &hpr) {
+  LQuaternion quat;
+  decode_rotation(_tracks[TT_rotation], get_frame_index(frame), quat);
+  hpr = quat.get_hpr();
+}
+
+/**
+ * Returns the rotation component associated with the current frame, expressed
+ * as a quaternion.  As above, this only makes sense for a matrix-type
+ * channel.
+ */
+void AnimChannelMatrixQuantized::
+get_quat(int frame, LQuaternion &quat) {
+  decode_rotation(_tracks[TT_rotation], get_frame_index(frame), quat);
+}
+
+/**
+ * Returns the x, y, and z translation components associated with the current
+ * frame.  As above, this only makes sense for a matrix-type channel.
+ */
+void AnimChannelMatrixQuantized::
+get_pos(int frame, LVecBase3 &pos) {
+  decode_vector(_tracks[TT_pos], get_frame_index(frame), pos);
+}
+
+/**
+ * Returns the a, b, and c shear components associated with the current frame.
+ * As above, this only makes sense for a matrix-type channel.
+ */
+void AnimChannelMatrixQuantized::
+get_shear(int frame, LVecBase3 &shear) {
+  decode_vector(_tracks[TT_shear], get_frame_index(frame), shear);
+}
+
+/**
+ * Writes a brief description of the channel and all of its descendants.
+ */
+void AnimChannelMatrixQuantized::
+write(std::ostream &out, int indent_level) const {
+  indent(out, indent_level)
+    << get_type() << " " << get_name() << " " << _num_frames << " frames, "
+    << get_num_keys() << " keys";
+
+  if (!_children.empty()) {
+    out << " {\n";
+    write_descendants(out, indent_level + 2);
+    indent(out, indent_level) << "}";
+  }
+
+  out << "\n";
+}
+
+/**
+ * Returns a copy of this object, and attaches it to the indicated parent
+ * (which may be NULL only if this is an AnimBundle).  Intended to be called
+ * by copy_subtree() only.
+ */
+AnimGroup *AnimChannelMatrixQuantized::
+make_copy(AnimGroup *parent) const {
+  return new AnimChannelMatrixQuantized(parent, *this);
+}
+
+/**
+ * Fills in the indicated scale, shear or translation track from the given
+ * per-frame values, keeping only as many keyframes as are needed to
+ * reproduce the values within the indicated tolerance.
+ */
+void AnimChannelMatrixQuantized::
+encode_vector_track(Track &track, const pvector<LVecBase3> &values,
+                    PN_stdfloat tolerance) {
+  int num_frames = (int)values.size();
+
+  LVecBase3 min_value = values[0];
+  LVecBase3 max_value = values[0];
+  for (int f = 1; f < num_frames; ++f) {
+    min_value = min_value.fmin(values[f]);
+    max_value = max_value.fmax(values[f]);
+  }
+
+  LVecBase3 range = max_value - min_value;
+  if (range[0] <= tolerance * 2.0f &&
+      range[1] <= tolerance * 2.0f &&
+      range[2] <= tolerance * 2.0f) {
+    // The value is constant, within the tolerance.
+    LVecBase3 value = (min_value + max_value) * 0.5f;
+    track._base.set(value[0], value[1], value[2], 0.0f);
+    return;
+  }
+
+  track._base.set(min_value[0], min_value[1], min_value[2], 0.0f);
+  track._step = range / (PN_stdfloat)0xffff;
+
+  pvector<uint16_t> quantized(num_frames * 3);
+  pvector<LVecBase3> decoded(num_frames);
+  for (int f = 0; f < num_frames; ++f) {
+    for (int c = 0; c < 3; ++c) {
+      int q = 0;
+      if (track._step[c] != 0.0f) {
+        q = (int)floor((values[f][c] - min_value[c]) / track._step[c] + 0.5f);
+        q = std::max(0, std::min(q, 0xffff));
+      }
+      quantized[f * 3 + c] = (uint16_t)q;
+    }
+    decoded[f] = dequantize_vector(track, &quantized[f * 3]);
+  }
+
+  // Greedily extend each segment between two keys as far as it will go
+  // while still interpolating the frames in between within the tolerance.
+  pvector<int> keys;
+  keys.push_back(0);
+  int start = 0;
+  while (start < num_frames - 1) {
+    int end = start + 1;
+    while (end + 1 < num_frames) {
+      int next = end + 1;
+      bool fits = true;
+      for (int f = start + 1; f < next && fits; ++f) {
+        PN_stdfloat t = (PN_stdfloat)(f - start) / (PN_stdfloat)(next - start);
+        LVecBase3 value = decoded[start] + (decoded[next] - decoded[start]) * t;
+        LVecBase3 error = value - values[f];
+        fits = (cabs(error[0]) <= tolerance &&
+                cabs(error[1]) <= tolerance &&
+                cabs(error[2]) <= tolerance);
+      }
+      if (!fits) {
+        break;
+      }
+      end = next;
+    }
+    keys.push_back(end);
+    start = end;
+  }
+
+  set_keys(track, keys, quantized);
+}
+
+/**
+ * Fills in the rotation track from the given per-frame quaternions, keeping
+ * only as many keyframes as are needed to reproduce the rotations within the
+ * indicated tolerance, in degrees.
+ */
+void AnimChannelMatrixQuantized::
+encode_rotation_track(Track &track, const pvector<LQuaternion> &values,
+                      PN_stdfloat tolerance) {
+  int num_frames = (int)values.size();
+
+  bool is_constant = true;
+  for (int f = 1; f < num_frames && is_constant; ++f) {
+    is_constant = (angle_between(values[f], values[0]) <= tolerance);
+  }
+  if (is_constant) {
+    track._base = values[0];
+    return;
+  }
+
+  pvector<uint16_t> quantized(num_frames * 3);
+  pvector<LQuaternion> decoded(num_frames);
+  for (int f = 0; f < num_frames; ++f) {
+    quantize_quat(values[f], &quantized[f * 3]);
+    dequantize_quat(&quantized[f * 3], decoded[f]);
+  }
+
+  pvector<int> keys;
+  keys.push_back(0);
+  int start = 0;
+  while (start < num_frames - 1) {
+    int end = start + 1;
+    while (end + 1 < num_frames) {
+      int next = end + 1;
+      bool fits = true;
+      for (int f = start + 1; f < next && fits; ++f) {
+        PN_stdfloat t = (PN_stdfloat)(f - start) / (PN_stdfloat)(next - start);
+        LQuaternion value;
+        nlerp(decoded[start], decoded[next], t, value);
+        fits = (angle_between(value, values[f]) <= tolerance);
+      }
+      if (!fits) {
+        break;
+      }
+      end = next;
+    }
+    keys.push_back(end);
+    start = end;
+  }
+
+  set_keys(track, keys, quantized);
+}
+
+/**
+ * Stores the indicated keyframes in the track, given the quantized values of
+ * all of the frames.
+ */
+void AnimChannelMatrixQuantized::
+set_keys(Track &track, const pvector<int> &keys,
+         const pvector<uint16_t> &quantized) {
+  PTA_ushort frames = PTA_ushort::empty_array(keys.size(), get_class_type());
+  PTA_ushort values = PTA_ushort::empty_array(keys.size() * 3, get_class_type());
+  for (size_t k = 0; k < keys.size(); ++k) {
+    frames[k] = (unsigned short)keys[k];
+    values[k * 3 + 0] = quantized[keys[k] * 3 + 0];
+    values[k * 3 + 1] = quantized[keys[k] * 3 + 1];
+    values[k * 3 + 2] = quantized[keys[k] * 3 + 2];
+  }
+  track._frames = frames;
+  track._values = values;
+}
+
+/**
+ * Finds the keys on either side of the indicated frame, which must already be
+ * within the range of the table, and the fraction of the way from k0 to k1.
+ * Returns false if the track has no keys.
+ */
+bool AnimChannelMatrixQuantized::
+find_keys(const Track &track, int frame, int &k0, int &k1, PN_stdfloat &t) {
+  size_t num_keys = track._frames.size();
+  if (num_keys == 0) {
+    return false;
+  }
+
+  const unsigned short *frames = track._frames.p();
+  const unsigned short *next =
+    std::upper_bound(frames, frames + num_keys, (unsigned short)frame);
+  k1 = (int)(next - frames);
+  k0 = k1 - 1;
+  nassertr(k0 >= 0, false);
+
+  if (k1 >= (int)num_keys || frames[k0] == frame) {
+    // The frame is on a key.
+    k1 = k0;
+    t = 0.0f;
+  } else {
+    t = (PN_stdfloat)(frame - frames[k0]) / (PN_stdfloat)(frames[k1] - frames[k0]);
+  }
+  return true;
+}
+
+/**
+ * Decodes the value of a scale, shear or translation track at the indicated
+ * frame.
+ */
+void AnimChannelMatrixQuantized::
+decode_vector(const Track &track, int frame, LVecBase3 &value) {
+  int k0, k1;
+  PN_stdfloat t;
+  if (!find_keys(track, frame, k0, k1, t)) {
+    value = track._base.get_xyz();
+    return;
+  }
+
+  const unsigned short *values = track._values.p();
+  value = dequantize_vector(track, values + k0 * 3);
+  if (k1 != k0) {
+    LVecBase3 value1 = dequantize_vector(track, values + k1 * 3);
+    value += (value1 - value) * t;
+  }
+}
+
+/**
+ * Decodes the value of the rotation track at the indicated frame.
+ */
+void AnimChannelMatrixQuantized::
+decode_rotation(const Track &track, int frame, LQuaternion &value) {
+  int k0, k1;
+  PN_stdfloat t;
+  if (!find_keys(track, frame, k0, k1, t)) {
+    value = LQuaternion(track._base);
+    return;
+  }
+
+  const unsigned short *values = track._values.p();
+  dequantize_quat(values + k0 * 3, value);
+  if (k1 != k0) {
+    LQuaternion value1;
+    dequantize_quat(values + k1 * 3, value1);
+    nlerp(LQuaternion(value), value1, t, value);
+  }
+}
+
+/**
+ * Returns true if the channel has a different value on the two indicated
+ * frames.
+ */
+bool AnimChannelMatrixQuantized::
+frames_differ(int frame_a, int frame_b) const {
+  int fa = get_frame_index(frame_a);
+  int fb = get_frame_index(frame_b);
+  if (fa == fb) {
+    return false;
+  }
+
+  for (int i = 0; i < TT_num_tracks; ++i) {
+    const Track &track = _tracks[i];
+    if (track._frames.empty()) {
+      continue;
+    }
+    if (i == TT_rotation) {
+      LQuaternion a, b;
+      decode_rotation(track, fa, a);
+      decode_rotation(track, fb, b);
+      if (a != b) {
+        return true;
+      }
+    } else {
+      LVecBase3 a, b;
+      decode_vector(track, fa, a);
+      decode_vector(track, fb, b);
+      if (a != b) {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+/**
+ * Encodes a normalized quaternion into 48 bits.  Since the quaternion has
+ * unit length and q and -q represent the same rotation, only the three
+ * smallest components need be stored, each in 15 bits; the largest can be
+ * recovered from them.  The index of the largest component is stored in the
+ * top bits of the first two words.
+ */
+void AnimChannelMatrixQuantized::
+quantize_quat(const LQuaternion &quat, uint16_t q[3]) {
+  int largest = 0;
+  for (int i = 1; i < 4; ++i) {
+    if (cabs(quat[i]) > cabs(quat[largest])) {
+      largest = i;
+    }
+  }
+  PN_stdfloat sign = (quat[largest] < 0.0f) ? -1.0f : 1.0f;
+
+  int c = 0;
+  for (int i = 0; i < 4; ++i) {
+    if (i != largest) {
+      PN_stdfloat value = quat[i] * sign;
+      value = (value + quat_component_range) / (quat_component_range * 2.0f);
+      int iv = (int)floor(value * quat_component_max + 0.5f);
+      q[c++] = (uint16_t)std::max(0, std::min(iv, quat_component_max));
+    }
+  }
+
+  q[0] |= (uint16_t)((largest >> 1) << 15);
+  q[1] |= (uint16_t)((largest & 1) << 15);
+}
+
+/**
+ * The inverse of quantize_quat().
+ */
+void AnimChannelMatrixQuantized::
+dequantize_quat(const uint16_t q[3], LQuaternion &quat) {
+  int largest = ((q[0] >> 15) << 1) | (q[1] >> 15);
+
+  PN_stdfloat sum = 0.0f;
+  int c = 0;
+  for (int i = 0; i < 4; ++i) {
+    if (i != largest) {
+      PN_stdfloat value = (PN_stdfloat)(q[c++] & quat_component_max) / quat_component_max;
+      value = value * (quat_component_range * 2.0f) - quat_component_range;
+      quat[i] = value;
+      sum += value * value;
+    }
+  }
+  quat[largest] = csqrt(std::max((PN_stdfloat)0.0f, (PN_stdfloat)1.0f - sum));
+}
+
+/**
+ * Factory method to generate an AnimChannelMatrixQuantized object.
+ */
+void AnimChannelMatrixQuantized::
+register_with_read_factory() {
+  BamReader::get_factory()->register_factory(get_class_type(), make_AnimChannelMatrixQuantized);
+}
+
+/**
+ * Function to write the important information in the particular object to a
+ * Datagram
+ */
+void AnimChannelMatrixQuantized::
+write_datagram(BamWriter *manager, Datagram &me) {
+  AnimChannelMatrix::write_datagram(manager, me);
+
+  me.add_uint16(_num_frames - 1);
+  for (int i = 0; i < TT_num_tracks; ++i) {
+    const Track &track = _tracks[i];
+    me.add_uint16(track._frames.size());
+    if (track._frames.empty()) {
+      track._base.write_datagram(me);
+    } else {
+      track._base.get_xyz().write_datagram(me);
+      track._step.write_datagram(me);
+      for (unsigned short frame : track._frames) {
+        me.add_uint16(frame);
+      }
+      for (unsigned short value : track._values) {
+        me.add_uint16(value);
+      }
+    }
+  }
+}
+
+/**
+ * Function that reads out of the datagram (or asks manager to read) all of
+ * the data that is needed to re-create this object and stores it in the
+ * appropiate place
+ */
+void AnimChannelMatrixQuantized::
+fillin(DatagramIterator &scan, BamReader *manager) {
+  AnimChannelMatrix::fillin(scan, manager);
+
+  _num_frames = (int)scan.get_uint16() + 1;
+  for (int i = 0; i < TT_num_tracks; ++i) {
+    Track &track = _tracks[i];
+    size_t num_keys = scan.get_uint16();
+    if (num_keys == 0) {
+      track._base.read_datagram(scan);
+    } else {
+      LVecBase3 base;
+      base.read_datagram(scan);
+      track._base.set(base[0], base[1], base[2], 0.0f);
+      track._step.read_datagram(scan);
+
+      PTA_ushort frames = PTA_ushort::empty_array(num_keys, get_class_type());
+      for (size_t k = 0; k < num_keys; ++k) {
+        frames[k] = scan.get_uint16();
+      }
+      PTA_ushort values = PTA_ushort::empty_array(num_keys * 3, get_class_type());
+      for (size_t k = 0; k < num_keys * 3; ++k) {
+        values[k] = scan.get_uint16();
+      }
+      track._frames = frames;
+      track._values = values;
+    }
+  }
+}
+
+/**
+ * Factory method to generate an AnimChannelMatrixQuantized object.
+ */
+TypedWritable *AnimChannelMatrixQuantized::
+make_AnimChannelMatrixQuantized(const FactoryParams &params) {
+  AnimChannelMatrixQuantized *me = new AnimChannelMatrixQuantized;
+  DatagramIterator scan;
+  BamReader *manager;
+
+  parse_params(params, scan, manager);
+  me->fillin(scan, manager);
+  return me;
+}
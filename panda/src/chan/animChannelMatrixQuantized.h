@@ -0,0 +1,158 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file animChannelMatrixQuantized.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef ANIMCHANNELMATRIXQUANTIZED_H
+#define ANIMCHANNELMATRIXQUANTIZED_H
+
+#include "pandabase.h"
+
+#include "animChannel.h"
+#include "pta_ushort.h"
+#include "luse.h"
+
+class AnimChannelMatrixXfmTable;
+
+/**
+ * An animation channel that issues a matrix each frame, like
+ * AnimChannelMatrixXfmTable, but stores its tables in a compact, lossy form.
+ * It may be created from an existing AnimChannelMatrixXfmTable; see also
+ * AnimBundle::quantize_channels().
+ *
+ * The transform is stored as four tracks: scale, shear, rotation and
+ * translation.  A track that doesn't change is stored as a single value.
+ * Otherwise, it is stored as a list of keyframes, with the frames in between
+ * reconstructed by linear interpolation; frames that can be interpolated
+ * within the requested tolerance are omitted.  The scale, shear and
+ * translation components of each key are quantized to 16 bits within the
+ * range of the track, and the rotation is stored as a quaternion in 48 bits,
+ * by storing only the three smallest components.
+ *
+ * The tables are decoded on demand in get_value(), so the channel never needs
+ * to be expanded in memory.
+ */
+class EXPCL_PANDA_CHAN AnimChannelMatrixQuantized : public AnimChannelMatrix {
+protected:
+  AnimChannelMatrixQuantized();
+  AnimChannelMatrixQuantized(AnimGroup *parent, const AnimChannelMatrixQuantized &copy);
+
+PUBLISHED:
+  explicit AnimChannelMatrixQuantized(AnimGroup *parent,
+                                      const AnimChannelMatrixXfmTable *source,
+                                      PN_stdfloat pos_tolerance = 0.001f,
+                                      PN_stdfloat hpr_tolerance = 0.05f,
+                                      PN_stdfloat scale_tolerance = 0.001f);
+  virtual ~AnimChannelMatrixQuantized();
+
+  INLINE int get_num_frames() const;
+  int get_num_keys() const;
+  size_t get_data_size() const;
+
+  MAKE_PROPERTY(num_frames, get_num_frames);
+
+public:
+  virtual bool has_changed(int last_frame, double last_frac,
+                           int this_frame, double this_frac);
+  virtual void get_value(int frame, LMatrix4 &mat);
+
+  virtual void get_value_no_scale_shear(int frame, LMatrix4 &value);
+  virtual void get_scale(int frame, LVecBase3 &scale);
+  virtual void get_hpr(int frame, LVecBase3 &hpr);
+  virtual void get_quat(int frame, LQuaternion &quat);
+  virtual void get_pos(int frame, LVecBase3 &pos);
+  virtual void get_shear(int frame, LVecBase3 &shear);
+
+  virtual void write(std::ostream &out, int indent_level) const;
+
+protected:
+  virtual AnimGroup *make_copy(AnimGroup *parent) const;
+
+private:
+  enum TrackType {
+    TT_scale,
+    TT_shear,
+    TT_rotation,
+    TT_pos,
+    TT_num_tracks,
+  };
+
+  /**
+   * The keyframes of one component of the transform.  Each key stores three
+   * 16-bit values.  If there are no keys, the component is constant, and
+   * _base holds its value.
+   */
+  class Track {
+  public:
+    CPTA_ushort _frames;
+    CPTA_ushort _values;
+
+    // For scale, shear and translation, a quantized value q decodes to
+    // _base + q * _step.  For a constant rotation, _base holds the
+    // quaternion.
+    LVecBase4 _base;
+    LVecBase3 _step;
+  };
+
+  void encode_vector_track(Track &track, const pvector<LVecBase3> &values,
+                           PN_stdfloat tolerance);
+  void encode_rotation_track(Track &track, const pvector<LQuaternion> &values,
+                             PN_stdfloat tolerance);
+  static void set_keys(Track &track, const pvector<int> &keys,
+                       const pvector<uint16_t> &quantized);
+
+  INLINE int get_frame_index(int frame) const;
+  static bool find_keys(const Track &track, int frame, int &k0, int &k1,
+                        PN_stdfloat &t);
+  static void decode_vector(const Track &track, int frame, LVecBase3 &value);
+  static void decode_rotation(const Track &track, int frame, LQuaternion &value);
+  bool frames_differ(int frame_a, int frame_b) const;
+
+  INLINE static LVecBase3 dequantize_vector(const Track &track,
+                                            const uint16_t *q);
+  static void quantize_quat(const LQuaternion &quat, uint16_t q[3]);
+  static void dequantize_quat(const uint16_t q[3], LQuaternion &quat);
+  INLINE static void nlerp(const LQuaternion &a, const LQuaternion &b,
+                           PN_stdfloat t, LQuaternion &result);
+
+  int _num_frames;
+  Track _tracks[TT_num_tracks];
+
+public:
+  static void register_with_read_factory();
+  virtual void write_datagram(BamWriter *manager, Datagram &me);
+
+  static TypedWritable *make_AnimChannelMatrixQuantized(const FactoryParams &params);
+
+protected:
+  void fillin(DatagramIterator &scan, BamReader *manager);
+
+public:
+  virtual TypeHandle get_type() const {
+    return get_class_type();
+  }
+  virtual TypeHandle force_init_type() {init_type(); return get_class_type();}
+  static TypeHandle get_class_type() {
+    return _type_handle;
+  }
+  static void init_type() {
+    AnimChannelMatrix::init_type();
+    register_type(_type_handle, "AnimChannelMatrixQuantized",
+                  AnimChannelMatrix::get_class_type());
+  }
+
+private:
+  static TypeHandle _type_handle;
+};
+
+#include "animChannelMatrixQuantized.I"
+
+#endif
@@ -13,6 +13,8 @@
 
 #include "animGroup.h"
 #include "animBundle.h"
+#include "animChannelMatrixXfmTable.h"
+#include "animChannelMatrixQuantized.h"
 #include "config_chan.h"
 
 #include "indent.h"
@@ -238,6 +240,35 @@ copy_subtree(AnimGroup *parent) const {
   return new_group;
 }
 
+/**
+ * Replaces each AnimChannelMatrixXfmTable at this node and below with an
+ * equivalent AnimChannelMatrixQuantized.  Intended to be called by
+ * AnimBundle::quantize_channels() only.
+ */
+void AnimGroup::
+r_quantize_channels(PN_stdfloat pos_tolerance, PN_stdfloat hpr_tolerance,
+                    PN_stdfloat scale_tolerance) {
+  for (size_t i = 0; i < _children.size(); ++i) {
+    if (_children[i]->is_of_type(AnimChannelMatrixXfmTable::get_class_type())) {
+      const AnimChannelMatrixXfmTable *table =
+        DCAST(AnimChannelMatrixXfmTable, _children[i]);
+      PT(AnimGroup) channel =
+        new AnimChannelMatrixQuantized(this, table, pos_tolerance,
+                                       hpr_tolerance, scale_tolerance);
+
+      // The constructor added the new channel to the end of our list; move it
+      // into the place of the old one, and give it the old one's children.
+      nassertv(_children.back() == channel);
+      _children.pop_back();
+      channel->_children.swap(_children[i]->_children);
+      _children[i] = channel;
+    }
+
+    _children[i]->r_quantize_channels(pos_tolerance, hpr_tolerance,
+                                      scale_tolerance);
+  }
+}
+
 /**
  * Function to write the important information in the particular object to a
  * Datagram
@@ -63,6 +63,9 @@ protected:
   virtual AnimGroup *make_copy(AnimGroup *parent) const;
   PT(AnimGroup) copy_subtree(AnimGroup *parent) const;
 
+  void r_quantize_channels(PN_stdfloat pos_tolerance, PN_stdfloat hpr_tolerance,
+                           PN_stdfloat scale_tolerance);
+
 protected:
   typedef pvector< PT(AnimGroup) > Children;
   Children _children;
@@ -18,6 +18,7 @@
 #include "animChannelMatrixXfmTable.h"
 #include "animChannelMatrixDynamic.h"
 #include "animChannelMatrixFixed.h"
+#include "animChannelMatrixQuantized.h"
 #include "animChannelScalarTable.h"
 #include "animChannelScalarDynamic.h"
 #include "animControl.h"
@@ -108,6 +109,7 @@ ConfigureFn(config_chan) {
   AnimChannelMatrixXfmTable::init_type();
   AnimChannelMatrixDynamic::init_type();
   AnimChannelMatrixFixed::init_type();
+  AnimChannelMatrixQuantized::init_type();
   AnimChannelScalarTable::init_type();
   AnimChannelScalarDynamic::init_type();
   AnimControl::init_type();
@@ -139,6 +141,7 @@ ConfigureFn(config_chan) {
   AnimChannelMatrixXfmTable::register_with_read_factory();
   AnimChannelMatrixDynamic::register_with_read_factory();
   AnimChannelMatrixFixed::register_with_read_factory();
+  AnimChannelMatrixQuantized::register_with_read_factory();
   AnimChannelScalarTable::register_with_read_factory();
   AnimChannelScalarDynamic::register_with_read_factory();
   AnimPreloadTable::register_with_read_factory();
@@ -110,37 +110,7 @@ do_update(PartBundle *root, const CycleData *root_cdata, PartGroup *parent,
           bool parent_changed, bool anim_changed,
           Thread *current_thread) {
   bool any_changed = false;
-  bool needs_update = anim_changed;
-
-  // See if any of the channel values have changed since last time.
-
-  if (!needs_update) {
-    if (_forced_channel != nullptr) {
-      needs_update = _forced_channel->has_changed(0, 0.0, 0, 0.0);
-
-    } else if (_effective_control != nullptr) {
-      const PartBundle::CData *cdata = (const PartBundle::CData *)root_cdata;
-      needs_update = _effective_control->channel_has_changed(_effective_channel, cdata->_frame_blend_flag);
-
-    } else {
-      const PartBundle::CData *cdata = (const PartBundle::CData *)root_cdata;
-      PartBundle::ChannelBlend::const_iterator bci;
-      for (bci = cdata->_blend.begin();
-           !needs_update && bci != cdata->_blend.end();
-           ++bci) {
-        AnimControl *control = (*bci).first;
-
-        AnimChannelBase *channel = nullptr;
-        int channel_index = control->get_channel_index();
-        if (channel_index >= 0 && channel_index < (int)_channels.size()) {
-          channel = _channels[channel_index];
-        }
-        if (channel != nullptr) {
-          needs_update = control->channel_has_changed(channel, cdata->_frame_blend_flag);
-        }
-      }
-    }
-  }
+  bool needs_update = this->needs_update(root_cdata, anim_changed);
 
   if (needs_update) {
     // Ok, get the latest value.
@@ -166,6 +136,43 @@ do_update(PartBundle *root, const CycleData *root_cdata, PartGroup *parent,
 }
 
 
+/**
+ * Returns true if any of the channel values that affect this part have
+ * changed since the last update, or if anim_changed is true, in which case
+ * the part must be updated regardless.
+ */
+bool MovingPartBase::
+needs_update(const CycleData *root_cdata, bool anim_changed) const {
+  if (anim_changed) {
+    return true;
+  }
+
+  if (_forced_channel != nullptr) {
+    return _forced_channel->has_changed(0, 0.0, 0, 0.0);
+  }
+
+  const PartBundle::CData *cdata = (const PartBundle::CData *)root_cdata;
+  if (_effective_control != nullptr) {
+    return _effective_control->channel_has_changed(_effective_channel, cdata->_frame_blend_flag);
+  }
+
+  PartBundle::ChannelBlend::const_iterator bci;
+  for (bci = cdata->_blend.begin(); bci != cdata->_blend.end(); ++bci) {
+    AnimControl *control = (*bci).first;
+
+    AnimChannelBase *channel = nullptr;
+    int channel_index = control->get_channel_index();
+    if (channel_index >= 0 && channel_index < (int)_channels.size()) {
+      channel = _channels[channel_index];
+    }
+    if (channel != nullptr &&
+        control->channel_has_changed(channel, cdata->_frame_blend_flag)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 /**
  * This is called by do_update() whenever the part or some ancestor has
  * changed values.  It is a hook for derived classes to update whatever cache
@@ -28,6 +28,8 @@
 #include "configVariableEnum.h"
 #include "loaderOptions.h"
 #include "bindAnimRequest.h"
+#include "movingPartBase.h"
+#include "pStatTimer.h"
 
 #include <algorithm>
 
@@ -37,6 +39,9 @@ using std::string;
 
 TypeHandle PartBundle::_type_handle;
 
+PStatCollector PartBundle::_blend_pcollector("*:Animation:Blend");
+PStatCollector PartBundle::_compose_pcollector("*:Animation:Compose");
+
 
 static ConfigVariableEnum<PartBundle::BlendType> anim_blend_type
 ("anim-blend-type", PartBundle::BT_normalized_linear,
@@ -55,6 +60,7 @@ PartBundle(const PartBundle &copy) :
 {
   _anim_preload = copy._anim_preload;
   _update_delay = 0.0;
+  _flat_parts_seq = -1;
 
   CDWriter cdata(_cycler, true);
   CDReader cdata_from(copy._cycler);
@@ -73,6 +79,7 @@ PartBundle(const string &name) :
   PartGroup(name)
 {
   _update_delay = 0.0;
+  _flat_parts_seq = -1;
 }
 
 /**
@@ -483,8 +490,7 @@ update() {
     bool anim_changed = cdata->_anim_changed;
     bool frame_blend_flag = cdata->_frame_blend_flag;
 
-    any_changed = do_update(this, cdata, nullptr, false, anim_changed,
-                            current_thread);
+    any_changed = do_update_parts(cdata, false, anim_changed, current_thread);
 
     // Now update all the controls for next time.
     ChannelBlend::const_iterator cbi;
@@ -508,7 +514,7 @@ bool PartBundle::
 force_update() {
   Thread *current_thread = Thread::get_current_thread();
   CDWriter cdata(_cycler, false, current_thread);
-  bool any_changed = do_update(this, cdata, nullptr, true, true, current_thread);
+  bool any_changed = do_update_parts(cdata, true, true, current_thread);
 
   // Now update all the controls for next time.
   ChannelBlend::const_iterator cbi;
@@ -728,6 +734,88 @@ clear_and_stop_intersecting(AnimControl *control, CData *cdata) {
   }
 }
 
+/**
+ * Updates all of the parts in the bundle for the current frame.  This has the
+ * same effect as calling do_update() on the hierarchy, but walks the
+ * flattened list of parts instead, first computing the blended values of all
+ * of the parts that need it, and then composing each part with its parent.
+ *
+ * The return value is true if any part has changed, false otherwise.
+ */
+bool PartBundle::
+do_update_parts(const CData *cdata, bool parent_changed, bool anim_changed,
+                Thread *current_thread) {
+  AtomicAdjust::Integer seq = AtomicAdjust::get(_hierarchy_seq);
+  if (_flat_parts_seq != seq) {
+    _flat_parts.clear();
+    r_flatten_parts(this, -1);
+    _flat_parts_seq = seq;
+  }
+
+  {
+    PStatTimer timer(_blend_pcollector, current_thread);
+    for (FlatPart &part : _flat_parts) {
+      part._needs_update = false;
+      if (part._moving_part != nullptr &&
+          part._moving_part->needs_update(cdata, anim_changed)) {
+        part._needs_update = true;
+        part._moving_part->get_blend_value(this);
+      }
+    }
+  }
+
+  bool any_changed = false;
+  {
+    PStatTimer timer(_compose_pcollector, current_thread);
+    for (FlatPart &part : _flat_parts) {
+      PartGroup *parent = this;
+      bool this_parent_changed = parent_changed;
+      if (part._parent_index >= 0) {
+        const FlatPart &parent_part = _flat_parts[part._parent_index];
+        parent = parent_part._group;
+        this_parent_changed = parent_part._changed;
+      }
+
+      // The children of a part that isn't a MovingPart simply inherit the
+      // changed state of its parent.
+      part._changed = this_parent_changed || part._needs_update;
+      if (part._moving_part != nullptr && part._changed) {
+        if (part._moving_part->update_internals(this, parent,
+                                                part._needs_update,
+                                                this_parent_changed,
+                                                current_thread)) {
+          any_changed = true;
+        }
+      }
+    }
+  }
+
+  return any_changed;
+}
+
+/**
+ * Appends the descendants of the indicated group to _flat_parts, each one
+ * before its own children.
+ */
+void PartBundle::
+r_flatten_parts(PartGroup *group, int parent_index) {
+  for (PartGroup *child : group->_children) {
+    FlatPart part;
+    part._group = child;
+    part._moving_part = nullptr;
+    if (child->is_of_type(MovingPartBase::get_class_type())) {
+      part._moving_part = (MovingPartBase *)child;
+    }
+    part._parent_index = parent_index;
+    part._needs_update = false;
+    part._changed = false;
+
+    int index = (int)_flat_parts.size();
+    _flat_parts.push_back(part);
+    r_flatten_parts(child, index);
+  }
+}
+
 /**
  * Called by the BamReader to perform any final actions needed for setting up
  * the object after all objects have been read and all pointers have been
@@ -737,7 +825,7 @@ void PartBundle::
 finalize(BamReader *) {
   Thread *current_thread = Thread::get_current_thread();
   CDWriter cdata(_cycler, true);
-  do_update(this, cdata, nullptr, true, true, current_thread);
+  do_update_parts(cdata, true, true, current_thread);
 }
 
 /**
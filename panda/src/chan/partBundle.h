@@ -31,6 +31,7 @@
 #include "transformState.h"
 #include "weakPointerTo.h"
 #include "copyOnWritePointer.h"
+#include "pStatCollector.h"
 
 class Loader;
 class AnimBundle;
@@ -38,6 +39,7 @@ class PartBundleNode;
 class PartBundleNode;
 class TransformState;
 class AnimPreloadTable;
+class MovingPartBase;
 
 /**
  * This is the root of a MovingPart hierarchy.  It defines the hierarchy of
@@ -166,6 +168,10 @@ private:
   PN_stdfloat do_get_control_effect(AnimControl *control, const CData *cdata) const;
   void clear_and_stop_intersecting(AnimControl *control, CData *cdata);
 
+  bool do_update_parts(const CData *cdata, bool parent_changed,
+                       bool anim_changed, Thread *current_thread);
+  void r_flatten_parts(PartGroup *group, int parent_index);
+
   COWPT(AnimPreloadTable) _anim_preload;
 
   typedef pvector<PartBundleNode *> Nodes;
@@ -176,6 +182,24 @@ private:
 
   double _update_delay;
 
+  // All of the parts below the bundle, listed in topological order, so that
+  // they can be updated in a flat loop rather than recursively.  This is
+  // rebuilt whenever the hierarchy changes.
+  class FlatPart {
+  public:
+    PartGroup *_group;
+    MovingPartBase *_moving_part;
+    int _parent_index;
+    bool _needs_update;
+    bool _changed;
+  };
+  typedef pvector<FlatPart> FlatParts;
+  FlatParts _flat_parts;
+  AtomicAdjust::Integer _flat_parts_seq;
+
+  static PStatCollector _blend_pcollector;
+  static PStatCollector _compose_pcollector;
+
   // This is the data that must be cycled between pipeline stages.
   class CData : public CycleData {
   public:
@@ -28,6 +28,7 @@
 using std::ostream;
 
 TypeHandle PartGroup::_type_handle;
+AtomicAdjust::Integer PartGroup::_hierarchy_seq = 0;
 
 /**
  * Creates the PartGroup, and adds it to the indicated parent.  The only way
@@ -41,6 +42,7 @@ PartGroup(PartGroup *parent, const std::string &name) :
   nassertv(parent != nullptr);
 
   parent->_children.push_back(this);
+  mark_hierarchy_modified();
 }
 
 /**
@@ -85,6 +87,7 @@ copy_subgraph() const {
     PartGroup *child = (*ci)->copy_subgraph();
     root->_children.push_back(child);
   }
+  mark_hierarchy_modified();
 
   return root;
 }
@@ -166,6 +169,7 @@ public:
 void PartGroup::
 sort_descendants() {
   std::stable_sort(_children.begin(), _children.end(), PartGroupAlphabeticalOrder());
+  mark_hierarchy_modified();
 
   Children::iterator ci;
   for (ci = _children.begin(); ci != _children.end(); ++ci) {
@@ -482,6 +486,15 @@ do_update(PartBundle *root, const CycleData *root_cdata, PartGroup *,
   return any_changed;
 }
 
+/**
+ * Should be called whenever the children of any PartGroup are changed, to
+ * indicate that the PartBundles must rebuild their list of parts.
+ */
+void PartGroup::
+mark_hierarchy_modified() {
+  AtomicAdjust::inc(_hierarchy_seq);
+}
+
 /**
  * Called by PartBundle::xform(), this indicates the indicated transform is
  * being applied to the root joint.
@@ -670,6 +683,7 @@ complete_pointers(TypedWritable **p_list, BamReader *manager) {
   for (ci = _children.begin(); ci != _children.end(); ++ci) {
     (*ci) = DCAST(PartGroup, p_list[pi++]);
   }
+  mark_hierarchy_modified();
 
   return pi;
 }
@@ -23,6 +23,7 @@
 #include "thread.h"
 #include "plist.h"
 #include "luse.h"
+#include "atomicAdjust.h"
 
 class AnimControl;
 class AnimGroup;
@@ -116,6 +117,12 @@ protected:
   typedef pvector< PT(PartGroup) > Children;
   Children _children;
 
+  static void mark_hierarchy_modified();
+
+  // This is incremented whenever the children of any PartGroup are changed,
+  // so that each PartBundle knows when to rebuild its list of parts.
+  static AtomicAdjust::Integer _hierarchy_seq;
+
 public:
   static void register_with_read_factory();
   virtual void write_datagram(BamWriter* manager, Datagram &me);
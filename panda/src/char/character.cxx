@@ -707,6 +707,7 @@ r_merge_bundles(Character::JointMap &joint_map,
   }
 
   new_group->_children.swap(new_children);
+  PartGroup::mark_hierarchy_modified();
 }
 
 /**
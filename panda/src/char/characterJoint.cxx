@@ -19,9 +19,12 @@
 #include "datagramIterator.h"
 #include "bamReader.h"
 #include "bamWriter.h"
+#include "pStatTimer.h"
 
 TypeHandle CharacterJoint::_type_handle;
 
+PStatCollector CharacterJoint::_publish_pcollector("*:Animation:Publish");
+
 /**
  * For internal use only.
  */
@@ -134,6 +137,7 @@ update_internals(PartBundle *root, PartGroup *parent, bool self_changed,
 
   if (net_changed) {
     if (!_net_transform_nodes.empty()) {
+      PStatTimer timer(_publish_pcollector, current_thread);
       CPT(TransformState) t = TransformState::make_mat(_net_transform);
 
       NodeList::iterator ai;
@@ -157,6 +161,7 @@ update_internals(PartBundle *root, PartGroup *parent, bool self_changed,
   }
 
   if (self_changed && !_local_transform_nodes.empty()) {
+    PStatTimer timer(_publish_pcollector, current_thread);
     CPT(TransformState) t = TransformState::make_mat(_value);
 
     NodeList::iterator ai;
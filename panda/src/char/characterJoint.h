@@ -21,6 +21,7 @@
 #include "pandaNode.h"
 #include "nodePathCollection.h"
 #include "ordered_vector.h"
+#include "pStatCollector.h"
 
 class JointVertexTransform;
 class Character;
@@ -84,6 +85,8 @@ private:
   typedef ov_set<JointVertexTransform *> VertexTransforms;
   VertexTransforms _vertex_transforms;
 
+  static PStatCollector _publish_pcollector;
+
 public:
   static void register_with_read_factory();
   virtual void write_datagram(BamWriter* manager, Datagram &me);
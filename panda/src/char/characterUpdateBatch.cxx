@@ -0,0 +1,79 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file characterUpdateBatch.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#include "characterUpdateBatch.h"
+
+/**
+ *
+ */
+CharacterUpdateBatch::
+CharacterUpdateBatch() {
+}
+
+/**
+ * Calls Character::update() on each of the Characters that have been added,
+ * and waits for all of them to finish.  The characters are updated in
+ * parallel by the global JobPool, with the calling thread lending a hand.
+ */
+void CharacterUpdateBatch::
+update(Thread *current_thread) {
+  do_update(false, current_thread);
+}
+
+/**
+ * Calls Character::force_update() on each of the Characters that have been
+ * added, and waits for all of them to finish.
+ */
+void CharacterUpdateBatch::
+force_update(Thread *current_thread) {
+  do_update(true, current_thread);
+}
+
+/**
+ * The implementation of update() and force_update().
+ */
+void CharacterUpdateBatch::
+do_update(bool force, Thread *current_thread) {
+  JobPool *pool = JobPool::get_global_ptr();
+  if (_characters.size() < 2 || pool->get_num_threads() == 0) {
+    for (Character *character : _characters) {
+      if (force) {
+        character->force_update();
+      } else {
+        character->update();
+      }
+    }
+    return;
+  }
+
+  pvector<UpdateJob> jobs(_characters.size());
+  JobPool::Batch batch(pool, current_thread);
+  for (size_t i = 0; i < _characters.size(); ++i) {
+    jobs[i]._character = _characters[i];
+    jobs[i]._force = force;
+    batch.add_job(&jobs[i]);
+  }
+  batch.wait();
+}
+
+/**
+ *
+ */
+void CharacterUpdateBatch::UpdateJob::
+do_job(Thread *current_thread) {
+  if (_force) {
+    _character->force_update();
+  } else {
+    _character->update();
+  }
+}
@@ -0,0 +1,63 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file characterUpdateBatch.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef CHARACTERUPDATEBATCH_H
+#define CHARACTERUPDATEBATCH_H
+
+#include "pandabase.h"
+
+#include "referenceCount.h"
+#include "character.h"
+#include "jobPool.h"
+#include "pointerTo.h"
+#include "pvector.h"
+
+/**
+ * This class collects a number of Characters and updates the joints of all
+ * of them at once, spreading the work over the threads of the global
+ * JobPool.  This is useful for scenes with many animated characters: calling
+ * update() on the batch early in the frame means that the cull traversal
+ * finds the characters already up-to-date, instead of animating them one at a
+ * time as it encounters them.
+ */
+class EXPCL_PANDA_CHAR CharacterUpdateBatch : public ReferenceCount {
+PUBLISHED:
+  CharacterUpdateBatch();
+
+  INLINE void add_character(Character *character);
+  INLINE size_t get_num_characters() const;
+  INLINE Character *get_character(size_t n) const;
+  MAKE_SEQ(get_characters, get_num_characters, get_character);
+  INLINE void clear_characters();
+
+  BLOCKING void update(Thread *current_thread = Thread::get_current_thread());
+  BLOCKING void force_update(Thread *current_thread = Thread::get_current_thread());
+
+private:
+  void do_update(bool force, Thread *current_thread);
+
+  class UpdateJob : public JobPool::Job {
+  public:
+    virtual void do_job(Thread *current_thread);
+
+    Character *_character;
+    bool _force;
+  };
+
+  typedef pvector<PT(Character)> Characters;
+  Characters _characters;
+};
+
+#include "characterUpdateBatch.I"
+
+#endif
@@ -1,5 +1,6 @@
 #include "characterJointEffect.cxx"
 #include "characterSlider.cxx"
+#include "characterUpdateBatch.cxx"
 #include "characterVertexSlider.cxx"
 #include "jointVertexTransform.cxx"
 
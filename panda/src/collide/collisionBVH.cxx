@@ -0,0 +1,382 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file collisionBVH.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#include "collisionBVH.h"
+#include "boundingVolume.h"
+#include "finiteBoundingVolume.h"
+#include "boundingLine.h"
+
+#include <algorithm>
+
+// A node with no more than this many items is always made a leaf.
+static const int min_leaf_items = 2;
+
+// A node with more than this many items is always split, even if the surface
+// area heuristic suggests it isn't worth it.
+static const int max_leaf_items = 16;
+
+// The number of buckets into which the items are sorted when searching for
+// the best split.
+static const int num_bins = 12;
+
+// Beyond this depth, nodes are split at the median, so that a pathological
+// distribution of items cannot make the tree arbitrarily deep.
+static const int max_sah_depth = 48;
+
+namespace {
+  class Bin {
+  public:
+    Bin() : _count(0) {}
+
+    void extend(const LPoint3 &min_point, const LPoint3 &max_point) {
+      if (_count == 0) {
+        _min = min_point;
+        _max = max_point;
+      } else {
+        _min.set(std::min(_min[0], min_point[0]),
+                 std::min(_min[1], min_point[1]),
+                 std::min(_min[2], min_point[2]));
+        _max.set(std::max(_max[0], max_point[0]),
+                 std::max(_max[1], max_point[1]),
+                 std::max(_max[2], max_point[2]));
+      }
+    }
+
+    LPoint3 _min;
+    LPoint3 _max;
+    int _count;
+  };
+}
+
+/**
+ * Returns true if the indicated box overlaps the indicated node or item.
+ */
+template<class Box>
+static INLINE bool
+box_overlaps_box(const Box &box, const LPoint3 &min_point, const LPoint3 &max_point) {
+  return box._min[0] <= max_point[0] && min_point[0] <= box._max[0] &&
+         box._min[1] <= max_point[1] && min_point[1] <= box._max[1] &&
+         box._min[2] <= max_point[2] && min_point[2] <= box._max[2];
+}
+
+/**
+ * Returns true if the indicated infinite line overlaps the indicated node or
+ * item.
+ */
+template<class Box>
+static INLINE bool
+line_overlaps_box(const Box &box, const LPoint3 &point, const LVector3 &direction) {
+  PN_stdfloat t_min = -FLT_MAX;
+  PN_stdfloat t_max = FLT_MAX;
+  for (int i = 0; i < 3; ++i) {
+    if (direction[i] == 0) {
+      if (point[i] < box._min[i] || point[i] > box._max[i]) {
+        return false;
+      }
+    } else {
+      PN_stdfloat t1 = (box._min[i] - point[i]) / direction[i];
+      PN_stdfloat t2 = (box._max[i] - point[i]) / direction[i];
+      if (t1 > t2) {
+        std::swap(t1, t2);
+      }
+      t_min = std::max(t_min, t1);
+      t_max = std::min(t_max, t2);
+      if (t_min > t_max) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * Orders items by the position of their center along one axis.
+ */
+class CompareCenters {
+public:
+  CompareCenters(int axis) : _axis(axis) {}
+
+  template<class Item>
+  bool operator () (const Item &a, const Item &b) const {
+    return a._center[_axis] < b._center[_axis];
+  }
+
+  int _axis;
+};
+
+/**
+ *
+ */
+CollisionBVH::
+CollisionBVH() :
+  _num_items(0)
+{
+}
+
+/**
+ * Adds a new item with the indicated axis-aligned bounds.  Items are numbered
+ * consecutively from 0 in the order they are added.
+ */
+void CollisionBVH::
+add_item(const LPoint3 &min_point, const LPoint3 &max_point) {
+  Item item;
+  item._min = min_point;
+  item._max = max_point;
+  item._center = (min_point + max_point) * 0.5f;
+  item._index = _num_items++;
+  _items.push_back(item);
+}
+
+/**
+ * Adds a new item whose extents are given by the indicated bounding volume.
+ * If the volume is not finite, the item will be returned from every query.
+ */
+void CollisionBVH::
+add_item(const BoundingVolume *bounds) {
+  const FiniteBoundingVolume *fbv = bounds->as_finite_bounding_volume();
+  if (fbv == nullptr || fbv->is_empty() || fbv->is_infinite()) {
+    add_unbounded_item();
+  } else {
+    add_item(fbv->get_min(), fbv->get_max());
+  }
+}
+
+/**
+ * Adds a new item that can not be culled, and will therefore be returned from
+ * every query.
+ */
+void CollisionBVH::
+add_unbounded_item() {
+  _unbounded.push_back(_num_items++);
+}
+
+/**
+ * Builds the hierarchy from the items that have been added so far.  This
+ * should be called once, after all of the items have been added.
+ */
+void CollisionBVH::
+build() {
+  _nodes.clear();
+  if (_items.empty()) {
+    return;
+  }
+
+  // Grow each box by a small fraction of the overall size, so that items
+  // that merely touch the query volume are not lost to roundoff error.
+  Bin total;
+  Items::const_iterator ii;
+  for (ii = _items.begin(); ii != _items.end(); ++ii) {
+    total.extend((*ii)._min, (*ii)._max);
+    ++total._count;
+  }
+  LVector3 size = total._max - total._min;
+  PN_stdfloat epsilon = std::max(std::max(size[0], size[1]), size[2]) * 1.0e-5f;
+  LVector3 pad(epsilon, epsilon, epsilon);
+
+  Items::iterator ij;
+  for (ij = _items.begin(); ij != _items.end(); ++ij) {
+    (*ij)._min -= pad;
+    (*ij)._max += pad;
+  }
+
+  _nodes.reserve(_items.size() / min_leaf_items * 2);
+  r_build(0, (int)_items.size(), 0);
+}
+
+/**
+ * Appends to the indicated vector the indices of all of the items whose
+ * bounds might intersect the indicated volume, in increasing order.  If
+ * volume is NULL, or of a type that the hierarchy cannot test, all of the
+ * items are returned.
+ */
+void CollisionBVH::
+find_candidates(const GeometricBoundingVolume *volume,
+                pvector<int> &candidates) const {
+  size_t first = candidates.size();
+
+  const FiniteBoundingVolume *fbv = nullptr;
+  const BoundingLine *line = nullptr;
+  if (volume != nullptr) {
+    fbv = volume->as_finite_bounding_volume();
+    if (fbv == nullptr) {
+      line = volume->as_bounding_line();
+    }
+  }
+
+  if (fbv == nullptr && line == nullptr) {
+    for (int i = 0; i < _num_items; ++i) {
+      candidates.push_back(i);
+    }
+    return;
+  }
+
+  if (volume->is_empty()) {
+    return;
+  }
+
+  if (!_nodes.empty()) {
+    LPoint3 min_point, max_point, point;
+    LVector3 direction;
+    if (fbv != nullptr) {
+      min_point = fbv->get_min();
+      max_point = fbv->get_max();
+    } else {
+      point = line->get_point_a();
+      direction = line->get_point_b() - point;
+    }
+
+    int stack[128];
+    int stack_size = 0;
+    stack[stack_size++] = 0;
+    while (stack_size > 0) {
+      const Node &node = _nodes[stack[--stack_size]];
+      if (fbv != nullptr ? !box_overlaps_box(node, min_point, max_point)
+                         : !line_overlaps_box(node, point, direction)) {
+        continue;
+      }
+
+      if (node._count != 0) {
+        for (int i = node._first; i < node._first + node._count; ++i) {
+          const Item &item = _items[i];
+          if (fbv != nullptr ? box_overlaps_box(item, min_point, max_point)
+                             : line_overlaps_box(item, point, direction)) {
+            candidates.push_back(item._index);
+          }
+        }
+      } else {
+        nassertv(stack_size + 2 <= 128);
+        stack[stack_size++] = node._first;
+        stack[stack_size++] = (int)(&node - &_nodes[0]) + 1;
+      }
+    }
+  }
+
+  candidates.insert(candidates.end(), _unbounded.begin(), _unbounded.end());
+  std::sort(candidates.begin() + first, candidates.end());
+}
+
+/**
+ *
+ */
+void CollisionBVH::
+output(std::ostream &out) const {
+  out << "CollisionBVH, " << _num_items << " items, " << _nodes.size()
+      << " nodes";
+}
+
+/**
+ * Recursively builds the node for the indicated range of _items, and all of
+ * its descendants, reordering the items as necessary.
+ */
+void CollisionBVH::
+r_build(int first, int count, int depth) {
+  int node_index = (int)_nodes.size();
+  _nodes.push_back(Node());
+
+  Bin bounds, centers;
+  for (int i = first; i < first + count; ++i) {
+    bounds.extend(_items[i]._min, _items[i]._max);
+    centers.extend(_items[i]._center, _items[i]._center);
+    ++bounds._count;
+    ++centers._count;
+  }
+  _nodes[node_index]._min = bounds._min;
+  _nodes[node_index]._max = bounds._max;
+  _nodes[node_index]._first = first;
+  _nodes[node_index]._count = count;
+
+  if (count <= min_leaf_items) {
+    return;
+  }
+
+  LVector3 extent = centers._max - centers._min;
+  int axis = 0;
+  if (extent[1] > extent[axis]) {
+    axis = 1;
+  }
+  if (extent[2] > extent[axis]) {
+    axis = 2;
+  }
+
+  Items::iterator begin = _items.begin() + first;
+  Items::iterator end = begin + count;
+  int mid = -1;
+
+  if (extent[axis] > 0 && depth < max_sah_depth) {
+    // Sort the item centers into bins along the longest axis, and consider
+    // each boundary between bins as a possible split.
+    PN_stdfloat scale = num_bins / extent[axis];
+    Bin bins[num_bins];
+    for (Items::iterator ii = begin; ii != end; ++ii) {
+      int b = std::min(num_bins - 1, (int)(((*ii)._center[axis] - centers._min[axis]) * scale));
+      bins[b].extend((*ii)._min, (*ii)._max);
+      ++bins[b]._count;
+    }
+
+    PN_stdfloat right_cost[num_bins];
+    Bin right;
+    for (int b = num_bins - 1; b > 0; --b) {
+      if (bins[b]._count != 0) {
+        right.extend(bins[b]._min, bins[b]._max);
+        right._count += bins[b]._count;
+      }
+      right_cost[b] = (right._count != 0) ? get_half_area(right._min, right._max) * right._count : 0;
+    }
+
+    int best_bin = -1;
+    PN_stdfloat best_cost = 0;
+    Bin left;
+    for (int b = 0; b < num_bins - 1; ++b) {
+      if (bins[b]._count != 0) {
+        left.extend(bins[b]._min, bins[b]._max);
+        left._count += bins[b]._count;
+      }
+      if (left._count != 0 && left._count != count) {
+        PN_stdfloat cost = get_half_area(left._min, left._max) * left._count + right_cost[b + 1];
+        if (best_bin < 0 || cost < best_cost) {
+          best_bin = b + 1;
+          best_cost = cost;
+        }
+      }
+    }
+
+    if (best_bin >= 0) {
+      if (count <= max_leaf_items &&
+          best_cost >= get_half_area(bounds._min, bounds._max) * count) {
+        // Splitting wouldn't save us anything.
+        return;
+      }
+
+      Items::iterator split = begin;
+      for (Items::iterator ii = begin; ii != end; ++ii) {
+        int b = std::min(num_bins - 1, (int)(((*ii)._center[axis] - centers._min[axis]) * scale));
+        if (b < best_bin) {
+          std::swap(*ii, *split);
+          ++split;
+        }
+      }
+      mid = (int)(split - _items.begin());
+    }
+  }
+
+  if (mid <= first || mid >= first + count) {
+    // Fall back to splitting at the median.
+    mid = first + count / 2;
+    std::nth_element(begin, _items.begin() + mid, end, CompareCenters(axis));
+  }
+
+  r_build(first, mid - first, depth + 1);
+  _nodes[node_index]._first = (int)_nodes.size();
+  _nodes[node_index]._count = 0;
+  r_build(mid, first + count - mid, depth + 1);
+}
@@ -0,0 +1,94 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file collisionBVH.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef COLLISIONBVH_H
+#define COLLISIONBVH_H
+
+#include "pandabase.h"
+
+#include "referenceCount.h"
+#include "luse.h"
+#include "pvector.h"
+
+class BoundingVolume;
+class GeometricBoundingVolume;
+
+/**
+ * A bounding volume hierarchy over a set of items, each of which is
+ * described by an axis-aligned box.  The CollisionTraverser builds one of
+ * these for each CollisionNode with many solids, and for each Geom with many
+ * triangles, so that it need not consider every item within a node whose
+ * bounding volume is intersected.
+ *
+ * Items are identified by the order in which they were added.  Items whose
+ * bounds are not finite are never culled.  The tree is built with the
+ * surface area heuristic.
+ */
+class EXPCL_PANDA_COLLIDE CollisionBVH : public ReferenceCount {
+public:
+  CollisionBVH();
+
+  void add_item(const LPoint3 &min_point, const LPoint3 &max_point);
+  void add_item(const BoundingVolume *bounds);
+  void add_unbounded_item();
+  void build();
+
+  INLINE int get_num_items() const;
+  INLINE int get_num_nodes() const;
+
+  void find_candidates(const GeometricBoundingVolume *volume,
+                       pvector<int> &candidates) const;
+
+  void output(std::ostream &out) const;
+
+private:
+  class Item {
+  public:
+    LPoint3 _min;
+    LPoint3 _max;
+    LPoint3 _center;
+    int _index;
+  };
+  typedef pvector<Item> Items;
+
+  // A leaf node has a nonzero _count, and refers to that many entries of
+  // _items starting at _first.  An interior node's first child immediately
+  // follows it, and _first is the index of its second child.
+  class Node {
+  public:
+    LPoint3 _min;
+    LPoint3 _max;
+    int _first;
+    int _count;
+  };
+  typedef pvector<Node> Nodes;
+
+  void r_build(int first, int count, int depth);
+
+  INLINE static PN_stdfloat get_half_area(const LPoint3 &min_point,
+                                          const LPoint3 &max_point);
+
+  Items _items;
+  Nodes _nodes;
+  pvector<int> _unbounded;
+  int _num_items;
+};
+
+INLINE std::ostream &operator << (std::ostream &out, const CollisionBVH &bvh) {
+  bvh.output(out);
+  return out;
+}
+
+#include "collisionBVH.I"
+
+#endif
@@ -0,0 +1,659 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file collisionBroadphase.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#include "collisionBroadphase.h"
+#include "config_collide.h"
+#include "geometricBoundingVolume.h"
+#include "finiteBoundingVolume.h"
+#include "boundingLine.h"
+#include "geomNode.h"
+#include "lodNode.h"
+
+#include <algorithm>
+
+// A node that would occupy more than this many cells is instead kept on a
+// separate list, which is checked for every collider.
+static const int max_cells_per_record = 64;
+
+namespace {
+  class CompareRecordSort {
+  public:
+    CompareRecordSort(const CollisionBroadphase &broadphase) :
+      _broadphase(broadphase) {}
+
+    bool operator () (int a, int b) const {
+      return _broadphase.get_record(a)._sort < _broadphase.get_record(b)._sort;
+    }
+
+    const CollisionBroadphase &_broadphase;
+  };
+}
+
+/**
+ *
+ */
+CollisionBroadphase::
+CollisionBroadphase() :
+  _has_grid_bounds(false),
+  _has_ancestor_bounds(false),
+  _cell_size(collision_broadphase_cell_size),
+  _num_sorted(0),
+  _update_seq(0),
+  _query_seq(0)
+{
+}
+
+/**
+ * Walks the scene graph below the indicated root to bring the grid up to
+ * date with the nodes that may be collided into by a collider with any of
+ * the bits of from_mask.  Nodes that have not moved since the last update
+ * keep their place in the grid.
+ */
+void CollisionBroadphase::
+update(const NodePath &root, CollideMask from_mask, Thread *current_thread) {
+  ++_update_seq;
+  _num_sorted = 0;
+  _from_mask = from_mask;
+  _dirty_records.clear();
+  _has_ancestor_bounds = false;
+
+  if (!root.is_empty() && !from_mask.is_zero()) {
+    WalkState state;
+    state._net_transform = TransformState::make_identity();
+    state._include_mask = CollideMask::all_on();
+    state._has_bounds = true;
+    r_update(root, state, current_thread);
+  }
+
+  // Forget the nodes that we did not encounter this time.
+  RecordIndex::iterator ri = _record_index.begin();
+  while (ri != _record_index.end()) {
+    int index = (*ri).second;
+    if (_records[index]._last_update != _update_seq) {
+      unlink_record(index);
+      _records[index] = Record();
+      _records[index]._in_use = false;
+      _free_records.push_back(index);
+      _record_index.erase(ri++);
+    } else {
+      ++ri;
+    }
+  }
+
+  if (_cell_size <= 0) {
+    choose_cell_size();
+  }
+
+  if (_cell_size > 0) {
+    for (int index : _dirty_records) {
+      unlink_record(index);
+      link_record(index);
+    }
+  }
+  _dirty_records.clear();
+}
+
+/**
+ * Removes all of the nodes from the grid.  If the cell size was chosen
+ * automatically, it will be chosen again at the next update.
+ */
+void CollisionBroadphase::
+clear() {
+  _records.clear();
+  _free_records.clear();
+  _dirty_records.clear();
+  _large_records.clear();
+  _record_index.clear();
+  _cells.clear();
+  _has_grid_bounds = false;
+  _cell_size = collision_broadphase_cell_size;
+  _num_sorted = 0;
+}
+
+/**
+ * Fills candidates with the indices of the records that might be reached by
+ * a collider with the indicated bounding volume, expressed in the space of
+ * the root's parent, and the indicated from collide mask.  The candidates
+ * are returned in the order in which the nodes appear in the scene graph.
+ *
+ * If the volume is neither finite nor a line, or is NULL, every record with a
+ * matching collide mask is returned.
+ */
+void CollisionBroadphase::
+find_candidates(const GeometricBoundingVolume *volume, CollideMask from_mask,
+                pvector<int> &candidates) {
+  candidates.clear();
+  ++_query_seq;
+
+  Query query;
+  query._from_mask = from_mask;
+  query._bounded = false;
+  query._is_line = false;
+
+  bool in_grid = true;
+  if (volume != nullptr) {
+    if (volume->is_empty()) {
+      return;
+    }
+    const FiniteBoundingVolume *fbv = volume->as_finite_bounding_volume();
+    const BoundingLine *line = volume->as_bounding_line();
+    if (fbv != nullptr && !fbv->is_infinite()) {
+      query._min = fbv->get_min();
+      query._max = fbv->get_max();
+      query._bounded = true;
+
+    } else if (line != nullptr) {
+      query._is_line = true;
+      query._point = line->get_point_a();
+      query._direction = line->get_point_b() - line->get_point_a();
+
+      // A line is infinitely long, but only the part of it that passes
+      // through the grid can reach any of the nodes within it.
+      if (_has_grid_bounds) {
+        in_grid = clip_line(query, _grid_min, _grid_max);
+      }
+    }
+  }
+
+  PN_stdfloat extent = 1.0f;
+  if (query._bounded) {
+    // Pad the box slightly, so that nodes that merely touch the volume are
+    // not lost to roundoff error.
+    for (int i = 0; i < 3; ++i) {
+      extent = std::max(extent, std::max(cabs(query._min[i]), cabs(query._max[i])));
+    }
+  }
+  query._pad = extent * 1.0e-5f;
+  query._min -= LVector3(query._pad);
+  query._max += LVector3(query._pad);
+
+  bool scan_all = true;
+  if (query._bounded && _cell_size > 0) {
+    // If the volume covers more cells than there are nodes, it is cheaper to
+    // examine every node.
+    double num_cells = 1.0;
+    for (int i = 0; i < 3; ++i) {
+      num_cells *= (double)(get_cell_coord(query._max[i]) - get_cell_coord(query._min[i]) + 1);
+    }
+    scan_all = (num_cells > (double)_record_index.size());
+  }
+
+  if (!in_grid) {
+    // The volume misses the grid entirely; only the large nodes, which are
+    // not in it, might still be reached.
+    for (int index : _large_records) {
+      if (accepts(_records[index], query)) {
+        candidates.push_back(index);
+      }
+    }
+
+  } else if (scan_all) {
+    for (const RecordIndex::value_type &ri : _record_index) {
+      if (accepts(_records[ri.second], query)) {
+        candidates.push_back(ri.second);
+      }
+    }
+
+  } else {
+    int min_cell[3], max_cell[3];
+    for (int i = 0; i < 3; ++i) {
+      min_cell[i] = get_cell_coord(query._min[i]);
+      max_cell[i] = get_cell_coord(query._max[i]);
+    }
+
+    for (int x = min_cell[0]; x <= max_cell[0]; ++x) {
+      for (int y = min_cell[1]; y <= max_cell[1]; ++y) {
+        for (int z = min_cell[2]; z <= max_cell[2]; ++z) {
+          int slot = _cells.find(get_cell_key(x, y, z));
+          if (slot < 0) {
+            continue;
+          }
+          const Cell &cell = _cells.get_data(slot);
+          if ((cell._mask & from_mask).is_zero()) {
+            continue;
+          }
+          for (int index : cell._records) {
+            Record &record = _records[index];
+            if (record._last_query != _query_seq) {
+              record._last_query = _query_seq;
+              if (accepts(record, query)) {
+                candidates.push_back(index);
+              }
+            }
+          }
+        }
+      }
+    }
+
+    for (int index : _large_records) {
+      if (accepts(_records[index], query)) {
+        candidates.push_back(index);
+      }
+    }
+  }
+
+  std::sort(candidates.begin(), candidates.end(), CompareRecordSort(*this));
+}
+
+/**
+ * Replaces the box of the indicated line query with the box around the part
+ * of the line that lies within the indicated box.  Returns false if the line
+ * misses the box altogether.
+ */
+bool CollisionBroadphase::
+clip_line(Query &query, const LPoint3 &min_point, const LPoint3 &max_point) {
+  PN_stdfloat t_min = -FLT_MAX;
+  PN_stdfloat t_max = FLT_MAX;
+  for (int i = 0; i < 3; ++i) {
+    if (query._direction[i] == 0) {
+      if (query._point[i] < min_point[i] || query._point[i] > max_point[i]) {
+        return false;
+      }
+    } else {
+      PN_stdfloat t1 = (min_point[i] - query._point[i]) / query._direction[i];
+      PN_stdfloat t2 = (max_point[i] - query._point[i]) / query._direction[i];
+      if (t1 > t2) {
+        std::swap(t1, t2);
+      }
+      t_min = std::max(t_min, t1);
+      t_max = std::min(t_max, t2);
+      if (t_min > t_max) {
+        return false;
+      }
+    }
+  }
+
+  LPoint3 a = query._point + query._direction * t_min;
+  LPoint3 b = query._point + query._direction * t_max;
+  query._min.set(std::min(a[0], b[0]), std::min(a[1], b[1]), std::min(a[2], b[2]));
+  query._max.set(std::max(a[0], b[0]), std::max(a[1], b[1]), std::max(a[2], b[2]));
+
+  // Axes along which the line doesn't travel were not clipped above.
+  for (int i = 0; i < 3; ++i) {
+    if (query._direction[i] == 0) {
+      query._min[i] = query._max[i] = query._point[i];
+    }
+  }
+  query._bounded = true;
+  return true;
+}
+
+/**
+ *
+ */
+void CollisionBroadphase::
+output(std::ostream &out) const {
+  out << "CollisionBroadphase, " << _record_index.size() << " nodes in "
+      << _cells.get_num_entries() << " cells of size " << _cell_size;
+  if (!_large_records.empty()) {
+    out << ", " << _large_records.size() << " large";
+  }
+}
+
+/**
+ * The recursive implementation of update().  The parent_state describes the
+ * parent of the indicated node, except for the include mask, which applies
+ * to the node itself.
+ */
+void CollisionBroadphase::
+r_update(const NodePath &node_path, const WalkState &parent_state,
+         Thread *current_thread) {
+  PandaNode *node = node_path.node();
+
+  // There's no point in looking further if nothing at this level or below
+  // can be collided into by any of the colliders.
+  CollideMask net_mask = node->get_net_collide_mask(current_thread);
+  if ((net_mask & parent_state._include_mask & _from_mask).is_zero()) {
+    return;
+  }
+
+  if (parent_state._has_bounds) {
+    CPT(BoundingVolume) bounds = node->get_bounds(current_thread);
+    if (bounds->is_empty()) {
+      return;
+    }
+  }
+
+  WalkState state;
+  const TransformState *transform = node->get_transform(current_thread);
+  if (transform->is_identity()) {
+    state._net_transform = parent_state._net_transform;
+  } else {
+    if (transform->is_singular()) {
+      // The traverser can't convert the colliders into the space of this
+      // node, so it skips it and everything below it.
+      return;
+    }
+    state._net_transform = parent_state._net_transform->compose(transform);
+  }
+
+  bool is_final = node->is_final(current_thread);
+  state._include_mask = parent_state._include_mask;
+  state._has_bounds = parent_state._has_bounds && !is_final;
+  state._final_bounds = parent_state._final_bounds;
+  state._final_parent_net_transform = parent_state._final_parent_net_transform;
+  if (is_final && state._final_bounds == nullptr) {
+    state._final_bounds = node->get_bounds(current_thread);
+    state._final_parent_net_transform = parent_state._net_transform;
+  }
+
+  // The traverser tests the colliders against the bounds of every node on
+  // the way down.  We can skip that only if those bounds were computed from
+  // the nodes below, not if they were set explicitly.
+  if (state._has_bounds && node->get_num_children(current_thread) > 0 &&
+      node->get_user_bounds(current_thread->get_pipeline_stage(), current_thread) != nullptr) {
+    _has_ancestor_bounds = true;
+  }
+
+  if (node->is_collision_node() || node->is_geom_node()) {
+    CollideMask into_mask = node->get_into_collide_mask();
+    if (!(into_mask & _from_mask).is_zero()) {
+      update_record(node_path, node, into_mask,
+                    net_mask & parent_state._include_mask, parent_state,
+                    state._net_transform, is_final, current_thread);
+    }
+  }
+
+  // Visit the children the same way that the CollisionTraverser does.
+  if (node->has_single_child_visibility()) {
+    int index = node->get_visible_child();
+    if (index >= 0 && index < node->get_num_children(current_thread)) {
+      NodePath child_path(node_path, node->get_child(index, current_thread), current_thread);
+      r_update(child_path, state, current_thread);
+    }
+
+  } else if (node->is_lod_node()) {
+    int index = DCAST(LODNode, node)->get_lowest_switch();
+    CollideMask include_mask = state._include_mask;
+    PandaNode::Children children = node->get_children(current_thread);
+    int num_children = children.get_num_children();
+    for (int i = 0; i < num_children; ++i) {
+      state._include_mask = include_mask;
+      if (i != index) {
+        state._include_mask &= ~GeomNode::get_default_collide_mask();
+      }
+      NodePath child_path(node_path, children.get_child(i), current_thread);
+      r_update(child_path, state, current_thread);
+    }
+
+  } else {
+    PandaNode::Children children = node->get_children(current_thread);
+    int num_children = children.get_num_children();
+    for (int i = 0; i < num_children; ++i) {
+      NodePath child_path(node_path, children.get_child(i), current_thread);
+      r_update(child_path, state, current_thread);
+    }
+  }
+}
+
+/**
+ * Records that the indicated node was encountered by the current update, and
+ * marks it to be moved within the grid if it has changed since the last
+ * update.
+ */
+void CollisionBroadphase::
+update_record(const NodePath &node_path, PandaNode *node,
+              CollideMask into_mask, CollideMask net_mask,
+              const WalkState &parent_state,
+              const TransformState *net_transform, bool is_final,
+              Thread *current_thread) {
+  int index;
+  RecordIndex::iterator ri = _record_index.find(node_path);
+  if (ri != _record_index.end()) {
+    index = (*ri).second;
+  } else {
+    if (!_free_records.empty()) {
+      index = _free_records.back();
+      _free_records.pop_back();
+    } else {
+      index = (int)_records.size();
+      _records.push_back(Record());
+    }
+    _record_index[node_path] = index;
+
+    Record &record = _records[index];
+    record._node_path = node_path;
+    record._in_use = true;
+    record._linked = false;
+    record._large = false;
+    record._last_query = 0;
+  }
+
+  Record &record = _records[index];
+  record._last_update = _update_seq;
+  record._sort = _num_sorted++;
+  record._has_parent_bounds = parent_state._has_bounds;
+  record._has_local_bounds = parent_state._has_bounds && !is_final;
+
+  // The topmost final node is the node itself if no ancestor is final, but
+  // then testing its bounds is the same as testing the node's own, so we
+  // only keep them for the nodes below it.
+  const BoundingVolume *final_bounds = nullptr;
+  const TransformState *final_parent_net_transform = nullptr;
+  if (!parent_state._has_bounds) {
+    final_bounds = parent_state._final_bounds;
+    final_parent_net_transform = parent_state._final_parent_net_transform;
+  }
+
+  CPT(BoundingVolume) bounds = node->get_bounds(current_thread);
+  if (record._net_transform == net_transform &&
+      record._parent_net_transform == parent_state._net_transform &&
+      record._bounds == bounds &&
+      record._final_bounds == final_bounds &&
+      record._final_parent_net_transform == final_parent_net_transform &&
+      record._into_mask == into_mask &&
+      record._net_mask == net_mask) {
+    // Nothing has changed.
+    return;
+  }
+
+  record._net_transform = net_transform;
+  record._parent_net_transform = parent_state._net_transform;
+  record._bounds = bounds;
+  record._final_bounds = final_bounds;
+  record._final_parent_net_transform = final_parent_net_transform;
+  record._into_mask = into_mask;
+  record._net_mask = net_mask;
+
+  CPT(TransformState) inverse = net_transform->get_inverse();
+  record._inv_mat = inverse->has_mat() ? inverse->get_mat() : LMatrix4::ident_mat();
+  inverse = parent_state._net_transform->get_inverse();
+  record._parent_inv_mat = inverse->has_mat() ? inverse->get_mat() : LMatrix4::ident_mat();
+
+  // The grid stores each node by the box around its bounding volume, in the
+  // space of the root's parent.
+  const BoundingVolume *grid_bounds = bounds;
+  const TransformState *grid_transform = parent_state._net_transform;
+  if (final_bounds != nullptr) {
+    inverse = final_parent_net_transform->get_inverse();
+    record._final_parent_inv_mat = inverse->has_mat() ? inverse->get_mat() : LMatrix4::ident_mat();
+    grid_bounds = final_bounds;
+    grid_transform = final_parent_net_transform;
+  }
+
+  record._bounded = false;
+  const FiniteBoundingVolume *fbv = grid_bounds->as_finite_bounding_volume();
+  if (fbv != nullptr && !fbv->is_empty() && !fbv->is_infinite()) {
+    PT(BoundingVolume) copy = fbv->make_copy();
+    GeometricBoundingVolume *gbv = copy->as_geometric_bounding_volume();
+    if (gbv != nullptr) {
+      if (!grid_transform->is_identity()) {
+        gbv->xform(grid_transform->get_mat());
+      }
+      fbv = gbv->as_finite_bounding_volume();
+      if (fbv != nullptr && !fbv->is_empty() && !fbv->is_infinite()) {
+        record._min = fbv->get_min();
+        record._max = fbv->get_max();
+        record._bounded = true;
+      }
+    }
+  }
+
+  _dirty_records.push_back(index);
+}
+
+/**
+ * Chooses the size of the cells from the sizes of the nodes that are
+ * currently known, so that a typical node occupies only a few cells.
+ */
+void CollisionBroadphase::
+choose_cell_size() {
+  double total = 0.0;
+  int count = 0;
+  for (const RecordIndex::value_type &ri : _record_index) {
+    const Record &record = _records[ri.second];
+    if (record._bounded) {
+      LVector3 size = record._max - record._min;
+      total += std::max(size[0], std::max(size[1], size[2]));
+      ++count;
+    }
+  }
+
+  if (count == 0) {
+    return;
+  }
+
+  _cell_size = (PN_stdfloat)(2.0 * total / count);
+  if (!(_cell_size > 0)) {
+    _cell_size = 1.0f;
+  }
+
+  // Everything needs to be put into the grid now.
+  _dirty_records.clear();
+  for (const RecordIndex::value_type &ri : _record_index) {
+    _dirty_records.push_back(ri.second);
+  }
+}
+
+/**
+ * Adds the indicated record to the cells of the grid that its box overlaps.
+ */
+void CollisionBroadphase::
+link_record(int index) {
+  Record &record = _records[index];
+  nassertv(record._in_use && !record._linked);
+  record._linked = true;
+
+  if (record._bounded) {
+    double num_cells = 1.0;
+    for (int i = 0; i < 3; ++i) {
+      record._min_cell[i] = get_cell_coord(record._min[i]);
+      record._max_cell[i] = get_cell_coord(record._max[i]);
+      num_cells *= (double)(record._max_cell[i] - record._min_cell[i] + 1);
+    }
+    record._large = (num_cells > max_cells_per_record);
+  } else {
+    record._large = true;
+  }
+
+  if (record._large) {
+    _large_records.push_back(index);
+    return;
+  }
+
+  // Keep track of the box around everything in the grid.  This only grows
+  // until the grid is emptied, so it may be larger than necessary.
+  if (!_has_grid_bounds) {
+    _grid_min = record._min;
+    _grid_max = record._max;
+    _has_grid_bounds = true;
+  } else {
+    _grid_min.set(std::min(_grid_min[0], record._min[0]),
+                  std::min(_grid_min[1], record._min[1]),
+                  std::min(_grid_min[2], record._min[2]));
+    _grid_max.set(std::max(_grid_max[0], record._max[0]),
+                  std::max(_grid_max[1], record._max[1]),
+                  std::max(_grid_max[2], record._max[2]));
+  }
+
+  for (int x = record._min_cell[0]; x <= record._max_cell[0]; ++x) {
+    for (int y = record._min_cell[1]; y <= record._max_cell[1]; ++y) {
+      for (int z = record._min_cell[2]; z <= record._max_cell[2]; ++z) {
+        uint64_t key = get_cell_key(x, y, z);
+        int slot = _cells.find(key);
+        if (slot < 0) {
+          slot = _cells.store(key, Cell());
+        }
+        Cell &cell = _cells.modify_data(slot);
+        cell._records.push_back(index);
+        cell._mask |= record._into_mask;
+      }
+    }
+  }
+}
+
+/**
+ * Removes the indicated record from the cells of the grid, if it has been
+ * added to them.
+ */
+void CollisionBroadphase::
+unlink_record(int index) {
+  Record &record = _records[index];
+  if (!record._linked) {
+    return;
+  }
+  record._linked = false;
+
+  if (record._large) {
+    pvector<int>::iterator li =
+      std::find(_large_records.begin(), _large_records.end(), index);
+    nassertv(li != _large_records.end());
+    *li = _large_records.back();
+    _large_records.pop_back();
+    record._large = false;
+    return;
+  }
+
+  for (int x = record._min_cell[0]; x <= record._max_cell[0]; ++x) {
+    for (int y = record._min_cell[1]; y <= record._max_cell[1]; ++y) {
+      for (int z = record._min_cell[2]; z <= record._max_cell[2]; ++z) {
+        uint64_t key = get_cell_key(x, y, z);
+        int slot = _cells.find(key);
+        nassertd(slot >= 0) continue;
+
+        Cell &cell = _cells.modify_data(slot);
+        pvector<int>::iterator ci =
+          std::find(cell._records.begin(), cell._records.end(), index);
+        nassertd(ci != cell._records.end()) continue;
+        *ci = cell._records.back();
+        cell._records.pop_back();
+
+        if (cell._records.empty()) {
+          _cells.remove(key);
+        } else {
+          update_cell_mask(key);
+        }
+      }
+    }
+  }
+
+  if (_cells.is_empty()) {
+    _has_grid_bounds = false;
+  }
+}
+
+/**
+ * Recomputes the union of the into collide masks of the nodes in the
+ * indicated cell.
+ */
+void CollisionBroadphase::
+update_cell_mask(uint64_t key) {
+  int slot = _cells.find(key);
+  nassertv(slot >= 0);
+
+  Cell &cell = _cells.modify_data(slot);
+  cell._mask = CollideMask::all_off();
+  for (int index : cell._records) {
+    cell._mask |= _records[index]._into_mask;
+  }
+}
@@ -0,0 +1,197 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file collisionBroadphase.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef COLLISIONBROADPHASE_H
+#define COLLISIONBROADPHASE_H
+
+#include "pandabase.h"
+
+#include "referenceCount.h"
+#include "nodePath.h"
+#include "collideMask.h"
+#include "transformState.h"
+#include "boundingVolume.h"
+#include "simpleHashMap.h"
+#include "pmap.h"
+#include "pvector.h"
+#include "luse.h"
+
+class GeometricBoundingVolume;
+
+/**
+ * A uniform grid, stored as a spatial hash, of the CollisionNodes and
+ * GeomNodes below the root of a collision traversal.  A CollisionTraverser
+ * with set_broadphase() enabled keeps one of these, and uses it to find the
+ * nodes that each of its colliders might reach without comparing every
+ * collider against every node of the scene graph.  This is particularly
+ * valuable when many colliders are also into objects for each other, such
+ * as a crowd of avatars that push each other apart.
+ *
+ * The grid persists from one traversal to the next.  Each update() walks the
+ * graph to find the into nodes, but a node is only moved to different cells
+ * of the grid when its net transform or its bounding volume has changed.
+ * Each cell also records the union of the into collide masks of its nodes,
+ * so that cells with no interesting nodes are skipped without examining
+ * their contents.
+ */
+class EXPCL_PANDA_COLLIDE CollisionBroadphase : public ReferenceCount {
+public:
+  CollisionBroadphase();
+
+  void update(const NodePath &root, CollideMask from_mask,
+              Thread *current_thread = Thread::get_current_thread());
+  void clear();
+
+  void find_candidates(const GeometricBoundingVolume *volume,
+                       CollideMask from_mask, pvector<int> &candidates);
+
+  /**
+   * One node of the scene graph that may be collided into.  The inverse
+   * matrices convert from the coordinate space of the root's parent, in
+   * which the colliders' bounding volumes are expressed, to the coordinate
+   * space of the node and to that of its parent, respectively.
+   */
+  class Record {
+  public:
+    NodePath _node_path;
+    CollideMask _into_mask;
+    CollideMask _net_mask;
+    int _sort;
+
+    CPT(TransformState) _net_transform;
+    CPT(TransformState) _parent_net_transform;
+    CPT(BoundingVolume) _bounds;
+    LMatrix4 _inv_mat;
+    LMatrix4 _parent_inv_mat;
+
+    // If the node is below a node that has its final flag set, the
+    // colliders' bounding volumes are not tested any further below that
+    // node.  Instead, this is the bounding volume of the topmost such node,
+    // in the space of its parent, and the matrix that converts to that
+    // space.
+    CPT(BoundingVolume) _final_bounds;
+    CPT(TransformState) _final_parent_net_transform;
+    LMatrix4 _final_parent_inv_mat;
+    bool _has_parent_bounds;
+    bool _has_local_bounds;
+
+    LPoint3 _min;
+    LPoint3 _max;
+    bool _bounded;
+    bool _large;
+    int _min_cell[3];
+    int _max_cell[3];
+
+    bool _in_use;
+    bool _linked;
+    unsigned int _last_update;
+    unsigned int _last_query;
+  };
+
+  INLINE int get_num_records() const;
+  INLINE const Record &get_record(int n) const;
+  INLINE int get_num_cells() const;
+  INLINE PN_stdfloat get_cell_size() const;
+  INLINE bool has_ancestor_bounds() const;
+
+  void output(std::ostream &out) const;
+
+private:
+  // The description of a collider's bounding volume used by
+  // find_candidates().
+  class Query {
+  public:
+    CollideMask _from_mask;
+    bool _bounded;
+    LPoint3 _min;
+    LPoint3 _max;
+    PN_stdfloat _pad;
+    bool _is_line;
+    LPoint3 _point;
+    LVector3 _direction;
+  };
+
+  class WalkState {
+  public:
+    CPT(TransformState) _net_transform;
+    CollideMask _include_mask;
+    bool _has_bounds;
+    CPT(BoundingVolume) _final_bounds;
+    CPT(TransformState) _final_parent_net_transform;
+  };
+
+  void r_update(const NodePath &node_path, const WalkState &parent_state,
+                Thread *current_thread);
+  void update_record(const NodePath &node_path, PandaNode *node,
+                     CollideMask into_mask, CollideMask net_mask,
+                     const WalkState &parent_state,
+                     const TransformState *net_transform, bool is_final,
+                     Thread *current_thread);
+  void choose_cell_size();
+  static bool clip_line(Query &query, const LPoint3 &min_point,
+                        const LPoint3 &max_point);
+
+  void link_record(int index);
+  void unlink_record(int index);
+  void update_cell_mask(uint64_t key);
+
+  INLINE int get_cell_coord(PN_stdfloat value) const;
+  INLINE static uint64_t get_cell_key(int x, int y, int z);
+  INLINE static bool accepts(const Record &record, const Query &query);
+
+  typedef pvector<Record> Records;
+  Records _records;
+  pvector<int> _free_records;
+  pvector<int> _dirty_records;
+  pvector<int> _large_records;
+
+  typedef pmap<NodePath, int> RecordIndex;
+  RecordIndex _record_index;
+
+  class Cell {
+  public:
+    pvector<int> _records;
+    CollideMask _mask;
+  };
+
+  // The keys pack the three cell coordinates into the low 63 bits, so they
+  // need to be mixed more thoroughly than integer_hash would.
+  class CellKeyHash {
+  public:
+    INLINE size_t operator () (const uint64_t &key) const;
+    INLINE bool operator () (const uint64_t &a, const uint64_t &b) const;
+    INLINE bool is_equal(const uint64_t &a, const uint64_t &b) const;
+  };
+  typedef SimpleHashMap<uint64_t, Cell, CellKeyHash> Cells;
+  Cells _cells;
+
+  LPoint3 _grid_min;
+  LPoint3 _grid_max;
+  bool _has_grid_bounds;
+  bool _has_ancestor_bounds;
+
+  CollideMask _from_mask;
+  PN_stdfloat _cell_size;
+  int _num_sorted;
+  unsigned int _update_seq;
+  unsigned int _query_seq;
+};
+
+INLINE std::ostream &operator << (std::ostream &out, const CollisionBroadphase &broadphase) {
+  broadphase.output(out);
+  return out;
+}
+
+#include "collisionBroadphase.I"
+
+#endif
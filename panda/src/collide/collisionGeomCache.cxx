@@ -0,0 +1,164 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file collisionGeomCache.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#include "collisionGeomCache.h"
+#include "collisionPolygon.h"
+#include "config_collide.h"
+#include "geomTriangles.h"
+#include "boundingSphere.h"
+#include "geomVertexReader.h"
+#include "lightMutexHolder.h"
+
+LightMutex CollisionGeomCache::_lock("CollisionGeomCache");
+CollisionGeomCache::Entries CollisionGeomCache::_entries;
+size_t CollisionGeomCache::_purge_size = 64;
+
+/**
+ * Returns the triangles of the indicated Geom, which must be of type
+ * PT_polygons, as stored in the cache.  The indicated vertex data must be the
+ * Geom's own vertex data; animated vertices should not be cached.
+ */
+CPT(CollisionGeomCache::Triangles) CollisionGeomCache::
+get_triangles(const Geom *geom, const GeomVertexData *data,
+              Thread *current_thread) {
+  UpdateSeq geom_modified = geom->get_modified(current_thread);
+  UpdateSeq data_modified = data->get_modified(current_thread);
+
+  {
+    LightMutexHolder holder(_lock);
+    Entries::const_iterator ei = _entries.find(geom);
+    if (ei != _entries.end()) {
+      const Entry &entry = (*ei).second;
+      if (!entry._geom.was_deleted() &&
+          entry._data == data &&
+          entry._geom_modified == geom_modified &&
+          entry._data_modified == data_modified) {
+        return entry._triangles;
+      }
+    }
+  }
+
+  // Compute the triangles without holding the lock.  Another thread may
+  // happen to be doing the same thing, in which case one of the results
+  // simply replaces the other.
+  PT(Triangles) triangles = new Triangles;
+  collect_triangles(geom, data, triangles->_vertices);
+
+  int num_triangles = (int)(triangles->_vertices.size() / 3);
+  if (collision_bvh_threshold > 0 && num_triangles >= collision_bvh_threshold) {
+    PT(CollisionBVH) bvh = new CollisionBVH;
+    PT(CollisionSolidBatch) batch = new CollisionSolidBatch;
+    const LPoint3 *v = &triangles->_vertices[0];
+    for (int i = 0; i < num_triangles; ++i, v += 3) {
+      // Use the same bounding sphere the traverser tests each triangle
+      // against, so that the hierarchy is never more selective than that.
+      BoundingSphere sphere;
+      sphere.around(v, v + 3);
+      bvh->add_item(&sphere);
+      batch->add_triangle(v[0], v[1], v[2]);
+    }
+    bvh->build();
+    triangles->_bvh = bvh;
+    triangles->_batch = batch;
+  }
+
+  LightMutexHolder holder(_lock);
+  if (_entries.size() >= _purge_size) {
+    purge();
+  }
+  Entry &entry = _entries[geom];
+  entry._geom = geom;
+  entry._data = data;
+  entry._geom_modified = geom_modified;
+  entry._data_modified = data_modified;
+  entry._triangles = triangles;
+  return triangles;
+}
+
+/**
+ * Fills the indicated vector with the vertices of the triangles of the
+ * indicated Geom, three per triangle, skipping degenerate triangles.
+ */
+void CollisionGeomCache::
+collect_triangles(const Geom *geom, const GeomVertexData *data,
+                  pvector<LPoint3> &vertices) {
+  GeomVertexReader vertex(data, InternalName::get_vertex());
+
+  int num_primitives = geom->get_num_primitives();
+  for (int i = 0; i < num_primitives; ++i) {
+    const GeomPrimitive *primitive = geom->get_primitive(i);
+    CPT(GeomPrimitive) tris = primitive->decompose();
+    nassertv(tris->is_of_type(GeomTriangles::get_class_type()));
+
+    if (tris->is_indexed()) {
+      // Indexed case.
+      GeomVertexReader index(tris->get_vertices(), 0);
+      while (!index.is_at_end()) {
+        LPoint3 v[3];
+
+        vertex.set_row_unsafe(index.get_data1i());
+        v[0] = vertex.get_data3();
+        vertex.set_row_unsafe(index.get_data1i());
+        v[1] = vertex.get_data3();
+        vertex.set_row_unsafe(index.get_data1i());
+        v[2] = vertex.get_data3();
+
+        if (CollisionPolygon::verify_points(v[0], v[1], v[2])) {
+          vertices.insert(vertices.end(), v, v + 3);
+        }
+      }
+    } else {
+      // Non-indexed case.
+      vertex.set_row_unsafe(primitive->get_first_vertex());
+      int num_vertices = primitive->get_num_vertices();
+      for (int i = 0; i < num_vertices; i += 3) {
+        LPoint3 v[3];
+
+        v[0] = vertex.get_data3();
+        v[1] = vertex.get_data3();
+        v[2] = vertex.get_data3();
+
+        if (CollisionPolygon::verify_points(v[0], v[1], v[2])) {
+          vertices.insert(vertices.end(), v, v + 3);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Empties the cache, releasing the memory used by the cached triangles.
+ */
+void CollisionGeomCache::
+clear_cache() {
+  LightMutexHolder holder(_lock);
+  _entries.clear();
+  _purge_size = 64;
+}
+
+/**
+ * Removes the entries for Geoms that have been deleted.  Assumes the lock is
+ * held.
+ */
+void CollisionGeomCache::
+purge() {
+  Entries::iterator ei = _entries.begin();
+  while (ei != _entries.end()) {
+    if ((*ei).second._geom.was_deleted()) {
+      _entries.erase(ei++);
+    } else {
+      ++ei;
+    }
+  }
+  _purge_size = std::max((size_t)64, _entries.size() * 2);
+}
@@ -0,0 +1,77 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file collisionGeomCache.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef COLLISIONGEOMCACHE_H
+#define COLLISIONGEOMCACHE_H
+
+#include "pandabase.h"
+
+#include "collisionBVH.h"
+#include "collisionSolidBatch.h"
+#include "geom.h"
+#include "geomVertexData.h"
+#include "weakPointerTo.h"
+#include "updateSeq.h"
+#include "lightMutex.h"
+#include "pmap.h"
+
+/**
+ * Remembers the triangles of each Geom that has been tested for collisions
+ * by a CollisionTraverser, along with a CollisionBVH and a
+ * CollisionSolidBatch over them if there are enough of them, so that none of
+ * this needs to be recomputed every frame.  The
+ * cached triangles are automatically recomputed whenever the Geom or its
+ * vertex data are modified.
+ *
+ * This is used only by the CollisionTraverser.
+ */
+class EXPCL_PANDA_COLLIDE CollisionGeomCache {
+public:
+  /**
+   * The triangles of a Geom, three vertices apiece, in the order in which
+   * they appear in the Geom.  Degenerate triangles are omitted.
+   */
+  class Triangles : public ReferenceCount {
+  public:
+    pvector<LPoint3> _vertices;
+    PT(CollisionBVH) _bvh;
+    PT(CollisionSolidBatch) _batch;
+  };
+
+  static CPT(Triangles) get_triangles(const Geom *geom,
+                                      const GeomVertexData *data,
+                                      Thread *current_thread);
+  static void collect_triangles(const Geom *geom, const GeomVertexData *data,
+                                pvector<LPoint3> &vertices);
+
+  static void clear_cache();
+
+private:
+  class Entry {
+  public:
+    WCPT(Geom) _geom;
+    const GeomVertexData *_data;
+    UpdateSeq _geom_modified;
+    UpdateSeq _data_modified;
+    CPT(Triangles) _triangles;
+  };
+  typedef pmap<const Geom *, Entry> Entries;
+
+  static void purge();
+
+  static LightMutex _lock;
+  static Entries _entries;
+  static size_t _purge_size;
+};
+
+#endif
@@ -29,6 +29,7 @@
 #include "boundingSphere.h"
 #include "boundingBox.h"
 #include "config_mathutil.h"
+#include "lightMutexHolder.h"
 
 TypeHandle CollisionNode::_type_handle;
 
@@ -40,7 +41,8 @@ CollisionNode::
 CollisionNode(const std::string &name) :
   PandaNode(name),
   _from_collide_mask(get_default_collide_mask()),
-  _collider_sort(0)
+  _collider_sort(0),
+  _bvh_lock("CollisionNode::_bvh_lock")
 {
   set_cull_callback();
 
@@ -59,7 +61,8 @@ CollisionNode(const CollisionNode &copy) :
   PandaNode(copy),
   _from_collide_mask(copy._from_collide_mask),
   _collider_sort(copy._collider_sort),
-  _solids(copy._solids)
+  _solids(copy._solids),
+  _bvh_lock("CollisionNode::_bvh_lock")
 {
 }
 
@@ -323,6 +326,57 @@ compute_internal_bounds(CPT(BoundingVolume) &internal_bounds,
   internal_vertices = 0;
 }
 
+/**
+ * Returns a bounding volume hierarchy over the solids of this node, for use
+ * by the CollisionTraverser.  It is built the first time it is requested,
+ * and again whenever the node's internal bounding volume has been recomputed
+ * since, which happens whenever the set of solids is changed through the
+ * CollisionNode interface, or a solid is modified via modify_solid().
+ */
+CPT(CollisionBVH) CollisionNode::
+get_bvh(Thread *current_thread) const {
+  LightMutexHolder holder(_bvh_lock);
+  update_bvh(current_thread);
+  return _bvh;
+}
+
+/**
+ * Returns a CollisionSolidBatch of the solids of this node, for use by the
+ * CollisionTraverser.  It is kept up to date in the same way as the
+ * hierarchy returned by get_bvh().
+ */
+CPT(CollisionSolidBatch) CollisionNode::
+get_solid_batch(Thread *current_thread) const {
+  LightMutexHolder holder(_bvh_lock);
+  update_bvh(current_thread);
+  return _solid_batch;
+}
+
+/**
+ * Rebuilds the hierarchy and the batch if the internal bounds have changed
+ * since they were last built.  Assumes the lock is held.
+ */
+void CollisionNode::
+update_bvh(Thread *current_thread) const {
+  CPT(BoundingVolume) bounds = get_internal_bounds(current_thread);
+  if (_bvh != nullptr && _bvh_bounds == bounds) {
+    return;
+  }
+
+  PT(CollisionBVH) bvh = new CollisionBVH;
+  PT(CollisionSolidBatch) batch = new CollisionSolidBatch;
+  Solids::const_iterator si;
+  for (si = _solids.begin(); si != _solids.end(); ++si) {
+    CPT(CollisionSolid) solid = (*si).get_read_pointer(current_thread);
+    bvh->add_item(solid->get_bounds());
+    batch->add_solid(solid);
+  }
+  bvh->build();
+  _bvh = bvh;
+  _solid_batch = batch;
+  _bvh_bounds = bounds;
+}
+
 /**
  * Returns a RenderState for rendering the ghosted collision solid that
  * represents the previous frame's position, for those collision nodes that
@@ -19,6 +19,9 @@
 #include "collisionSolid.h"
 
 #include "collideMask.h"
+#include "collisionBVH.h"
+#include "collisionSolidBatch.h"
+#include "lightMutex.h"
 #include "pandaNode.h"
 
 /**
@@ -48,6 +51,9 @@ public:
 
   virtual void output(std::ostream &out) const;
 
+  CPT(CollisionBVH) get_bvh(Thread *current_thread = Thread::get_current_thread()) const;
+  CPT(CollisionSolidBatch) get_solid_batch(Thread *current_thread = Thread::get_current_thread()) const;
+
 PUBLISHED:
   INLINE void set_collide_mask(CollideMask mask);
   void set_from_collide_mask(CollideMask mask);
@@ -86,6 +92,7 @@ protected:
 
 private:
   CPT(RenderState) get_last_pos_state();
+  void update_bvh(Thread *current_thread) const;
 
   // This data is not cycled, for now.  We assume the collision traversal will
   // take place in App only.  Perhaps we will revisit this later.
@@ -95,6 +102,14 @@ private:
   typedef pvector< COWPT(CollisionSolid) > Solids;
   Solids _solids;
 
+  // The hierarchy and batch over _solids, built on demand by get_bvh() and
+  // get_solid_batch(), and the internal bounds that were current when they
+  // were built.
+  LightMutex _bvh_lock;
+  mutable CPT(CollisionBVH) _bvh;
+  mutable CPT(CollisionSolidBatch) _solid_batch;
+  mutable CPT(BoundingVolume) _bvh_bounds;
+
   friend class CollisionTraverser;
 
 public:
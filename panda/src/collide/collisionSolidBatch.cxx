@@ -0,0 +1,353 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file collisionSolidBatch.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#include "collisionSolidBatch.h"
+#include "config_collide.h"
+#include "collisionSphere.h"
+#include "collisionPolygon.h"
+#include "geometricBoundingVolume.h"
+#include "finiteBoundingVolume.h"
+#include "boundingSphere.h"
+#include "boundingLine.h"
+
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || (_M_IX86_FP >= 2) || defined(_M_X64) || defined(_M_AMD64)
+#define HAVE_COLLISION_BATCH_SSE2 1
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#endif
+
+/**
+ *
+ */
+CollisionSolidBatch::
+CollisionSolidBatch() :
+  _extent(0.0f)
+{
+}
+
+/**
+ * Adds the indicated solid.  CollisionSpheres and CollisionPolygons are
+ * described by their actual geometry; any other kind of solid is kept in the
+ * batch, but will never be filtered out.
+ */
+void CollisionSolidBatch::
+add_solid(const CollisionSolid *solid) {
+  if (solid->is_exact_type(CollisionSphere::get_class_type())) {
+    const CollisionSphere *sphere = (const CollisionSphere *)solid;
+    add_item(sphere->get_center(), sphere->get_radius(), LVector3::zero(), 0);
+
+  } else if (solid->is_exact_type(CollisionPolygon::get_class_type()) &&
+             ((const CollisionPolygon *)solid)->get_num_points() >= 3) {
+    const CollisionPolygon *poly = (const CollisionPolygon *)solid;
+    size_t num_points = poly->get_num_points();
+
+    LPoint3 center(0, 0, 0);
+    for (size_t i = 0; i < num_points; ++i) {
+      center += poly->get_point(i);
+    }
+    center /= (PN_stdfloat)num_points;
+
+    PN_stdfloat radius_2 = 0;
+    for (size_t i = 0; i < num_points; ++i) {
+      radius_2 = std::max(radius_2, (poly->get_point(i) - center).length_squared());
+    }
+
+    LPlane plane = poly->get_plane();
+    LVector3 normal = plane.get_normal();
+    PN_stdfloat length = normal.length();
+    if (length != 0) {
+      add_item(center, csqrt(radius_2), normal / length, plane[3] / length);
+    } else {
+      add_item(center, csqrt(radius_2), LVector3::zero(), 0);
+    }
+
+  } else {
+    add_item(LPoint3::zero(), std::numeric_limits<PN_stdfloat>::infinity(),
+             LVector3::zero(), 0);
+  }
+}
+
+/**
+ * Adds a triangle, as for the triangles of a Geom.
+ */
+void CollisionSolidBatch::
+add_triangle(const LPoint3 &a, const LPoint3 &b, const LPoint3 &c) {
+  LPoint3 center = (a + b + c) / 3.0f;
+  PN_stdfloat radius_2 = std::max(std::max((a - center).length_squared(),
+                                           (b - center).length_squared()),
+                                  (c - center).length_squared());
+
+  LVector3 normal = (b - a).cross(c - a);
+  PN_stdfloat length = normal.length();
+  if (length != 0) {
+    normal /= length;
+    add_item(center, csqrt(radius_2), normal, -normal.dot(a));
+  } else {
+    add_item(center, csqrt(radius_2), LVector3::zero(), 0);
+  }
+}
+
+/**
+ * Removes from the indicated list of item indices, which should be in
+ * increasing order, any item that the indicated bounding volume cannot
+ * possibly intersect.  The order of the remaining indices is preserved.  If
+ * the volume is neither a line nor a finite volume, nothing is removed.
+ *
+ * This uses SSE2 instructions to test four items at once, if they are
+ * available, unless collision-solid-batch-simd has been turned off.
+ */
+void CollisionSolidBatch::
+filter(const GeometricBoundingVolume *volume, pvector<int> &indices) const {
+#ifdef HAVE_COLLISION_BATCH_SSE2
+  if (!collision_solid_batch_simd) {
+    filter_scalar(volume, indices);
+    return;
+  }
+
+  Query query;
+  if (!make_query(volume, query)) {
+    return;
+  }
+
+  const Item *items = &_items[0];
+  size_t num_indices = indices.size();
+  int *index = indices.empty() ? nullptr : &indices[0];
+  int num_kept = 0;
+  size_t i = 0;
+
+  __m128 eps = _mm_set1_ps(query._epsilon);
+  __m128 qx = _mm_set1_ps(query._point[0]);
+  __m128 qy = _mm_set1_ps(query._point[1]);
+  __m128 qz = _mm_set1_ps(query._point[2]);
+  __m128 qr = _mm_set1_ps(query._point[3]);
+  __m128 dx = _mm_set1_ps(query._direction[0]);
+  __m128 dy = _mm_set1_ps(query._direction[1]);
+  __m128 dz = _mm_set1_ps(query._direction[2]);
+  __m128 sign_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+  for (; i + 4 <= num_indices; i += 4) {
+    // Load the spheres and planes of the next four items, and transpose them
+    // so that each register holds one component of all four.
+    __m128 cx = _mm_loadu_ps(items[index[i]]._sphere);
+    __m128 cy = _mm_loadu_ps(items[index[i + 1]]._sphere);
+    __m128 cz = _mm_loadu_ps(items[index[i + 2]]._sphere);
+    __m128 cr = _mm_loadu_ps(items[index[i + 3]]._sphere);
+    _MM_TRANSPOSE4_PS(cx, cy, cz, cr);
+
+    __m128 wx = _mm_sub_ps(cx, qx);
+    __m128 wy = _mm_sub_ps(cy, qy);
+    __m128 wz = _mm_sub_ps(cz, qz);
+    __m128 w2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(wx, wx), _mm_mul_ps(wy, wy)),
+                           _mm_mul_ps(wz, wz));
+    __m128 pass;
+
+    if (query._is_line) {
+      // The squared distance from the item's center to the line must not
+      // exceed its squared radius.
+      __m128 t = _mm_add_ps(_mm_add_ps(_mm_mul_ps(wx, dx), _mm_mul_ps(wy, dy)),
+                            _mm_mul_ps(wz, dz));
+      __m128 dist2 = _mm_sub_ps(w2, _mm_mul_ps(t, t));
+      __m128 reach = _mm_add_ps(cr, eps);
+      __m128 limit = _mm_add_ps(_mm_mul_ps(reach, reach),
+                                _mm_mul_ps(w2, _mm_set1_ps(1.0e-6f)));
+      pass = _mm_cmple_ps(dist2, limit);
+
+    } else {
+      // The spheres must overlap...
+      __m128 reach = _mm_add_ps(_mm_add_ps(cr, qr), eps);
+      pass = _mm_cmple_ps(w2, _mm_mul_ps(reach, reach));
+
+      // ...and the query sphere must reach the item's plane.
+      __m128 nx = _mm_loadu_ps(items[index[i]]._plane);
+      __m128 ny = _mm_loadu_ps(items[index[i + 1]]._plane);
+      __m128 nz = _mm_loadu_ps(items[index[i + 2]]._plane);
+      __m128 nd = _mm_loadu_ps(items[index[i + 3]]._plane);
+      _MM_TRANSPOSE4_PS(nx, ny, nz, nd);
+
+      __m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, qx), _mm_mul_ps(ny, qy)),
+                               _mm_add_ps(_mm_mul_ps(nz, qz), nd));
+      dist = _mm_and_ps(dist, sign_mask);
+      pass = _mm_and_ps(pass, _mm_cmple_ps(dist, _mm_add_ps(qr, eps)));
+    }
+
+    int mask = _mm_movemask_ps(pass);
+    if (mask == 0xf) {
+      index[num_kept++] = index[i];
+      index[num_kept++] = index[i + 1];
+      index[num_kept++] = index[i + 2];
+      index[num_kept++] = index[i + 3];
+    } else {
+      for (int j = 0; j < 4; ++j) {
+        if (mask & (1 << j)) {
+          index[num_kept++] = index[i + j];
+        }
+      }
+    }
+  }
+
+  num_kept = filter_range_scalar(query, indices, i, num_kept);
+  indices.resize(num_kept);
+
+#else
+  filter_scalar(volume, indices);
+#endif  // HAVE_COLLISION_BATCH_SSE2
+}
+
+/**
+ * Does the same thing as filter(), but tests one item at a time.  This is
+ * used when SIMD instructions are not available.
+ */
+void CollisionSolidBatch::
+filter_scalar(const GeometricBoundingVolume *volume,
+              pvector<int> &indices) const {
+  Query query;
+  if (make_query(volume, query)) {
+    int num_kept = filter_range_scalar(query, indices, 0, 0);
+    indices.resize(num_kept);
+  }
+}
+
+/**
+ * Returns true if the filter() is implemented with SIMD instructions on this
+ * platform, or false if it falls back to filter_scalar().
+ */
+bool CollisionSolidBatch::
+has_simd() {
+#ifdef HAVE_COLLISION_BATCH_SSE2
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+ * Appends a new item with the indicated bounding sphere and plane.
+ */
+void CollisionSolidBatch::
+add_item(const LPoint3 &center, PN_stdfloat radius,
+         const LVector3 &normal, PN_stdfloat d) {
+  Item item;
+  item._sphere[0] = (float)center[0];
+  item._sphere[1] = (float)center[1];
+  item._sphere[2] = (float)center[2];
+  item._sphere[3] = (float)radius;
+  item._plane[0] = (float)normal[0];
+  item._plane[1] = (float)normal[1];
+  item._plane[2] = (float)normal[2];
+  item._plane[3] = (float)d;
+  _items.push_back(item);
+
+  if (radius < std::numeric_limits<PN_stdfloat>::infinity()) {
+    _extent = std::max(_extent, (float)(std::max(std::max(cabs(center[0]), cabs(center[1])), cabs(center[2])) + radius));
+  }
+}
+
+/**
+ * Reduces the indicated bounding volume to a sphere or a line.  Returns false
+ * if this is not possible.
+ */
+bool CollisionSolidBatch::
+make_query(const GeometricBoundingVolume *volume, Query &query) const {
+  if (volume == nullptr || volume->is_empty() || volume->is_infinite()) {
+    return false;
+  }
+
+  LPoint3 point;
+  LVector3 direction(0, 0, 0);
+  PN_stdfloat radius = 0;
+
+  const BoundingSphere *sphere = volume->as_bounding_sphere();
+  const FiniteBoundingVolume *fbv = volume->as_finite_bounding_volume();
+  const BoundingLine *line = volume->as_bounding_line();
+  if (sphere != nullptr) {
+    point = sphere->get_center();
+    radius = sphere->get_radius();
+    query._is_line = false;
+
+  } else if (fbv != nullptr) {
+    // Any other finite volume is replaced by the sphere around its box.
+    LPoint3 min_point = fbv->get_min();
+    LPoint3 max_point = fbv->get_max();
+    point = (min_point + max_point) * 0.5f;
+    radius = (max_point - min_point).length() * 0.5f;
+    query._is_line = false;
+
+  } else if (line != nullptr) {
+    point = line->get_point_a();
+    direction = line->get_point_b() - point;
+    if (!direction.normalize()) {
+      return false;
+    }
+    query._is_line = true;
+
+  } else {
+    return false;
+  }
+
+  for (int i = 0; i < 3; ++i) {
+    query._point[i] = (float)point[i];
+    query._direction[i] = (float)direction[i];
+  }
+  query._point[3] = (float)radius;
+  query._direction[3] = 0.0f;
+
+  // Allow for the roundoff error of single-precision arithmetic at the scale
+  // of the coordinates involved.
+  float scale = std::max(_extent, (float)(std::max(std::max(cabs(point[0]), cabs(point[1])), cabs(point[2])) + radius));
+  query._epsilon = scale * 1.0e-5f;
+  return true;
+}
+
+/**
+ * Tests the indices from begin onward, one at a time, moving the ones that
+ * pass down to follow the first num_kept indices.  Returns the new number of
+ * indices kept.
+ */
+int CollisionSolidBatch::
+filter_range_scalar(const Query &query, pvector<int> &indices,
+                    size_t begin, int num_kept) const {
+  float eps = query._epsilon;
+  const float *q = query._point;
+  const float *d = query._direction;
+
+  size_t num_indices = indices.size();
+  for (size_t i = begin; i < num_indices; ++i) {
+    const Item &item = _items[indices[i]];
+    const float *c = item._sphere;
+    float wx = c[0] - q[0];
+    float wy = c[1] - q[1];
+    float wz = c[2] - q[2];
+    float w2 = wx * wx + wy * wy + wz * wz;
+
+    bool pass;
+    if (query._is_line) {
+      float t = wx * d[0] + wy * d[1] + wz * d[2];
+      float reach = c[3] + eps;
+      pass = (w2 - t * t <= reach * reach + w2 * 1.0e-6f);
+
+    } else {
+      const float *n = item._plane;
+      float reach = c[3] + q[3] + eps;
+      float dist = n[0] * q[0] + n[1] * q[1] + n[2] * q[2] + n[3];
+      pass = (w2 <= reach * reach) && (std::fabs(dist) <= q[3] + eps);
+    }
+
+    if (pass) {
+      indices[num_kept++] = indices[i];
+    }
+  }
+  return num_kept;
+}
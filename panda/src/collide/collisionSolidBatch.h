@@ -0,0 +1,86 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file collisionSolidBatch.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef COLLISIONSOLIDBATCH_H
+#define COLLISIONSOLIDBATCH_H
+
+#include "pandabase.h"
+
+#include "referenceCount.h"
+#include "luse.h"
+#include "pvector.h"
+
+class CollisionSolid;
+class GeometricBoundingVolume;
+
+/**
+ * A compact copy of the spheres, polygons or triangles of a CollisionNode or
+ * Geom, arranged so that a collider's bounding volume can be tested against
+ * four of them at once.  The CollisionTraverser uses this to discard most of
+ * the solids that a collider cannot possibly reach, before it makes the full
+ * intersection test against the remaining ones.
+ *
+ * The test is conservative: it considers only the bounding sphere of each
+ * item, and, for polygons and triangles, the item's plane.  Solids of other
+ * types are never discarded.
+ */
+class EXPCL_PANDA_COLLIDE CollisionSolidBatch : public ReferenceCount {
+public:
+  CollisionSolidBatch();
+
+  void add_solid(const CollisionSolid *solid);
+  void add_triangle(const LPoint3 &a, const LPoint3 &b, const LPoint3 &c);
+
+  INLINE int get_num_items() const;
+
+  void filter(const GeometricBoundingVolume *volume,
+              pvector<int> &indices) const;
+  void filter_scalar(const GeometricBoundingVolume *volume,
+                     pvector<int> &indices) const;
+
+  static bool has_simd();
+
+private:
+  // The collider's bounding volume, reduced to either a sphere or a line.
+  class Query {
+  public:
+    bool _is_line;
+    float _point[4];
+    float _direction[4];
+    float _epsilon;
+  };
+
+  void add_item(const LPoint3 &center, PN_stdfloat radius,
+                const LVector3 &normal, PN_stdfloat d);
+  bool make_query(const GeometricBoundingVolume *volume, Query &query) const;
+  int filter_range_scalar(const Query &query, pvector<int> &indices,
+                          size_t begin, int num_kept) const;
+
+  // Each item occupies eight floats: the center and radius of its bounding
+  // sphere, followed by the coefficients of its plane.  The plane of an item
+  // that has none is all zeroes, which never excludes anything.
+  class Item {
+  public:
+    float _sphere[4];
+    float _plane[4];
+  };
+  typedef pvector<Item> Items;
+  Items _items;
+
+  // The largest coordinate or radius seen, used to scale the tolerance.
+  float _extent;
+};
+
+#include "collisionSolidBatch.I"
+
+#endif
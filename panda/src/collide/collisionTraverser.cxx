@@ -16,6 +16,9 @@
 #include "collisionEntry.h"
 #include "collisionPolygon.h"
 #include "collisionGeom.h"
+#include "collisionGeomCache.h"
+#include "collisionBVH.h"
+#include "collisionSolidBatch.h"
 #include "collisionRecorder.h"
 #include "collisionVisualizer.h"
 #include "collisionSphere.h"
@@ -34,6 +37,7 @@
 #include "lodNode.h"
 #include "nodePath.h"
 #include "pStatTimer.h"
+#include "jobPool.h"
 #include "indent.h"
 
 #include <algorithm>
@@ -46,6 +50,10 @@ PStatCollector CollisionTraverser::_cnode_volume_pcollector("Collision Volumes:C
 PStatCollector CollisionTraverser::_gnode_volume_pcollector("Collision Volumes:GeomNode");
 PStatCollector CollisionTraverser::_geom_volume_pcollector("Collision Volumes:Geom");
 
+PStatCollector CollisionTraverser::_parallel_job_pcollector("App:Collisions:Parallel:Job");
+PStatCollector CollisionTraverser::_parallel_merge_pcollector("App:Collisions:Parallel:Merge");
+PStatCollector CollisionTraverser::_broadphase_pcollector("App:Collisions:Broadphase");
+
 TypeHandle CollisionTraverser::_type_handle;
 
 // This function object class is used in prepare_colliders(), below.
@@ -74,6 +82,9 @@ CollisionTraverser(const std::string &name) :
   _this_pcollector(_collisions_pcollector, name)
 {
   _respect_prev_transform = respect_prev_transform;
+  _parallel = parallel_collision_traversal;
+  _use_broadphase = collision_broadphase;
+  _test_counts = nullptr;
   #ifdef DO_COLLISION_RECORDING
   _recorder = nullptr;
   #endif
@@ -272,8 +283,17 @@ traverse(const NodePath &root) {
   }
 
   bool traversal_done = false;
-  if ((int)_colliders.size() <= CollisionLevelStateSingle::get_max_colliders() ||
-      !allow_collider_multiple) {
+  if (_use_broadphase) {
+    traversal_done = traverse_broadphase(root);
+  }
+
+  if (!traversal_done && _parallel) {
+    traversal_done = traverse_parallel(root);
+  }
+
+  if (!traversal_done &&
+      ((int)_colliders.size() <= CollisionLevelStateSingle::get_max_colliders() ||
+       !allow_collider_multiple)) {
     // Use the single-word-at-a-time traverser, which might need to make lots
     // of passes.
     LevelStatesSingle level_states;
@@ -562,7 +582,10 @@ prepare_colliders_single(CollisionTraverser::LevelStatesSingle &level_states,
  */
 void CollisionTraverser::
 r_traverse_single(CollisionLevelStateSingle &level_state, size_t pass) {
-  if (!level_state.any_in_bounds()) {
+  int num_volume_tests = 0;
+  bool any_in_bounds = level_state.any_in_bounds(num_volume_tests);
+  count_tests(CollisionLevelStateBase::_node_volume_pcollector, num_volume_tests);
+  if (!any_in_bounds) {
     return;
   }
   if (!level_state.apply_transform()) {
@@ -773,7 +796,10 @@ prepare_colliders_double(CollisionTraverser::LevelStatesDouble &level_states,
  */
 void CollisionTraverser::
 r_traverse_double(CollisionLevelStateDouble &level_state, size_t pass) {
-  if (!level_state.any_in_bounds()) {
+  int num_volume_tests = 0;
+  bool any_in_bounds = level_state.any_in_bounds(num_volume_tests);
+  count_tests(CollisionLevelStateBase::_node_volume_pcollector, num_volume_tests);
+  if (!any_in_bounds) {
     return;
   }
   if (!level_state.apply_transform()) {
@@ -984,7 +1010,10 @@ prepare_colliders_quad(CollisionTraverser::LevelStatesQuad &level_states,
  */
 void CollisionTraverser::
 r_traverse_quad(CollisionLevelStateQuad &level_state, size_t pass) {
-  if (!level_state.any_in_bounds()) {
+  int num_volume_tests = 0;
+  bool any_in_bounds = level_state.any_in_bounds(num_volume_tests);
+  count_tests(CollisionLevelStateBase::_node_volume_pcollector, num_volume_tests);
+  if (!any_in_bounds) {
     return;
   }
   if (!level_state.apply_transform()) {
@@ -1114,6 +1143,496 @@ r_traverse_quad(CollisionLevelStateQuad &level_state, size_t pass) {
   }
 }
 
+/**
+ * Stands in for one of the traverser's handlers while a group of colliders
+ * is being traversed by a ParallelJob.  Rather than passing the detected
+ * collisions on to the real handler, it gives them to the job, which holds
+ * them until all of the jobs have finished.
+ */
+class CollisionTraverser::ParallelHandler : public CollisionHandler {
+public:
+  ParallelHandler(ParallelJob *job, CollisionHandler *handler);
+
+  virtual void add_entry(CollisionEntry *entry);
+
+private:
+  ParallelJob *_job;
+  CollisionHandler *_handler;
+};
+
+/**
+ * Traverses the scene graph for one group of colliders, in whichever thread
+ * picks it up, and records the collisions it detects along with enough
+ * information to put them back into serial order afterwards.
+ */
+class CollisionTraverser::ParallelJob : public JobPool::Job {
+public:
+  typedef pvector<CollisionLevelStateBase::ColliderDef> ColliderDefs;
+
+  ParallelJob(const CollisionTraverser &trav, const NodePath &root,
+              const ColliderDefs &defs, int begin, int end, int pass_size);
+
+  virtual void do_job(Thread *current_thread);
+
+  void record_entry(CollisionEntry *entry, CollisionHandler *handler);
+
+  class Entry {
+  public:
+    PT(CollisionEntry) _entry;
+    CollisionHandler *_handler;
+
+    // The pass in which a serial traversal would have detected this, the
+    // path of child indices leading to the into node, and the index of the
+    // from solid in the sorted list of colliders.
+    int _pass;
+    const pvector<int> *_path;
+    int _index;
+  };
+  typedef pvector<Entry> Entries;
+  Entries _entries;
+  TestCounts _test_counts;
+
+  // Orders Entry pointers the way a serial traversal would have reported
+  // them.
+  class CompareEntries {
+  public:
+    bool operator () (const Entry *a, const Entry *b) const;
+  };
+
+private:
+  CollisionTraverser _trav;
+  CollisionLevelStateSingle _level_state;
+  const ColliderDefs &_defs;
+  int _begin;
+  int _end;
+  int _pass_size;
+
+  // A pdeque, so that the Entries may keep pointers into it.
+  typedef pdeque<pvector<int> > Paths;
+  Paths _paths;
+  NodePath _last_into_node_path;
+};
+
+/**
+ *
+ */
+CollisionTraverser::ParallelHandler::
+ParallelHandler(ParallelJob *job, CollisionHandler *handler) :
+  _job(job),
+  _handler(handler)
+{
+  _wants_all_potential_collidees = handler->wants_all_potential_collidees();
+}
+
+/**
+ *
+ */
+void CollisionTraverser::ParallelHandler::
+add_entry(CollisionEntry *entry) {
+  _job->record_entry(entry, _handler);
+}
+
+/**
+ *
+ */
+bool CollisionTraverser::ParallelJob::CompareEntries::
+operator () (const Entry *a, const Entry *b) const {
+  if (a->_pass != b->_pass) {
+    return a->_pass < b->_pass;
+  }
+  if (a->_path != b->_path && *a->_path != *b->_path) {
+    // Lexicographic order of the child indices is the order in which the
+    // nodes are visited, since a node is visited before its children.
+    return std::lexicographical_compare(a->_path->begin(), a->_path->end(),
+                                        b->_path->begin(), b->_path->end());
+  }
+  return a->_index < b->_index;
+}
+
+/**
+ * Prepares a job to traverse the scene graph for the colliders begin through
+ * end of the indicated list, which must not exceed the number of colliders
+ * that fit in a CollisionLevelStateSingle.
+ */
+CollisionTraverser::ParallelJob::
+ParallelJob(const CollisionTraverser &trav, const NodePath &root,
+            const ColliderDefs &defs, int begin, int end, int pass_size) :
+  _trav(trav.get_name()),
+  _level_state(root),
+  _defs(defs),
+  _begin(begin),
+  _end(end),
+  _pass_size(pass_size)
+{
+  _trav._respect_prev_transform = trav._respect_prev_transform;
+  _trav._parallel = false;
+  _trav._test_counts = &_test_counts;
+
+  // Our private traverser maps each of our colliders to a ParallelHandler
+  // that stands in for the real handler.
+  typedef pmap<CollisionHandler *, PT(CollisionHandler) > Proxies;
+  Proxies proxies;
+
+  _level_state.reserve(end - begin);
+  for (int i = begin; i < end; ++i) {
+    const CollisionLevelStateBase::ColliderDef &def = defs[i];
+    _level_state.prepare_collider(def, root);
+
+    Colliders::const_iterator ci = trav._colliders.find(def._node_path);
+    nassertd(ci != trav._colliders.end()) continue;
+
+    CollisionHandler *handler = (*ci).second;
+    Proxies::iterator pi = proxies.find(handler);
+    if (pi == proxies.end()) {
+      PT(CollisionHandler) proxy = new ParallelHandler(this, handler);
+      pi = proxies.insert(Proxies::value_type(handler, proxy)).first;
+    }
+    _trav._colliders[def._node_path] = (*pi).second;
+  }
+}
+
+/**
+ *
+ */
+void CollisionTraverser::ParallelJob::
+do_job(Thread *current_thread) {
+  PStatTimer timer(_parallel_job_pcollector, current_thread);
+  _trav.r_traverse_single(_level_state, 0);
+}
+
+/**
+ * Called by a ParallelHandler to save a detected collision until it can be
+ * passed to the real handler.
+ */
+void CollisionTraverser::ParallelJob::
+record_entry(CollisionEntry *entry, CollisionHandler *handler) {
+  int index = _begin;
+  while (index < _end &&
+         (_defs[index]._collider != entry->get_from() ||
+          _defs[index]._node_path != entry->get_from_node_path())) {
+    ++index;
+  }
+  nassertv(index < _end);
+
+  // Collisions with the same into node are usually reported together, so we
+  // only need to work out the path when the into node changes.
+  NodePath into_node_path = entry->get_into_node_path();
+  if (_paths.empty() || into_node_path != _last_into_node_path) {
+    _last_into_node_path = into_node_path;
+    _paths.push_back(pvector<int>());
+    pvector<int> &path = _paths.back();
+
+    NodePath np = into_node_path;
+    while (np.has_parent()) {
+      NodePath parent = np.get_parent();
+      path.push_back(parent.node()->find_child(np.node()));
+      np = parent;
+    }
+    std::reverse(path.begin(), path.end());
+  }
+
+  Entry rec;
+  rec._entry = entry;
+  rec._handler = handler;
+  rec._pass = index / _pass_size;
+  rec._path = &_paths.back();
+  rec._index = index;
+  _entries.push_back(rec);
+}
+
+/**
+ * Performs the traversal by dividing the colliders into several groups, each
+ * of which is traversed by a separate job on the global JobPool.  The
+ * detected collisions are passed to the handlers afterwards, in the order in
+ * which the serial traversal would have detected them.
+ *
+ * Returns true if the traversal was performed, or false if it is not
+ * appropriate to do it in parallel, in which case nothing has been done.
+ */
+bool CollisionTraverser::
+traverse_parallel(const NodePath &root) {
+#ifdef DO_COLLISION_RECORDING
+  if (has_recorder()) {
+    // The recorder wants to hear about the tests as they are made.
+    return false;
+  }
+#endif  // DO_COLLISION_RECORDING
+
+  JobPool *pool = JobPool::get_global_ptr();
+  if (pool->get_num_threads() == 0) {
+    return false;
+  }
+
+  // Gather up the solids of all of the colliders, in the same sorted order
+  // used by prepare_colliders_single() and friends.
+  int num_colliders = _colliders.size();
+  int *indirect = (int *)alloca(sizeof(int) * num_colliders);
+  int i;
+  for (i = 0; i < num_colliders; ++i) {
+    indirect[i] = i;
+  }
+  std::sort(indirect, indirect + num_colliders, SortByColliderSort(*this));
+
+  ParallelJob::ColliderDefs defs;
+  defs.reserve(num_colliders);
+  for (i = 0; i < num_colliders; ++i) {
+    OrderedColliderDef &ocd = _ordered_colliders[indirect[i]];
+    NodePath cnode_path = ocd._node_path;
+
+    if (!cnode_path.is_same_graph(root)) {
+      if (ocd._in_graph) {
+        // Only report this warning once.
+        collide_cat.info()
+          << "Collider " << cnode_path
+          << " is not in scene graph.  Ignoring.\n";
+        ocd._in_graph = false;
+      }
+
+    } else {
+      ocd._in_graph = true;
+      CollisionNode *cnode = DCAST(CollisionNode, cnode_path.node());
+
+      CollisionLevelStateBase::ColliderDef def;
+      def._node = cnode;
+      def._node_path = cnode_path;
+
+      int num_solids = cnode->get_num_solids();
+      for (int s = 0; s < num_solids; ++s) {
+        def._collider = cnode->get_solid(s);
+        defs.push_back(def);
+      }
+    }
+  }
+
+  int num_solids = (int)defs.size();
+  if (num_solids < 2) {
+    return false;
+  }
+
+  // The serial traversal reports its collisions pass by pass, so we need to
+  // know how it would have divided the colliders into passes.
+  int pass_size = get_pass_size(num_colliders, num_solids);
+
+  // Make at least one job for each thread, including this one, but no job
+  // may have more colliders than fit in a single word.
+  int max_colliders = CollisionLevelStateSingle::get_max_colliders();
+  int num_jobs = std::max((num_solids + max_colliders - 1) / max_colliders,
+                          std::min(num_solids, pool->get_num_threads() + 1));
+
+  pvector<ParallelJob *> jobs;
+  jobs.reserve(num_jobs);
+  {
+    JobPool::Batch batch(pool);
+    for (int j = 0; j < num_jobs; ++j) {
+      int begin = num_solids * j / num_jobs;
+      int end = num_solids * (j + 1) / num_jobs;
+      ParallelJob *job = new ParallelJob(*this, root, defs, begin, end, pass_size);
+      jobs.push_back(job);
+      batch.add_job(job);
+    }
+    batch.wait();
+  }
+
+  {
+    PStatTimer timer(_parallel_merge_pcollector);
+
+    // Put the collisions back into serial order.  Within one job, they were
+    // already recorded in the right order, which the stable sort preserves.
+    pvector<const ParallelJob::Entry *> entries;
+    for (ParallelJob *job : jobs) {
+      for (const ParallelJob::Entry &entry : job->_entries) {
+        entries.push_back(&entry);
+      }
+    }
+    std::stable_sort(entries.begin(), entries.end(), ParallelJob::CompareEntries());
+
+    for (const ParallelJob::Entry *entry : entries) {
+      entry->_handler->add_entry(entry->_entry);
+    }
+
+    // The jobs could not add their tests to the collectors themselves.
+    for (ParallelJob *job : jobs) {
+      for (const auto &item : job->_test_counts) {
+        item.first->add_level(item.second);
+      }
+    }
+  }
+
+  for (ParallelJob *job : jobs) {
+    delete job;
+  }
+  return true;
+}
+
+/**
+ * Performs the traversal by using the spatial hash kept in _broadphase to
+ * find the nodes that each collider might reach, rather than by comparing
+ * each collider against each node of the scene graph.  The same tests are
+ * made of the nodes that are found, and the collisions are reported to the
+ * handlers in the same order as traverse() would otherwise report them.
+ *
+ * Returns true if the traversal was performed, or false if it is not
+ * appropriate to use the broadphase, in which case nothing has been reported
+ * to the handlers.  This is the case when a CollisionRecorder is in use, or
+ * when some of the nodes have bounding volumes set by set_bounds().
+ */
+bool CollisionTraverser::
+traverse_broadphase(const NodePath &root) {
+#ifdef DO_COLLISION_RECORDING
+  if (has_recorder()) {
+    // The recorder wants to see each node that the traversal visits.
+    return false;
+  }
+#endif  // DO_COLLISION_RECORDING
+
+  Thread *current_thread = Thread::get_current_thread();
+
+  LevelStatesQuad level_states;
+  prepare_colliders_quad(level_states, root);
+
+  int num_solids = 0;
+  CollideMask from_mask;
+  for (const CollisionLevelStateQuad &level_state : level_states) {
+    int num_colliders = level_state.get_num_colliders();
+    num_solids += num_colliders;
+    for (int c = 0; c < num_colliders; ++c) {
+      from_mask |= level_state.get_collider_node(c)->get_from_collide_mask();
+    }
+  }
+  if (num_solids == 0) {
+    return false;
+  }
+
+  // The serial traversal reports its collisions pass by pass, so we need to
+  // know how it would have divided the colliders into passes.
+  int pass_size = get_pass_size((int)_colliders.size(), num_solids);
+  int state_size = CollisionLevelStateQuad::get_max_colliders();
+
+  BroadphasePairs pairs;
+  {
+    PStatTimer timer(_broadphase_pcollector);
+    if (_broadphase == nullptr) {
+      _broadphase = new CollisionBroadphase;
+    }
+    _broadphase->update(root, from_mask, current_thread);
+    if (_broadphase->has_ancestor_bounds()) {
+      return false;
+    }
+
+    int root_depth = root.get_num_nodes();
+    pvector<int> candidates;
+    for (size_t s = 0; s < level_states.size(); ++s) {
+      const CollisionLevelStateQuad &level_state = level_states[s];
+      int num_colliders = level_state.get_num_colliders();
+      for (int c = 0; c < num_colliders; ++c) {
+        CollisionNode *cnode = level_state.get_collider_node(c);
+        _broadphase->find_candidates(level_state.get_local_bound(c),
+                                     cnode->get_from_collide_mask(),
+                                     candidates);
+
+        BroadphasePair pair;
+        pair._pass = ((int)s * state_size + c) / pass_size;
+        pair._state = (int)s;
+        pair._collider = c;
+        for (int index : candidates) {
+          const CollisionBroadphase::Record &record = _broadphase->get_record(index);
+
+          // Don't test a node with itself, or with any of its descendants.
+          bool is_own = false;
+          NodePath np = record._node_path;
+          while (!is_own && np.get_num_nodes() >= root_depth) {
+            is_own = (np.node() == cnode);
+            np = np.get_parent();
+          }
+
+          if (!is_own) {
+            pair._sort = record._sort;
+            pair._record = index;
+            pairs.push_back(pair);
+          }
+        }
+      }
+    }
+    std::sort(pairs.begin(), pairs.end());
+  }
+
+  for (const BroadphasePair &pair : pairs) {
+    const CollisionLevelStateQuad &level_state = level_states[pair._state];
+    const CollisionBroadphase::Record &record = _broadphase->get_record(pair._record);
+    PandaNode *node = record._node_path.node();
+
+    // Convert the collider's bounding volume into the spaces of the node and
+    // of its parent, just as the serial traversal would have as it descended
+    // the graph.
+    const GeometricBoundingVolume *from_gbv = level_state.get_local_bound(pair._collider);
+    PT(GeometricBoundingVolume) from_parent_gbv;
+    PT(GeometricBoundingVolume) from_node_gbv;
+    if (from_gbv != nullptr) {
+      if (record._final_bounds != nullptr) {
+        // The node is below a node with the final flag, so only the bounds
+        // of that node matter.
+        const GeometricBoundingVolume *final_gbv =
+          record._final_bounds->as_geometric_bounding_volume();
+        if (final_gbv != nullptr) {
+          PT(GeometricBoundingVolume) gbv = DCAST(GeometricBoundingVolume, from_gbv->make_copy());
+          gbv->xform(record._final_parent_inv_mat);
+          if (final_gbv->contains(gbv) == 0) {
+            continue;
+          }
+        }
+      }
+      if (record._has_parent_bounds) {
+        from_parent_gbv = DCAST(GeometricBoundingVolume, from_gbv->make_copy());
+        from_parent_gbv->xform(record._parent_inv_mat);
+      }
+      if (record._has_local_bounds) {
+        from_node_gbv = DCAST(GeometricBoundingVolume, from_gbv->make_copy());
+        from_node_gbv->xform(record._inv_mat);
+      }
+    }
+
+    CPT(BoundingVolume) node_bv = node->get_bounds(current_thread);
+    const GeometricBoundingVolume *node_gbv = node_bv->as_geometric_bounding_volume();
+
+    CollisionEntry entry;
+    entry._into_node = node;
+    entry._into_node_path = record._node_path;
+    if (_respect_prev_transform) {
+      entry._flags |= CollisionEntry::F_respect_prev_transform;
+    }
+    entry._from_node = level_state.get_collider_node(pair._collider);
+    entry._from_node_path = level_state.get_collider_node_path(pair._collider);
+    entry._from = level_state.get_collider(pair._collider);
+
+    if (node->is_collision_node()) {
+      compare_collider_to_node(entry, from_parent_gbv, from_node_gbv, node_gbv);
+    } else {
+      compare_collider_to_geom_node(entry, from_parent_gbv, from_node_gbv, node_gbv);
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Returns the number of collision solids that the serial traversal tests in
+ * each pass, given the number of colliders and the total number of solids
+ * among them.  This mirrors the choice made in traverse().
+ */
+int CollisionTraverser::
+get_pass_size(int num_colliders, int num_solids) {
+  if (!allow_collider_multiple ||
+      (num_colliders <= CollisionLevelStateSingle::get_max_colliders() &&
+       num_solids <= CollisionLevelStateSingle::get_max_colliders())) {
+    return CollisionLevelStateSingle::get_max_colliders();
+  } else if (num_colliders <= CollisionLevelStateDouble::get_max_colliders() &&
+             num_solids <= CollisionLevelStateDouble::get_max_colliders()) {
+    return CollisionLevelStateDouble::get_max_colliders();
+  } else {
+    return CollisionLevelStateQuad::get_max_colliders();
+  }
+}
+
 /**
  *
  */
@@ -1126,7 +1645,7 @@ compare_collider_to_node(CollisionEntry &entry,
   if (from_parent_gbv != nullptr &&
       into_node_gbv != nullptr) {
     within_node_bounds = (into_node_gbv->contains(from_parent_gbv) != 0);
-    _cnode_volume_pcollector.add_level(1);
+    count_tests(_cnode_volume_pcollector);
   }
 
   if (within_node_bounds) {
@@ -1152,6 +1671,35 @@ compare_collider_to_node(CollisionEntry &entry,
       ci = _colliders.find(entry.get_from_node_path());
       nassertv(ci != _colliders.end());
       entry.test_intersection((*ci).second, this);
+
+    } else if (collision_bvh_threshold > 0 &&
+               num_solids >= collision_bvh_threshold &&
+               from_node_gbv != nullptr &&
+               !get_handler(entry.get_from_node_path())->wants_all_potential_collidees()) {
+      // There are enough solids that it pays to consult the node's bounding
+      // volume hierarchy for the solids that might be within reach.  The
+      // candidates are visited in the same order as the loop below would.
+      CPT(CollisionBVH) bvh = cnode->get_bvh(current_thread);
+      pvector<int> candidates;
+      bvh->find_candidates(from_node_gbv, candidates);
+      if (collision_solid_batch) {
+        cnode->get_solid_batch(current_thread)->filter(from_node_gbv, candidates);
+      }
+
+      pvector<int>::const_iterator ii;
+      for (ii = candidates.begin(); ii != candidates.end(); ++ii) {
+        nassertv(*ii < num_solids);
+        entry._into = cnode->_solids[*ii].get_read_pointer(current_thread);
+
+        CPT(BoundingVolume) solid_bv = entry._into->get_bounds();
+        const GeometricBoundingVolume *solid_gbv = nullptr;
+        if (solid_bv->is_of_type(GeometricBoundingVolume::get_class_type())) {
+          solid_gbv = (const GeometricBoundingVolume *)solid_bv.p();
+        }
+
+        compare_collider_to_solid(entry, from_node_gbv, solid_gbv);
+      }
+
     } else {
       CollisionNode::Solids::const_iterator si;
       for (si = cnode->_solids.begin(); si != cnode->_solids.end(); ++si) {
@@ -1185,7 +1733,7 @@ compare_collider_to_geom_node(CollisionEntry &entry,
   if (from_parent_gbv != nullptr &&
       into_node_gbv != nullptr) {
     within_node_bounds = (into_node_gbv->contains(from_parent_gbv) != 0);
-    _gnode_volume_pcollector.add_level(1);
+    count_tests(_gnode_volume_pcollector);
   }
 
   if (within_node_bounds) {
@@ -1226,7 +1774,7 @@ compare_collider_to_solid(CollisionEntry &entry,
       solid_gbv != nullptr) {
     within_solid_bounds = (solid_gbv->contains(from_node_gbv) != 0);
     #ifdef DO_PSTATS
-    ((CollisionSolid *)entry.get_into())->get_volume_pcollector().add_level(1);
+    count_tests(((CollisionSolid *)entry.get_into())->get_volume_pcollector());
     #endif  // DO_PSTATS
 #ifndef NDEBUG
     if (collide_cat.is_spam()) {
@@ -1256,7 +1804,7 @@ compare_collider_to_geom(CollisionEntry &entry, const Geom *geom,
   if (from_node_gbv != nullptr &&
       geom_gbv != nullptr) {
     within_geom_bounds = (geom_gbv->contains(from_node_gbv) != 0);
-    _geom_volume_pcollector.add_level(1);
+    count_tests(_geom_volume_pcollector);
   }
   if (within_geom_bounds) {
     Colliders::const_iterator ci;
@@ -1266,76 +1814,53 @@ compare_collider_to_geom(CollisionEntry &entry, const Geom *geom,
     if (geom->get_primitive_type() == Geom::PT_polygons) {
       Thread *current_thread = Thread::get_current_thread();
       CPT(GeomVertexData) data = geom->get_animated_vertex_data(true, current_thread);
-      GeomVertexReader vertex(data, InternalName::get_vertex());
-
-      int num_primitives = geom->get_num_primitives();
-      for (int i = 0; i < num_primitives; ++i) {
-        const GeomPrimitive *primitive = geom->get_primitive(i);
-        CPT(GeomPrimitive) tris = primitive->decompose();
-        nassertv(tris->is_of_type(GeomTriangles::get_class_type()));
-
-        if (tris->is_indexed()) {
-          // Indexed case.
-          GeomVertexReader index(tris->get_vertices(), 0);
-          while (!index.is_at_end()) {
-            LPoint3 v[3];
-
-            vertex.set_row_unsafe(index.get_data1i());
-            v[0] = vertex.get_data3();
-            vertex.set_row_unsafe(index.get_data1i());
-            v[1] = vertex.get_data3();
-            vertex.set_row_unsafe(index.get_data1i());
-            v[2] = vertex.get_data3();
-
-            // Generate a temporary CollisionGeom on the fly for each triangle
-            // in the Geom.
-            if (CollisionPolygon::verify_points(v[0], v[1], v[2])) {
-              bool within_solid_bounds = true;
-              if (from_node_gbv != nullptr) {
-                BoundingSphere sphere;
-                sphere.around(v, v + 3);
-                within_solid_bounds = (sphere.contains(from_node_gbv) != 0);
-#ifdef DO_PSTATS
-                CollisionGeom::_volume_pcollector.add_level(1);
-#endif  // DO_PSTATS
-              }
-              if (within_solid_bounds) {
-                PT(CollisionGeom) cgeom = new CollisionGeom(v[0], v[1], v[2]);
-                entry._into = cgeom;
-                entry.test_intersection((*ci).second, this);
-              }
-            }
-          }
-        } else {
-          // Non-indexed case.
-          vertex.set_row_unsafe(primitive->get_first_vertex());
-          int num_vertices = primitive->get_num_vertices();
-          for (int i = 0; i < num_vertices; i += 3) {
-            LPoint3 v[3];
-
-            v[0] = vertex.get_data3();
-            v[1] = vertex.get_data3();
-            v[2] = vertex.get_data3();
-
-            // Generate a temporary CollisionGeom on the fly for each triangle
-            // in the Geom.
-            if (CollisionPolygon::verify_points(v[0], v[1], v[2])) {
-              bool within_solid_bounds = true;
-              if (from_node_gbv != nullptr) {
-                BoundingSphere sphere;
-                sphere.around(v, v + 3);
-                within_solid_bounds = (sphere.contains(from_node_gbv) != 0);
+
+      // Unless the vertices are animated, the triangles are remembered from
+      // one traversal to the next, along with a hierarchy over them if there
+      // are many.
+      CPT(CollisionGeomCache::Triangles) triangles;
+      pvector<LPoint3> animated_vertices;
+      const pvector<LPoint3> *vertices;
+      if (collision_bvh_threshold > 0 &&
+          data == geom->get_vertex_data(current_thread)) {
+        triangles = CollisionGeomCache::get_triangles(geom, data, current_thread);
+        vertices = &triangles->_vertices;
+      } else {
+        CollisionGeomCache::collect_triangles(geom, data, animated_vertices);
+        vertices = &animated_vertices;
+      }
+
+      int num_triangles = (int)(vertices->size() / 3);
+      pvector<int> candidates;
+      bool use_bvh = (triangles != nullptr && triangles->_bvh != nullptr &&
+                      from_node_gbv != nullptr &&
+                      !(*ci).second->wants_all_potential_collidees());
+      if (use_bvh) {
+        triangles->_bvh->find_candidates(from_node_gbv, candidates);
+        if (collision_solid_batch) {
+          triangles->_batch->filter(from_node_gbv, candidates);
+        }
+        num_triangles = (int)candidates.size();
+      }
+
+      for (int i = 0; i < num_triangles; ++i) {
+        const LPoint3 *v = &(*vertices)[(use_bvh ? candidates[i] : i) * 3];
+
+        // Generate a temporary CollisionGeom on the fly for each triangle in
+        // the Geom.
+        bool within_solid_bounds = true;
+        if (from_node_gbv != nullptr) {
+          BoundingSphere sphere;
+          sphere.around(v, v + 3);
+          within_solid_bounds = (sphere.contains(from_node_gbv) != 0);
 #ifdef DO_PSTATS
-                CollisionGeom::_volume_pcollector.add_level(1);
+          count_tests(CollisionGeom::_volume_pcollector);
 #endif  // DO_PSTATS
-              }
-              if (within_solid_bounds) {
-                PT(CollisionGeom) cgeom = new CollisionGeom(v[0], v[1], v[2]);
-                entry._into = cgeom;
-                entry.test_intersection((*ci).second, this);
-              }
-            }
-          }
+        }
+        if (within_solid_bounds) {
+          PT(CollisionGeom) cgeom = new CollisionGeom(v[0], v[1], v[2]);
+          entry._into = cgeom;
+          entry.test_intersection((*ci).second, this);
         }
       }
     }
@@ -18,6 +18,7 @@
 
 #include "collisionHandler.h"
 #include "collisionLevelState.h"
+#include "collisionBroadphase.h"
 
 #include "pointerTo.h"
 #include "pStatCollector.h"
@@ -52,6 +53,14 @@ PUBLISHED:
   MAKE_PROPERTY(respect_prev_transform, get_respect_prev_transform,
                                         set_respect_prev_transform);
 
+  INLINE void set_parallel(bool flag);
+  INLINE bool get_parallel() const;
+  MAKE_PROPERTY(parallel, get_parallel, set_parallel);
+
+  INLINE void set_broadphase(bool flag);
+  INLINE bool get_broadphase() const;
+  MAKE_PROPERTY(broadphase, get_broadphase, set_broadphase);
+
   void add_collider(const NodePath &collider, CollisionHandler *handler);
   bool remove_collider(const NodePath &collider);
   bool has_collider(const NodePath &collider) const;
@@ -79,6 +88,9 @@ PUBLISHED:
   void output(std::ostream &out) const;
   void write(std::ostream &out, int indent_level) const;
 
+public:
+  INLINE void count_tests(PStatCollector &collector, int num_tests = 1) const;
+
 private:
   typedef pvector<CollisionLevelStateSingle> LevelStatesSingle;
   void prepare_colliders_single(LevelStatesSingle &level_states, const NodePath &root);
@@ -109,6 +121,27 @@ private:
 
   PStatCollector &get_pass_collector(int pass);
 
+  class ParallelHandler;
+  class ParallelJob;
+  bool traverse_parallel(const NodePath &root);
+  bool traverse_broadphase(const NodePath &root);
+
+  // A collider that the broadphase found might reach an into node.  These
+  // are sorted into the order in which the serial traversal would test them.
+  class BroadphasePair {
+  public:
+    INLINE bool operator < (const BroadphasePair &other) const;
+
+    int _pass;
+    int _sort;
+    int _state;
+    int _collider;
+    int _record;
+  };
+  typedef pvector<BroadphasePair> BroadphasePairs;
+
+  static int get_pass_size(int num_colliders, int num_solids);
+
 private:
   PT(CollisionHandler) _default_handler;
 
@@ -129,6 +162,15 @@ private:
   Handlers::iterator remove_handler(Handlers::iterator hi);
 
   bool _respect_prev_transform;
+  bool _parallel;
+  bool _use_broadphase;
+  PT(CollisionBroadphase) _broadphase;
+
+  // The traverser of a ParallelJob runs in one of the JobPool's threads, so
+  // it counts its tests here instead of adding them to the collectors, and
+  // the thread that owns the traversal adds them up afterwards.
+  typedef pmap<PStatCollector *, int> TestCounts;
+  TestCounts *_test_counts;
 #ifdef DO_COLLISION_RECORDING
   CollisionRecorder *_recorder;
   NodePath _collision_visualizer_np;
@@ -144,6 +186,10 @@ private:
   static PStatCollector _gnode_volume_pcollector;
   static PStatCollector _geom_volume_pcollector;
 
+  static PStatCollector _parallel_job_pcollector;
+  static PStatCollector _parallel_merge_pcollector;
+  static PStatCollector _broadphase_pcollector;
+
   PStatCollector _this_pcollector;
   typedef pvector<PStatCollector> PassCollectors;
   PassCollectors _pass_collectors;
@@ -164,6 +210,8 @@ private:
   static TypeHandle _type_handle;
 
   friend class SortByColliderSort;
+  friend class ParallelHandler;
+  friend class ParallelJob;
 };
 
 INLINE std::ostream &operator << (std::ostream &out, const CollisionTraverser &trav) {
@@ -111,6 +111,56 @@ ConfigVariableBool pushers_horizontal
           "set_horizontal() flag by default, false to let the move "
           "in three dimensions by default."));
 
+ConfigVariableBool parallel_collision_traversal
+("parallel-collision-traversal", false,
+ PRC_DESC("Set this true to have CollisionTraversers split their colliders "
+          "across the threads of the global job pool by default (see "
+          "job-pool-num-threads).  The collisions are still reported to the "
+          "handlers in the same order as a single-threaded traversal.  "
+          "This can also be enabled per traverser with "
+          "CollisionTraverser::set_parallel()."));
+
+ConfigVariableInt collision_bvh_threshold
+("collision-bvh-threshold", 16,
+ PRC_DESC("The CollisionTraverser builds a bounding volume hierarchy for "
+          "any CollisionNode with at least this many solids, and for any "
+          "Geom with at least this many triangles that is tested for "
+          "collisions, so that it need not test each solid or triangle "
+          "individually.  The hierarchy is kept until the node or Geom is "
+          "modified.  Set this to 0 to disable the hierarchies."));
+
+ConfigVariableBool collision_solid_batch
+("collision-solid-batch", true,
+ PRC_DESC("When this is true, the solids or triangles that pass the "
+          "collision-bvh-threshold are additionally tested four at a time "
+          "against the bounding volume of the collider, using SIMD "
+          "instructions where available, before the individual "
+          "intersection tests are made."));
+
+ConfigVariableBool collision_solid_batch_simd
+("collision-solid-batch-simd", true,
+ PRC_DESC("Set this false to make collision-solid-batch test one solid or "
+          "triangle at a time even where SIMD instructions are available.  "
+          "The results are the same either way; this is mainly useful for "
+          "comparing the two."));
+
+ConfigVariableBool collision_broadphase
+("collision-broadphase", false,
+ PRC_DESC("Set this true to have CollisionTraversers use a spatial hash of "
+          "the nodes below the traversal root to find the nodes that each "
+          "collider might reach, instead of comparing every collider "
+          "against the bounding volume of every node.  This is worthwhile "
+          "when there are many colliders that collide with each other.  "
+          "This can also be enabled per traverser with "
+          "CollisionTraverser::set_broadphase()."));
+
+ConfigVariableDouble collision_broadphase_cell_size
+("collision-broadphase-cell-size", 0.0,
+ PRC_DESC("The length of the side of each cell of the spatial hash used by "
+          "collision-broadphase.  Ideally, this is a little larger than a "
+          "typical collider.  If this is 0, the size is chosen "
+          "automatically from the sizes of the nodes in the scene graph."));
+
 /**
  * Initializes the library.  This must be called at least once before any of
  * the functions or classes in this library can be used.  Normally it will be
@@ -30,6 +30,12 @@ extern EXPCL_PANDA_COLLIDE ConfigVariableDouble collision_parabola_bounds_thresh
 extern EXPCL_PANDA_COLLIDE ConfigVariableInt collision_parabola_bounds_sample;
 extern EXPCL_PANDA_COLLIDE ConfigVariableInt fluid_cap_amount;
 extern EXPCL_PANDA_COLLIDE ConfigVariableBool pushers_horizontal;
+extern EXPCL_PANDA_COLLIDE ConfigVariableBool parallel_collision_traversal;
+extern EXPCL_PANDA_COLLIDE ConfigVariableInt collision_bvh_threshold;
+extern EXPCL_PANDA_COLLIDE ConfigVariableBool collision_solid_batch;
+extern EXPCL_PANDA_COLLIDE ConfigVariableBool collision_solid_batch_simd;
+extern EXPCL_PANDA_COLLIDE ConfigVariableBool collision_broadphase;
+extern EXPCL_PANDA_COLLIDE ConfigVariableDouble collision_broadphase_cell_size;
 
 extern EXPCL_PANDA_COLLIDE void init_libcollide();
 
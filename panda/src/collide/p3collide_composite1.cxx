@@ -1,8 +1,11 @@
 #include "config_collide.cxx"
 #include "collisionBox.cxx"
+#include "collisionBroadphase.cxx"
+#include "collisionBVH.cxx"
 #include "collisionCapsule.cxx"
 #include "collisionEntry.cxx"
 #include "collisionGeom.cxx"
+#include "collisionGeomCache.cxx"
 #include "collisionHandler.cxx"
 #include "collisionHandlerEvent.cxx"
 #include "collisionHandlerHighestEvent.cxx"
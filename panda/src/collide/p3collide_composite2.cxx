@@ -10,6 +10,7 @@
 #include "collisionRecorder.cxx"
 #include "collisionSegment.cxx"
 #include "collisionSolid.cxx"
+#include "collisionSolidBatch.cxx"
 #include "collisionSphere.cxx"
 #include "collisionTraverser.cxx"
 #include "collisionVisualizer.cxx"
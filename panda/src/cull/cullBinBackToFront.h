@@ -51,10 +51,9 @@ private:
   class ObjectData {
   public:
     INLINE ObjectData(CullableObject *object, PN_stdfloat dist);
-    INLINE bool operator < (const ObjectData &other) const;
 
     CullableObject *_object;
-    PN_stdfloat _dist;
+    uint32_t _sort_key;
   };
 
   typedef pvector<ObjectData> Objects;
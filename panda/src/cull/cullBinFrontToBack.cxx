@@ -18,8 +18,6 @@
 #include "cullHandler.h"
 #include "pStatTimer.h"
 
-#include <algorithm>
-
 
 TypeHandle CullBinFrontToBack::_type_handle;
 
@@ -75,7 +73,7 @@ add_object(CullableObject *object, Thread *current_thread) {
 void CullBinFrontToBack::
 finish_cull(SceneSetup *, Thread *current_thread) {
   PStatTimer timer(_cull_this_pcollector, current_thread);
-  sort(_objects.begin(), _objects.end());
+  sort_by_key(_objects, 32);
 }
 
 /**
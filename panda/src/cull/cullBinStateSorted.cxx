@@ -16,6 +16,7 @@
 #include "cullableObject.h"
 #include "cullHandler.h"
 #include "pStatTimer.h"
+#include "pbitops.h"
 
 #include <algorithm>
 
@@ -59,7 +60,81 @@ add_object(CullableObject *object, Thread *current_thread) {
 void CullBinStateSorted::
 finish_cull(SceneSetup *, Thread *current_thread) {
   PStatTimer timer(_cull_this_pcollector, current_thread);
-  sort(_objects.begin(), _objects.end());
+
+  size_t num_objects = _objects.size();
+  if (num_objects < 2) {
+    return;
+  }
+
+  // Comparing two states is relatively expensive, so rather than comparing
+  // the objects pairwise, we number the distinct states, vertex formats and
+  // vertex datas, and sort on an integer key made from those numbers.  Only
+  // the states need to be put in order; the others are numbered in order of
+  // first appearance, since they only need to be grouped together.
+  pvector<const RenderState *> states;
+  Indices state_indices, format_indices, data_indices;
+  pvector<Ranks> ranks(num_objects);
+
+  for (size_t i = 0; i < num_objects; ++i) {
+    const ObjectData &data = _objects[i];
+    Ranks &rank = ranks[i];
+    if (i != 0 && data._object->_state == _objects[i - 1]._object->_state) {
+      rank._state = ranks[i - 1]._state;
+    } else {
+      rank._state = get_index(state_indices, data._object->_state.p());
+      if (rank._state == states.size()) {
+        states.push_back(data._object->_state.p());
+      }
+    }
+    rank._format = get_index(format_indices, data._format);
+    rank._data = get_index(data_indices, data._object->_munged_data.p());
+  }
+
+  // Now put the distinct states in order.
+  size_t num_states = states.size();
+  pvector<size_t> order(num_states);
+  for (size_t si = 0; si < num_states; ++si) {
+    order[si] = si;
+  }
+  std::sort(order.begin(), order.end(), CompareStates(states));
+  pvector<uint64_t> state_ranks(num_states);
+  for (size_t si = 0; si < num_states; ++si) {
+    state_ranks[order[si]] = si;
+  }
+
+  int state_bits = get_highest_on_bit((uint64_t)num_states - 1) + 1;
+  int format_bits = get_highest_on_bit((uint64_t)format_indices.get_num_entries() - 1) + 1;
+  int data_bits = get_highest_on_bit((uint64_t)data_indices.get_num_entries() - 1) + 1;
+
+  // In the unlikely event that the key doesn't fit, give up on grouping some
+  // of the vertex datas.
+  int data_shift = std::max(state_bits + format_bits + data_bits - 64, 0);
+  data_bits -= data_shift;
+
+  for (size_t i = 0; i < num_objects; ++i) {
+    const Ranks &rank = ranks[i];
+    _objects[i]._sort_key =
+      (state_ranks[rank._state] << (format_bits + data_bits)) |
+      ((uint64_t)rank._format << data_bits) |
+      ((uint64_t)rank._data >> data_shift);
+  }
+
+  sort_by_key(_objects, state_bits + format_bits + data_bits);
+}
+
+/**
+ * Returns the number assigned to the indicated pointer, assigning the next
+ * available number if it has not been seen before.
+ */
+size_t CullBinStateSorted::
+get_index(Indices &indices, const void *ptr) {
+  int slot = indices.find(ptr);
+  if (slot >= 0) {
+    return indices.get_data((size_t)slot);
+  }
+  size_t index = indices.get_num_entries();
+  indices.store(ptr, index);
+  return index;
 }
 
 
@@ -22,6 +22,7 @@
 #include "transformState.h"
 #include "renderState.h"
 #include "pointerTo.h"
+#include "simpleHashMap.h"
 
 /**
  * A specific kind of CullBin that sorts geometry to collect items of the same
@@ -54,15 +55,34 @@ private:
   class ObjectData {
   public:
     INLINE ObjectData(CullableObject *object);
-    INLINE bool operator < (const ObjectData &other) const;
 
     CullableObject *_object;
     const GeomVertexFormat *_format;
+    uint64_t _sort_key;
+  };
+
+  class CompareStates {
+  public:
+    INLINE CompareStates(const pvector<const RenderState *> &states);
+    INLINE bool operator () (size_t a, size_t b) const;
+
+    const pvector<const RenderState *> &_states;
   };
 
   typedef pvector<ObjectData> Objects;
   Objects _objects;
 
+  // Used while computing the sort keys in finish_cull().
+  class Ranks {
+  public:
+    size_t _state;
+    size_t _format;
+    size_t _data;
+  };
+  typedef SimpleHashMap<const void *, size_t, pointer_hash> Indices;
+
+  static size_t get_index(Indices &indices, const void *ptr);
+
 public:
   static TypeHandle get_class_type() {
     return _type_handle;
@@ -21,6 +21,7 @@
 #include "binCullHandler.h"
 #include "cullResult.h"
 #include "cullTraverser.h"
+#include "jobPool.h"
 #include "clockObject.h"
 #include "pStatTimer.h"
 #include "pStatGPUTimer.h"
@@ -96,8 +97,14 @@ PStatCollector GraphicsEngine::_vertex_data_independent_pcollector("Vertex Data:
 PStatCollector GraphicsEngine::_vertex_data_pending_pcollector("Vertex Data:Pending");
 PStatCollector GraphicsEngine::_vertex_data_resident_pcollector("Vertex Data:Resident");
 PStatCollector GraphicsEngine::_vertex_data_compressed_pcollector("Vertex Data:Compressed");
+PStatCollector GraphicsEngine::_vertex_data_mapped_pcollector("Vertex Data:Mapped");
 PStatCollector GraphicsEngine::_vertex_data_unused_disk_pcollector("Vertex Data:Disk:Unused");
 PStatCollector GraphicsEngine::_vertex_data_used_disk_pcollector("Vertex Data:Disk:Used");
+PStatCollector GraphicsEngine::_model_cache_pcollector("Model cache");
+PStatCollector GraphicsEngine::_model_cache_hits_pcollector("Model cache lookups:Hits");
+PStatCollector GraphicsEngine::_model_cache_misses_pcollector("Model cache lookups:Misses");
+PStatCollector GraphicsEngine::_model_cache_evictions_pcollector("Model cache evictions");
+PStatCollector GraphicsEngine::_model_cache_lookup_time_pcollector("Model cache lookup time");
 
 // These are counted independently by the collision system; we redefine them
 // here so we can reset them at each frame.
@@ -173,6 +180,11 @@ GraphicsEngine(Pipeline *pipeline) :
 
   _singular_warning_last_frame = false;
   _singular_warning_this_frame = false;
+
+  _cache_num_hits = 0;
+  _cache_num_misses = 0;
+  _cache_num_evictions = 0;
+  _cache_lookup_time = 0.0;
 }
 
 /**
@@ -831,6 +843,7 @@ render_frame() {
 
     GeomCacheManager::flush_level();
     CullTraverser::flush_level();
+    PandaNode::flush_level();
     RenderState::flush_level();
     TransformState::flush_level();
     CullableObject::flush_level();
@@ -855,6 +868,8 @@ render_frame() {
     CullTraverser::_nodes_pcollector.clear_level();
     CullTraverser::_geom_nodes_pcollector.clear_level();
     CullTraverser::_geoms_pcollector.clear_level();
+    PandaNode::_bounds_nodes_pcollector.clear_level();
+    PandaNode::_bounds_parallel_nodes_pcollector.clear_level();
     GeomCacheManager::_geom_cache_active_pcollector.clear_level();
     GeomCacheManager::_geom_cache_record_pcollector.clear_level();
     GeomCacheManager::_geom_cache_erase_pcollector.clear_level();
@@ -901,6 +916,7 @@ render_frame() {
       size_t independent = GeomVertexArrayData::get_independent_lru()->get_total_size();
       size_t resident = VertexDataPage::get_global_lru(VertexDataPage::RC_resident)->get_total_size();
       size_t compressed = VertexDataPage::get_global_lru(VertexDataPage::RC_compressed)->get_total_size();
+      size_t mapped = VertexDataPage::get_global_lru(VertexDataPage::RC_mapped)->get_total_size();
       size_t pending = VertexDataPage::get_pending_lru()->get_total_size();
 
       VertexDataSaveFile *save_file = VertexDataPage::get_save_file();
@@ -912,8 +928,28 @@ render_frame() {
       _vertex_data_pending_pcollector.set_level(pending);
       _vertex_data_resident_pcollector.set_level(resident);
       _vertex_data_compressed_pcollector.set_level(compressed);
+      _vertex_data_mapped_pcollector.set_level(mapped);
       _vertex_data_unused_disk_pcollector.set_level(total_disk - used_disk);
       _vertex_data_used_disk_pcollector.set_level(used_disk);
+
+      // The cache counters are cumulative; report how much they have changed
+      // since the last frame.
+      BamCache *cache = BamCache::get_global_ptr();
+      int num_hits = cache->get_num_hits();
+      int num_misses = cache->get_num_misses();
+      int num_evictions = cache->get_num_evictions();
+      double lookup_time = cache->get_total_lookup_time();
+
+      _model_cache_pcollector.set_level(cache->get_cache_size());
+      _model_cache_hits_pcollector.set_level(num_hits - _cache_num_hits);
+      _model_cache_misses_pcollector.set_level(num_misses - _cache_num_misses);
+      _model_cache_evictions_pcollector.set_level(num_evictions - _cache_num_evictions);
+      _model_cache_lookup_time_pcollector.set_level((lookup_time - _cache_lookup_time) * 1000.0);
+
+      _cache_num_hits = num_hits;
+      _cache_num_misses = num_misses;
+      _cache_num_evictions = num_evictions;
+      _cache_lookup_time = lookup_time;
     }
 
 #endif  // DO_PSTATS
@@ -1318,8 +1354,20 @@ do_cull(CullHandler *cull_handler, SceneSetup *scene_setup,
 
   CullTraverser *trav = dr->get_cull_traverser();
   trav->set_cull_handler(cull_handler);
+  if (gsg->get_threading_model().get_cull_parallel()) {
+    trav->set_job_pool(JobPool::get_global_ptr());
+  } else {
+    trav->set_job_pool(nullptr);
+  }
   trav->set_scene(scene_setup, gsg, dr->get_incomplete_render());
-  trav->traverse(scene_setup->get_scene_root());
+
+  NodePath scene_root = scene_setup->get_scene_root();
+  if (cull_update_bounds && !scene_root.is_empty()) {
+    // Bring the stale bounds up to date in one pass, rather than leaving the
+    // traversal to discover them one at a time.
+    scene_root.node()->update_bounds(trav->get_job_pool(), current_thread);
+  }
+  trav->traverse(scene_root);
   trav->end_traverse();
 }
 
@@ -1673,7 +1721,11 @@ cull_to_bins(GraphicsOutput *win, GraphicsStateGuardian *gsg,
   }
 
   PStatTimer timer(_cull_sort_pcollector, current_thread);
-  cull_result->finish_cull(scene_setup, current_thread);
+  JobPool *job_pool = nullptr;
+  if (gsg->get_threading_model().get_cull_parallel()) {
+    job_pool = JobPool::get_global_ptr();
+  }
+  cull_result->finish_cull(scene_setup, job_pool, current_thread);
 }
 
 /**
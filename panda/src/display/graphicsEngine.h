@@ -134,6 +134,8 @@ public:
   PT(Texture) do_get_screenshot(DisplayRegion *region, GraphicsStateGuardian *gsg);
 
 public:
+  PT(SceneSetup) setup_scene(GraphicsStateGuardian *gsg,
+                             DisplayRegionPipelineReader *dr);
   static void do_cull(CullHandler *cull_handler, SceneSetup *scene_setup,
                       GraphicsStateGuardian *gsg, Thread *current_thread);
 
@@ -165,8 +167,6 @@ private:
   void do_flip_frame(Thread *current_thread);
   INLINE void close_gsg(GraphicsPipe *pipe, GraphicsStateGuardian *gsg);
 
-  PT(SceneSetup) setup_scene(GraphicsStateGuardian *gsg,
-                             DisplayRegionPipelineReader *dr);
   void do_draw(GraphicsOutput *win, GraphicsStateGuardian *gsg,
                DisplayRegion *dr, Thread *current_thread);
 
@@ -342,6 +342,13 @@ private:
   bool _singular_warning_last_frame;
   bool _singular_warning_this_frame;
 
+  // The BamCache counters as of the previous frame, so that we can report
+  // the per-frame change to PStats.
+  int _cache_num_hits;
+  int _cache_num_misses;
+  int _cache_num_evictions;
+  double _cache_lookup_time;
+
   ReMutex _lock;
   ReMutex _public_lock;
 
@@ -384,9 +391,16 @@ private:
   static PStatCollector _vertex_data_pending_pcollector;
   static PStatCollector _vertex_data_resident_pcollector;
   static PStatCollector _vertex_data_compressed_pcollector;
+  static PStatCollector _vertex_data_mapped_pcollector;
   static PStatCollector _vertex_data_used_disk_pcollector;
   static PStatCollector _vertex_data_unused_disk_pcollector;
 
+  static PStatCollector _model_cache_pcollector;
+  static PStatCollector _model_cache_hits_pcollector;
+  static PStatCollector _model_cache_misses_pcollector;
+  static PStatCollector _model_cache_evictions_pcollector;
+  static PStatCollector _model_cache_lookup_time_pcollector;
+
   static PStatCollector _cnode_volume_pcollector;
   static PStatCollector _gnode_volume_pcollector;
   static PStatCollector _geom_volume_pcollector;
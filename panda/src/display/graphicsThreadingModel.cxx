@@ -36,10 +36,19 @@ using std::string;
  * draw are run simultaneously, in the same thread, with no binning or state
  * sorting.  It simplifies the cull process but it forces the scene to render
  * in scene graph order; state sorting and alpha sorting is lost.
+ *
+ * The name of the cull thread may also be followed by a "*" character to
+ * indicate that the cull traversal itself is to be split across the threads
+ * of the global JobPool.  For instance, "Cull*" culls and draws in a thread
+ * called "Cull", with help from the JobPool during the cull traversal.  This
+ * can greatly speed up culling very large scenes; the result is the same as
+ * that of a serial traversal.  See cull-parallel-depth and
+ * job-pool-num-threads.
  */
 GraphicsThreadingModel::
 GraphicsThreadingModel(const string &model) {
   _cull_sorting = true;
+  _cull_parallel = false;
   size_t start = 0;
   if (!model.empty() && model[0] == '-') {
     start = 1;
@@ -54,6 +63,11 @@ GraphicsThreadingModel(const string &model) {
     _draw_name = model.substr(slash + 1);
   }
 
+  if (!_cull_name.empty() && _cull_name[_cull_name.length() - 1] == '*') {
+    _cull_name = _cull_name.substr(0, _cull_name.length() - 1);
+    _cull_parallel = true;
+  }
+
   update_stages();
 }
 
@@ -63,10 +77,14 @@ GraphicsThreadingModel(const string &model) {
  */
 string GraphicsThreadingModel::
 get_model() const {
+  string cull_name = get_cull_name();
+  if (get_cull_parallel()) {
+    cull_name += "*";
+  }
   if (get_cull_sorting()) {
-    return get_cull_name() + "/" + get_draw_name();
+    return cull_name + "/" + get_draw_name();
   } else {
-    return string("-") + get_cull_name();
+    return string("-") + cull_name;
   }
 }
 
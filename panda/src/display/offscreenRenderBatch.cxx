@@ -0,0 +1,255 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file offscreenRenderBatch.cxx
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#include "offscreenRenderBatch.h"
+#include "config_display.h"
+#include "graphicsStateGuardian.h"
+#include "binCullHandler.h"
+#include "windowProperties.h"
+#include "pStatClient.h"
+
+/**
+ * Creates a pool of num_buffers offscreen buffers of the indicated size on the
+ * indicated pipe.  Each buffer gets its own GSG, so that they can be drawn
+ * independently of each other.  Check is_valid() to see whether any buffers
+ * could be created.
+ */
+OffscreenRenderBatch::
+OffscreenRenderBatch(GraphicsEngine *engine, GraphicsPipe *pipe,
+                     const std::string &name, int x_size, int y_size,
+                     int num_buffers, const FrameBufferProperties &fb_prop) :
+  _engine(engine),
+  _x_size(x_size),
+  _y_size(y_size),
+  _clear_color(background_color.get_value())
+{
+  nassertv(engine != nullptr && pipe != nullptr);
+
+  WindowProperties win_prop = WindowProperties::size(x_size, y_size);
+  _slots.resize(std::max(num_buffers, 0));
+
+  int num_created = 0;
+  while (num_created < num_buffers) {
+    std::ostringstream strm;
+    strm << name << "-" << num_created;
+    GraphicsOutput *buffer =
+      engine->make_output(pipe, strm.str(), 0, fb_prop, win_prop,
+                          GraphicsPipe::BF_refuse_window);
+    if (buffer == nullptr) {
+      display_cat.warning()
+        << "Could only create " << num_created << " of " << num_buffers
+        << " buffers for " << name << "\n";
+      break;
+    }
+
+    // The engine shouldn't render these buffers; we do that ourselves.
+    buffer->set_active(false);
+    buffer->set_clear_color(_clear_color);
+
+    Slot &slot = _slots[num_created];
+    slot._buffer = buffer;
+    slot._dr = buffer->make_display_region();
+    slot._texture = nullptr;
+    ++num_created;
+  }
+
+  _slots.resize(num_created);
+}
+
+/**
+ * Removes the buffers from the GraphicsEngine.
+ */
+OffscreenRenderBatch::
+~OffscreenRenderBatch() {
+  for (Slot &slot : _slots) {
+    _engine->remove_window(slot._buffer);
+  }
+}
+
+/**
+ * Sets the color to which each image is cleared before its scene is drawn.
+ * The default is the background-color config variable.
+ */
+void OffscreenRenderBatch::
+set_clear_color(const LColor &color) {
+  _clear_color = color;
+  for (Slot &slot : _slots) {
+    slot._buffer->set_clear_color(color);
+  }
+}
+
+/**
+ * Queues up an image of the scene as seen by the indicated camera, to be
+ * rendered by the next call to render().  The image is copied into the RAM
+ * image of the indicated Texture, or of a new Texture if none is given; either
+ * way, get_texture() returns it.  Returns the index of the image.
+ *
+ * The camera's lens should have the same aspect ratio as the buffers.
+ */
+size_t OffscreenRenderBatch::
+add_camera(const NodePath &camera, Texture *tex) {
+  nassertr(!camera.is_empty(), _requests.size());
+
+  Request request;
+  request._camera = camera;
+  request._texture = tex;
+  if (tex == nullptr) {
+    request._texture = new Texture(camera.get_name());
+  }
+  _requests.push_back(std::move(request));
+  return _requests.size() - 1;
+}
+
+/**
+ * Renders the view from each of the cameras that have been added into its
+ * Texture, and waits for all of them to finish.  The cameras are kept, so
+ * that calling this again renders the same views again into the same
+ * Textures.
+ *
+ * The images are rendered in groups of get_num_buffers() at a time.  Within a
+ * group, the scenes are culled in this thread, one after the other, since
+ * adding the objects to a CullResult looks up the GSG's munger in a cache on
+ * each shared RenderState, which is not protected by a lock.  (The traversal
+ * of each scene may itself be divided among the threads of the JobPool, if
+ * the engine's threading model asks for a parallel cull, but the objects are
+ * still handed to the CullResult by this thread.)  The scenes are then drawn
+ * in parallel by the global JobPool, unless the GSGs need the graphics
+ * hardware or a PStats client is connected, in which case they are drawn in
+ * this thread.
+ */
+void OffscreenRenderBatch::
+render(Thread *current_thread) {
+  if (_slots.empty()) {
+    if (!_requests.empty()) {
+      display_cat.error()
+        << "Cannot render " << _requests.size()
+        << " images, since no buffers could be created.\n";
+    }
+    return;
+  }
+
+  // The GSGs also add their statistics to collectors that they all share,
+  // which may not be updated from several threads at once, so they are drawn
+  // one at a time while PStats is listening.
+  JobPool *pool = JobPool::get_global_ptr();
+  bool parallel = _slots.size() > 1 && pool->get_num_threads() > 0 &&
+                  !_slots[0]._buffer->get_gsg()->is_hardware() &&
+                  !PStatClient::is_connected();
+
+  size_t num_slots = _slots.size();
+  for (size_t start = 0; start < _requests.size(); start += num_slots) {
+    size_t count = std::min(num_slots, _requests.size() - start);
+
+    for (size_t i = 0; i < count; ++i) {
+      cull(_slots[i], _requests[start + i], current_thread);
+    }
+
+    if (parallel && count > 1) {
+      JobPool::Batch batch(pool, current_thread);
+      for (size_t i = 0; i < count; ++i) {
+        batch.add_job(&_slots[i]);
+      }
+      batch.wait();
+
+    } else {
+      for (size_t i = 0; i < count; ++i) {
+        _slots[i].draw(current_thread);
+      }
+    }
+  }
+}
+
+/**
+ * Sets up the indicated slot to draw the view from the camera of the
+ * indicated request, and culls the scene into its bins.
+ */
+void OffscreenRenderBatch::
+cull(Slot &slot, const Request &request, Thread *current_thread) {
+  GraphicsStateGuardian *gsg = slot._buffer->get_gsg();
+  slot._dr->set_camera(request._camera);
+  slot._texture = request._texture;
+
+  {
+    DisplayRegionPipelineReader dr_reader(slot._dr, current_thread);
+    slot._scene_setup = _engine->setup_scene(gsg, &dr_reader);
+  }
+  if (slot._scene_setup == nullptr) {
+    // Nothing to draw, but the image is still cleared.
+    return;
+  }
+
+  if (slot._cull_result == nullptr) {
+    slot._cull_result = new CullResult(gsg, slot._dr->get_draw_region_pcollector());
+  }
+  BinCullHandler cull_handler(slot._cull_result);
+  GraphicsEngine::do_cull(&cull_handler, slot._scene_setup, gsg, current_thread);
+  slot._cull_result->finish_cull(slot._scene_setup, nullptr, current_thread);
+}
+
+/**
+ *
+ */
+void OffscreenRenderBatch::Slot::
+do_job(Thread *current_thread) {
+  draw(current_thread);
+}
+
+/**
+ * Draws the bins that were filled in by cull(), and copies the result into
+ * the RAM image of the Texture.  This only touches the objects belonging to
+ * this slot, so it may be called for several slots at once.
+ */
+void OffscreenRenderBatch::Slot::
+draw(Thread *current_thread) {
+  GraphicsStateGuardian *gsg = _buffer->get_gsg();
+
+  if (_buffer->begin_frame(GraphicsOutput::FM_render, current_thread)) {
+    if (_buffer->is_any_clear_active()) {
+      _buffer->clear(current_thread);
+    }
+
+    {
+      DisplayRegionPipelineReader dr_reader(_dr, current_thread);
+      gsg->prepare_display_region(&dr_reader);
+    }
+
+    if (_scene_setup == nullptr) {
+      // Nothing to see here.
+
+    } else if (!gsg->set_scene(_scene_setup)) {
+      display_cat.error()
+        << gsg->get_type() << " cannot render scene with specified lens.\n";
+
+    } else if (gsg->begin_scene()) {
+      _cull_result->draw(current_thread);
+      gsg->end_scene();
+    }
+
+    RenderBuffer buffer = gsg->get_render_buffer(_dr->get_draw_buffer_type(),
+                                                 _buffer->get_fb_properties());
+    if (!gsg->framebuffer_copy_to_ram(_texture, 0, -1, _dr, buffer)) {
+      display_cat.error()
+        << "Could not copy " << _buffer->get_name() << " to "
+        << _texture->get_name() << "\n";
+    }
+
+    _buffer->end_frame(GraphicsOutput::FM_render, current_thread);
+  }
+
+  // Start over with empty bins for the next scene, and let go of this one.
+  if (_cull_result != nullptr) {
+    _cull_result = _cull_result->make_next();
+  }
+  _scene_setup = nullptr;
+  _texture = nullptr;
+}
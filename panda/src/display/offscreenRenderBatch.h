@@ -0,0 +1,118 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file offscreenRenderBatch.h
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#ifndef OFFSCREENRENDERBATCH_H
+#define OFFSCREENRENDERBATCH_H
+
+#include "pandabase.h"
+
+#include "referenceCount.h"
+#include "graphicsEngine.h"
+#include "graphicsOutput.h"
+#include "graphicsPipe.h"
+#include "displayRegion.h"
+#include "frameBufferProperties.h"
+#include "cullResult.h"
+#include "sceneSetup.h"
+#include "texture.h"
+#include "nodePath.h"
+#include "jobPool.h"
+#include "pointerTo.h"
+#include "pvector.h"
+
+/**
+ * This class renders many small images, each from its own camera, into a
+ * fixed pool of offscreen buffers, without going through
+ * GraphicsEngine::render_frame().  It is intended for producing large numbers
+ * of images, such as icons or training data, with a software renderer like
+ * tinydisplay.
+ *
+ * Each call to add_camera() queues up an image to be rendered by the next
+ * call to render(), which renders them all, as many at a time as there are
+ * buffers in the pool.  The scenes are culled in the calling thread, but when
+ * the buffers use software GSGs, they are drawn in parallel by the threads of
+ * the global JobPool, except while a PStats client is connected.  Each image is copied from its buffer into the RAM image
+ * of its Texture, which is reused by subsequent calls to render().
+ *
+ * The buffers are created inactive, so that the GraphicsEngine doesn't render
+ * them as well.  If the engine has a threading model other than the default,
+ * it is best to give this class its own GraphicsEngine.
+ */
+class EXPCL_PANDA_DISPLAY OffscreenRenderBatch : public ReferenceCount {
+PUBLISHED:
+  explicit OffscreenRenderBatch(GraphicsEngine *engine, GraphicsPipe *pipe,
+                                const std::string &name,
+                                int x_size, int y_size, int num_buffers,
+                                const FrameBufferProperties &fb_prop = FrameBufferProperties::get_default());
+  ~OffscreenRenderBatch();
+
+  INLINE bool is_valid() const;
+  INLINE int get_x_size() const;
+  INLINE int get_y_size() const;
+  INLINE int get_num_buffers() const;
+  INLINE GraphicsOutput *get_buffer(int n) const;
+  MAKE_SEQ(get_buffers, get_num_buffers, get_buffer);
+
+  void set_clear_color(const LColor &color);
+  INLINE const LColor &get_clear_color() const;
+
+  size_t add_camera(const NodePath &camera, Texture *tex = nullptr);
+  INLINE size_t get_num_cameras() const;
+  INLINE NodePath get_camera(size_t n) const;
+  MAKE_SEQ(get_cameras, get_num_cameras, get_camera);
+  INLINE Texture *get_texture(size_t n) const;
+  MAKE_SEQ(get_textures, get_num_cameras, get_texture);
+  INLINE void clear_cameras();
+
+  BLOCKING void render(Thread *current_thread = Thread::get_current_thread());
+
+  MAKE_PROPERTY(valid, is_valid);
+  MAKE_PROPERTY(x_size, get_x_size);
+  MAKE_PROPERTY(y_size, get_y_size);
+  MAKE_PROPERTY(clear_color, get_clear_color, set_clear_color);
+
+private:
+  // One of the buffers in the pool, along with the scene it is to draw next.
+  class Slot : public JobPool::Job {
+  public:
+    virtual void do_job(Thread *current_thread);
+    void draw(Thread *current_thread);
+
+    PT(GraphicsOutput) _buffer;
+    PT(DisplayRegion) _dr;
+    PT(SceneSetup) _scene_setup;
+    PT(CullResult) _cull_result;
+    Texture *_texture;
+  };
+  typedef pvector<Slot> Slots;
+
+  class Request {
+  public:
+    NodePath _camera;
+    PT(Texture) _texture;
+  };
+  typedef pvector<Request> Requests;
+
+  void cull(Slot &slot, const Request &request, Thread *current_thread);
+
+  PT(GraphicsEngine) _engine;
+  int _x_size;
+  int _y_size;
+  LColor _clear_color;
+  Slots _slots;
+  Requests _requests;
+};
+
+#include "offscreenRenderBatch.I"
+
+#endif
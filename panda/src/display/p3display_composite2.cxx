@@ -6,6 +6,7 @@
 #include "graphicsWindowInputDevice.cxx"
 #include "mouseAndKeyboard.cxx"
 #include "nativeWindowHandle.cxx"
+#include "offscreenRenderBatch.cxx"
 #include "parasiteBuffer.cxx"
 #include "standardMunger.cxx"
 #include "touchInfo.cxx"
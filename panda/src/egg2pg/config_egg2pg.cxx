@@ -157,6 +157,14 @@ ConfigVariableInt egg_max_indices
  PRC_DESC("Specifies the maximum number of vertex indices that will be "
           "added to any one GeomPrimitive by the egg loader."));
 
+ConfigVariableBool egg_parallel_polysets
+("egg-parallel-polysets", true,
+ PRC_DESC("When this is true, the egg loader meshes the primitives of each "
+          "static polyset and builds its Geoms on the threads of the "
+          "global JobPool, rather than one polyset at a time.  The "
+          "resulting scene graph is the same either way.  This has no "
+          "effect if job-pool-num-threads is 0."));
+
 ConfigVariableBool egg_emulate_bface
 ("egg-emulate-bface", true,
  PRC_DESC("When this is true, the bface flag applied to a polygon will "
@@ -49,6 +49,7 @@ extern EXPCL_PANDA_EGG2PG ConfigVariableBool egg_suppress_hidden;
 extern EXPCL_PANDA_EGG2PG ConfigVariableEnum<EggRenderMode::AlphaMode> egg_alpha_mode;
 extern EXPCL_PANDA_EGG2PG ConfigVariableInt egg_max_vertices;
 extern EXPCL_PANDA_EGG2PG ConfigVariableInt egg_max_indices;
+extern EXPCL_PANDA_EGG2PG ConfigVariableBool egg_parallel_polysets;
 extern EXPCL_PANDA_EGG2PG ConfigVariableBool egg_emulate_bface;
 extern EXPCL_PANDA_EGG2PG ConfigVariableBool egg_preload_simple_textures;
 extern EXPCL_PANDA_EGG2PG ConfigVariableDouble egg_vertex_membership_quantize;
@@ -96,6 +96,8 @@
 #include "uvScrollNode.h"
 #include "textureStagePool.h"
 #include "cmath.h"
+#include "jobPool.h"
+#include "lightMutexHolder.h"
 
 #include <ctype.h>
 #include <algorithm>
@@ -132,6 +134,27 @@ LODInstance(EggNode *egg_node) {
   _d = DCAST(EggSwitchConditionDistance, &sw);
 }
 
+// This is used by make_polyset() to build the Geoms of a static polyset on
+// one of the JobPool threads.  The results are collected by
+// finish_polysets().  A polyset that is built right away, but whose Geoms
+// must come after those of a pending job in the same GeomNode, also gets one
+// of these to hold its place; it is not run on the JobPool.
+class EggLoader::PolysetJob : public JobPool::Job {
+public:
+  virtual void do_job(Thread *current_thread);
+
+  EggLoader *_loader;
+  bool _is_built;
+  PT(EggBin) _egg_bin;
+  CPT(EggRenderState) _render_state;
+  EggVertexPools _vertex_pools;
+  LMatrix4d _transform;
+  bool _has_transform;
+  PT(PandaNode) _parent;
+  PT(GeomNode) _geom_node;
+  PolysetGeoms _geoms;
+};
+
 
 /**
  *
@@ -212,6 +235,8 @@ build_graph() {
     make_node(*ci, _root);
   }
 
+  finish_polysets();
+
   reparent_decals();
   start_sequences();
 
@@ -327,6 +352,102 @@ make_polyset(EggBin *egg_bin, PandaNode *parent, const LMatrix4d *transform,
   egg_bin->rebuild_vertex_pools(vertex_pools, (unsigned int)egg_max_vertices,
                                 false);
 
+  // Now the primitives in this bin no longer share any vertices with the
+  // primitives in other bins, so the rest of the work can be done on another
+  // thread.  We can't do this for animated geometry, which needs the
+  // CharacterMaker, or for vertices that are members of some group, since
+  // the group's list of member vertices may be modified along the way.
+  bool parallel = (egg_parallel_polysets && !is_dynamic &&
+                   character_maker == nullptr &&
+                   JobPool::get_global_ptr()->get_num_threads() > 0);
+
+  EggVertexPools::const_iterator vpi;
+  for (vpi = vertex_pools.begin(); vpi != vertex_pools.end() && parallel; ++vpi) {
+    EggVertexPool::const_iterator vi;
+    for (vi = (*vpi)->begin(); vi != (*vpi)->end(); ++vi) {
+      if ((*vi)->gref_size() != 0) {
+        parallel = false;
+        break;
+      }
+    }
+  }
+
+  if (parallel) {
+    PolysetJob *job = new PolysetJob;
+    job->_loader = this;
+    job->_is_built = false;
+    job->_egg_bin = egg_bin;
+    job->_render_state = render_state;
+    job->_vertex_pools.swap(vertex_pools);
+    job->_has_transform = (transform != nullptr);
+    if (transform != nullptr) {
+      job->_transform = *transform;
+    }
+    job->_parent = parent;
+
+    // We create the GeomNode now, even though we don't know yet whether it
+    // will get any Geoms, so that it takes the same place among its siblings
+    // as it would have if we had built the polyset right away.
+    job->_geom_node = make_polyset_node(egg_bin, parent, render_state);
+    if (job->_geom_node == parent) {
+      _polyset_job_nodes.insert(job->_geom_node);
+    }
+    _polyset_jobs.push_back(job);
+    return;
+  }
+
+  PolysetGeoms geoms;
+  build_polyset(egg_bin, render_state, vertex_pools, transform, is_dynamic,
+                character_maker, geoms);
+  if (geoms.empty()) {
+    return;
+  }
+
+  GeomNode *geom_node = make_polyset_node(egg_bin, parent, render_state);
+
+  if (geom_node == parent && _polyset_job_nodes.count(geom_node) != 0) {
+    // Some Geoms that come before ours in this GeomNode are still being
+    // built.  Take the next place in line, so that finish_polysets() adds
+    // the Geoms in the order of the polysets.
+    PolysetJob *job = new PolysetJob;
+    job->_loader = this;
+    job->_is_built = true;
+    job->_vertex_pools.swap(vertex_pools);
+    job->_parent = parent;
+    job->_geom_node = geom_node;
+    job->_geoms.swap(geoms);
+    _polyset_jobs.push_back(job);
+    return;
+  }
+
+  PolysetGeoms::const_iterator gi;
+  for (gi = geoms.begin(); gi != geoms.end(); ++gi) {
+    geom_node->add_geom((*gi).first, (*gi).second);
+  }
+
+  if (egg_show_normals) {
+    // Create some more geometry to visualize each normal.
+    for (vpi = vertex_pools.begin(); vpi != vertex_pools.end(); ++vpi) {
+      EggVertexPool *vertex_pool = (*vpi);
+      show_normals(vertex_pool, geom_node);
+    }
+  }
+}
+
+/**
+ * Meshes the primitives in the bin and builds the Geoms for a polyset, whose
+ * vertex pools have already been rebuilt by make_polyset().  The Geoms are
+ * appended to the geoms list, along with the state each should be added to
+ * the GeomNode with.
+ *
+ * This may be called from a JobPool thread, so it doesn't modify the scene
+ * graph.
+ */
+void EggLoader::
+build_polyset(EggBin *egg_bin, const EggRenderState *render_state,
+              EggVertexPools &vertex_pools, const LMatrix4d *transform,
+              bool is_dynamic, CharacterMaker *character_maker,
+              PolysetGeoms &geoms) {
   if (egg_mesh) {
     // If we're using the mesher, mesh now.
     egg_bin->mesh_triangles(render_state->_flat_shaded ? EggGroupNode::T_flat_shaded : 0);
@@ -344,8 +465,6 @@ make_polyset(EggBin *egg_bin, PandaNode *parent, const LMatrix4d *transform,
 
   // egg_bin->write(cerr, 0);
 
-  PT(GeomNode) geom_node;
-
   // Now iterate through each EggVertexPool.  Normally, there's only one, but
   // if we have a really big mesh, it might have been split into multiple
   // vertex pools (to keep each one within the egg_max_vertices constraint).
@@ -383,6 +502,7 @@ make_polyset(EggBin *egg_bin, PandaNode *parent, const LMatrix4d *transform,
     // of primitives that reference this vertex pool.
     UniquePrimitives unique_primitives;
     Primitives primitives;
+    EggGroupNode::const_iterator ci;
     for (ci = egg_bin->begin(); ci != egg_bin->end(); ++ci) {
       EggPrimitive *egg_prim;
       DCAST_INTO_V(egg_prim, (*ci));
@@ -426,24 +546,6 @@ make_polyset(EggBin *egg_bin, PandaNode *parent, const LMatrix4d *transform,
         // vertex_data->write(cerr); geom->write(cerr);
         // render_state->_state->write(cerr, 0);
 
-      // Create a new GeomNode if we haven't already.
-      if (geom_node == nullptr) {
-        // Now, is our parent node a GeomNode, or just an ordinary PandaNode?
-        // If it's a GeomNode, we can add the new Geom directly to our parent;
-        // otherwise, we need to create a new node.
-        if (parent->is_geom_node() && !render_state->_hidden) {
-          geom_node = DCAST(GeomNode, parent);
-
-        } else {
-          geom_node = new GeomNode(egg_bin->get_name());
-          if (render_state->_hidden) {
-            parent->add_stashed(geom_node);
-          } else {
-            parent->add_child(geom_node);
-          }
-        }
-      }
-
       CPT(RenderState) geom_state = render_state->_state;
       if (has_overall_color) {
         if (!overall_color.almost_equal(LColor(1.0f, 1.0f, 1.0f, 1.0f))) {
@@ -453,17 +555,102 @@ make_polyset(EggBin *egg_bin, PandaNode *parent, const LMatrix4d *transform,
         geom_state = geom_state->add_attrib(ColorAttrib::make_vertex(), -1);
       }
 
-      geom_node->add_geom(geom, geom_state);
+      geoms.push_back(PolysetGeoms::value_type(geom, geom_state));
     }
   }
+}
 
-  if (geom_node != nullptr && egg_show_normals) {
-    // Create some more geometry to visualize each normal.
-    for (vpi = vertex_pools.begin(); vpi != vertex_pools.end(); ++vpi) {
-      EggVertexPool *vertex_pool = (*vpi);
-      show_normals(vertex_pool, geom_node);
+/**
+ * Returns the GeomNode that the Geoms of the indicated polyset should be
+ * added to.  If the parent node is itself a GeomNode, this is the parent;
+ * otherwise, a new GeomNode is created and added to the parent.
+ */
+GeomNode *EggLoader::
+make_polyset_node(EggBin *egg_bin, PandaNode *parent,
+                  const EggRenderState *render_state) {
+  // Is our parent node a GeomNode, or just an ordinary PandaNode?  If it's a
+  // GeomNode, we can add the new Geom directly to our parent; otherwise, we
+  // need to create a new node.
+  if (parent->is_geom_node() && !render_state->_hidden) {
+    return DCAST(GeomNode, parent);
+  }
+
+  PT(GeomNode) geom_node = new GeomNode(egg_bin->get_name());
+  if (render_state->_hidden) {
+    parent->add_stashed(geom_node);
+  } else {
+    parent->add_child(geom_node);
+  }
+  return geom_node;
+}
+
+/**
+ * Builds the Geoms of all of the polysets that make_polyset() set aside,
+ * dividing them among the threads of the global JobPool, and then adds them
+ * to the scene graph in the order in which the polysets were encountered.
+ */
+void EggLoader::
+finish_polysets() {
+  if (_polyset_jobs.empty()) {
+    return;
+  }
+
+  {
+    JobPool::Batch batch(JobPool::get_global_ptr());
+    PolysetJobs::const_iterator ji;
+    for (ji = _polyset_jobs.begin(); ji != _polyset_jobs.end(); ++ji) {
+      if (!(*ji)->_is_built) {
+        batch.add_job(*ji);
+      }
     }
+    batch.wait();
   }
+
+  PolysetJobs::const_iterator ji;
+  for (ji = _polyset_jobs.begin(); ji != _polyset_jobs.end(); ++ji) {
+    PolysetJob *job = (*ji);
+    GeomNode *geom_node = job->_geom_node;
+
+    if (job->_geoms.empty()) {
+      // It turned out there was nothing to put in the GeomNode we made, so
+      // take it away again.
+      if (geom_node != job->_parent) {
+        int si = job->_parent->find_stashed(geom_node);
+        if (si >= 0) {
+          job->_parent->remove_stashed(si);
+        } else {
+          job->_parent->remove_child(geom_node);
+        }
+      }
+
+    } else {
+      PolysetGeoms::const_iterator gi;
+      for (gi = job->_geoms.begin(); gi != job->_geoms.end(); ++gi) {
+        geom_node->add_geom((*gi).first, (*gi).second);
+      }
+
+      if (egg_show_normals) {
+        EggVertexPools::const_iterator vpi;
+        for (vpi = job->_vertex_pools.begin(); vpi != job->_vertex_pools.end(); ++vpi) {
+          show_normals(*vpi, geom_node);
+        }
+      }
+    }
+
+    delete job;
+  }
+  _polyset_jobs.clear();
+  _polyset_job_nodes.clear();
+}
+
+/**
+ * Builds the Geoms for one polyset.
+ */
+void EggLoader::PolysetJob::
+do_job(Thread *current_thread) {
+  _loader->build_polyset(_egg_bin, _render_state, _vertex_pools,
+                         _has_transform ? &_transform : nullptr,
+                         false, nullptr, _geoms);
 }
 
 /**
@@ -2219,10 +2406,13 @@ make_vertex_data(const EggRenderState *render_state,
   vpt._bake_in_uvs = render_state->_bake_in_uvs;
   vpt._transform = transform;
 
-  VertexPoolData::iterator di;
-  di = _vertex_pool_data.find(vpt);
-  if (di != _vertex_pool_data.end()) {
-    return (*di).second;
+  {
+    LightMutexHolder holder(_vertex_pool_data_lock);
+    VertexPoolData::iterator di;
+    di = _vertex_pool_data.find(vpt);
+    if (di != _vertex_pool_data.end()) {
+      return (*di).second;
+    }
   }
 
   PT(GeomVertexArrayFormat) array_format = new GeomVertexArrayFormat;
@@ -2512,9 +2702,12 @@ make_vertex_data(const EggRenderState *render_state,
     }
   }
 
-  bool inserted = _vertex_pool_data.insert
-    (VertexPoolData::value_type(vpt, vertex_data)).second;
-  nassertr(inserted, vertex_data);
+  {
+    LightMutexHolder holder(_vertex_pool_data_lock);
+    bool inserted = _vertex_pool_data.insert
+      (VertexPoolData::value_type(vpt, vertex_data)).second;
+    nassertr(inserted, vertex_data);
+  }
 
   Thread::consider_yield();
   return vertex_data;
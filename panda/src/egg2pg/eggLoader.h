@@ -37,6 +37,8 @@
 #include "geomVertexData.h"
 #include "geomPrimitive.h"
 #include "bamCacheRecord.h"
+#include "lightMutex.h"
+#include "pset.h"
 
 class EggNode;
 class EggBin;
@@ -56,6 +58,7 @@ class OccluderNode;
 class PolylightNode;
 class EggRenderState;
 class CharacterMaker;
+class GeomNode;
 
 
 /**
@@ -107,6 +110,21 @@ private:
   typedef pmap<PrimitiveUnifier, PT(GeomPrimitive) > UniquePrimitives;
   typedef pvector< PT(GeomPrimitive) > Primitives;
 
+  // This is filled in by build_polyset().
+  typedef pvector<std::pair<PT(Geom), CPT(RenderState)> > PolysetGeoms;
+
+  // A polyset whose geometry is being built on the JobPool.
+  class PolysetJob;
+  typedef pvector<PolysetJob *> PolysetJobs;
+
+  void build_polyset(EggBin *egg_bin, const EggRenderState *render_state,
+                     EggVertexPools &vertex_pools, const LMatrix4d *transform,
+                     bool is_dynamic, CharacterMaker *character_maker,
+                     PolysetGeoms &geoms);
+  GeomNode *make_polyset_node(EggBin *egg_bin, PandaNode *parent,
+                              const EggRenderState *render_state);
+  void finish_polysets();
+
   void show_normals(EggVertexPool *vertex_pool, GeomNode *geom_node);
 
   void make_nurbs_curve(EggNurbsCurve *egg_curve, PandaNode *parent,
@@ -249,6 +267,13 @@ private:
   };
   typedef pmap<VertexPoolTransform, PT(GeomVertexData) > VertexPoolData;
   VertexPoolData _vertex_pool_data;
+  LightMutex _vertex_pool_data_lock;
+
+  PolysetJobs _polyset_jobs;
+
+  // The existing GeomNodes that some of the _polyset_jobs add Geoms to.
+  typedef pset<GeomNode *> PolysetJobNodes;
+  PolysetJobNodes _polyset_job_nodes;
 
   typedef pmap<LMatrix4, CPT(TransformState) > TransformStates;
   TransformStates _transform_states;
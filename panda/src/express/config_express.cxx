@@ -14,6 +14,7 @@
 #include "config_express.h"
 #include "datagram.h"
 #include "datagramIterator.h"
+#include "memoryMappedFile.h"
 #include "nodeReferenceCount.h"
 #include "referenceCount.h"
 #include "textEncoder.h"
@@ -102,6 +103,7 @@ init_libexpress() {
 
   Datagram::init_type();
   DatagramIterator::init_type();
+  MemoryMappedFile::init_type();
   Namable::init_type();
   NodeReferenceCount::init_type();
   ReferenceCount::init_type();
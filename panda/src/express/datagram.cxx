@@ -34,6 +34,9 @@ Datagram::
 void Datagram::
 clear() {
   _data.clear();
+  _external_data = nullptr;
+  _external_size = 0;
+  _external_owner.clear();
 }
 
 /**
@@ -99,7 +102,10 @@ void Datagram::
 pad_bytes(size_t size) {
   nassertv((int)size >= 0);
 
-  if (_data == nullptr) {
+  if (_external_data != nullptr) {
+    copy_external();
+
+  } else if (_data == nullptr) {
     // Create a new array.
     _data = PTA_uchar::empty_array(0);
 
@@ -129,7 +135,10 @@ void Datagram::
 append_data(const void *data, size_t size) {
   nassertv((int)size >= 0);
 
-  if (_data == nullptr) {
+  if (_external_data != nullptr) {
+    copy_external();
+
+  } else if (_data == nullptr) {
     // Create a new array.
     _data = PTA_uchar::empty_array(0);
 
@@ -162,6 +171,42 @@ assign(const void *data, size_t size) {
   _data = PTA_uchar::empty_array(0);
   _data.v().insert(_data.v().end(), (const unsigned char *)data,
                    (const unsigned char *)data + size);
+  _external_data = nullptr;
+  _external_size = 0;
+  _external_owner.clear();
+}
+
+/**
+ * Replaces the datagram's data with the indicated block, without copying it.
+ * The datagram refers to the block in place, and holds a reference to the
+ * indicated owner, which must keep the block valid and unchanged for as long
+ * as it exists.  The block is copied into the datagram only if the datagram
+ * is subsequently modified.
+ *
+ * This is used to read datagrams from a memory-mapped file, with the
+ * MemoryMappedFile as the owner.
+ */
+void Datagram::
+assign_external(const void *data, size_t size, ReferenceCount *owner) {
+  nassertv(data != nullptr && owner != nullptr);
+
+  _data.clear();
+  _external_data = (const unsigned char *)data;
+  _external_size = size;
+  _external_owner = owner;
+}
+
+/**
+ * Copies the external block referred to by the datagram into the datagram's
+ * own array, so that it may be modified.
+ */
+void Datagram::
+copy_external() {
+  _data = PTA_uchar::empty_array(0);
+  _data.v().assign(_external_data, _external_data + _external_size);
+  _external_data = nullptr;
+  _external_size = 0;
+  _external_owner.clear();
 }
 
 /**
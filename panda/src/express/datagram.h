@@ -21,6 +21,8 @@
 #include "littleEndian.h"
 #include "bigEndian.h"
 #include "pta_uchar.h"
+#include "referenceCount.h"
+#include "pointerTo.h"
 
 /**
  * An ordered list of data elements, formatted in memory for transmission over
@@ -41,11 +43,11 @@ PUBLISHED:
   INLINE Datagram(const void *data, size_t size);
   INLINE explicit Datagram(vector_uchar data);
   Datagram(const Datagram &copy) = default;
-  Datagram(Datagram &&from) noexcept = default;
+  INLINE Datagram(Datagram &&from) noexcept;
   virtual ~Datagram();
 
   Datagram &operator = (const Datagram &copy) = default;
-  Datagram &operator = (Datagram &&from) noexcept = default;
+  INLINE Datagram &operator = (Datagram &&from) noexcept;
 
   virtual void clear();
   void dump_hex(std::ostream &out, unsigned int indent=0) const;
@@ -90,6 +92,8 @@ PUBLISHED:
 
 public:
   void assign(const void *data, size_t size);
+  void assign_external(const void *data, size_t size, ReferenceCount *owner);
+  INLINE bool is_external() const;
 
   INLINE std::string get_message() const;
   INLINE const void *get_data() const;
@@ -117,8 +121,16 @@ PUBLISHED:
   void write(std::ostream &out, unsigned int indent=0) const;
 
 private:
+  void copy_external();
+
   PTA_uchar _data;
 
+  // If this is set, the contents are not in _data but in a block of memory
+  // belonging to _external_owner; see assign_external().
+  const unsigned char *_external_data = nullptr;
+  size_t _external_size = 0;
+  PT(ReferenceCount) _external_owner;
+
 #ifdef STDFLOAT_DOUBLE
   bool _stdfloat_double = true;
 #else
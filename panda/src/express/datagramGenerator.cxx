@@ -90,3 +90,24 @@ std::streampos DatagramGenerator::
 get_file_pos() {
   return 0;
 }
+
+/**
+ * Returns the memory-mapped file that the datagrams are being read from, if
+ * any, or NULL if the source is not mapped.
+ */
+MemoryMappedFile *DatagramGenerator::
+get_mapped_file() {
+  return nullptr;
+}
+
+/**
+ * If the datagram most recently returned by get_datagram() was read from a
+ * memory-mapped file, returns a pointer to the first byte of its contents
+ * within the mapping (see get_mapped_file()).  The contents at this location
+ * are identical to those of the datagram.  Returns NULL if the datagram is not
+ * available in place.
+ */
+const unsigned char *DatagramGenerator::
+get_mapped_datagram() {
+  return nullptr;
+}
@@ -22,6 +22,7 @@ class SubfileInfo;
 class FileReference;
 class Filename;
 class VirtualFile;
+class MemoryMappedFile;
 
 /**
  * This class defines the abstract interace to any source of datagrams,
@@ -42,6 +43,10 @@ PUBLISHED:
   virtual const FileReference *get_file();
   virtual VirtualFile *get_vfile();
   virtual std::streampos get_file_pos();
+
+public:
+  virtual MemoryMappedFile *get_mapped_file();
+  virtual const unsigned char *get_mapped_datagram();
 };
 
 #include "datagramGenerator.I"
@@ -0,0 +1,212 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file memoryMappedFile.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#include "memoryMappedFile.h"
+#include "config_express.h"
+#include "memoryHook.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN 1
+#endif
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif  // _WIN32
+
+TypeHandle MemoryMappedFile::_type_handle;
+
+/**
+ *
+ */
+MemoryMappedFile::
+~MemoryMappedFile() {
+  unmap();
+}
+
+/**
+ * Maps the indicated region of the named file.  If size is 0, the region
+ * extends to the end of the file.  Any previously mapped region is unmapped
+ * first.  Returns true on success, false on failure.
+ */
+bool MemoryMappedFile::
+map_file(const Filename &filename, size_t offset, size_t size) {
+  unmap();
+
+  Filename fn = Filename::binary_filename(filename);
+  bool success = false;
+
+#ifdef _WIN32
+  std::wstring os_specific = fn.to_os_specific_w();
+  HANDLE handle = CreateFileW(os_specific.c_str(), GENERIC_READ,
+                              FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (handle == INVALID_HANDLE_VALUE) {
+    express_cat.error()
+      << "Unable to open " << fn << " for mapping.\n";
+    return false;
+  }
+
+  LARGE_INTEGER file_size;
+  if (GetFileSizeEx(handle, &file_size) &&
+      offset <= (size_t)file_size.QuadPart) {
+    if (size == 0) {
+      size = (size_t)file_size.QuadPart - offset;
+    }
+    success = map_handle(handle, offset, size);
+  }
+  CloseHandle(handle);
+
+#else
+  std::string os_specific = fn.to_os_specific();
+  int fd = ::open(os_specific.c_str(), O_RDONLY);
+  if (fd == -1) {
+    express_cat.error()
+      << "Unable to open " << fn << " for mapping.\n";
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) == 0 && offset <= (size_t)st.st_size) {
+    if (size == 0) {
+      size = (size_t)st.st_size - offset;
+    }
+    success = map_fd(fd, offset, size);
+  }
+
+  // The mapping keeps its own reference to the file.
+  close(fd);
+#endif  // _WIN32
+
+  if (success) {
+    _filename = filename;
+  }
+  return success;
+}
+
+/**
+ * Releases the mapped region, if any.  Any pointers returned by get_data()
+ * become invalid.
+ */
+void MemoryMappedFile::
+unmap() {
+  if (_map_base != nullptr) {
+#ifdef _WIN32
+    UnmapViewOfFile(_map_base);
+#else
+    munmap(_map_base, _map_size);
+#endif
+    _map_base = nullptr;
+    _map_size = 0;
+  }
+
+  _filename = Filename();
+  _data = nullptr;
+  _offset = 0;
+  _size = 0;
+}
+
+#ifdef _WIN32
+/**
+ * Maps the indicated region of a file that has already been opened for
+ * reading.  The handle may be closed again afterwards.  Returns true on
+ * success, false on failure.
+ */
+bool MemoryMappedFile::
+map_handle(void *handle, size_t offset, size_t size) {
+  unmap();
+  if (size == 0) {
+    return false;
+  }
+
+  HANDLE mapping = CreateFileMapping((HANDLE)handle, nullptr, PAGE_READONLY,
+                                     0, 0, nullptr);
+  if (mapping == nullptr) {
+    express_cat.error()
+      << "Unable to map file, windows error code 0x" << std::hex
+      << GetLastError() << std::dec << ".\n";
+    return false;
+  }
+
+  size_t delta = offset % get_granularity();
+  uint64_t map_offset = (uint64_t)(offset - delta);
+  void *ptr = MapViewOfFile(mapping, FILE_MAP_READ,
+                            (DWORD)(map_offset >> 32), (DWORD)map_offset,
+                            size + delta);
+
+  // The view keeps the mapping object alive.
+  CloseHandle(mapping);
+
+  if (ptr == nullptr) {
+    express_cat.error()
+      << "Unable to map " << size << " bytes of file, windows error code 0x"
+      << std::hex << GetLastError() << std::dec << ".\n";
+    return false;
+  }
+
+  _map_base = ptr;
+  _map_size = size + delta;
+  _data = (const unsigned char *)ptr + delta;
+  _offset = offset;
+  _size = size;
+  return true;
+}
+
+#else  // _WIN32
+/**
+ * Maps the indicated region of a file that has already been opened for
+ * reading.  The file descriptor may be closed again afterwards.  Returns true
+ * on success, false on failure.
+ */
+bool MemoryMappedFile::
+map_fd(int fd, size_t offset, size_t size) {
+  unmap();
+  if (size == 0) {
+    return false;
+  }
+
+  size_t delta = offset % get_granularity();
+  void *ptr = mmap(nullptr, size + delta, PROT_READ, MAP_SHARED, fd,
+                   (off_t)(offset - delta));
+  if (ptr == MAP_FAILED) {
+    express_cat.error()
+      << "Unable to map " << size << " bytes of file.\n";
+    return false;
+  }
+
+  _map_base = ptr;
+  _map_size = size + delta;
+  _data = (const unsigned char *)ptr + delta;
+  _offset = offset;
+  _size = size;
+  return true;
+}
+#endif  // _WIN32
+
+/**
+ * Returns the multiple at which a mapped region of a file must start.
+ */
+size_t MemoryMappedFile::
+get_granularity() {
+#ifdef _WIN32
+  SYSTEM_INFO sysinfo;
+  GetSystemInfo(&sysinfo);
+  return (size_t)sysinfo.dwAllocationGranularity;
+#else
+  return memory_hook->get_page_size();
+#endif
+}
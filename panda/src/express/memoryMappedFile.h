@@ -0,0 +1,86 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file memoryMappedFile.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef MEMORYMAPPEDFILE_H
+#define MEMORYMAPPEDFILE_H
+
+#include "pandabase.h"
+#include "referenceCount.h"
+#include "filename.h"
+
+/**
+ * A read-only view of a region of a file on disk, mapped into the address
+ * space of the process.  The pages of the region are read in by the operating
+ * system on first access, and may be discarded by it again at any time, since
+ * they can always be reread from the file.
+ *
+ * The mapping remains valid for as long as this object exists, even if the
+ * file is closed, but it is undefined what is seen if the region of the file
+ * is modified in the meantime.  Writing to the mapped memory is not allowed.
+ */
+class EXPCL_PANDA_EXPRESS MemoryMappedFile : public ReferenceCount {
+PUBLISHED:
+  INLINE MemoryMappedFile();
+  ~MemoryMappedFile();
+
+  bool map_file(const Filename &filename, size_t offset = 0, size_t size = 0);
+  void unmap();
+
+  INLINE bool is_mapped() const;
+  INLINE const Filename &get_filename() const;
+  INLINE size_t get_offset() const;
+  INLINE size_t get_size() const;
+
+  MAKE_PROPERTY(filename, get_filename);
+  MAKE_PROPERTY(offset, get_offset);
+  MAKE_PROPERTY(size, get_size);
+
+public:
+#ifdef _WIN32
+  bool map_handle(void *handle, size_t offset, size_t size);
+#else
+  bool map_fd(int fd, size_t offset, size_t size);
+#endif
+
+  INLINE const unsigned char *get_data() const;
+
+private:
+  static size_t get_granularity();
+
+  Filename _filename;
+  size_t _offset;
+  size_t _size;
+  const unsigned char *_data;
+
+  // The actual mapping starts at a multiple of the mapping granularity, which
+  // may be somewhat before _data.
+  void *_map_base;
+  size_t _map_size;
+
+public:
+  static TypeHandle get_class_type() {
+    return _type_handle;
+  }
+  static void init_type() {
+    ReferenceCount::init_type();
+    register_type(_type_handle, "MemoryMappedFile",
+                  ReferenceCount::get_class_type());
+  }
+
+private:
+  static TypeHandle _type_handle;
+};
+
+#include "memoryMappedFile.I"
+
+#endif
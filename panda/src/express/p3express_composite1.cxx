@@ -14,6 +14,7 @@
 #include "hashGeneratorBase.cxx"
 #include "hashVal.cxx"
 #include "memoryInfo.cxx"
+#include "memoryMappedFile.cxx"
 #include "memoryUsage.cxx"
 #include "memoryUsagePointerCounts.cxx"
 #include "memoryUsagePointers.cxx"
@@ -0,0 +1,56 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file animateVerticesBatch.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#include "animateVerticesBatch.h"
+
+/**
+ *
+ */
+AnimateVerticesBatch::
+AnimateVerticesBatch() {
+}
+
+/**
+ * Calls animate_vertices() on each of the GeomVertexData objects that have
+ * been added, and waits for all of them to finish.  The objects are animated
+ * in parallel by the global JobPool, with the calling thread lending a hand.
+ *
+ * The meaning of force is the same as for GeomVertexData::animate_vertices().
+ */
+void AnimateVerticesBatch::
+animate(bool force, Thread *current_thread) {
+  JobPool *pool = JobPool::get_global_ptr();
+  if (_datas.size() < 2 || pool->get_num_threads() == 0) {
+    for (const GeomVertexData *data : _datas) {
+      data->animate_vertices(force, current_thread);
+    }
+    return;
+  }
+
+  pvector<AnimateJob> jobs(_datas.size());
+  JobPool::Batch batch(pool, current_thread);
+  for (size_t i = 0; i < _datas.size(); ++i) {
+    jobs[i]._data = _datas[i];
+    jobs[i]._force = force;
+    batch.add_job(&jobs[i]);
+  }
+  batch.wait();
+}
+
+/**
+ *
+ */
+void AnimateVerticesBatch::AnimateJob::
+do_job(Thread *current_thread) {
+  _data->animate_vertices(_force, current_thread);
+}
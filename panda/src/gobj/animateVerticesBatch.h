@@ -0,0 +1,66 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file animateVerticesBatch.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef ANIMATEVERTICESBATCH_H
+#define ANIMATEVERTICESBATCH_H
+
+#include "pandabase.h"
+
+#include "referenceCount.h"
+#include "geomVertexData.h"
+#include "jobPool.h"
+#include "pointerTo.h"
+#include "pvector.h"
+
+/**
+ * This class collects a number of GeomVertexData objects and calls
+ * animate_vertices() on all of them at once, spreading the work over the
+ * threads of the global JobPool.  This is the synchronous counterpart of
+ * AnimateVerticesRequest: it is useful when there are many CPU-animated
+ * models in the scene, for instance with a software renderer or in a
+ * headless simulation, and the animation is to be computed up front each
+ * frame.
+ *
+ * As with AnimateVerticesRequest, the results are cached on each
+ * GeomVertexData, so that a subsequent call to animate_vertices() during the
+ * cull traversal will simply return them.
+ */
+class EXPCL_PANDA_GOBJ AnimateVerticesBatch : public ReferenceCount {
+PUBLISHED:
+  AnimateVerticesBatch();
+
+  INLINE void add_data(const GeomVertexData *data);
+  INLINE size_t get_num_datas() const;
+  INLINE const GeomVertexData *get_data(size_t n) const;
+  MAKE_SEQ(get_datas, get_num_datas, get_data);
+  INLINE void clear_datas();
+
+  BLOCKING void animate(bool force,
+                        Thread *current_thread = Thread::get_current_thread());
+
+private:
+  class AnimateJob : public JobPool::Job {
+  public:
+    virtual void do_job(Thread *current_thread);
+
+    CPT(GeomVertexData) _data;
+    bool _force;
+  };
+
+  typedef pvector<CPT(GeomVertexData)> Datas;
+  Datas _datas;
+};
+
+#include "animateVerticesBatch.I"
+
+#endif
@@ -447,6 +447,17 @@ ConfigVariableInt vertex_data_page_threads
           "is 0, this work will be done in the main thread, which may "
           "introduce occasional random chugs in rendering."));
 
+ConfigVariableBool vertex_data_mmap
+("vertex-data-mmap", false,
+ PRC_DESC("Set this true to evict vertex pages by writing them to the "
+          "vertex save file once and mapping them back read-only from it, "
+          "instead of compressing them or reading them back into memory.  "
+          "A mapped page can be rendered from directly; its memory is "
+          "managed by the operating system, which may drop it whenever "
+          "memory is needed and read it back from the file on demand.  "
+          "This keeps the memory use of very large static scenes bounded "
+          "without paying for a copy each time a page is restored."));
+
 ConfigVariableInt graphics_memory_limit
 ("graphics-memory-limit", -1,
  PRC_DESC("This is a default limit that is imposed on each GSG at "
@@ -927,6 +927,76 @@ make_adjacency_in_place() {
   nassertv(all_is_valid);
 }
 
+/**
+ * Reorders the triangles of each primitive within this Geom for better use of
+ * a post-transform vertex cache with the indicated number of entries, leaving
+ * the results in place.  Triangle strips and fans are decomposed into
+ * triangles.  See GeomPrimitive::optimize_vertex_cache().
+ *
+ * This does not change the order of the vertices in the GeomVertexData, which
+ * may be shared with other Geoms; SceneGraphReducer::optimize_vertex_cache()
+ * does that as well.
+ *
+ * Don't call this in a downstream thread unless you don't mind it blowing
+ * away other changes you might have recently made in an upstream thread.
+ */
+void Geom::
+optimize_vertex_cache_in_place(int cache_size) {
+  Thread *current_thread = Thread::get_current_thread();
+  CDWriter cdata(_cycler, true, current_thread);
+
+#ifndef NDEBUG
+  GeomVertexDataPipelineReader data_reader(cdata->_data.get_read_pointer(current_thread), current_thread);
+  data_reader.check_array_readers();
+
+  bool all_is_valid = true;
+#endif
+  Primitives::iterator pi;
+  for (pi = cdata->_primitives.begin(); pi != cdata->_primitives.end(); ++pi) {
+    CPT(GeomPrimitive) new_prim = (*pi).get_read_pointer(current_thread)->optimize_vertex_cache(cache_size);
+    (*pi) = (GeomPrimitive *)new_prim.p();
+
+#ifndef NDEBUG
+    if (!new_prim->check_valid(&data_reader)) {
+      all_is_valid = false;
+    }
+#endif
+  }
+
+  cdata->_modified = Geom::get_next_modified();
+  reset_geom_rendering(cdata);
+  clear_cache_stage(current_thread);
+
+  nassertv(all_is_valid);
+}
+
+/**
+ * Returns the average cache miss ratio (ACMR) over all of the triangles in
+ * this Geom, assuming a FIFO post-transform vertex cache with the indicated
+ * number of entries.  This is the average number of vertices that have to be
+ * transformed per triangle; lower is better.  Returns 0 if the Geom contains
+ * no triangles.  See GeomPrimitive::calc_acmr().
+ */
+PN_stdfloat Geom::
+calc_acmr(int cache_size) const {
+  Thread *current_thread = Thread::get_current_thread();
+  CDReader cdata(_cycler, current_thread);
+
+  int num_misses = 0;
+  int num_triangles = 0;
+  Primitives::const_iterator pi;
+  for (pi = cdata->_primitives.begin(); pi != cdata->_primitives.end(); ++pi) {
+    int prim_triangles;
+    num_misses += (*pi).get_read_pointer(current_thread)->calc_num_cache_misses(cache_size, prim_triangles);
+    num_triangles += prim_triangles;
+  }
+
+  if (num_triangles == 0) {
+    return 0;
+  }
+  return (PN_stdfloat)num_misses / (PN_stdfloat)num_triangles;
+}
+
 /**
  * Copies the primitives from the indicated Geom into this one.  This does
  * require that both Geoms contain the same fundamental type primitives, both
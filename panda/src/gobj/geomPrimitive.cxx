@@ -34,6 +34,37 @@
 using std::max;
 using std::min;
 
+/**
+ * Returns the score of a vertex for the vertex cache optimization performed
+ * by GeomPrimitive::optimize_vertex_cache(), given its position in the
+ * simulated LRU cache (or -1 if it is not in the cache) and the number of
+ * triangles still to be added that use it.
+ */
+static float
+calc_vertex_cache_score(int cache_pos, int remaining, int cache_size) {
+  if (remaining == 0) {
+    // No triangles left to add, so this vertex doesn't matter any more.
+    return -1.0f;
+  }
+
+  float score = 0.0f;
+  if (cache_pos >= 0) {
+    if (cache_pos < 3) {
+      // This vertex was used by the last triangle.  Give it a fixed score, so
+      // that it doesn't matter which of the three vertices we continue from.
+      score = 0.75f;
+    } else {
+      score = 1.0f - (float)(cache_pos - 3) / (float)(cache_size - 3);
+      score = cpow(score, 1.5f);
+    }
+  }
+
+  // Boost vertices with few triangles left, so that we don't leave behind
+  // lone triangles that will have to be added later on.
+  score += 2.0f / csqrt((float)remaining);
+  return score;
+}
+
 TypeHandle GeomPrimitive::_type_handle;
 TypeHandle GeomPrimitive::CData::_type_handle;
 TypeHandle GeomPrimitivePipelineReader::_type_handle;
@@ -1049,6 +1080,200 @@ make_adjacency() const {
   return nullptr;
 }
 
+/**
+ * Returns a new primitive with the same triangles as this one, reordered to
+ * make better use of a post-transform vertex cache with the indicated number
+ * of entries.  This uses Tom Forsyth's linear-speed vertex cache optimization
+ * algorithm.  Triangle strips and fans are decomposed into triangles first.
+ *
+ * The order of the vertices within each triangle is preserved, so that the
+ * winding order and the provoking vertex for flat shading are unaffected.
+ * Only the order of the indices is changed; see
+ * SceneGraphReducer::optimize_vertex_cache() to also reorder the vertices.
+ *
+ * If the primitive does not consist of indexed triangles, this returns the
+ * original object.
+ */
+CPT(GeomPrimitive) GeomPrimitive::
+optimize_vertex_cache(int cache_size) const {
+  nassertr(cache_size > 3, this);
+
+  if (get_primitive_type() != PT_polygons) {
+    return this;
+  }
+
+  if (!is_exact_type(GeomTriangles::get_class_type())) {
+    CPT(GeomPrimitive) prim = decompose();
+    if (!prim->is_exact_type(GeomTriangles::get_class_type())) {
+      // Probably a primitive with adjacency information.
+      return this;
+    }
+    return prim->optimize_vertex_cache(cache_size);
+  }
+
+  if (!is_indexed()) {
+    return this;
+  }
+
+  int num_triangles = get_num_vertices() / 3;
+  if (num_triangles < 2) {
+    return this;
+  }
+
+  pvector<int> indices(num_triangles * 3);
+  int num_rows = 0;
+  {
+    GeomVertexReader index(get_vertices(), 0);
+    for (int i = 0; i < num_triangles * 3; ++i) {
+      indices[i] = index.get_data1i();
+      num_rows = max(num_rows, indices[i] + 1);
+    }
+  }
+
+  // For each vertex, build the list of triangles that still need to be
+  // emitted.  The first remaining[v] entries of the vertex's span in
+  // vertex_tris are the triangles that have not yet been added.
+  pvector<int> vertex_start(num_rows + 1, 0);
+  for (int i = 0; i < num_triangles * 3; ++i) {
+    ++vertex_start[indices[i] + 1];
+  }
+  for (int v = 0; v < num_rows; ++v) {
+    vertex_start[v + 1] += vertex_start[v];
+  }
+  pvector<int> remaining(num_rows, 0);
+  pvector<int> vertex_tris(num_triangles * 3);
+  for (int i = 0; i < num_triangles * 3; ++i) {
+    int v = indices[i];
+    vertex_tris[vertex_start[v] + remaining[v]] = i / 3;
+    ++remaining[v];
+  }
+
+  pvector<int> cache_pos(num_rows, -1);
+  pvector<float> vertex_score(num_rows);
+  for (int v = 0; v < num_rows; ++v) {
+    vertex_score[v] = calc_vertex_cache_score(-1, remaining[v], cache_size);
+  }
+
+  pvector<bool> tri_added(num_triangles, false);
+  int best_tri = 0;
+  float best_score = -1.0f;
+  for (int t = 0; t < num_triangles; ++t) {
+    const int *tri = &indices[t * 3];
+    float score = vertex_score[tri[0]] + vertex_score[tri[1]] + vertex_score[tri[2]];
+    if (score > best_score) {
+      best_tri = t;
+      best_score = score;
+    }
+  }
+
+  PT(GeomVertexArrayData) new_vertices = make_index_data();
+  new_vertices->unclean_set_num_rows(num_triangles * 3);
+  GeomVertexWriter new_index(new_vertices, 0);
+
+  pvector<int> cache, new_cache;
+  cache.reserve(cache_size + 3);
+  new_cache.reserve(cache_size + 3);
+  int next_tri = 0;
+
+  for (int n = 0; n < num_triangles; ++n) {
+    if (best_tri < 0) {
+      // None of the vertices in the cache have any triangles left.  Start
+      // again with the next triangle in the original order.
+      while (tri_added[next_tri]) {
+        ++next_tri;
+      }
+      best_tri = next_tri;
+    }
+
+    const int *tri = &indices[best_tri * 3];
+    tri_added[best_tri] = true;
+    new_cache.clear();
+    for (int k = 0; k < 3; ++k) {
+      int v = tri[k];
+      new_index.set_data1i(v);
+      if (std::find(new_cache.begin(), new_cache.end(), v) != new_cache.end()) {
+        // A degenerate triangle.
+        continue;
+      }
+      new_cache.push_back(v);
+
+      int *begin = &vertex_tris[vertex_start[v]];
+      int count = remaining[v];
+      for (int j = 0; j < count;) {
+        if (begin[j] == best_tri) {
+          begin[j] = begin[--count];
+        } else {
+          ++j;
+        }
+      }
+      remaining[v] = count;
+    }
+
+    size_t num_new = new_cache.size();
+    for (int v : cache) {
+      if (std::find(new_cache.begin(), new_cache.begin() + num_new, v) == new_cache.begin() + num_new) {
+        new_cache.push_back(v);
+      }
+    }
+
+    // Vertices that fell out of the end of the cache lose their cache bonus.
+    for (size_t i = cache_size; i < new_cache.size(); ++i) {
+      int v = new_cache[i];
+      cache_pos[v] = -1;
+      vertex_score[v] = calc_vertex_cache_score(-1, remaining[v], cache_size);
+    }
+    if (new_cache.size() > (size_t)cache_size) {
+      new_cache.resize(cache_size);
+    }
+
+    for (size_t i = 0; i < new_cache.size(); ++i) {
+      int v = new_cache[i];
+      cache_pos[v] = (int)i;
+      vertex_score[v] = calc_vertex_cache_score((int)i, remaining[v], cache_size);
+    }
+
+    // The next triangle is the best-scoring one that touches the cache.
+    best_tri = -1;
+    best_score = -1.0f;
+    for (int v : new_cache) {
+      const int *begin = &vertex_tris[vertex_start[v]];
+      for (int j = 0; j < remaining[v]; ++j) {
+        const int *tri = &indices[begin[j] * 3];
+        float score = vertex_score[tri[0]] + vertex_score[tri[1]] + vertex_score[tri[2]];
+        if (score > best_score) {
+          best_tri = begin[j];
+          best_score = score;
+        }
+      }
+    }
+
+    cache.swap(new_cache);
+  }
+
+  PT(GeomPrimitive) new_prim = make_copy();
+  new_prim->set_vertices(new_vertices);
+  return new_prim;
+}
+
+/**
+ * Returns the average cache miss ratio (ACMR) of this primitive: the average
+ * number of vertices that need to be transformed per triangle, assuming a
+ * FIFO post-transform vertex cache with the indicated number of entries.
+ * Lower is better; the theoretical minimum is about 0.5 for a regular mesh,
+ * and the worst case is 3.0.
+ *
+ * Returns 0 if the primitive does not contain any triangles.
+ */
+PN_stdfloat GeomPrimitive::
+calc_acmr(int cache_size) const {
+  int num_triangles = 0;
+  int num_misses = calc_num_cache_misses(cache_size, num_triangles);
+  if (num_triangles == 0) {
+    return 0;
+  }
+  return (PN_stdfloat)num_misses / (PN_stdfloat)num_triangles;
+}
+
 /**
  * Returns the number of bytes consumed by the primitive and its index
  * table(s).
@@ -1803,6 +2028,54 @@ calc_sphere_radius(const LPoint3 &center, PN_stdfloat &sq_radius,
   }
 }
 
+/**
+ * Simulates a FIFO post-transform vertex cache with the indicated number of
+ * entries over the triangles of this primitive, and returns the number of
+ * cache misses.  num_triangles is filled in with the number of triangles that
+ * were considered.  See calc_acmr().
+ */
+int GeomPrimitive::
+calc_num_cache_misses(int cache_size, int &num_triangles) const {
+  num_triangles = 0;
+  if (get_primitive_type() != PT_polygons) {
+    return 0;
+  }
+
+  if (!is_exact_type(GeomTriangles::get_class_type())) {
+    CPT(GeomPrimitive) prim = decompose();
+    if (!prim->is_exact_type(GeomTriangles::get_class_type())) {
+      return 0;
+    }
+    return prim->calc_num_cache_misses(cache_size, num_triangles);
+  }
+
+  int num_vertices = get_num_vertices();
+  num_triangles = num_vertices / 3;
+  if (num_triangles == 0) {
+    return 0;
+  }
+
+  // A vertex is in the cache if fewer than cache_size misses have occurred
+  // since it was last loaded.
+  pvector<int> loaded(get_max_vertex() + 1, -cache_size - 1);
+  int num_misses = 0;
+
+  if (is_indexed()) {
+    GeomVertexReader index(get_vertices(), 0);
+    for (int i = 0; i < num_triangles * 3; ++i) {
+      int v = index.get_data1i();
+      if (num_misses - loaded[v] > cache_size) {
+        loaded[v] = num_misses++;
+      }
+    }
+  } else {
+    // Every vertex of a nonindexed primitive is transformed anew.
+    num_misses = num_triangles * 3;
+  }
+
+  return num_misses;
+}
+
 /**
  * Decomposes a complex primitive type into a simpler primitive type, for
  * instance triangle strips to triangles, and returns a pointer to the new
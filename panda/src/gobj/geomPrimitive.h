@@ -135,6 +135,9 @@ PUBLISHED:
   CPT(GeomPrimitive) make_lines() const;
   CPT(GeomPrimitive) make_patches() const;
   virtual CPT(GeomPrimitive) make_adjacency() const;
+  CPT(GeomPrimitive) optimize_vertex_cache(int cache_size = 32) const;
+
+  PN_stdfloat calc_acmr(int cache_size = 32) const;
 
   int get_num_bytes() const;
   INLINE int get_data_size_bytes() const;
@@ -232,6 +235,8 @@ public:
                           const GeomVertexData *vertex_data,
                           Thread *current_thread) const;
 
+  int calc_num_cache_misses(int cache_size, int &num_triangles) const;
+
 protected:
   virtual CPT(GeomPrimitive) decompose_impl() const;
   virtual CPT(GeomVertexArrayData) rotate_impl() const;
@@ -311,6 +311,7 @@ lru_epoch() {
   _independent_lru.begin_epoch();
   VertexDataPage::get_global_lru(VertexDataPage::RC_resident)->begin_epoch();
   VertexDataPage::get_global_lru(VertexDataPage::RC_compressed)->begin_epoch();
+  VertexDataPage::get_global_lru(VertexDataPage::RC_mapped)->begin_epoch();
 }
 
 /**
@@ -528,6 +529,15 @@ write_datagram(BamWriter *manager, Datagram &dg, void *extra_data) const {
 
   dg.add_uint32(_buffer.get_size());
 
+  if (manager->get_file_minor_ver() >= 46) {
+    // Pad the data so that it begins on an aligned boundary within the file,
+    // which allows it to be used in place if the file is mapped when read.
+    size_t padding =
+      manager->get_alignment_padding(dg.get_length() + 1, MEMORY_HOOK_ALIGNMENT);
+    dg.add_uint8(padding);
+    dg.pad_bytes(padding);
+  }
+
   if (manager->get_file_endian() == BamWriter::BE_native) {
     // For native endianness, we only have to write the data directly.
     dg.append_data(_buffer.get_read_pointer(true), _buffer.get_size());
@@ -560,12 +570,31 @@ fillin(DatagramIterator &scan, BamReader *manager, void *extra_data) {
   } else {
     // Now, the array data is just stored directly.
     size_t size = scan.get_uint32();
-    _buffer.unclean_realloc(size);
-    _buffer.set_size(size);
+    if (manager->get_file_minor_ver() >= 46) {
+      scan.skip_bytes(scan.get_uint8());
+    }
+
+    // If the bam file is mapped into memory, and the data is suitably
+    // aligned within it, we can refer to it in place instead of copying it.
+    PT(MemoryMappedFile) mapping;
+    const unsigned char *mapped_data = nullptr;
+    if (size != 0 && size <= scan.get_remaining_size() &&
+        manager->get_file_endian() == BamReader::BE_native) {
+      mapped_data = manager->get_mapped_pointer(scan, mapping);
+    }
 
-    const unsigned char *source_data =
-      (const unsigned char *)scan.get_datagram().get_data();
-    memcpy(_buffer.get_write_pointer(), source_data + scan.get_current_index(), size);
+    if (mapped_data != nullptr &&
+        ((uintptr_t)mapped_data % MEMORY_HOOK_ALIGNMENT) == 0) {
+      _buffer.set_mapped_data(mapping, mapped_data, size);
+
+    } else {
+      _buffer.unclean_realloc(size);
+      _buffer.set_size(size);
+
+      const unsigned char *source_data =
+        (const unsigned char *)scan.get_datagram().get_data();
+      memcpy(_buffer.get_write_pointer(), source_data + scan.get_current_index(), size);
+    }
     scan.skip_bytes(size);
   }
 
@@ -295,6 +295,8 @@ PUBLISHED:
   MAKE_PROPERTY(modified, get_modified);
 
   INLINE bool request_resident() const;
+  INLINE bool is_mapped() const;
+  MAKE_PROPERTY(mapped, is_mapped);
 
   INLINE VertexBufferContext *prepare_now(PreparedGraphicsObjects *prepared_objects,
                                           GraphicsStateGuardianBase *gsg) const;
@@ -22,6 +22,11 @@
 #include "pset.h"
 #include "indent.h"
 
+#if defined(__SSE2__) || (_M_IX86_FP >= 2) || defined(_M_X64) || defined(_M_AMD64)
+#define HAVE_SKINNING_SSE2 1
+#include <emmintrin.h>
+#endif
+
 using std::ostream;
 
 TypeHandle GeomVertexData::_type_handle;
@@ -1563,13 +1568,23 @@ update_animated_vertices(GeomVertexData::CData *cdata, Thread *current_thread) {
   // Then apply the transforms.
   CPT(TransformBlendTable) tb_table = cdata->_transform_blend_table.get_read_pointer(current_thread);
   if (tb_table != nullptr) {
-    // Recompute all the blends up front, so we don't have to test each one
-    // for staleness at each vertex.
+    // Recompute all the blends up front, and store the resulting matrices, so
+    // we don't have to test each one for staleness or sum up its transforms
+    // at each vertex.
+    int num_blends = tb_table->get_num_blends();
+    pvector<LMatrix4> blend_mats;
+    pvector<LMatrix4f> blend_matsf;
+    blend_mats.reserve(num_blends);
+    blend_matsf.reserve(num_blends);
     {
       PStatTimer timer4(_blends_pcollector);
-      int num_blends = tb_table->get_num_blends();
       for (int bi = 0; bi < num_blends; bi++) {
-        tb_table->get_blend(bi).update_blend(current_thread);
+        const TransformBlend &blend = tb_table->get_blend(bi);
+        blend.update_blend(current_thread);
+        LMatrix4 mat;
+        blend.get_blend(mat, current_thread);
+        blend_mats.push_back(mat);
+        blend_matsf.push_back(LCAST(float, mat));
       }
     }
 
@@ -1587,6 +1602,13 @@ update_animated_vertices(GeomVertexData::CData *cdata, Thread *current_thread) {
       return;
     }
 
+    if (num_subranges == 0) {
+      return;
+    }
+
+    // Look up the blend index of each animated vertex just once, rather than
+    // again for each column.
+    pvector<int> blend_indices(num_rows, 0);
     CPT(GeomVertexArrayFormat) blend_array_format = orig_format->get_array(blend_array_index);
 
     if (blend_array_format->get_stride() == 2 &&
@@ -1596,173 +1618,130 @@ update_animated_vertices(GeomVertexData::CData *cdata, Thread *current_thread) {
         new GeomVertexArrayDataHandle(cdata->_arrays[blend_array_index].get_read_pointer(current_thread), current_thread);
       const unsigned short *blendt = (const unsigned short *)blend_array_handle->get_read_pointer(true);
 
-      size_t ci;
-      for (ci = 0; ci < new_format->get_num_points(); ci++) {
-        GeomVertexRewriter data(new_data, new_format->get_point(ci));
-
-        for (int i = 0; i < num_subranges; ++i) {
-          int begin = rows.get_subrange_begin(i);
-          int end = rows.get_subrange_end(i);
-          nassertv(begin < end);
-
-          int first_vertex = begin;
-          int first_bi = blendt[first_vertex];
-
-          while (first_vertex < end) {
-            // At this point, first_vertex is the first of a series of
-            // vertices that shares the blend index first_bi.
-
-            // Scan for the end of this series of vertices--we're looking for
-            // the next vertex with a different blend index.
-            int next_vertex = first_vertex;
-            int next_bi = first_bi;
-            ++next_vertex;
-            while (next_vertex < end) {
-              next_bi = blendt[next_vertex];
-              if (next_bi != first_bi) {
-                break;
-              }
-              ++next_vertex;
-            }
+      for (int i = 0; i < num_subranges; ++i) {
+        int begin = rows.get_subrange_begin(i);
+        int end = rows.get_subrange_end(i);
+        nassertv(begin < end && end <= num_rows);
+        for (int j = begin; j < end; ++j) {
+          nassertv(blendt[j] < num_blends);
+          blend_indices[j] = blendt[j];
+        }
+      }
 
-            // We've just reached the end of the vertices with a matching
-            // blend index.  Transform all those vertices as a block.
-            LMatrix4 mat;
-            tb_table->get_blend(first_bi).get_blend(mat, current_thread);
-            new_data->do_transform_point_column(new_format, data, mat, first_vertex, next_vertex);
+    } else {
+      // The blend indices are anything else.  Use the GeomVertexReader to
+      // iterate through them.
+      GeomVertexReader blendi(this, InternalName::get_transform_blend());
+      nassertv(blendi.has_column());
 
-            first_vertex = next_vertex;
-            first_bi = next_bi;
-          }
+      for (int i = 0; i < num_subranges; ++i) {
+        int begin = rows.get_subrange_begin(i);
+        int end = rows.get_subrange_end(i);
+        nassertv(begin < end && end <= num_rows);
+        blendi.set_row_unsafe(begin);
+        for (int j = begin; j < end; ++j) {
+          int bi = blendi.get_data1i();
+          nassertv(bi >= 0 && bi < num_blends);
+          blend_indices[j] = bi;
         }
       }
+    }
 
-      for (ci = 0; ci < new_format->get_num_vectors(); ci++) {
-        GeomVertexRewriter data(new_data, new_format->get_vector(ci));
-
-        for (int i = 0; i < num_subranges; ++i) {
-          int begin = rows.get_subrange_begin(i);
-          int end = rows.get_subrange_end(i);
-          nassertv(begin < end);
+    size_t ci;
+    for (ci = 0; ci < new_format->get_num_points(); ci++) {
+      GeomVertexRewriter data(new_data, new_format->get_point(ci));
+      const GeomVertexColumn *data_column = data.get_column();
 
-          int first_vertex = begin;
-          int first_bi = blendt[first_vertex];
+      if (data_column->get_num_values() == 3 &&
+          data_column->get_numeric_type() == NT_float32) {
+        // This is the common case of a table of LPoint3f's, which we can
+        // blend directly.
+        size_t stride = data.get_stride();
+        unsigned char *datat = data.get_array_handle()->get_write_pointer();
+        datat += data_column->get_start();
 
-          while (first_vertex < end) {
-            // At this point, first_vertex is the first of a series of
-            // vertices that shares the blend index first_bi.
+        for (int i = 0; i < num_subranges; ++i) {
+          skin_point3f(datat, stride, &blend_indices[0],
+                       rows.get_subrange_begin(i), rows.get_subrange_end(i),
+                       &blend_matsf[0]);
+        }
+        continue;
+      }
 
-            // Scan for the end of this series of vertices--we're looking for
-            // the next vertex with a different blend index.
-            int next_vertex = first_vertex;
-            int next_bi = first_bi;
+      for (int i = 0; i < num_subranges; ++i) {
+        int begin = rows.get_subrange_begin(i);
+        int end = rows.get_subrange_end(i);
+
+        // Transform each series of vertices that shares the same blend index
+        // as a block.
+        int first_vertex = begin;
+        while (first_vertex < end) {
+          int bi = blend_indices[first_vertex];
+          int next_vertex = first_vertex + 1;
+          while (next_vertex < end && blend_indices[next_vertex] == bi) {
             ++next_vertex;
-            while (next_vertex < end) {
-              next_bi = blendt[next_vertex];
-              if (next_bi != first_bi) {
-                break;
-              }
-              ++next_vertex;
-            }
-
-            // We've just reached the end of the vertices with a matching
-            // blend index.  Transform all those vertices as a block.
-            LMatrix4 mat;
-            tb_table->get_blend(first_bi).get_blend(mat, current_thread);
-            new_data->do_transform_vector_column(new_format, data, mat, first_vertex, next_vertex);
-
-            first_vertex = next_vertex;
-            first_bi = next_bi;
           }
+          new_data->do_transform_point_column(new_format, data, blend_mats[bi], first_vertex, next_vertex);
+          first_vertex = next_vertex;
         }
       }
+    }
 
-    } else {
-      // The blend indices are anything else.  Use the GeomVertexReader to
-      // iterate through them.
-      GeomVertexReader blendi(this, InternalName::get_transform_blend());
-      nassertv(blendi.has_column());
-
-      size_t ci;
-      for (ci = 0; ci < new_format->get_num_points(); ci++) {
-        GeomVertexRewriter data(new_data, new_format->get_point(ci));
-
-        for (int i = 0; i < num_subranges; ++i) {
-          int begin = rows.get_subrange_begin(i);
-          int end = rows.get_subrange_end(i);
-          nassertv(begin < end);
-          blendi.set_row_unsafe(begin);
-
-          int first_vertex = begin;
-          int first_bi = blendi.get_data1i();
-
-          while (first_vertex < end) {
-            // At this point, first_vertex is the first of a series of
-            // vertices that shares the blend index first_bi.
-
-            // Scan for the end of this series of vertices--we're looking for
-            // the next vertex with a different blend index.
-            int next_vertex = first_vertex;
-            int next_bi = first_bi;
-            ++next_vertex;
-            while (next_vertex < end) {
-              next_bi = blendi.get_data1i();
-              if (next_bi != first_bi) {
-                break;
-              }
-              ++next_vertex;
+    // The normals need a different matrix, which we compute for each blend
+    // only once we find we need it.
+    pvector<LMatrix4f> normal_matsf;
+    pvector<unsigned char> normalize;
+
+    for (ci = 0; ci < new_format->get_num_vectors(); ci++) {
+      GeomVertexRewriter data(new_data, new_format->get_vector(ci));
+      const GeomVertexColumn *data_column = data.get_column();
+
+      if (data_column->get_num_values() == 3 &&
+          data_column->get_numeric_type() == NT_float32) {
+        // This is the common case of a table of LVector3f's, which we can
+        // blend directly.
+        const LMatrix4f *mats = &blend_matsf[0];
+        const unsigned char *normalize_flags = nullptr;
+
+        if (data_column->get_contents() == C_normal) {
+          if (normal_matsf.empty()) {
+            normal_matsf.reserve(num_blends);
+            normalize.reserve(num_blends);
+            for (int bi = 0; bi < num_blends; ++bi) {
+              LMatrix4 xform;
+              normalize.push_back(calc_vector_xform(blend_mats[bi], C_normal, xform));
+              normal_matsf.push_back(LCAST(float, xform));
             }
-
-            // We've just reached the end of the vertices with a matching
-            // blend index.  Transform all those vertices as a block.
-            LMatrix4 mat;
-            tb_table->get_blend(first_bi).get_blend(mat, current_thread);
-            new_data->do_transform_point_column(new_format, data, mat, first_vertex, next_vertex);
-
-            first_vertex = next_vertex;
-            first_bi = next_bi;
           }
+          mats = &normal_matsf[0];
+          normalize_flags = &normalize[0];
         }
-      }
 
-      for (ci = 0; ci < new_format->get_num_vectors(); ci++) {
-        GeomVertexRewriter data(new_data, new_format->get_vector(ci));
+        size_t stride = data.get_stride();
+        unsigned char *datat = data.get_array_handle()->get_write_pointer();
+        datat += data_column->get_start();
 
         for (int i = 0; i < num_subranges; ++i) {
-          int begin = rows.get_subrange_begin(i);
-          int end = rows.get_subrange_end(i);
-          nassertv(begin != end);
-          blendi.set_row_unsafe(begin);
-
-          int first_vertex = begin;
-          int first_bi = blendi.get_data1i();
-
-          while (first_vertex < end) {
-            // At this point, first_vertex is the first of a series of
-            // vertices that shares the blend index first_bi.
-
-            // Scan for the end of this series of vertices--we're looking for
-            // the next vertex with a different blend index.
-            int next_vertex = first_vertex;
-            int next_bi = first_bi;
-            ++next_vertex;
-            while (next_vertex < end) {
-              next_bi = blendi.get_data1i();
-              if (next_bi != first_bi) {
-                break;
-              }
-              ++next_vertex;
-            }
+          skin_vector3f(datat, stride, &blend_indices[0],
+                        rows.get_subrange_begin(i), rows.get_subrange_end(i),
+                        mats, normalize_flags);
+        }
+        continue;
+      }
 
-            // We've just reached the end of the vertices with a matching
-            // blend index.  Transform all those vertices as a block.
-            LMatrix4 mat;
-            tb_table->get_blend(first_bi).get_blend(mat, current_thread);
-            new_data->do_transform_vector_column(new_format, data, mat, first_vertex, next_vertex);
+      for (int i = 0; i < num_subranges; ++i) {
+        int begin = rows.get_subrange_begin(i);
+        int end = rows.get_subrange_end(i);
 
-            first_vertex = next_vertex;
-            first_bi = next_bi;
+        int first_vertex = begin;
+        while (first_vertex < end) {
+          int bi = blend_indices[first_vertex];
+          int next_vertex = first_vertex + 1;
+          while (next_vertex < end && blend_indices[next_vertex] == bi) {
+            ++next_vertex;
           }
+          new_data->do_transform_vector_column(new_format, data, blend_mats[bi], first_vertex, next_vertex);
+          first_vertex = next_vertex;
         }
       }
     }
@@ -1827,35 +1806,7 @@ do_transform_vector_column(const GeomVertexFormat *format, GeomVertexRewriter &d
   int num_values = data_column->get_num_values();
 
   LMatrix4 xform;
-  bool normalize = false;
-  if (data_column->get_contents() == C_normal) {
-    // This is to preserve perpendicularity to the surface.
-    LVecBase3 scale_sq(mat.get_row3(0).length_squared(),
-                       mat.get_row3(1).length_squared(),
-                       mat.get_row3(2).length_squared());
-    if (IS_THRESHOLD_EQUAL(scale_sq[0], scale_sq[1], 2.0e-3f) &&
-        IS_THRESHOLD_EQUAL(scale_sq[0], scale_sq[2], 2.0e-3f)) {
-      // There is a uniform scale.
-      LVecBase3 scale, shear, hpr;
-      if (IS_THRESHOLD_EQUAL(scale_sq[0], 1, 2.0e-3f)) {
-        // No scale to worry about.
-        xform = mat;
-      } else if (decompose_matrix(mat.get_upper_3(), scale, shear, hpr)) {
-        // Make a new matrix with scale/translate taken out of the equation.
-        compose_matrix(xform, LVecBase3(1, 1, 1), shear, hpr, LVecBase3::zero());
-      } else {
-        normalize = true;
-      }
-    } else {
-      // There is a non-uniform scale, so we need to do all this to preserve
-      // orthogonality to the surface.
-      xform.invert_from(mat);
-      xform.transpose_in_place();
-      normalize = true;
-    }
-  } else {
-    xform = mat;
-  }
+  bool normalize = calc_vector_xform(mat, data_column->get_contents(), xform);
 
   if ((num_values == 3 || num_values == 4) &&
       data_column->get_numeric_type() == NT_float32) {
@@ -1897,6 +1848,152 @@ do_transform_vector_column(const GeomVertexFormat *format, GeomVertexRewriter &d
   }
 }
 
+/**
+ * Computes the matrix with which a vector column with the indicated contents
+ * should be transformed, in order to transform the vertices by mat.  Returns
+ * true if the vectors must also be normalized afterwards.
+ */
+bool GeomVertexData::
+calc_vector_xform(const LMatrix4 &mat, Contents contents, LMatrix4 &xform) {
+  if (contents != C_normal) {
+    xform = mat;
+    return false;
+  }
+
+  // This is to preserve perpendicularity to the surface.
+  LVecBase3 scale_sq(mat.get_row3(0).length_squared(),
+                     mat.get_row3(1).length_squared(),
+                     mat.get_row3(2).length_squared());
+  if (IS_THRESHOLD_EQUAL(scale_sq[0], scale_sq[1], 2.0e-3f) &&
+      IS_THRESHOLD_EQUAL(scale_sq[0], scale_sq[2], 2.0e-3f)) {
+    // There is a uniform scale.
+    LVecBase3 scale, shear, hpr;
+    if (IS_THRESHOLD_EQUAL(scale_sq[0], 1, 2.0e-3f)) {
+      // No scale to worry about.
+      xform = mat;
+      return false;
+    } else if (decompose_matrix(mat.get_upper_3(), scale, shear, hpr)) {
+      // Make a new matrix with scale/translate taken out of the equation.
+      compose_matrix(xform, LVecBase3(1, 1, 1), shear, hpr, LVecBase3::zero());
+      return false;
+    } else {
+      xform = mat;
+      return true;
+    }
+  } else {
+    // There is a non-uniform scale, so we need to do all this to preserve
+    // orthogonality to the surface.
+    xform.invert_from(mat);
+    xform.transpose_in_place();
+    return true;
+  }
+}
+
+/**
+ * Transforms each of the LPoint3f objects in the indicated rows of the table
+ * by the matrix of its own blend, as given by its entry in blend_indices.
+ */
+void GeomVertexData::
+skin_point3f(unsigned char *datat, size_t stride, const int *blend_indices,
+             int begin_row, int end_row, const LMatrix4f *mats) {
+#ifdef HAVE_SKINNING_SSE2
+  // Each row of the matrix is scaled by the corresponding component of the
+  // point, four values at a time.  Consecutive vertices often share the same
+  // blend, in which case we keep the matrix in registers.
+  __m128 row0 = _mm_setzero_ps();
+  __m128 row1 = _mm_setzero_ps();
+  __m128 row2 = _mm_setzero_ps();
+  __m128 row3 = _mm_setzero_ps();
+  int last_bi = -1;
+
+  for (int i = begin_row; i < end_row; ++i) {
+    int bi = blend_indices[i];
+    if (bi != last_bi) {
+      const float *m = mats[bi].get_data();
+      row0 = _mm_loadu_ps(m);
+      row1 = _mm_loadu_ps(m + 4);
+      row2 = _mm_loadu_ps(m + 8);
+      row3 = _mm_loadu_ps(m + 12);
+      last_bi = bi;
+    }
+    float *v = (float *)(datat + i * stride);
+    __m128 result =
+      _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(v[0]), row0),
+                            _mm_mul_ps(_mm_set1_ps(v[1]), row1)),
+                 _mm_add_ps(_mm_mul_ps(_mm_set1_ps(v[2]), row2), row3));
+
+    // Only write back the three components; the fourth float may belong to
+    // another column.
+    _mm_storel_pi((__m64 *)v, result);
+    _mm_store_ss(v + 2, _mm_movehl_ps(result, result));
+  }
+
+#else
+  for (int i = begin_row; i < end_row; ++i) {
+    LPoint3f &vertex = *(LPoint3f *)(datat + i * stride);
+    vertex = mats[blend_indices[i]].xform_point(vertex);
+  }
+#endif  // HAVE_SKINNING_SSE2
+}
+
+/**
+ * Transforms each of the LVector3f objects in the indicated rows of the table
+ * by the matrix of its own blend, as given by its entry in blend_indices.  If
+ * normalize is not NULL, the vectors whose blend has a nonzero entry in it
+ * are also normalized.
+ */
+void GeomVertexData::
+skin_vector3f(unsigned char *datat, size_t stride, const int *blend_indices,
+              int begin_row, int end_row, const LMatrix4f *mats,
+              const unsigned char *normalize) {
+#ifdef HAVE_SKINNING_SSE2
+  __m128 row0 = _mm_setzero_ps();
+  __m128 row1 = _mm_setzero_ps();
+  __m128 row2 = _mm_setzero_ps();
+  bool norm = false;
+  int last_bi = -1;
+
+  for (int i = begin_row; i < end_row; ++i) {
+    int bi = blend_indices[i];
+    if (bi != last_bi) {
+      const float *m = mats[bi].get_data();
+      row0 = _mm_loadu_ps(m);
+      row1 = _mm_loadu_ps(m + 4);
+      row2 = _mm_loadu_ps(m + 8);
+      norm = (normalize != nullptr && normalize[bi] != 0);
+      last_bi = bi;
+    }
+    float *v = (float *)(datat + i * stride);
+    __m128 result =
+      _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(v[0]), row0),
+                            _mm_mul_ps(_mm_set1_ps(v[1]), row1)),
+                 _mm_mul_ps(_mm_set1_ps(v[2]), row2));
+
+    if (norm) {
+      __m128 sq = _mm_mul_ps(result, result);
+      float length_sq = _mm_cvtss_f32(_mm_add_ss(_mm_add_ss(sq, _mm_shuffle_ps(sq, sq, 1)),
+                                                 _mm_movehl_ps(sq, sq)));
+      if (length_sq != 0.0f) {
+        result = _mm_div_ps(result, _mm_set1_ps(sqrtf(length_sq)));
+      }
+    }
+
+    _mm_storel_pi((__m64 *)v, result);
+    _mm_store_ss(v + 2, _mm_movehl_ps(result, result));
+  }
+
+#else
+  for (int i = begin_row; i < end_row; ++i) {
+    int bi = blend_indices[i];
+    LVector3f &vertex = *(LVector3f *)(datat + i * stride);
+    vertex = mats[bi].xform_vec(vertex);
+    if (normalize != nullptr && normalize[bi] != 0) {
+      vertex.normalize();
+    }
+  }
+#endif  // HAVE_SKINNING_SSE2
+}
+
 /**
  * Transforms each of the LPoint3f objects in the indicated table by the
  * indicated matrix.
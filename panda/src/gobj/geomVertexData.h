@@ -339,6 +339,15 @@ private:
                                  const LMatrix4 &mat, int begin_row, int end_row);
   void do_transform_vector_column(const GeomVertexFormat *format, GeomVertexRewriter &data,
                                   const LMatrix4 &mat, int begin_row, int end_row);
+  static bool calc_vector_xform(const LMatrix4 &mat, Contents contents,
+                                LMatrix4 &xform);
+  static void skin_point3f(unsigned char *datat, size_t stride,
+                           const int *blend_indices, int begin_row,
+                           int end_row, const LMatrix4f *mats);
+  static void skin_vector3f(unsigned char *datat, size_t stride,
+                            const int *blend_indices, int begin_row,
+                            int end_row, const LMatrix4f *mats,
+                            const unsigned char *normalize);
   static void table_xform_point3f(unsigned char *datat, size_t num_rows,
                                   size_t stride, const LMatrix4f &matf);
   static void table_xform_normal3f(unsigned char *datat, size_t num_rows,
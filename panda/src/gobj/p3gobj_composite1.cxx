@@ -1,4 +1,5 @@
 #include "adaptiveLru.cxx"
+#include "animateVerticesBatch.cxx"
 #include "animateVerticesRequest.cxx"
 #include "bufferContext.cxx"
 #include "bufferContextChain.cxx"
@@ -42,6 +42,7 @@
 #include "streamReader.h"
 #include "texturePeeker.h"
 #include "convert_srgb.h"
+#include "jobPool.h"
 
 #ifdef HAVE_SQUISH
 #include <squish.h>
@@ -49,6 +50,10 @@
 
 #include <stddef.h>
 
+#if defined(__SSE2__) || (_M_IX86_FP >= 2) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#endif
+
 using std::endl;
 using std::istream;
 using std::max;
@@ -72,6 +77,84 @@ TypeHandle Texture::_type_handle;
 TypeHandle Texture::CData::_type_handle;
 AutoTextureScale Texture::_textures_power_2 = ATS_unspecified;
 
+// Generating a mipmap level or compressing an image at least this large is
+// divided among the threads of the global JobPool.
+static const size_t parallel_min_image_size = 65536;
+
+/**
+ * Returns the number of jobs into which an operation on an image of the
+ * indicated size in bytes, consisting of the indicated number of independent
+ * rows, should be divided.  Returns 1 if it should just be done in the
+ * calling thread.
+ */
+static int
+choose_num_jobs(size_t image_size, int num_rows) {
+  if (image_size < parallel_min_image_size) {
+    return 1;
+  }
+  int num_threads = JobPool::get_global_ptr()->get_num_threads();
+  if (num_threads == 0) {
+    return 1;
+  }
+
+  // Make a few jobs for each thread, including the calling thread, so that
+  // the load is still balanced if some of them are busy with other work.
+  int num_jobs = (num_threads + 1) * 4;
+  num_jobs = min(num_jobs, (int)(image_size / (parallel_min_image_size / 4)));
+  return max(1, min(num_jobs, num_rows));
+}
+
+/**
+ * Generates a range of rows of a mipmap level, for
+ * do_filter_2d_mipmap_pages().
+ */
+class Texture::FilterMipmapJob : public JobPool::Job {
+public:
+  virtual void do_job(Thread *current_thread);
+
+  const Texture *_texture;
+  const CData *_cdata;
+  RamImage *_to;
+  const RamImage *_from;
+  int _x_size;
+  int _y_size;
+  int _begin_row;
+  int _end_row;
+};
+
+/**
+ * Compresses a range of rows of 4x4 blocks, for do_compress_block_rows().
+ */
+class Texture::CompressBlockRowsJob : public JobPool::Job {
+public:
+  virtual void do_job(Thread *current_thread);
+
+  CompressBlockRows *_func;
+  unsigned char *_dest;
+  const unsigned char *_src;
+  int _x_size;
+  int _num_block_rows;
+};
+
+#ifdef HAVE_SQUISH
+/**
+ * Compresses a range of rows of 4x4 cells of one page, for do_squish().
+ */
+class Texture::SquishJob : public JobPool::Job {
+public:
+  virtual void do_job(Thread *current_thread);
+
+  unsigned char *_dest;
+  const unsigned char *_source_page;
+  size_t _source_page_size;
+  int _x_size;
+  int _begin_y;
+  int _end_y;
+  int _num_components;
+  int _squish_flags;
+};
+#endif  // HAVE_SQUISH
+
 // Stuff to read and write DDS files.
 
 // little-endian, of course
@@ -6045,91 +6128,104 @@ do_compress_ram_image_bc4(const RamImage &uncompressed_image,
   int x_blocks = (x_size >> 2);
   int y_blocks = (y_size >> 2);
 
-  // NB. This algorithm isn't fully optimal, since it doesn't try to make use
-  // of the secondary interpolation mode supported by BC4.  This is not
-  // important for most textures, but it may be added in the future.
-
   nassertv((size_t)x_blocks * (size_t)y_blocks * 4 * 4 <= uncompressed_image._page_size);
   nassertv((size_t)x_size * (size_t)y_size == uncompressed_image._page_size);
 
-  static const int remap[] = {1, 7, 6, 5, 4, 3, 2, 0};
+  // The pages are stored one after the other, so we can treat them as one
+  // tall image.
+  do_compress_block_rows(&compress_block_rows_bc4,
+                         compressed_image._image.p(),
+                         uncompressed_image._image.p(),
+                         (size_t)x_blocks * 8, (size_t)x_size * 4,
+                         x_size, y_blocks * num_pages);
+}
 
-  for (int z = 0; z < num_pages; ++z) {
-    unsigned char *dest = compressed_image._image.p() + z * compressed_image._page_size;
-    unsigned const char *src = uncompressed_image._image.p() + z * uncompressed_image._page_size;
+/**
+ * Compresses the indicated number of rows of 4x4 blocks of a one-channel
+ * image using BC4 compression.
+ */
+void Texture::
+compress_block_rows_bc4(unsigned char *dest, const unsigned char *src,
+                        int x_size, int num_block_rows) {
+  int x_blocks = (x_size >> 2);
 
-    // Convert one 4 x 4 block at a time.
-    for (int y = 0; y < y_blocks; ++y) {
-      for (int x = 0; x < x_blocks; ++x) {
-        int a, b, c, d;
-        float fac, add;
-        unsigned char minv, maxv;
-        unsigned const char *blk = src;
-
-        // Find the minimum and maximum value in the block.
-        minv = blk[0];
-        maxv = blk[0];
-        minv = min(blk[1], minv); maxv = max(blk[1], maxv);
-        minv = min(blk[2], minv); maxv = max(blk[2], maxv);
-        minv = min(blk[3], minv); maxv = max(blk[3], maxv);
-        blk += x_size;
-        minv = min(blk[0], minv); maxv = max(blk[0], maxv);
-        minv = min(blk[1], minv); maxv = max(blk[1], maxv);
-        minv = min(blk[2], minv); maxv = max(blk[2], maxv);
-        minv = min(blk[3], minv); maxv = max(blk[3], maxv);
-        blk += x_size;
-        minv = min(blk[0], minv); maxv = max(blk[0], maxv);
-        minv = min(blk[1], minv); maxv = max(blk[1], maxv);
-        minv = min(blk[2], minv); maxv = max(blk[2], maxv);
-        minv = min(blk[3], minv); maxv = max(blk[3], maxv);
-        blk += x_size;
-        minv = min(blk[0], minv); maxv = max(blk[0], maxv);
-        minv = min(blk[1], minv); maxv = max(blk[1], maxv);
-        minv = min(blk[2], minv); maxv = max(blk[2], maxv);
-        minv = min(blk[3], minv); maxv = max(blk[3], maxv);
-
-        // Now calculate the index for each pixel.
-        blk = src;
-        if (maxv > minv) {
-          fac = 7.5f / (maxv - minv);
-        } else {
-          fac = 0;
-        }
-        add = -minv * fac;
-        a = (remap[(int)(blk[0] * fac + add)])
-          | (remap[(int)(blk[1] * fac + add)] << 3)
-          | (remap[(int)(blk[2] * fac + add)] << 6)
-          | (remap[(int)(blk[3] * fac + add)] << 9);
-        blk += x_size;
-        b = (remap[(int)(blk[0] * fac + add)] << 4)
-          | (remap[(int)(blk[1] * fac + add)] << 7)
-          | (remap[(int)(blk[2] * fac + add)] << 10)
-          | (remap[(int)(blk[3] * fac + add)] << 13);
-        blk += x_size;
-        c = (remap[(int)(blk[0] * fac + add)])
-          | (remap[(int)(blk[1] * fac + add)] << 3)
-          | (remap[(int)(blk[2] * fac + add)] << 6)
-          | (remap[(int)(blk[3] * fac + add)] << 9);
-        blk += x_size;
-        d = (remap[(int)(blk[0] * fac + add)] << 4)
-          | (remap[(int)(blk[1] * fac + add)] << 7)
-          | (remap[(int)(blk[2] * fac + add)] << 10)
-          | (remap[(int)(blk[3] * fac + add)] << 13);
+  // NB. This algorithm isn't fully optimal, since it doesn't try to make use
+  // of the secondary interpolation mode supported by BC4.  This is not
+  // important for most textures, but it may be added in the future.
 
-        *(dest++) = maxv;
-        *(dest++) = minv;
-        *(dest++) = a & 0xff;
-        *(dest++) = (a >> 8) | (b & 0xf0);
-        *(dest++) = b >> 8;
-        *(dest++) = c & 0xff;
-        *(dest++) = (c >> 8) | (d & 0xf0);
-        *(dest++) = d >> 8;
+  static const int remap[] = {1, 7, 6, 5, 4, 3, 2, 0};
 
-        // Advance to the beginning of the next 4x4 block.
-        src += 4;
-      }
-      src += x_size * 3;
-    }
+  // Convert one 4 x 4 block at a time.
+  for (int y = 0; y < num_block_rows; ++y) {
+    for (int x = 0; x < x_blocks; ++x) {
+      int a, b, c, d;
+      float fac, add;
+      unsigned char minv, maxv;
+      unsigned const char *blk = src;
+
+      // Find the minimum and maximum value in the block.
+      minv = blk[0];
+      maxv = blk[0];
+      minv = min(blk[1], minv); maxv = max(blk[1], maxv);
+      minv = min(blk[2], minv); maxv = max(blk[2], maxv);
+      minv = min(blk[3], minv); maxv = max(blk[3], maxv);
+      blk += x_size;
+      minv = min(blk[0], minv); maxv = max(blk[0], maxv);
+      minv = min(blk[1], minv); maxv = max(blk[1], maxv);
+      minv = min(blk[2], minv); maxv = max(blk[2], maxv);
+      minv = min(blk[3], minv); maxv = max(blk[3], maxv);
+      blk += x_size;
+      minv = min(blk[0], minv); maxv = max(blk[0], maxv);
+      minv = min(blk[1], minv); maxv = max(blk[1], maxv);
+      minv = min(blk[2], minv); maxv = max(blk[2], maxv);
+      minv = min(blk[3], minv); maxv = max(blk[3], maxv);
+      blk += x_size;
+      minv = min(blk[0], minv); maxv = max(blk[0], maxv);
+      minv = min(blk[1], minv); maxv = max(blk[1], maxv);
+      minv = min(blk[2], minv); maxv = max(blk[2], maxv);
+      minv = min(blk[3], minv); maxv = max(blk[3], maxv);
+
+      // Now calculate the index for each pixel.
+      blk = src;
+      if (maxv > minv) {
+        fac = 7.5f / (maxv - minv);
+      } else {
+        fac = 0;
+      }
+      add = -minv * fac;
+      a = (remap[(int)(blk[0] * fac + add)])
+        | (remap[(int)(blk[1] * fac + add)] << 3)
+        | (remap[(int)(blk[2] * fac + add)] << 6)
+        | (remap[(int)(blk[3] * fac + add)] << 9);
+      blk += x_size;
+      b = (remap[(int)(blk[0] * fac + add)] << 4)
+        | (remap[(int)(blk[1] * fac + add)] << 7)
+        | (remap[(int)(blk[2] * fac + add)] << 10)
+        | (remap[(int)(blk[3] * fac + add)] << 13);
+      blk += x_size;
+      c = (remap[(int)(blk[0] * fac + add)])
+        | (remap[(int)(blk[1] * fac + add)] << 3)
+        | (remap[(int)(blk[2] * fac + add)] << 6)
+        | (remap[(int)(blk[3] * fac + add)] << 9);
+      blk += x_size;
+      d = (remap[(int)(blk[0] * fac + add)] << 4)
+        | (remap[(int)(blk[1] * fac + add)] << 7)
+        | (remap[(int)(blk[2] * fac + add)] << 10)
+        | (remap[(int)(blk[3] * fac + add)] << 13);
+
+      *(dest++) = maxv;
+      *(dest++) = minv;
+      *(dest++) = a & 0xff;
+      *(dest++) = (a >> 8) | (b & 0xf0);
+      *(dest++) = b >> 8;
+      *(dest++) = c & 0xff;
+      *(dest++) = (c >> 8) | (d & 0xf0);
+      *(dest++) = d >> 8;
+
+      // Advance to the beginning of the next 4x4 block.
+      src += 4;
+    }
+    src += x_size * 3;
     Thread::consider_yield();
   }
 }
@@ -6145,150 +6241,205 @@ do_compress_ram_image_bc5(const RamImage &uncompressed_image,
   int y_blocks = (y_size >> 2);
   int stride = x_size * 2;
 
-  // BC5 uses the same compression algorithm as BC4, except repeated for two
-  // channels.
-
   nassertv((size_t)x_blocks * (size_t)y_blocks * 4 * 4 * 2 <= uncompressed_image._page_size);
   nassertv((size_t)stride * (size_t)y_size == uncompressed_image._page_size);
 
-  static const int remap[] = {1, 7, 6, 5, 4, 3, 2, 0};
+  // The pages are stored one after the other, so we can treat them as one
+  // tall image.
+  do_compress_block_rows(&compress_block_rows_bc5,
+                         compressed_image._image.p(),
+                         uncompressed_image._image.p(),
+                         (size_t)x_blocks * 16, (size_t)stride * 4,
+                         x_size, y_blocks * num_pages);
+}
 
-  for (int z = 0; z < num_pages; ++z) {
-    unsigned char *dest = compressed_image._image.p() + z * compressed_image._page_size;
-    unsigned const char *src = uncompressed_image._image.p() + z * uncompressed_image._page_size;
+/**
+ * Calls the indicated function to compress the indicated number of rows of
+ * 4x4 blocks, starting at the given addresses.  If there are enough of them,
+ * the rows are divided among the threads of the global JobPool.
+ */
+void Texture::
+do_compress_block_rows(CompressBlockRows *func, unsigned char *dest,
+                       const unsigned char *src,
+                       size_t dest_row_size, size_t src_row_size,
+                       int x_size, int num_block_rows) {
+  int num_jobs = choose_num_jobs(src_row_size * num_block_rows, num_block_rows);
+  if (num_jobs <= 1) {
+    func(dest, src, x_size, num_block_rows);
+    return;
+  }
 
-    // Convert one 4 x 4 block at a time.
-    for (int y = 0; y < y_blocks; ++y) {
-      for (int x = 0; x < x_blocks; ++x) {
-        int a, b, c, d;
-        float fac, add;
-        unsigned char minv, maxv;
-        unsigned const char *blk = src;
-
-        // Find the minimum and maximum red value in the block.
-        minv = blk[0];
-        maxv = blk[0];
-        minv = min(blk[2], minv); maxv = max(blk[2], maxv);
-        minv = min(blk[4], minv); maxv = max(blk[4], maxv);
-        minv = min(blk[6], minv); maxv = max(blk[6], maxv);
-        blk += stride;
-        minv = min(blk[0], minv); maxv = max(blk[0], maxv);
-        minv = min(blk[2], minv); maxv = max(blk[2], maxv);
-        minv = min(blk[4], minv); maxv = max(blk[4], maxv);
-        minv = min(blk[6], minv); maxv = max(blk[6], maxv);
-        blk += stride;
-        minv = min(blk[0], minv); maxv = max(blk[0], maxv);
-        minv = min(blk[2], minv); maxv = max(blk[2], maxv);
-        minv = min(blk[4], minv); maxv = max(blk[4], maxv);
-        minv = min(blk[6], minv); maxv = max(blk[6], maxv);
-        blk += stride;
-        minv = min(blk[0], minv); maxv = max(blk[0], maxv);
-        minv = min(blk[2], minv); maxv = max(blk[2], maxv);
-        minv = min(blk[4], minv); maxv = max(blk[4], maxv);
-        minv = min(blk[6], minv); maxv = max(blk[6], maxv);
-
-        // Now calculate the index for each pixel.
-        if (maxv > minv) {
-          fac = 7.5f / (maxv - minv);
-        } else {
-          fac = 0;
-        }
-        add = -minv * fac;
-        blk = src;
-        a = (remap[(int)(blk[0] * fac + add)])
-          | (remap[(int)(blk[2] * fac + add)] << 3)
-          | (remap[(int)(blk[4] * fac + add)] << 6)
-          | (remap[(int)(blk[6] * fac + add)] << 9);
-        blk += stride;
-        b = (remap[(int)(blk[0] * fac + add)] << 4)
-          | (remap[(int)(blk[2] * fac + add)] << 7)
-          | (remap[(int)(blk[4] * fac + add)] << 10)
-          | (remap[(int)(blk[6] * fac + add)] << 13);
-        blk += stride;
-        c = (remap[(int)(blk[0] * fac + add)])
-          | (remap[(int)(blk[2] * fac + add)] << 3)
-          | (remap[(int)(blk[4] * fac + add)] << 6)
-          | (remap[(int)(blk[6] * fac + add)] << 9);
-        blk += stride;
-        d = (remap[(int)(blk[0] * fac + add)] << 4)
-          | (remap[(int)(blk[2] * fac + add)] << 7)
-          | (remap[(int)(blk[4] * fac + add)] << 10)
-          | (remap[(int)(blk[6] * fac + add)] << 13);
-
-        *(dest++) = maxv;
-        *(dest++) = minv;
-        *(dest++) = a & 0xff;
-        *(dest++) = (a >> 8) | (b & 0xf0);
-        *(dest++) = b >> 8;
-        *(dest++) = c & 0xff;
-        *(dest++) = (c >> 8) | (d & 0xf0);
-        *(dest++) = d >> 8;
-
-        // Find the minimum and maximum green value in the block.
-        blk = src + 1;
-        minv = blk[0];
-        maxv = blk[0];
-        minv = min(blk[2], minv); maxv = max(blk[2], maxv);
-        minv = min(blk[4], minv); maxv = max(blk[4], maxv);
-        minv = min(blk[6], minv); maxv = max(blk[6], maxv);
-        blk += stride;
-        minv = min(blk[0], minv); maxv = max(blk[0], maxv);
-        minv = min(blk[2], minv); maxv = max(blk[2], maxv);
-        minv = min(blk[4], minv); maxv = max(blk[4], maxv);
-        minv = min(blk[6], minv); maxv = max(blk[6], maxv);
-        blk += stride;
-        minv = min(blk[0], minv); maxv = max(blk[0], maxv);
-        minv = min(blk[2], minv); maxv = max(blk[2], maxv);
-        minv = min(blk[4], minv); maxv = max(blk[4], maxv);
-        minv = min(blk[6], minv); maxv = max(blk[6], maxv);
-        blk += stride;
-        minv = min(blk[0], minv); maxv = max(blk[0], maxv);
-        minv = min(blk[2], minv); maxv = max(blk[2], maxv);
-        minv = min(blk[4], minv); maxv = max(blk[4], maxv);
-        minv = min(blk[6], minv); maxv = max(blk[6], maxv);
-
-        // Now calculate the index for each pixel.
-        if (maxv > minv) {
-          fac = 7.5f / (maxv - minv);
-        } else {
-          fac = 0;
-        }
-        add = -minv * fac;
-        blk = src + 1;
-        a = (remap[(int)(blk[0] * fac + add)])
-          | (remap[(int)(blk[2] * fac + add)] << 3)
-          | (remap[(int)(blk[4] * fac + add)] << 6)
-          | (remap[(int)(blk[6] * fac + add)] << 9);
-        blk += stride;
-        b = (remap[(int)(blk[0] * fac + add)] << 4)
-          | (remap[(int)(blk[2] * fac + add)] << 7)
-          | (remap[(int)(blk[4] * fac + add)] << 10)
-          | (remap[(int)(blk[6] * fac + add)] << 13);
-        blk += stride;
-        c = (remap[(int)(blk[0] * fac + add)])
-          | (remap[(int)(blk[2] * fac + add)] << 3)
-          | (remap[(int)(blk[4] * fac + add)] << 6)
-          | (remap[(int)(blk[6] * fac + add)] << 9);
-        blk += stride;
-        d = (remap[(int)(blk[0] * fac + add)] << 4)
-          | (remap[(int)(blk[2] * fac + add)] << 7)
-          | (remap[(int)(blk[4] * fac + add)] << 10)
-          | (remap[(int)(blk[6] * fac + add)] << 13);
-
-        *(dest++) = maxv;
-        *(dest++) = minv;
-        *(dest++) = a & 0xff;
-        *(dest++) = (a >> 8) | (b & 0xf0);
-        *(dest++) = b >> 8;
-        *(dest++) = c & 0xff;
-        *(dest++) = (c >> 8) | (d & 0xf0);
-        *(dest++) = d >> 8;
-
-        // Advance to the beginning of the next 4x4 block.
-        src += 8;
-      }
-      src += stride * 3;
-    }
+  pvector<CompressBlockRowsJob> jobs(num_jobs);
+  JobPool::Batch batch(JobPool::get_global_ptr());
+  for (int i = 0; i < num_jobs; ++i) {
+    int begin_row = (int)((int64_t)num_block_rows * i / num_jobs);
+    int end_row = (int)((int64_t)num_block_rows * (i + 1) / num_jobs);
+
+    CompressBlockRowsJob &job = jobs[i];
+    job._func = func;
+    job._dest = dest + begin_row * dest_row_size;
+    job._src = src + begin_row * src_row_size;
+    job._x_size = x_size;
+    job._num_block_rows = end_row - begin_row;
+    batch.add_job(&job);
+  }
+  batch.wait();
+}
+
+/**
+ * Compresses the job's range of block rows.
+ */
+void Texture::CompressBlockRowsJob::
+do_job(Thread *current_thread) {
+  _func(_dest, _src, _x_size, _num_block_rows);
+}
+
+/**
+ * Compresses the indicated number of rows of 4x4 blocks of a two-channel
+ * image using BC5 compression.
+ */
+void Texture::
+compress_block_rows_bc5(unsigned char *dest, const unsigned char *src,
+                        int x_size, int num_block_rows) {
+  int x_blocks = (x_size >> 2);
+  int stride = x_size * 2;
+
+  // BC5 uses the same compression algorithm as BC4, except repeated for two
+  // channels.
+
+  static const int remap[] = {1, 7, 6, 5, 4, 3, 2, 0};
+
+  // Convert one 4 x 4 block at a time.
+  for (int y = 0; y < num_block_rows; ++y) {
+    for (int x = 0; x < x_blocks; ++x) {
+      int a, b, c, d;
+      float fac, add;
+      unsigned char minv, maxv;
+      unsigned const char *blk = src;
+
+      // Find the minimum and maximum red value in the block.
+      minv = blk[0];
+      maxv = blk[0];
+      minv = min(blk[2], minv); maxv = max(blk[2], maxv);
+      minv = min(blk[4], minv); maxv = max(blk[4], maxv);
+      minv = min(blk[6], minv); maxv = max(blk[6], maxv);
+      blk += stride;
+      minv = min(blk[0], minv); maxv = max(blk[0], maxv);
+      minv = min(blk[2], minv); maxv = max(blk[2], maxv);
+      minv = min(blk[4], minv); maxv = max(blk[4], maxv);
+      minv = min(blk[6], minv); maxv = max(blk[6], maxv);
+      blk += stride;
+      minv = min(blk[0], minv); maxv = max(blk[0], maxv);
+      minv = min(blk[2], minv); maxv = max(blk[2], maxv);
+      minv = min(blk[4], minv); maxv = max(blk[4], maxv);
+      minv = min(blk[6], minv); maxv = max(blk[6], maxv);
+      blk += stride;
+      minv = min(blk[0], minv); maxv = max(blk[0], maxv);
+      minv = min(blk[2], minv); maxv = max(blk[2], maxv);
+      minv = min(blk[4], minv); maxv = max(blk[4], maxv);
+      minv = min(blk[6], minv); maxv = max(blk[6], maxv);
+
+      // Now calculate the index for each pixel.
+      if (maxv > minv) {
+        fac = 7.5f / (maxv - minv);
+      } else {
+        fac = 0;
+      }
+      add = -minv * fac;
+      blk = src;
+      a = (remap[(int)(blk[0] * fac + add)])
+        | (remap[(int)(blk[2] * fac + add)] << 3)
+        | (remap[(int)(blk[4] * fac + add)] << 6)
+        | (remap[(int)(blk[6] * fac + add)] << 9);
+      blk += stride;
+      b = (remap[(int)(blk[0] * fac + add)] << 4)
+        | (remap[(int)(blk[2] * fac + add)] << 7)
+        | (remap[(int)(blk[4] * fac + add)] << 10)
+        | (remap[(int)(blk[6] * fac + add)] << 13);
+      blk += stride;
+      c = (remap[(int)(blk[0] * fac + add)])
+        | (remap[(int)(blk[2] * fac + add)] << 3)
+        | (remap[(int)(blk[4] * fac + add)] << 6)
+        | (remap[(int)(blk[6] * fac + add)] << 9);
+      blk += stride;
+      d = (remap[(int)(blk[0] * fac + add)] << 4)
+        | (remap[(int)(blk[2] * fac + add)] << 7)
+        | (remap[(int)(blk[4] * fac + add)] << 10)
+        | (remap[(int)(blk[6] * fac + add)] << 13);
+
+      *(dest++) = maxv;
+      *(dest++) = minv;
+      *(dest++) = a & 0xff;
+      *(dest++) = (a >> 8) | (b & 0xf0);
+      *(dest++) = b >> 8;
+      *(dest++) = c & 0xff;
+      *(dest++) = (c >> 8) | (d & 0xf0);
+      *(dest++) = d >> 8;
+
+      // Find the minimum and maximum green value in the block.
+      blk = src + 1;
+      minv = blk[0];
+      maxv = blk[0];
+      minv = min(blk[2], minv); maxv = max(blk[2], maxv);
+      minv = min(blk[4], minv); maxv = max(blk[4], maxv);
+      minv = min(blk[6], minv); maxv = max(blk[6], maxv);
+      blk += stride;
+      minv = min(blk[0], minv); maxv = max(blk[0], maxv);
+      minv = min(blk[2], minv); maxv = max(blk[2], maxv);
+      minv = min(blk[4], minv); maxv = max(blk[4], maxv);
+      minv = min(blk[6], minv); maxv = max(blk[6], maxv);
+      blk += stride;
+      minv = min(blk[0], minv); maxv = max(blk[0], maxv);
+      minv = min(blk[2], minv); maxv = max(blk[2], maxv);
+      minv = min(blk[4], minv); maxv = max(blk[4], maxv);
+      minv = min(blk[6], minv); maxv = max(blk[6], maxv);
+      blk += stride;
+      minv = min(blk[0], minv); maxv = max(blk[0], maxv);
+      minv = min(blk[2], minv); maxv = max(blk[2], maxv);
+      minv = min(blk[4], minv); maxv = max(blk[4], maxv);
+      minv = min(blk[6], minv); maxv = max(blk[6], maxv);
+
+      // Now calculate the index for each pixel.
+      if (maxv > minv) {
+        fac = 7.5f / (maxv - minv);
+      } else {
+        fac = 0;
+      }
+      add = -minv * fac;
+      blk = src + 1;
+      a = (remap[(int)(blk[0] * fac + add)])
+        | (remap[(int)(blk[2] * fac + add)] << 3)
+        | (remap[(int)(blk[4] * fac + add)] << 6)
+        | (remap[(int)(blk[6] * fac + add)] << 9);
+      blk += stride;
+      b = (remap[(int)(blk[0] * fac + add)] << 4)
+        | (remap[(int)(blk[2] * fac + add)] << 7)
+        | (remap[(int)(blk[4] * fac + add)] << 10)
+        | (remap[(int)(blk[6] * fac + add)] << 13);
+      blk += stride;
+      c = (remap[(int)(blk[0] * fac + add)])
+        | (remap[(int)(blk[2] * fac + add)] << 3)
+        | (remap[(int)(blk[4] * fac + add)] << 6)
+        | (remap[(int)(blk[6] * fac + add)] << 9);
+      blk += stride;
+      d = (remap[(int)(blk[0] * fac + add)] << 4)
+        | (remap[(int)(blk[2] * fac + add)] << 7)
+        | (remap[(int)(blk[4] * fac + add)] << 10)
+        | (remap[(int)(blk[6] * fac + add)] << 13);
+
+      *(dest++) = maxv;
+      *(dest++) = minv;
+      *(dest++) = a & 0xff;
+      *(dest++) = (a >> 8) | (b & 0xf0);
+      *(dest++) = b >> 8;
+      *(dest++) = c & 0xff;
+      *(dest++) = (c >> 8) | (d & 0xf0);
+      *(dest++) = d >> 8;
+
+      // Advance to the beginning of the next 4x4 block.
+      src += 8;
+    }
+    src += stride * 3;
     Thread::consider_yield();
   }
 }
@@ -7615,8 +7766,11 @@ do_generate_ram_mipmap_images(CData *cdata, bool allow_recompress) {
     int n = 0;
     while (x_size > 1 || y_size > 1) {
       cdata->_ram_images.push_back(RamImage());
-      do_filter_2d_mipmap_pages(cdata, cdata->_ram_images[n + 1], cdata->_ram_images[n],
-                                x_size, y_size);
+      if (!do_filter_2d_mipmap_pages(cdata, cdata->_ram_images[n + 1], cdata->_ram_images[n],
+                                     x_size, y_size)) {
+        do_clear_ram_mipmap_images(cdata);
+        return;
+      }
       x_size = max(x_size >> 1, 1);
       y_size = max(y_size >> 1, 1);
       ++n;
@@ -9081,20 +9235,94 @@ compare_images(const PNMImage &a, const PNMImage &b) {
  * x_size and y_size are the size of the previous level.  They need not be a
  * power of 2, or even a multiple of 2.
  *
+ * If the level is large enough, the rows are divided among the threads of
+ * the global JobPool.
+ *
+ * Returns true on success, or false if mipmaps cannot be generated for the
+ * texture's component type, in which case the new level is left empty.
+ *
  * Assumes the lock is already held.
  */
-void Texture::
+bool Texture::
 do_filter_2d_mipmap_pages(const CData *cdata,
                           Texture::RamImage &to, const Texture::RamImage &from,
                           int x_size, int y_size) const {
-  Filter2DComponent *filter_component;
-  Filter2DComponent *filter_alpha;
-
+  // Check the component type before allocating the new level, rather than
+  // letting each job of do_filter_2d_mipmap_rows() discover it.
   if (is_srgb(cdata->_format)) {
     // We currently only support sRGB mipmap generation for unsigned byte
     // textures, due to our use of a lookup table.
-    nassertv(cdata->_component_type == T_unsigned_byte);
+    nassertr(cdata->_component_type == T_unsigned_byte, false);
+
+  } else if (cdata->_component_type != T_unsigned_byte &&
+             cdata->_component_type != T_unsigned_short &&
+             cdata->_component_type != T_float) {
+    gobj_cat.error()
+      << "Unable to generate mipmaps for 2D texture with component type "
+      << cdata->_component_type << "!\n";
+    return false;
+  }
+
+  size_t pixel_size = cdata->_num_components * cdata->_component_width;
+
+  int to_x_size = max(x_size >> 1, 1);
+  int to_y_size = max(y_size >> 1, 1);
+
+  size_t to_row_size = (size_t)to_x_size * pixel_size;
+  to._page_size = (size_t)to_y_size * to_row_size;
+  to._image = PTA_uchar::empty_array(to._page_size * cdata->_z_size * cdata->_num_views, get_class_type());
+
+  int num_rows = to_y_size * cdata->_z_size * cdata->_num_views;
+  int num_jobs = choose_num_jobs(to._image.size(), num_rows);
+  if (num_jobs <= 1) {
+    do_filter_2d_mipmap_rows(cdata, to, from, x_size, y_size, 0, num_rows);
+    return true;
+  }
+
+  JobPool *pool = JobPool::get_global_ptr();
+  pvector<FilterMipmapJob> jobs(num_jobs);
+  JobPool::Batch batch(pool);
+  for (int i = 0; i < num_jobs; ++i) {
+    FilterMipmapJob &job = jobs[i];
+    job._texture = this;
+    job._cdata = cdata;
+    job._to = &to;
+    job._from = &from;
+    job._x_size = x_size;
+    job._y_size = y_size;
+    job._begin_row = (int)((int64_t)num_rows * i / num_jobs);
+    job._end_row = (int)((int64_t)num_rows * (i + 1) / num_jobs);
+    batch.add_job(&job);
+  }
+  batch.wait();
+  return true;
+}
+
+/**
+ * Generates the job's range of rows of the new mipmap level.
+ */
+void Texture::FilterMipmapJob::
+do_job(Thread *current_thread) {
+  _texture->do_filter_2d_mipmap_rows(_cdata, *_to, *_from, _x_size, _y_size,
+                                     _begin_row, _end_row);
+}
+
+/**
+ * Does the work of do_filter_2d_mipmap_pages() for the indicated range of
+ * rows of the new level, counting the rows of all of its pages in sequence.
+ * The new level must already have been allocated, and the component type
+ * checked, by do_filter_2d_mipmap_pages().
+ */
+void Texture::
+do_filter_2d_mipmap_rows(const CData *cdata,
+                         Texture::RamImage &to, const Texture::RamImage &from,
+                         int x_size, int y_size,
+                         int begin_row, int end_row) const {
+  Filter2DComponent *filter_component;
+  Filter2DComponent *filter_alpha;
+  Filter2DRow *filter_row = nullptr;
 
+  if (is_srgb(cdata->_format)) {
     if (has_sse2_sRGB_encode()) {
       filter_component = &filter_2d_unsigned_byte_srgb_sse2;
     } else {
@@ -9108,20 +9336,21 @@ do_filter_2d_mipmap_pages(const CData *cdata,
     switch (cdata->_component_type) {
     case T_unsigned_byte:
       filter_component = &filter_2d_unsigned_byte;
+      filter_row = &filter_2d_row_unsigned_byte;
       break;
 
     case T_unsigned_short:
       filter_component = &filter_2d_unsigned_short;
+      filter_row = &filter_2d_row_unsigned_short;
       break;
 
     case T_float:
       filter_component = &filter_2d_float;
+      filter_row = &filter_2d_row_float;
       break;
 
     default:
-      gobj_cat.error()
-        << "Unable to generate mipmaps for 2D texture with component type "
-        << cdata->_component_type << "!";
+      nassertv(false);
       return;
     }
     filter_alpha = filter_component;
@@ -9132,10 +9361,7 @@ do_filter_2d_mipmap_pages(const CData *cdata,
 
   int to_x_size = max(x_size >> 1, 1);
   int to_y_size = max(y_size >> 1, 1);
-
   size_t to_row_size = (size_t)to_x_size * pixel_size;
-  to._page_size = (size_t)to_y_size * to_row_size;
-  to._image = PTA_uchar::empty_array(to._page_size * cdata->_z_size * cdata->_num_views, get_class_type());
 
   bool alpha = has_alpha(cdata->_format);
   int num_color_components = cdata->_num_components;
@@ -9143,86 +9369,47 @@ do_filter_2d_mipmap_pages(const CData *cdata,
     --num_color_components;
   }
 
-  int num_pages = cdata->_z_size * cdata->_num_views;
-  for (int z = 0; z < num_pages; ++z) {
-    // For each level.
-    unsigned char *p = to._image.p() + z * to._page_size;
-    nassertv(p <= to._image.p() + to._image.size() + to._page_size);
-    const unsigned char *q = from._image.p() + z * from._page_size;
-    nassertv(q <= from._image.p() + from._image.size() + from._page_size);
-    if (y_size != 1) {
-      int y;
-      for (y = 0; y < y_size - 1; y += 2) {
-        // For each row.
-        nassertv(p == to._image.p() + z * to._page_size + (y / 2) * to_row_size);
-        nassertv(q == from._image.p() + z * from._page_size + y * row_size);
-        if (x_size != 1) {
-          int x;
-          for (x = 0; x < x_size - 1; x += 2) {
-            // For each pixel.
-            for (int c = 0; c < num_color_components; ++c) {
-              // For each component.
-              filter_component(p, q, pixel_size, row_size);
-            }
-            if (alpha) {
-              filter_alpha(p, q, pixel_size, row_size);
-            }
-            q += pixel_size;
-          }
-          if (x < x_size) {
-            // Skip the last odd pixel.
-            q += pixel_size;
-          }
-        } else {
-          // Just one pixel.
-          for (int c = 0; c < num_color_components; ++c) {
-            // For each component.
-            filter_component(p, q, 0, row_size);
-          }
-          if (alpha) {
-            filter_alpha(p, q, 0, row_size);
-          }
-        }
-        q += row_size;
-        Thread::consider_yield();
+  // If there is only one row, we filter it with itself.
+  size_t next_row = (y_size != 1) ? row_size : 0;
+
+  for (int row = begin_row; row < end_row; ++row) {
+    int z = row / to_y_size;
+    int y = row % to_y_size;
+
+    unsigned char *p = to._image.p() + z * to._page_size + y * to_row_size;
+    nassertv(p + to_row_size <= to._image.p() + to._image.size());
+    const unsigned char *q = from._image.p() + z * from._page_size + (y * 2) * row_size;
+    nassertv(q + row_size + next_row <= from._image.p() + from._image.size());
+
+    if (x_size == 1) {
+      // Just one pixel.
+      for (int c = 0; c < num_color_components; ++c) {
+        // For each component.
+        filter_component(p, q, 0, next_row);
       }
-      if (y < y_size) {
-        // Skip the last odd row.
-        q += row_size;
+      if (alpha) {
+        filter_alpha(p, q, 0, next_row);
       }
+
+    } else if (filter_row != nullptr) {
+      // Filter the whole row at once.  If x_size is odd, the last pixel is
+      // skipped.
+      filter_row(p, q, to_x_size, pixel_size, next_row);
+
     } else {
-      // Just one row.
-      if (x_size != 1) {
-        int x;
-        for (x = 0; x < x_size - 1; x += 2) {
-          // For each pixel.
-          for (int c = 0; c < num_color_components; ++c) {
-            // For each component.
-            filter_component(p, q, pixel_size, 0);
-          }
-          if (alpha) {
-            filter_alpha(p, q, pixel_size, 0);
-          }
-          q += pixel_size;
-        }
-        if (x < x_size) {
-          // Skip the last odd pixel.
-          q += pixel_size;
-        }
-      } else {
-        // Just one pixel.
+      for (int x = 0; x < to_x_size; ++x) {
+        // For each pixel.
         for (int c = 0; c < num_color_components; ++c) {
           // For each component.
-          filter_component(p, q, 0, 0);
+          filter_component(p, q, pixel_size, next_row);
         }
         if (alpha) {
-          filter_alpha(p, q, pixel_size, 0);
+          filter_alpha(p, q, pixel_size, next_row);
         }
+        q += pixel_size;
       }
     }
-
-    nassertv(p == to._image.p() + (z + 1) * to._page_size);
-    nassertv(q == from._image.p() + (z + 1) * from._page_size);
+    Thread::consider_yield();
   }
 }
 
@@ -9548,6 +9735,197 @@ filter_2d_float(unsigned char *&p, const unsigned char *&q,
   q += 4;
 }
 
+/**
+ * Averages each 2x2 block of pixels in a pair of rows into a single pixel,
+ * for producing the next mipmap level.  This produces the same result as
+ * calling filter_2d_unsigned_byte() for each component of each pixel in the
+ * row, but it is much faster.
+ */
+void Texture::
+filter_2d_row_unsigned_byte(unsigned char *p, const unsigned char *q,
+                            int num_pixels, size_t pixel_size,
+                            size_t row_size) {
+  const unsigned char *q1 = q + row_size;
+  int x = 0;
+
+#if defined(__SSE2__) || (_M_IX86_FP >= 2) || defined(_M_X64) || defined(_M_AMD64)
+  const __m128i zero = _mm_setzero_si128();
+  if (pixel_size == 4) {
+    // Eight source pixels at a time, which make four new pixels.
+    for (; x + 4 <= num_pixels; x += 4) {
+      const unsigned char *a = q + x * 8;
+      const unsigned char *b = q1 + x * 8;
+      __m128i a0 = _mm_loadu_si128((const __m128i *)a);
+      __m128i a1 = _mm_loadu_si128((const __m128i *)(a + 16));
+      __m128i b0 = _mm_loadu_si128((const __m128i *)b);
+      __m128i b1 = _mm_loadu_si128((const __m128i *)(b + 16));
+
+      // Sum the two rows, widened to 16 bits.  Each register now holds two
+      // pixels.
+      __m128i s01 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+      __m128i s23 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+      __m128i s45 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+      __m128i s67 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+      // Now add each even pixel to the odd pixel next to it.
+      __m128i d01 = _mm_add_epi16(_mm_unpacklo_epi64(s01, s23), _mm_unpackhi_epi64(s01, s23));
+      __m128i d23 = _mm_add_epi16(_mm_unpacklo_epi64(s45, s67), _mm_unpackhi_epi64(s45, s67));
+      d01 = _mm_srli_epi16(d01, 2);
+      d23 = _mm_srli_epi16(d23, 2);
+      _mm_storeu_si128((__m128i *)(p + x * 4), _mm_packus_epi16(d01, d23));
+    }
+
+  } else if (pixel_size == 1) {
+    // Sixteen source pixels at a time, which make eight new pixels.
+    const __m128i ones = _mm_set1_epi16(1);
+    for (; x + 8 <= num_pixels; x += 8) {
+      __m128i a = _mm_loadu_si128((const __m128i *)(q + x * 2));
+      __m128i b = _mm_loadu_si128((const __m128i *)(q1 + x * 2));
+      __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+      __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+
+      // Adding adjacent pairs of 16-bit values gives us 32-bit sums.
+      lo = _mm_srli_epi32(_mm_madd_epi16(lo, ones), 2);
+      hi = _mm_srli_epi32(_mm_madd_epi16(hi, ones), 2);
+      __m128i d = _mm_packs_epi32(lo, hi);
+      _mm_storel_epi64((__m128i *)(p + x), _mm_packus_epi16(d, d));
+    }
+  }
+#endif
+
+  q += x * pixel_size * 2;
+  q1 += x * pixel_size * 2;
+  p += x * pixel_size;
+  for (; x < num_pixels; ++x) {
+    for (size_t c = 0; c < pixel_size; ++c) {
+      unsigned int result = ((unsigned int)q[c] +
+                             (unsigned int)q[pixel_size + c] +
+                             (unsigned int)q1[c] +
+                             (unsigned int)q1[pixel_size + c]) >> 2;
+      p[c] = (unsigned char)result;
+    }
+    p += pixel_size;
+    q += pixel_size * 2;
+    q1 += pixel_size * 2;
+  }
+}
+
+/**
+ * Averages each 2x2 block of pixels in a pair of rows into a single pixel,
+ * for producing the next mipmap level.  This produces the same result as
+ * calling filter_2d_unsigned_short() for each component of each pixel in the
+ * row, but it is much faster.
+ */
+void Texture::
+filter_2d_row_unsigned_short(unsigned char *p, const unsigned char *q,
+                             int num_pixels, size_t pixel_size,
+                             size_t row_size) {
+  int x = 0;
+
+#if defined(__SSE2__) || (_M_IX86_FP >= 2) || defined(_M_X64) || defined(_M_AMD64)
+  if (pixel_size == 8) {
+    // Four source pixels at a time, which make two new pixels.
+    const unsigned char *q1 = q + row_size;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias32 = _mm_set1_epi32(0x8000);
+    const __m128i bias16 = _mm_set1_epi16((short)0x8000);
+    for (; x + 2 <= num_pixels; x += 2) {
+      const unsigned char *a = q + x * 16;
+      const unsigned char *b = q1 + x * 16;
+      __m128i a0 = _mm_loadu_si128((const __m128i *)a);
+      __m128i a1 = _mm_loadu_si128((const __m128i *)(a + 16));
+      __m128i b0 = _mm_loadu_si128((const __m128i *)b);
+      __m128i b1 = _mm_loadu_si128((const __m128i *)(b + 16));
+
+      // Sum the two rows, widened to 32 bits.  Each register now holds one
+      // pixel.
+      __m128i s0 = _mm_add_epi32(_mm_unpacklo_epi16(a0, zero), _mm_unpacklo_epi16(b0, zero));
+      __m128i s1 = _mm_add_epi32(_mm_unpackhi_epi16(a0, zero), _mm_unpackhi_epi16(b0, zero));
+      __m128i s2 = _mm_add_epi32(_mm_unpacklo_epi16(a1, zero), _mm_unpacklo_epi16(b1, zero));
+      __m128i s3 = _mm_add_epi32(_mm_unpackhi_epi16(a1, zero), _mm_unpackhi_epi16(b1, zero));
+      __m128i d0 = _mm_srli_epi32(_mm_add_epi32(s0, s1), 2);
+      __m128i d1 = _mm_srli_epi32(_mm_add_epi32(s2, s3), 2);
+
+      // SSE2 has no unsigned saturating pack from 32 to 16 bits, so we shift
+      // the values into signed range, and back again afterwards.
+      d0 = _mm_sub_epi32(d0, bias32);
+      d1 = _mm_sub_epi32(d1, bias32);
+      __m128i d = _mm_xor_si128(_mm_packs_epi32(d0, d1), bias16);
+      _mm_storeu_si128((__m128i *)(p + x * 8), d);
+    }
+  }
+#endif
+
+  size_t num_components = pixel_size / 2;
+  q += x * pixel_size * 2;
+  p += x * pixel_size;
+  for (; x < num_pixels; ++x) {
+    for (size_t c = 0; c < num_components; ++c) {
+      filter_2d_unsigned_short(p, q, pixel_size, row_size);
+    }
+    q += pixel_size;
+  }
+}
+
+/**
+ * Averages each 2x2 block of pixels in a pair of rows into a single pixel,
+ * for producing the next mipmap level.  This produces the same result as
+ * calling filter_2d_float() for each component of each pixel in the row, but
+ * it is much faster.
+ */
+void Texture::
+filter_2d_row_float(unsigned char *p, const unsigned char *q,
+                    int num_pixels, size_t pixel_size, size_t row_size) {
+  const float *a = (const float *)q;
+  const float *b = (const float *)(q + row_size);
+  float *d = (float *)p;
+  size_t num_components = pixel_size / 4;
+  int x = 0;
+
+#if defined(__SSE2__) || (_M_IX86_FP >= 2) || defined(_M_X64) || defined(_M_AMD64)
+  // The sums are done in the same order as in filter_2d_float(), so that the
+  // results are identical.
+  const __m128 quarter = _mm_set1_ps(0.25f);
+  if (num_components == 4) {
+    for (; x < num_pixels; ++x) {
+      __m128 sum = _mm_add_ps(_mm_loadu_ps(a), _mm_loadu_ps(a + 4));
+      sum = _mm_add_ps(sum, _mm_loadu_ps(b));
+      sum = _mm_add_ps(sum, _mm_loadu_ps(b + 4));
+      _mm_storeu_ps(d, _mm_mul_ps(sum, quarter));
+      a += 8;
+      b += 8;
+      d += 4;
+    }
+
+  } else if (num_components == 1) {
+    // Eight source pixels at a time, which make four new pixels.
+    for (; x + 4 <= num_pixels; x += 4) {
+      __m128 a0 = _mm_loadu_ps(a);
+      __m128 a1 = _mm_loadu_ps(a + 4);
+      __m128 b0 = _mm_loadu_ps(b);
+      __m128 b1 = _mm_loadu_ps(b + 4);
+      __m128 sum = _mm_add_ps(_mm_shuffle_ps(a0, a1, _MM_SHUFFLE(2, 0, 2, 0)),
+                              _mm_shuffle_ps(a0, a1, _MM_SHUFFLE(3, 1, 3, 1)));
+      sum = _mm_add_ps(sum, _mm_shuffle_ps(b0, b1, _MM_SHUFFLE(2, 0, 2, 0)));
+      sum = _mm_add_ps(sum, _mm_shuffle_ps(b0, b1, _MM_SHUFFLE(3, 1, 3, 1)));
+      _mm_storeu_ps(d, _mm_mul_ps(sum, quarter));
+      a += 8;
+      b += 8;
+      d += 4;
+    }
+  }
+#endif
+
+  for (; x < num_pixels; ++x) {
+    for (size_t c = 0; c < num_components; ++c) {
+      d[c] = (a[c] + a[num_components + c] + b[c] + b[num_components + c]) / 4.0f;
+    }
+    a += num_components * 2;
+    b += num_components * 2;
+    d += num_components;
+  }
+}
+
 /**
  * Averages a 2x2x2 block of pixel components into a single pixel component,
  * for producing the next mipmap level.  Increments p and q to the next
@@ -9666,8 +10044,23 @@ do_squish(CData *cdata, Texture::CompressionMode compression, int squish_flags)
     do_generate_ram_mipmap_images(cdata, false);
   }
 
+  size_t total_size = 0;
+  int total_cell_rows = 0;
+  for (size_t n = 0; n < cdata->_ram_images.size(); ++n) {
+    int y_size = do_get_expected_mipmap_y_size(cdata, n);
+    int num_pages = do_get_expected_mipmap_num_pages(cdata, n);
+    total_size += cdata->_ram_images[n]._image.size();
+    total_cell_rows += ((y_size + 3) >> 2) * num_pages;
+  }
+
+  // Divide the cells into jobs of about the same number of rows, without
+  // letting any job cross a page boundary.
+  int num_jobs = choose_num_jobs(total_size, total_cell_rows);
+  int rows_per_job = (total_cell_rows + num_jobs - 1) / num_jobs;
+
   RamImages compressed_ram_images;
   compressed_ram_images.reserve(cdata->_ram_images.size());
+  pvector<SquishJob> jobs;
   for (size_t n = 0; n < cdata->_ram_images.size(); ++n) {
     RamImage compressed_image;
     int x_size = do_get_expected_mipmap_x_size(cdata, n);
@@ -9675,66 +10068,43 @@ do_squish(CData *cdata, Texture::CompressionMode compression, int squish_flags)
     int num_pages = do_get_expected_mipmap_num_pages(cdata, n);
     int page_size = squish::GetStorageRequirements(x_size, y_size, squish_flags);
     int cell_size = squish::GetStorageRequirements(4, 4, squish_flags);
+    size_t cell_row_size = (size_t)((x_size + 3) >> 2) * cell_size;
 
     compressed_image._page_size = page_size;
     compressed_image._image = PTA_uchar::empty_array(page_size * num_pages);
     for (int z = 0; z < num_pages; ++z) {
       unsigned char *dest_page = compressed_image._image.p() + z * page_size;
       unsigned const char *source_page = cdata->_ram_images[n]._image.p() + z * cdata->_ram_images[n]._page_size;
-      unsigned const char *source_page_end = source_page + cdata->_ram_images[n]._page_size;
-      // Convert one 4 x 4 cell at a time.
-      unsigned char *d = dest_page;
-      for (int y = 0; y < y_size; y += 4) {
-        for (int x = 0; x < x_size; x += 4) {
-          unsigned char tb[16 * 4];
-          int mask = 0;
-          unsigned char *t = tb;
-          for (int i = 0; i < 16; ++i) {
-            int xi = x + i % 4;
-            int yi = y + i / 4;
-            unsigned const char *s = source_page + (yi * x_size + xi) * cdata->_num_components;
-            if (s < source_page_end) {
-              switch (cdata->_num_components) {
-              case 1:
-                t[0] = s[0];   // r
-                t[1] = s[0];   // g
-                t[2] = s[0];   // b
-                t[3] = 255;    // a
-                break;
-
-              case 2:
-                t[0] = s[0];   // r
-                t[1] = s[0];   // g
-                t[2] = s[0];   // b
-                t[3] = s[1];   // a
-                break;
 
-              case 3:
-                t[0] = s[2];   // r
-                t[1] = s[1];   // g
-                t[2] = s[0];   // b
-                t[3] = 255;    // a
-                break;
-
-              case 4:
-                t[0] = s[2];   // r
-                t[1] = s[1];   // g
-                t[2] = s[0];   // b
-                t[3] = s[3];   // a
-                break;
-              }
-              mask |= (1 << i);
-            }
-            t += 4;
-          }
-          squish::CompressMasked(tb, mask, d, squish_flags);
-          d += cell_size;
-          Thread::consider_yield();
-        }
+      for (int y = 0; y < y_size; y += rows_per_job * 4) {
+        SquishJob job;
+        job._dest = dest_page + (y >> 2) * cell_row_size;
+        job._source_page = source_page;
+        job._source_page_size = cdata->_ram_images[n]._page_size;
+        job._x_size = x_size;
+        job._begin_y = y;
+        job._end_y = min(y + rows_per_job * 4, y_size);
+        job._num_components = cdata->_num_components;
+        job._squish_flags = squish_flags;
+        jobs.push_back(job);
       }
     }
     compressed_ram_images.push_back(compressed_image);
   }
+
+  if (num_jobs <= 1) {
+    Thread *current_thread = Thread::get_current_thread();
+    for (SquishJob &job : jobs) {
+      job.do_job(current_thread);
+    }
+  } else {
+    JobPool::Batch batch(JobPool::get_global_ptr());
+    for (SquishJob &job : jobs) {
+      batch.add_job(&job);
+    }
+    batch.wait();
+  }
+
   cdata->_ram_images.swap(compressed_ram_images);
   cdata->_ram_image_compression = compression;
   return true;
@@ -9745,6 +10115,82 @@ do_squish(CData *cdata, Texture::CompressionMode compression, int squish_flags)
 #endif  // HAVE_SQUISH
 }
 
+#ifdef HAVE_SQUISH
+/**
+ * Compresses the rows of 4x4 cells of a single page of an image from begin_y
+ * to end_y, which are given in pixels, using squish.  dest points to the
+ * first compressed cell of row begin_y.
+ */
+void Texture::
+squish_block_rows(unsigned char *dest, const unsigned char *source_page,
+                  size_t source_page_size, int x_size,
+                  int begin_y, int end_y, int num_components,
+                  int squish_flags) {
+  unsigned const char *source_page_end = source_page + source_page_size;
+  int cell_size = squish::GetStorageRequirements(4, 4, squish_flags);
+
+  // Convert one 4 x 4 cell at a time.
+  unsigned char *d = dest;
+  for (int y = begin_y; y < end_y; y += 4) {
+    for (int x = 0; x < x_size; x += 4) {
+      unsigned char tb[16 * 4];
+      int mask = 0;
+      unsigned char *t = tb;
+      for (int i = 0; i < 16; ++i) {
+        int xi = x + i % 4;
+        int yi = y + i / 4;
+        unsigned const char *s = source_page + (yi * x_size + xi) * num_components;
+        if (s < source_page_end) {
+          switch (num_components) {
+          case 1:
+            t[0] = s[0];   // r
+            t[1] = s[0];   // g
+            t[2] = s[0];   // b
+            t[3] = 255;    // a
+            break;
+
+          case 2:
+            t[0] = s[0];   // r
+            t[1] = s[0];   // g
+            t[2] = s[0];   // b
+            t[3] = s[1];   // a
+            break;
+
+          case 3:
+            t[0] = s[2];   // r
+            t[1] = s[1];   // g
+            t[2] = s[0];   // b
+            t[3] = 255;    // a
+            break;
+
+          case 4:
+            t[0] = s[2];   // r
+            t[1] = s[1];   // g
+            t[2] = s[0];   // b
+            t[3] = s[3];   // a
+            break;
+          }
+          mask |= (1 << i);
+        }
+        t += 4;
+      }
+      squish::CompressMasked(tb, mask, d, squish_flags);
+      d += cell_size;
+      Thread::consider_yield();
+    }
+  }
+}
+
+/**
+ * Compresses the job's range of cell rows.
+ */
+void Texture::SquishJob::
+do_job(Thread *current_thread) {
+  squish_block_rows(_dest, _source_page, _source_page_size, _x_size,
+                    _begin_y, _end_y, _num_components, _squish_flags);
+}
+#endif  // HAVE_SQUISH
+
 /**
  * Invokes the squish library to uncompress the RAM image(s).
  */
@@ -707,6 +707,19 @@ protected:
                                         int x_size, int y_size, int z_size);
   static void do_compress_ram_image_bc5(const RamImage &src, RamImage &dest,
                                         int x_size, int y_size, int z_size);
+  typedef void CompressBlockRows(unsigned char *dest, const unsigned char *src,
+                                 int x_size, int num_block_rows);
+  static void do_compress_block_rows(CompressBlockRows *func,
+                                     unsigned char *dest,
+                                     const unsigned char *src,
+                                     size_t dest_row_size, size_t src_row_size,
+                                     int x_size, int num_block_rows);
+  static void compress_block_rows_bc4(unsigned char *dest,
+                                      const unsigned char *src,
+                                      int x_size, int num_block_rows);
+  static void compress_block_rows_bc5(unsigned char *dest,
+                                      const unsigned char *src,
+                                      int x_size, int num_block_rows);
   static void do_uncompress_ram_image_bc4(const RamImage &src, RamImage &dest,
                                           int x_size, int y_size, int z_size);
   static void do_uncompress_ram_image_bc5(const RamImage &src, RamImage &dest,
@@ -866,9 +879,13 @@ private:
   INLINE static bool is_dds_filename(const Filename &fullpath);
   INLINE static bool is_ktx_filename(const Filename &fullpath);
 
-  void do_filter_2d_mipmap_pages(const CData *cdata,
+  bool do_filter_2d_mipmap_pages(const CData *cdata,
                                  RamImage &to, const RamImage &from,
                                  int x_size, int y_size) const;
+  void do_filter_2d_mipmap_rows(const CData *cdata,
+                                RamImage &to, const RamImage &from,
+                                int x_size, int y_size,
+                                int begin_row, int end_row) const;
 
   void do_filter_3d_mipmap_level(const CData *cdata,
                                  RamImage &to, const RamImage &from,
@@ -878,6 +895,10 @@ private:
                                  const unsigned char *&q,
                                  size_t pixel_size, size_t row_size);
 
+  typedef void Filter2DRow(unsigned char *p, const unsigned char *q,
+                           int num_pixels, size_t pixel_size,
+                           size_t row_size);
+
   typedef void Filter3DComponent(unsigned char *&p,
                                  const unsigned char *&q,
                                  size_t pixel_size, size_t row_size,
@@ -898,6 +919,18 @@ private:
   static void filter_2d_float(unsigned char *&p, const unsigned char *&q,
                               size_t pixel_size, size_t row_size);
 
+  static void filter_2d_row_unsigned_byte(unsigned char *p,
+                                          const unsigned char *q,
+                                          int num_pixels, size_t pixel_size,
+                                          size_t row_size);
+  static void filter_2d_row_unsigned_short(unsigned char *p,
+                                           const unsigned char *q,
+                                           int num_pixels, size_t pixel_size,
+                                           size_t row_size);
+  static void filter_2d_row_float(unsigned char *p, const unsigned char *q,
+                                  int num_pixels, size_t pixel_size,
+                                  size_t row_size);
+
   static void filter_3d_unsigned_byte(unsigned char *&p,
                                       const unsigned char *&q,
                                       size_t pixel_size, size_t row_size,
@@ -918,6 +951,15 @@ private:
                               size_t pixel_size, size_t row_size, size_t page_size);
 
   bool do_squish(CData *cdata, CompressionMode compression, int squish_flags);
+  static void squish_block_rows(unsigned char *dest,
+                                const unsigned char *source_page,
+                                size_t source_page_size, int x_size,
+                                int begin_y, int end_y, int num_components,
+                                int squish_flags);
+
+  class FilterMipmapJob;
+  class CompressBlockRowsJob;
+  class SquishJob;
   bool do_unsquish(CData *cdata, int squish_flags);
 
 protected:
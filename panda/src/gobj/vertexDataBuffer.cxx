@@ -39,6 +39,8 @@ operator = (const VertexDataBuffer &copy) {
   _size = copy._size;
   _reserved_size = copy._size;
   _block = copy._block;
+  _mapping = copy._mapping;
+  _mapped_data = copy._mapped_data;
   nassertv(_reserved_size >= _size);
 }
 
@@ -55,6 +57,8 @@ swap(VertexDataBuffer &other) {
   size_t reserved_size = _reserved_size;
 
   _block.swap(other._block);
+  _mapping.swap(other._mapping);
+  std::swap(_mapped_data, other._mapped_data);
 
   _resident_data = other._resident_data;
   _size = other._size;
@@ -66,6 +70,31 @@ swap(VertexDataBuffer &other) {
   nassertv(_reserved_size >= _size);
 }
 
+/**
+ * Makes the buffer refer to the indicated data within a mapped file, instead
+ * of owning a copy of it.  The data must remain valid as long as the mapping
+ * object exists, and must be suitably aligned.  It is never written to; if
+ * the buffer is subsequently modified, it is copied into memory of its own
+ * first.
+ */
+void VertexDataBuffer::
+set_mapped_data(MemoryMappedFile *mapping, const unsigned char *data,
+                size_t size) {
+  LightMutexHolder holder(_lock);
+  nassertv(mapping != nullptr && data != nullptr);
+  nassertv(((uintptr_t)data % MEMORY_HOOK_ALIGNMENT) == 0);
+
+  _size = 0;
+  do_unclean_realloc(0);
+
+  if (size != 0) {
+    _mapping = mapping;
+    _mapped_data = data;
+    _size = size;
+    _reserved_size = size;
+  }
+}
+
 /**
  * Changes the reserved size of the buffer, preserving its data (except for
  * any data beyond the new end of the buffer, if the buffer is being reduced).
@@ -119,8 +148,10 @@ do_unclean_realloc(size_t reserved_size) {
         << this << ".unclean_realloc(" << reserved_size << ")\n";
     }
 
-    // If we're paged out, discard the page.
+    // If we're paged out or mapped, discard the page or mapping.
     _block = nullptr;
+    _mapping = nullptr;
+    _mapped_data = nullptr;
 
     if (_resident_data != nullptr) {
       nassertv(_reserved_size != 0);
@@ -151,8 +182,8 @@ do_unclean_realloc(size_t reserved_size) {
  */
 void VertexDataBuffer::
 do_page_out(VertexDataBook &book) {
-  if (_block != nullptr || _reserved_size == 0) {
-    // We're already paged out.
+  if (_block != nullptr || _mapped_data != nullptr || _reserved_size == 0) {
+    // We're already paged out, or our memory isn't ours to page out.
     return;
   }
   nassertv(_resident_data != nullptr);
@@ -194,9 +225,21 @@ do_page_in() {
     return;
   }
 
-  nassertv(_block != nullptr);
   nassertv(_reserved_size == _size);
 
+  if (_mapped_data != nullptr) {
+    // Copy the data out of the mapped file, and let go of it.
+    _resident_data = (unsigned char *)get_class_type().allocate_array(_size);
+    nassertv(_resident_data != nullptr);
+
+    memcpy(_resident_data, _mapped_data, _size);
+    _mapping = nullptr;
+    _mapped_data = nullptr;
+    return;
+  }
+
+  nassertv(_block != nullptr);
+
   _resident_data = (unsigned char *)get_class_type().allocate_array(_size);
   nassertv(_resident_data != nullptr);
 
@@ -22,6 +22,7 @@
 #include "pStatCollector.h"
 #include "lightMutex.h"
 #include "lightMutexHolder.h"
+#include "memoryMappedFile.h"
 
 /**
  * A block of bytes that stores the actual raw vertex data referenced by a
@@ -39,10 +40,16 @@
  * memory is considered read-only.  In this state, _reserved_size will always
  * equal _size.
  *
+ * mapped - the buffer's memory belongs to a file that has been mapped into
+ * memory, such as the bam file it was loaded from (in _mapped_data, kept
+ * alive by _mapping).  This memory is also read-only, and _reserved_size
+ * will always equal _size.
+ *
  * VertexDataBuffers start out in independent state.  They get moved to paged
  * state when their owning GeomVertexArrayData objects get evicted from the
  * _independent_lru.  They can get moved back to independent state if they are
- * modified (e.g.  get_write_pointer() or realloc() is called).
+ * modified (e.g.  get_write_pointer() or realloc() is called).  A mapped
+ * buffer is likewise copied into independent state when it is modified.
  *
  * The idea is to keep the highly dynamic and frequently-modified
  * VertexDataBuffers resident in easy-to-access memory, while collecting the
@@ -69,6 +76,10 @@ public:
 
   INLINE void page_out(VertexDataBook &book);
 
+  void set_mapped_data(MemoryMappedFile *mapping, const unsigned char *data,
+                       size_t size);
+  INLINE bool is_mapped() const;
+
   void swap(VertexDataBuffer &other);
 
 private:
@@ -82,6 +93,8 @@ private:
   size_t _size;
   size_t _reserved_size;
   PT(VertexDataBlock) _block;
+  PT(MemoryMappedFile) _mapping;
+  const unsigned char *_mapped_data;
   LightMutex _lock;
 
 public:
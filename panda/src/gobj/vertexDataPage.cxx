@@ -47,6 +47,16 @@ ConfigVariableInt vertex_data_compression_level
           "vertex data.  The number should be in the range 1 to 9, where "
           "larger values are slower but give better compression."));
 
+ConfigVariableInt max_mapped_vertex_data
+("max-mapped-vertex-data", -1,
+ PRC_DESC("Specifies the maximum number of bytes of vertex data that is "
+          "allowed to remain mapped from the save file at one time, when "
+          "vertex-data-mmap is set.  If more than this number of bytes "
+          "is mapped, the least-recently-used pages will be unmapped "
+          "until they are needed again.  This limits address space rather "
+          "than memory, since the operating system may drop mapped pages "
+          "from memory anyway.  Set it to -1 for no limit."));
+
 ConfigVariableInt max_disk_vertex_data
 ("max-disk-vertex-data", -1,
  PRC_DESC("Specifies the maximum number of bytes of vertex data "
@@ -62,12 +72,14 @@ Mutex &VertexDataPage::_tlock = *(new Mutex("VertexDataPage::_tlock"));
 SimpleLru VertexDataPage::_resident_lru("resident", max_resident_vertex_data);
 SimpleLru VertexDataPage::_compressed_lru("compressed", max_compressed_vertex_data);
 SimpleLru VertexDataPage::_disk_lru("disk", 0);
+SimpleLru VertexDataPage::_mapped_lru("mapped", max_mapped_vertex_data);
 SimpleLru VertexDataPage::_pending_lru("pending", 0);
 
 SimpleLru *VertexDataPage::_global_lru[RC_end_of_list] = {
   &VertexDataPage::_resident_lru,
   &VertexDataPage::_compressed_lru,
   &VertexDataPage::_disk_lru,
+  &VertexDataPage::_mapped_lru,
 };
 
 VertexDataSaveFile *VertexDataPage::_save_file;
@@ -80,6 +92,7 @@ PStatCollector VertexDataPage::_vdata_compress_pcollector("*:Vertex Data:Compres
 PStatCollector VertexDataPage::_vdata_decompress_pcollector("*:Vertex Data:Decompress");
 PStatCollector VertexDataPage::_vdata_save_pcollector("*:Vertex Data:Save");
 PStatCollector VertexDataPage::_vdata_restore_pcollector("*:Vertex Data:Restore");
+PStatCollector VertexDataPage::_vdata_map_pcollector("*:Vertex Data:Map");
 PStatCollector VertexDataPage::_thread_wait_pcollector("Wait:Idle");
 PStatCollector VertexDataPage::_alloc_pages_pcollector("System memory:MMap:Vertex data");
 
@@ -155,7 +168,12 @@ VertexDataPage::
     }
   }
 
-  if (_page_data != nullptr) {
+  if (_ram_class == RC_mapped) {
+    _mapping.clear();
+    _page_data = nullptr;
+    _size = 0;
+
+  } else if (_page_data != nullptr) {
     free_page_data(_page_data, _allocated_size);
     _size = 0;
   }
@@ -268,7 +286,9 @@ evict_lru() {
 
   switch (_ram_class) {
   case RC_resident:
-    if (_compressed_lru.get_max_size() == 0) {
+    if (vertex_data_mmap) {
+      request_ram_class(RC_mapped);
+    } else if (_compressed_lru.get_max_size() == 0) {
       request_ram_class(RC_disk);
     } else {
       request_ram_class(RC_compressed);
@@ -276,6 +296,7 @@ evict_lru() {
     break;
 
   case RC_compressed:
+  case RC_mapped:
     request_ram_class(RC_disk);
     break;
 
@@ -301,6 +322,18 @@ VertexDataBlock *VertexDataPage::
 do_alloc(size_t size) {
   VertexDataBlock *block = (VertexDataBlock *)SimpleAllocator::do_alloc(size);
 
+  if (block != nullptr && get_readable_ram_class() == RC_mapped) {
+    // The new block is about to be written to, which can't be done through
+    // a read-only mapping.  Bring the page back into memory first.
+    MutexHolder holder(_tlock);
+    if (_pending_ram_class != _ram_class) {
+      nassertr(_thread_mgr != nullptr, block);
+      _thread_mgr->remove_page(this);
+    }
+    make_resident();
+    _pending_ram_class = _ram_class;
+  }
+
   if (block != nullptr && _ram_class != RC_disk) {
     // When we allocate a new block within a resident page, we have to clear
     // the disk cache (since we have just invalidated it).
@@ -311,8 +344,8 @@ do_alloc(size_t size) {
 }
 
 /**
- * Short-circuits the thread and forces the page into resident status
- * immediately.
+ * Short-circuits the thread and forces the page into resident status (or
+ * mapped status, if it can be mapped) immediately.
  *
  * Intended to be called from the main thread.  Assumes the lock is already
  * held.
@@ -325,8 +358,13 @@ make_resident_now() {
     _thread_mgr->remove_page(this);
   }
 
-  make_resident();
-  _pending_ram_class = RC_resident;
+  if (get_readable_ram_class() == RC_mapped) {
+    make_mapped();
+  }
+  if (_ram_class != RC_mapped) {
+    make_resident();
+  }
+  _pending_ram_class = _ram_class;
 }
 
 /**
@@ -343,6 +381,23 @@ make_resident() {
     return;
   }
 
+  if (_ram_class == RC_mapped) {
+    // Copy the data out of the mapping.  The copy on disk remains valid, so
+    // it needn't be written again if the page is evicted later.
+    size_t new_allocated_size = round_up(_uncompressed_size);
+    unsigned char *new_data = alloc_page_data(new_allocated_size);
+    memcpy(new_data, _page_data, _uncompressed_size);
+
+    _mapping.clear();
+    _page_data = new_data;
+    _size = _uncompressed_size;
+    _allocated_size = new_allocated_size;
+
+    set_lru_size(_size);
+    set_ram_class(RC_resident);
+    return;
+  }
+
   if (_ram_class == RC_disk) {
     do_restore_from_disk();
   }
@@ -442,6 +497,10 @@ make_compressed() {
     do_restore_from_disk();
   }
 
+  if (_ram_class == RC_mapped) {
+    make_resident();
+  }
+
   if (_ram_class == RC_resident) {
     nassertv(_size == _uncompressed_size);
 
@@ -563,6 +622,17 @@ make_disk() {
     return;
   }
 
+  if (_ram_class == RC_mapped) {
+    // The data is already on disk; we only need to let go of the mapping.
+    nassertv(_saved_block != nullptr);
+    _mapping.clear();
+    _page_data = nullptr;
+    _size = 0;
+
+    set_ram_class(RC_disk);
+    return;
+  }
+
   if (_ram_class == RC_resident || _ram_class == RC_compressed) {
     if (!do_save_to_disk()) {
       // Can't save it to disk for some reason.
@@ -580,6 +650,59 @@ make_disk() {
   }
 }
 
+/**
+ * Moves the page to mapped status by writing it to disk as necessary and
+ * mapping it back from there.
+ *
+ * Assumes the lock is already held.
+ */
+void VertexDataPage::
+make_mapped() {
+  if (_ram_class == RC_mapped) {
+    // If we're already mapped, just mark the page recently used.
+    mark_used_lru();
+    return;
+  }
+
+  if (_ram_class == RC_disk && do_map_from_disk()) {
+    return;
+  }
+
+  if (_ram_class == RC_disk || _ram_class == RC_compressed) {
+    make_resident();
+  }
+
+  if (_ram_class == RC_resident) {
+    if (_saved_block != nullptr && _saved_block->get_compressed()) {
+      // We can only map an uncompressed copy.
+      _saved_block.clear();
+    }
+    if (!do_save_to_disk()) {
+      // Can't save it to disk for some reason.
+      gobj_cat.warning()
+        << "Couldn't save page " << this << " to disk.\n";
+      mark_used_lru();
+      return;
+    }
+
+    unsigned char *page_data = _page_data;
+    size_t allocated_size = _allocated_size;
+    _page_data = nullptr;
+    _size = 0;
+    _ram_class = RC_disk;
+    if (!do_map_from_disk()) {
+      gobj_cat.warning()
+        << "Couldn't map page " << this << " from disk.\n";
+      _page_data = page_data;
+      _size = _uncompressed_size;
+      _ram_class = RC_resident;
+      mark_used_lru();
+      return;
+    }
+    free_page_data(page_data, allocated_size);
+  }
+}
+
 /**
  * Writes the page to disk, but does not evict it from memory or affect its
  * LRU status.  If it gets evicted later without having been modified, it will
@@ -657,6 +780,48 @@ do_restore_from_disk() {
   }
 }
 
+/**
+ * Maps the page read-only from its copy on disk, if it was stored there
+ * uncompressed, and makes it mapped.  Returns true on success, false if the
+ * page could not be mapped; in this case it is left on disk.
+ *
+ * Assumes the lock is already held.
+ */
+bool VertexDataPage::
+do_map_from_disk() {
+  nassertr(_ram_class == RC_disk, false);
+  nassertr(_saved_block != nullptr, false);
+  nassertr(_page_data == nullptr && _size == 0, false);
+
+  if (_saved_block->get_compressed()) {
+    return false;
+  }
+
+  PStatTimer timer(_vdata_map_pcollector);
+
+  PT(MemoryMappedFile) mapping = new MemoryMappedFile;
+  if (!get_save_file()->map_data(mapping, _saved_block)) {
+    return false;
+  }
+
+  if (gobj_cat.is_debug()) {
+    gobj_cat.debug()
+      << "Mapped page, " << _uncompressed_size << " bytes, from disk\n";
+  }
+
+  // Nothing may be written to the mapped memory.  do_alloc() makes the page
+  // resident before a new block is written to it, and a page is made resident
+  // before it is compressed.
+  _mapping = mapping;
+  _page_data = (unsigned char *)mapping->get_data();
+  _size = _uncompressed_size;
+  _allocated_size = mapping->get_size();
+
+  set_lru_size(_size);
+  set_ram_class(RC_mapped);
+  return true;
+}
+
 /**
  * Called when the "book size"--the size of the page as recorded in its book's
  * table--has changed for some reason.  Assumes the lock is held.
@@ -705,6 +870,10 @@ request_ram_class(RamClass ram_class) {
       make_disk();
       break;
 
+    case RC_mapped:
+      make_mapped();
+      break;
+
     case RC_end_of_list:
       break;
     }
@@ -795,7 +964,9 @@ add_page(VertexDataPage *page, RamClass ram_class) {
     page->mark_used_lru(&_pending_lru);
 
     page->_pending_ram_class = ram_class;
-    if (ram_class == RC_resident) {
+    if (ram_class == RC_resident ||
+        (ram_class == RC_mapped && page->_ram_class != RC_resident)) {
+      // This makes the page readable, so it gets priority.
       _pending_reads.push_back(page);
     } else {
       _pending_writes.push_back(page);
@@ -829,14 +1000,12 @@ remove_page(VertexDataPage *page) {
     }
   }
 
-  if (page->_pending_ram_class == RC_resident) {
-    PendingPages::iterator pi =
-      find(_pending_reads.begin(), _pending_reads.end(), page);
-    nassertv(pi != _pending_reads.end());
+  PendingPages::iterator pi =
+    find(_pending_reads.begin(), _pending_reads.end(), page);
+  if (pi != _pending_reads.end()) {
     _pending_reads.erase(pi);
   } else {
-    PendingPages::iterator pi =
-      find(_pending_writes.begin(), _pending_writes.end(), page);
+    pi = find(_pending_writes.begin(), _pending_writes.end(), page);
     nassertv(pi != _pending_writes.end());
     _pending_writes.erase(pi);
   }
@@ -973,6 +1142,10 @@ thread_main() {
         _working_page->make_disk();
         break;
 
+      case RC_mapped:
+        _working_page->make_mapped();
+        break;
+
       case RC_end_of_list:
         break;
       }
@@ -15,10 +15,12 @@
 #define VERTEXDATAPAGE_H
 
 #include "pandabase.h"
+#include "config_gobj.h"
 #include "simpleLru.h"
 #include "simpleAllocator.h"
 #include "pStatCollector.h"
 #include "vertexDataSaveFile.h"
+#include "memoryMappedFile.h"
 #include "pmutex.h"
 #include "conditionVar.h"
 #include "thread.h"
@@ -31,7 +33,8 @@ class VertexDataBlock;
 /**
  * A block of bytes that holds one or more VertexDataBlocks.  The entire page
  * may be paged out, in the form of in-memory compression or to an on-disk
- * cache file, if necessary.
+ * cache file, if necessary.  If vertex-data-mmap is set, a page that has been
+ * written to the cache file is mapped back read-only from it instead.
  */
 class EXPCL_PANDA_GOBJ VertexDataPage : public SimpleAllocator, public SimpleLruPage {
 private:
@@ -48,6 +51,11 @@ PUBLISHED:
     RC_compressed,
     RC_disk,
 
+    // The page has been written to disk and mapped back into memory
+    // read-only.  It may be read from, but its memory is owned by the
+    // operating system, which pages it in and out of the file as it sees fit.
+    RC_mapped,
+
     RC_end_of_list,  // list marker; do not use
   };
 
@@ -94,14 +102,17 @@ private:
   void make_resident();
   void make_compressed();
   void make_disk();
+  void make_mapped();
 
   bool do_save_to_disk();
   void do_restore_from_disk();
+  bool do_map_from_disk();
 
   void adjust_book_size();
 
   void request_ram_class(RamClass ram_class);
   INLINE void set_ram_class(RamClass ram_class);
+  INLINE RamClass get_readable_ram_class() const;
   static void make_save_file();
 
   INLINE size_t round_up(size_t page_size) const;
@@ -159,6 +170,7 @@ private:
   size_t _size, _allocated_size, _uncompressed_size;
   RamClass _ram_class;
   PT(VertexDataSaveBlock) _saved_block;
+  PT(MemoryMappedFile) _mapping;
   size_t _book_size;
   size_t _block_size;
 
@@ -198,6 +210,7 @@ private:
   static SimpleLru _resident_lru;
   static SimpleLru _compressed_lru;
   static SimpleLru _disk_lru;
+  static SimpleLru _mapped_lru;
   static SimpleLru _pending_lru;
   static SimpleLru *_global_lru[RC_end_of_list];
 
@@ -209,6 +222,7 @@ private:
   static PStatCollector _vdata_decompress_pcollector;
   static PStatCollector _vdata_save_pcollector;
   static PStatCollector _vdata_restore_pcollector;
+  static PStatCollector _vdata_map_pcollector;
   static PStatCollector _thread_wait_pcollector;
   static PStatCollector _alloc_pages_pcollector;
 
@@ -348,6 +348,27 @@ read_data(unsigned char *data, size_t size, VertexDataSaveBlock *block) {
   return true;
 }
 
+/**
+ * Maps the indicated block of the file read-only into memory, instead of
+ * reading it.  The block must be kept until the mapping is released, since
+ * otherwise its space in the file may be reused.  Returns true on success,
+ * false on failure.
+ */
+bool VertexDataSaveFile::
+map_data(MemoryMappedFile *mapping, VertexDataSaveBlock *block) {
+  MutexHolder holder(_lock);
+
+  if (!_is_valid) {
+    return false;
+  }
+
+#ifdef _WIN32
+  return mapping->map_handle(_handle, block->get_start(), block->get_size());
+#else
+  return mapping->map_fd(_fd, block->get_start(), block->get_size());
+#endif  // _WIN32
+}
+
 /**
  * Creates a new SimpleAllocatorBlock object.  Override this function to
  * specialize the block type returned.
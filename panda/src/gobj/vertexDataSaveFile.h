@@ -18,6 +18,7 @@
 #include "simpleAllocator.h"
 #include "filename.h"
 #include "pmutex.h"
+#include "memoryMappedFile.h"
 
 #if defined(_WIN32)
 #ifndef WIN32_LEAN_AND_MEAN
@@ -50,6 +51,7 @@ public:
                                      bool compressed);
   bool read_data(unsigned char *data, size_t size,
                  VertexDataSaveBlock *block);
+  bool map_data(MemoryMappedFile *mapping, VertexDataSaveBlock *block);
 
 protected:
   virtual SimpleAllocatorBlock *make_block(size_t start, size_t size);
@@ -54,6 +54,9 @@ open_read(const Filename &bam_filename, bool report_errors) {
   if (!_din.open(bam_filename)) {
     return false;
   }
+  if (bam_mmap) {
+    _din.map_file();
+  }
 
   return continue_open_read(bam_filename, report_errors);
 }
@@ -37,10 +37,13 @@ void CacheStats::
 reset(double now) {
 #ifndef NDEBUG
   _cache_hits = 0;
+  AtomicAdjust::set(_cache_thread_hits, 0);
   _cache_misses = 0;
   _cache_adds = 0;
   _cache_new_adds = 0;
   _cache_dels = 0;
+  AtomicAdjust::set(_lock_acquires, 0);
+  AtomicAdjust::set(_lock_contended, 0);
   _last_reset = now;
 #endif  // NDEBUG
 }
@@ -52,11 +55,15 @@ void CacheStats::
 write(std::ostream &out, const char *name) const {
 #ifndef NDEBUG
   out << name << " cache: " << _cache_hits << " hits, "
+      << AtomicAdjust::get(_cache_thread_hits) << " thread-local hits, "
       << _cache_misses << " misses\n"
       << _cache_adds + _cache_new_adds << "(" << _cache_new_adds << ") adds(new), "
       << _cache_dels << " dels, "
       << _total_cache_size << " / " << _num_states << " = "
       << (double)_total_cache_size / (double)_num_states
-      << " average cache size\n";
+      << " average cache size\n"
+      << AtomicAdjust::get(_lock_contended) << " / "
+      << AtomicAdjust::get(_lock_acquires)
+      << " lock acquisitions contended\n";
 #endif  // NDEBUG
 }
@@ -17,6 +17,8 @@
 #include "pandabase.h"
 #include "clockObject.h"
 #include "pnotify.h"
+#include "lightReMutex.h"
+#include "atomicAdjust.h"
 
 /**
  * This is used to track the utilization of the TransformState and RenderState
@@ -31,11 +33,13 @@ public:
   INLINE void maybe_report(const char *name);
 
   INLINE void inc_hits();
+  INLINE void inc_thread_hits();
   INLINE void inc_misses();
   INLINE void inc_adds(bool is_new);
   INLINE void inc_dels();
   INLINE void add_total_size(int count);
   INLINE void add_num_states(int count);
+  INLINE void check_contention(LightReMutex &lock);
 
 private:
 #ifndef NDEBUG
@@ -46,6 +50,12 @@ private:
   int _cache_dels = 0;
   int _total_cache_size = 0;
   int _num_states = 0;
+
+  // These are counted outside of the states lock, by any thread.
+  AtomicAdjust::Integer _cache_thread_hits = 0;
+  AtomicAdjust::Integer _lock_acquires = 0;
+  AtomicAdjust::Integer _lock_contended = 0;
+
   double _last_reset = 0.0;
 
   bool _cache_report = false;
@@ -39,6 +39,7 @@
 #include "findApproxLevelEntry.h"
 #include "fog.h"
 #include "fogAttrib.h"
+#include "frozenNode.h"
 #include "geomDrawCallbackData.h"
 #include "geomNode.h"
 #include "geomTransformer.h"
@@ -81,6 +82,7 @@
 #include "shaderAttrib.h"
 #include "shader.h"
 #include "showBoundsEffect.h"
+#include "softwareOcclusionCullTraverser.h"
 #include "stencilAttrib.h"
 #include "stateMunger.h"
 #include "texMatrixAttrib.h"
@@ -130,11 +132,44 @@ ConfigVariableBool debug_portal_cull
           "(You first need to enable portal culling, using the allow-portal-cull"
           "variable.)"));
 
+ConfigVariableInt cull_parallel_depth
+("cull-parallel-depth", 2,
+ PRC_DESC("When the cull traversal is split across multiple threads (see "
+          "the \"*\" suffix of the threading-model), this is the depth in "
+          "the scene graph, below the scene root, at which the traversal is "
+          "handed off to the worker threads.  Each node at this depth is "
+          "traversed as a separate job.  Smaller values produce fewer, "
+          "larger jobs."));
+
+ConfigVariableBool cull_update_bounds
+("cull-update-bounds", true,
+ PRC_DESC("When this is true, the bounding volumes of the scene graph are "
+          "brought up to date in a single pass just before each cull "
+          "traversal, visiting only the subgraphs whose bounds have been "
+          "marked stale.  When the cull is split across multiple threads, "
+          "this pass is also shared with the worker threads.  When it is "
+          "false, the bounds are recomputed as the cull traversal discovers "
+          "them."));
+
+ConfigVariableInt bounds_update_parallel_threshold
+("bounds-update-parallel-threshold", 16,
+ PRC_DESC("The minimum number of children with stale bounds a node must have "
+          "before PandaNode::update_bounds() hands the children off to the "
+          "worker threads of a JobPool, if one is given.  Set this to 0 to "
+          "always recompute the bounds on the calling thread."));
+
 ConfigVariableBool show_occluder_volumes
 ("show-occluder-volumes", false,
  PRC_DESC("Set this true to enable debug visualization of the volumes used "
           "to cull objects behind an occluder."));
 
+ConfigVariableInt software_occlusion_size
+("software-occlusion-size", "256 128",
+ PRC_DESC("The size in pixels of the depth buffer into which a "
+          "SoftwareOcclusionCullTraverser draws its occluders.  Larger "
+          "buffers are more precise, but take longer to draw and to test "
+          "against."));
+
 ConfigVariableBool unambiguous_graph
 ("unambiguous-graph", false,
  PRC_DESC("Set this true to make ambiguous path warning messages generate an "
@@ -172,6 +207,19 @@ ConfigVariableBool compose_componentwise
           "operations when possible.  If this is false, the compositions "
           "are always computed by matrix."));
 
+ConfigVariableBool thread_composition_cache
+("thread-composition-cache", true,
+ PRC_DESC("Set this true to keep a small cache of recent TransformState and "
+          "RenderState compositions for each thread, which is checked before "
+          "consulting the global composition cache.  This avoids contention "
+          "on the global states lock when several threads (for instance, "
+          "the cull and animation threads) compose states at the same time.  "
+          "Each thread's cache holds a reference to a bounded number of "
+          "states.  RenderState::clear_cache() and "
+          "TransformState::clear_cache() only mark these caches as stale; "
+          "each thread releases its references the next time it composes "
+          "a state, so a thread that has gone idle keeps them until then."));
+
 ConfigVariableBool paranoid_const
 ("paranoid-const", false,
  PRC_DESC("Set this true to double-check that nothing is inappropriately "
@@ -413,6 +461,7 @@ init_libpgraph() {
   FindApproxLevelEntry::init_type();
   Fog::init_type();
   FogAttrib::init_type();
+  FrozenNode::init_type();
   GeomDrawCallbackData::init_type();
   GeomNode::init_type();
   GeomTransformer::init_type();
@@ -454,6 +503,7 @@ init_libpgraph() {
   ShadeModelAttrib::init_type();
   ShaderAttrib::init_type();
   ShowBoundsEffect::init_type();
+  SoftwareOcclusionCullTraverser::init_type();
   StateMunger::init_type();
   StencilAttrib::init_type();
   TexMatrixAttrib::init_type();
@@ -483,6 +533,7 @@ init_libpgraph() {
   DepthWriteAttrib::register_with_read_factory();
   Fog::register_with_read_factory();
   FogAttrib::register_with_read_factory();
+  FrozenNode::register_with_read_factory();
   GeomNode::register_with_read_factory();
   LensNode::register_with_read_factory();
   LightAttrib::register_with_read_factory();
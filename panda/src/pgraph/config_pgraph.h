@@ -34,13 +34,18 @@ extern ConfigVariableBool fake_view_frustum_cull;
 extern ConfigVariableBool clip_plane_cull;
 extern ConfigVariableBool allow_portal_cull;
 extern ConfigVariableBool debug_portal_cull;
+extern ConfigVariableInt cull_parallel_depth;
+extern EXPCL_PANDA_PGRAPH ConfigVariableBool cull_update_bounds;
+extern ConfigVariableInt bounds_update_parallel_threshold;
 extern ConfigVariableBool show_occluder_volumes;
+extern ConfigVariableInt software_occlusion_size;
 extern ConfigVariableBool unambiguous_graph;
 extern ConfigVariableBool detect_graph_cycles;
 extern ConfigVariableBool no_unsupported_copy;
 extern ConfigVariableBool allow_unrelated_wrt;
 extern ConfigVariableBool paranoid_compose;
 extern ConfigVariableBool compose_componentwise;
+extern ConfigVariableBool thread_composition_cache;
 extern ConfigVariableBool paranoid_const;
 extern ConfigVariableBool auto_break_cycles;
 extern EXPCL_PANDA_PGRAPH ConfigVariableBool garbage_collect_states;
@@ -21,6 +21,9 @@
 #include "pointerTo.h"
 #include "luse.h"
 #include "geomNode.h"
+#include "pvector.h"
+
+#include <algorithm>
 
 class CullableObject;
 class GraphicsStateGuardianBase;
@@ -65,9 +68,19 @@ protected:
   class ResultGraphBuilder;
   virtual void fill_result_graph(ResultGraphBuilder &builder)=0;
 
+  template<class ObjectData>
+  static void sort_by_key(pvector<ObjectData> &objects, int key_bits);
+  INLINE static uint32_t get_distance_key(PN_stdfloat distance);
+
 private:
   void check_flash_color();
 
+  template<class ObjectData>
+  class CompareSortKey {
+  public:
+    INLINE bool operator () (const ObjectData &a, const ObjectData &b) const;
+  };
+
 protected:
   std::string _name;
   BinType _bin_type;
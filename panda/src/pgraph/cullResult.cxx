@@ -28,6 +28,22 @@
 #include "config_pgraph.h"
 #include "depthOffsetAttrib.h"
 #include "colorBlendAttrib.h"
+#include "jobPool.h"
+
+/**
+ * Finishes the cull of one bin on behalf of CullResult::finish_cull().
+ */
+class CullResult::FinishCullJob : public JobPool::Job {
+public:
+  FinishCullJob(CullBin *bin, SceneSetup *scene_setup) :
+    _bin(bin),
+    _scene_setup(scene_setup) {}
+
+  virtual void do_job(Thread *current_thread);
+
+  CullBin *_bin;
+  SceneSetup *_scene_setup;
+};
 
 TypeHandle CullResult::_type_handle;
 
@@ -263,8 +279,20 @@ add_object(CullableObject *object, const CullTraverser *traverser) {
  */
 void CullResult::
 finish_cull(SceneSetup *scene_setup, Thread *current_thread) {
+  finish_cull(scene_setup, nullptr, current_thread);
+}
+
+/**
+ * This variant of finish_cull() shares the work of sorting the bins with the
+ * threads of the indicated JobPool, if it is not NULL.  Each bin is sorted
+ * independently of the others.
+ */
+void CullResult::
+finish_cull(SceneSetup *scene_setup, JobPool *job_pool,
+            Thread *current_thread) {
   CullBinManager *bin_manager = CullBinManager::get_global_ptr();
 
+  pvector<CullBin *> bins;
   for (size_t i = 0; i < _bins.size(); ++i) {
     if (!bin_manager->get_bin_active(i)) {
       // If the bin isn't active, don't sort it, and don't draw it.  In fact,
@@ -274,10 +302,35 @@ finish_cull(SceneSetup *scene_setup, Thread *current_thread) {
     } else {
       CullBin *bin = _bins[i];
       if (bin != nullptr) {
-        bin->finish_cull(scene_setup, current_thread);
+        bins.push_back(bin);
       }
     }
   }
+
+  if (job_pool == nullptr || bins.size() < 2) {
+    for (CullBin *bin : bins) {
+      bin->finish_cull(scene_setup, current_thread);
+    }
+    return;
+  }
+
+  pvector<FinishCullJob> jobs;
+  jobs.reserve(bins.size());
+
+  JobPool::Batch batch(job_pool, current_thread);
+  for (CullBin *bin : bins) {
+    jobs.push_back(FinishCullJob(bin, scene_setup));
+    batch.add_job(&jobs.back());
+  }
+  batch.wait();
+}
+
+/**
+ * Finishes the cull of the bin on the current thread.
+ */
+void CullResult::FinishCullJob::
+do_job(Thread *current_thread) {
+  _bin->finish_cull(_scene_setup, current_thread);
 }
 
 /**
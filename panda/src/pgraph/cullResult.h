@@ -29,6 +29,7 @@
 
 class CullTraverser;
 class GraphicsStateGuardianBase;
+class JobPool;
 class RenderState;
 class SceneSetup;
 class TransformState;
@@ -59,9 +60,14 @@ PUBLISHED:
   PT(PandaNode) make_result_graph();
 
 public:
+  void finish_cull(SceneSetup *scene_setup, JobPool *job_pool,
+                   Thread *current_thread);
+
   static void bin_removed(int bin_index);
 
 private:
+  class FinishCullJob;
+
   CullBin *make_new_bin(int bin_index);
 
   INLINE void check_flash_bin(CPT(RenderState) &state, CullBinManager *bin_manager, int bin_index);
@@ -34,11 +34,123 @@
 #include "geomLinestrips.h"
 #include "geomLines.h"
 #include "geomVertexWriter.h"
+#include "jobPool.h"
+#include "pStatTimer.h"
 
 PStatCollector CullTraverser::_nodes_pcollector("Nodes");
 PStatCollector CullTraverser::_geom_nodes_pcollector("Nodes:GeomNodes");
 PStatCollector CullTraverser::_geoms_pcollector("Geoms");
 PStatCollector CullTraverser::_geoms_occluded_pcollector("Geoms:Occluded");
+PStatCollector CullTraverser::_parallel_job_pcollector("Cull:Parallel:Job");
+PStatCollector CullTraverser::_parallel_wait_pcollector("Cull:Parallel:Wait");
+PStatCollector CullTraverser::_parallel_merge_pcollector("Cull:Parallel:Merge");
+
+/**
+ * Collects the objects produced by one thread's part of a parallel
+ * traversal, so that they can later be handed to the real CullHandler in a
+ * deterministic order.
+ */
+class CullTraverser::CollectHandler : public CullHandler {
+public:
+  virtual ~CollectHandler();
+
+  virtual void record_object(CullableObject *object,
+                             const CullTraverser *traverser);
+
+  typedef pvector<CullableObject *> Objects;
+  Objects _objects;
+};
+
+/**
+ * Traverses one subtree of the scene graph in a worker thread.  The job
+ * stores enough of the parent's CullTraverserData to reconstruct it in the
+ * worker, since the original only lives on the main thread's stack.
+ */
+class CullTraverser::SubtreeJob : public JobPool::Job {
+public:
+  SubtreeJob(const CullTraverser &trav, const CullTraverserData &parent,
+             PandaNode *child, size_t insert_point) :
+    _trav(new CullTraverser(trav)),
+    _parent_path(parent.get_node_path()),
+    _net_transform(parent._net_transform),
+    _state(parent._state),
+    _view_frustum(parent._view_frustum),
+    _cull_planes(parent._cull_planes),
+    _draw_mask(parent._draw_mask),
+    _portal_depth(parent._portal_depth),
+    _child(child),
+    _insert_point(insert_point) {}
+
+  virtual void do_job(Thread *current_thread);
+
+  PT(CullTraverser) _trav;
+  NodePath _parent_path;
+  CPT(TransformState) _net_transform;
+  CPT(RenderState) _state;
+  PT(GeometricBoundingVolume) _view_frustum;
+  CPT(CullPlanes) _cull_planes;
+  DrawMask _draw_mask;
+  int _portal_depth;
+  PT(PandaNode) _child;
+
+  // The number of objects the main thread had recorded at the time this job
+  // was created; the job's results are merged in at this point.
+  size_t _insert_point;
+  CollectHandler _collect;
+};
+
+/**
+ * The state of a parallel traversal, as seen by the thread that started it.
+ */
+class CullTraverser::ParallelCull : public CullTraverser::CollectHandler {
+public:
+  ParallelCull(JobPool *pool, Thread *current_thread) :
+    _batch(pool, current_thread) {}
+
+  typedef pvector<SubtreeJob *> Jobs;
+  Jobs _jobs;
+
+  JobPool::Batch _batch;
+};
+
+/**
+ * Deletes any objects that were never passed on, which only happens if the
+ * traversal was abandoned.
+ */
+CullTraverser::CollectHandler::
+~CollectHandler() {
+  for (CullableObject *object : _objects) {
+    delete object;
+  }
+}
+
+/**
+ * Stores the object for later merging.
+ */
+void CullTraverser::CollectHandler::
+record_object(CullableObject *object, const CullTraverser *traverser) {
+  _objects.push_back(object);
+}
+
+/**
+ * Traverses the subtree, collecting its objects into _collect.
+ */
+void CullTraverser::SubtreeJob::
+do_job(Thread *current_thread) {
+  PStatTimer timer(_parallel_job_pcollector, current_thread);
+
+  _trav->_current_thread = current_thread;
+  _trav->_cull_handler = &_collect;
+
+  CullTraverserData parent(_parent_path, _net_transform, _state,
+                           _view_frustum, current_thread);
+  parent._cull_planes = _cull_planes;
+  parent._draw_mask = _draw_mask;
+  parent._portal_depth = _portal_depth;
+
+  CullTraverserData data(parent, _child);
+  _trav->do_traverse(data);
+}
 
 TypeHandle CullTraverser::_type_handle;
 
@@ -56,6 +168,12 @@ CullTraverser() :
   _cull_handler = nullptr;
   _portal_clipper = nullptr;
   _effective_incomplete_render = true;
+  _job_pool = nullptr;
+  _parallel = nullptr;
+  _depth = 0;
+  _num_nodes = 0;
+  _num_geom_nodes = 0;
+  _num_geoms = 0;
 }
 
 /**
@@ -73,7 +191,13 @@ CullTraverser(const CullTraverser &copy) :
   _view_frustum(copy._view_frustum),
   _cull_handler(copy._cull_handler),
   _portal_clipper(copy._portal_clipper),
-  _effective_incomplete_render(copy._effective_incomplete_render)
+  _effective_incomplete_render(copy._effective_incomplete_render),
+  _job_pool(nullptr),
+  _parallel(nullptr),
+  _depth(0),
+  _num_nodes(0),
+  _num_geom_nodes(0),
+  _num_geoms(0)
 {
 }
 
@@ -152,8 +276,14 @@ traverse(const NodePath &root) {
                            _initial_state, _view_frustum,
                            _current_thread);
 
-    do_traverse(data);
+    if (_job_pool != nullptr && get_type() == get_class_type()) {
+      do_parallel_traverse(data);
+    } else {
+      do_traverse(data);
+    }
   }
+
+  flush_counts();
 }
 
 /**
@@ -172,7 +302,7 @@ traverse(CullTraverserData &data) {
  */
 void CullTraverser::
 traverse_below(CullTraverserData &data) {
-  _nodes_pcollector.add_level(1);
+  ++_num_nodes;
   PandaNodePipelineReader *node_reader = data.node_reader();
   PandaNode *node = data.node();
 
@@ -199,6 +329,24 @@ traverse_below(CullTraverserData &data) {
   PandaNode::Children children = node_reader->get_children();
   node_reader->release();
   int num_children = children.get_num_children();
+
+  if (_parallel != nullptr && _depth >= cull_parallel_depth) {
+    // Hand each of the children off to the job pool.
+    if (!node->has_selective_visibility()) {
+      for (int i = 0; i < num_children; ++i) {
+        defer_child(data, children.get_child(i));
+      }
+    } else {
+      int i = node->get_first_visible_child();
+      while (i < num_children) {
+        defer_child(data, children.get_child(i));
+        i = node->get_next_visible_child(i);
+      }
+    }
+    return;
+  }
+
+  ++_depth;
   if (!node->has_selective_visibility()) {
     for (int i = 0; i < num_children; ++i) {
       CullTraverserData next_data(data, children.get_child(i));
@@ -212,6 +360,7 @@ traverse_below(CullTraverserData &data) {
       i = node->get_next_visible_child(i);
     }
   }
+  --_depth;
 }
 
 /**
@@ -221,6 +370,83 @@ traverse_below(CullTraverserData &data) {
 void CullTraverser::
 end_traverse() {
   _cull_handler->end_traverse();
+  flush_counts();
+}
+
+/**
+ * Performs the traversal with the help of the JobPool.  The top of the scene
+ * graph is traversed in this thread, and everything below cull-parallel-depth
+ * is queued up as separate jobs.  The objects produced by each part are then
+ * passed to the real CullHandler in scene graph order, so that the result is
+ * identical to that of a serial traversal.
+ */
+void CullTraverser::
+do_parallel_traverse(CullTraverserData &data) {
+  ParallelCull parallel(_job_pool, _current_thread);
+
+  CullHandler *cull_handler = _cull_handler;
+  _cull_handler = &parallel;
+  _parallel = &parallel;
+  _depth = 0;
+
+  do_traverse(data);
+
+  _parallel = nullptr;
+  _cull_handler = cull_handler;
+
+  {
+    PStatTimer timer(_parallel_wait_pcollector, _current_thread);
+    parallel._batch.wait();
+  }
+
+  PStatTimer timer(_parallel_merge_pcollector, _current_thread);
+  ParallelCull::Jobs::const_iterator ji = parallel._jobs.begin();
+  size_t num_objects = parallel._objects.size();
+  for (size_t i = 0; i <= num_objects; ++i) {
+    while (ji != parallel._jobs.end() && (*ji)->_insert_point == i) {
+      SubtreeJob *job = (*ji);
+      _num_nodes += job->_trav->_num_nodes;
+      _num_geom_nodes += job->_trav->_num_geom_nodes;
+      _num_geoms += job->_trav->_num_geoms;
+      for (CullableObject *object : job->_collect._objects) {
+        _cull_handler->record_object(object, this);
+      }
+      job->_collect._objects.clear();
+      delete job;
+      ++ji;
+    }
+    if (i < num_objects) {
+      _cull_handler->record_object(parallel._objects[i], this);
+    }
+  }
+  parallel._objects.clear();
+  parallel._jobs.clear();
+}
+
+/**
+ * Adds the counts accumulated during traversal to the statistics collectors.
+ * This must be called in the thread that owns the traversal.
+ */
+void CullTraverser::
+flush_counts() {
+  _nodes_pcollector.add_level(_num_nodes);
+  _geom_nodes_pcollector.add_level(_num_geom_nodes);
+  _geoms_pcollector.add_level(_num_geoms);
+  _num_nodes = 0;
+  _num_geom_nodes = 0;
+  _num_geoms = 0;
+}
+
+/**
+ * Queues up a job to traverse the indicated child of the node represented by
+ * data, as part of a parallel traversal.
+ */
+void CullTraverser::
+defer_child(CullTraverserData &data, PandaNode *child) {
+  SubtreeJob *job =
+    new SubtreeJob(*this, data, child, _parallel->_objects.size());
+  _parallel->_jobs.push_back(job);
+  _parallel->_batch.add_job(job);
 }
 
 /**
@@ -232,7 +458,7 @@ draw_bounding_volume(const BoundingVolume *vol,
   PT(Geom) bounds_viz = make_bounds_viz(vol);
 
   if (bounds_viz != nullptr) {
-    _geoms_pcollector.add_level(2);
+    _num_geoms += 2;
     CullableObject *outer_viz =
       new CullableObject(bounds_viz, get_bounds_outer_viz_state(),
                          internal_transform);
@@ -267,7 +493,7 @@ show_bounds(CullTraverserData &data, bool tight) {
     PT(Geom) bounds_viz = make_tight_bounds_viz(node);
 
     if (bounds_viz != nullptr) {
-      _geoms_pcollector.add_level(1);
+      ++_num_geoms;
       CullableObject *outer_viz =
         new CullableObject(std::move(bounds_viz), get_bounds_outer_viz_state(),
                            internal_transform);
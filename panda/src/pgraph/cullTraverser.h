@@ -27,6 +27,7 @@
 #include "typedReferenceCount.h"
 #include "pStatCollector.h"
 #include "fogAttrib.h"
+#include "jobPool.h"
 
 class GraphicsStateGuardian;
 class PandaNode;
@@ -77,6 +78,10 @@ PUBLISHED:
 
   INLINE bool get_effective_incomplete_render() const;
 
+  INLINE void set_job_pool(JobPool *job_pool);
+  INLINE JobPool *get_job_pool() const;
+  MAKE_PROPERTY(job_pool, get_job_pool, set_job_pool);
+
   void traverse(const NodePath &root);
   void traverse(CullTraverserData &data);
   virtual void traverse_below(CullTraverserData &data);
@@ -88,6 +93,10 @@ PUBLISHED:
   void draw_bounding_volume(const BoundingVolume *vol,
                             const TransformState *internal_transform) const;
 
+public:
+  INLINE void count_geom_nodes(int num_geom_nodes);
+  INLINE void count_geoms(int num_geoms);
+
 protected:
   INLINE void do_traverse(CullTraverserData &data);
 
@@ -99,8 +108,19 @@ public:
   static PStatCollector _geom_nodes_pcollector;
   static PStatCollector _geoms_pcollector;
   static PStatCollector _geoms_occluded_pcollector;
+  static PStatCollector _parallel_job_pcollector;
+  static PStatCollector _parallel_wait_pcollector;
+  static PStatCollector _parallel_merge_pcollector;
 
 private:
+  class CollectHandler;
+  class SubtreeJob;
+  class ParallelCull;
+
+  void do_parallel_traverse(CullTraverserData &data);
+  void defer_child(CullTraverserData &data, PandaNode *child);
+  void flush_counts();
+
   void show_bounds(CullTraverserData &data, bool tight);
   static PT(Geom) make_bounds_viz(const BoundingVolume *vol);
   PT(Geom) make_tight_bounds_viz(PandaNode *node) const;
@@ -122,6 +142,19 @@ private:
   PortalClipper *_portal_clipper;
   bool _effective_incomplete_render;
 
+  // These are only used when the traversal is split across a JobPool.
+  JobPool *_job_pool;
+  ParallelCull *_parallel;
+  int _depth;
+
+  // The levels for the statistics collectors above are counted up separately
+  // by each traverser, since the traversers of a parallel cull run in
+  // different threads, and are only added to the collectors by the traverser
+  // that runs in the cull thread.
+  int _num_nodes;
+  int _num_geom_nodes;
+  mutable int _num_geoms;
+
 public:
   static TypeHandle get_class_type() {
     return _type_handle;
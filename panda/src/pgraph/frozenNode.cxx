@@ -0,0 +1,378 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file frozenNode.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#include "frozenNode.h"
+#include "geomNode.h"
+#include "modelNode.h"
+#include "modelRoot.h"
+#include "cullTraverser.h"
+#include "cullTraverserData.h"
+#include "cullHandler.h"
+#include "cullableObject.h"
+#include "boundingBox.h"
+#include "boundingHexahedron.h"
+#include "finiteBoundingVolume.h"
+#include "lightMutexHolder.h"
+#include "pStatTimer.h"
+#include "bamReader.h"
+
+TypeHandle FrozenNode::_type_handle;
+
+PStatCollector FrozenNode::_compile_pcollector("*:Frozen:Compile");
+
+/**
+ *
+ */
+FrozenNode::
+FrozenNode(const std::string &name) :
+  PandaNode(name)
+{
+  set_cull_callback();
+}
+
+/**
+ *
+ */
+FrozenNode::
+FrozenNode(const FrozenNode &copy) :
+  PandaNode(copy)
+{
+  set_cull_callback();
+}
+
+/**
+ * Returns a newly-allocated Node that is a shallow copy of this one.  It will
+ * be a different Node pointer, but its internal data may or may not be shared
+ * with that of the original Node.
+ */
+PandaNode *FrozenNode::
+make_copy() const {
+  return new FrozenNode(*this);
+}
+
+/**
+ * Returns true if it is generally safe to combine this particular kind of
+ * PandaNode with other kinds of PandaNodes of compatible type, adding
+ * children or whatever.  For instance, an LODNode should not be combined with
+ * any other PandaNode, because its set of children is meaningful.
+ */
+bool FrozenNode::
+safe_to_combine() const {
+  return false;
+}
+
+/**
+ * Returns true if it is generally safe to flatten out this particular kind of
+ * PandaNode by duplicating instances (by calling dupe_for_flatten()), false
+ * otherwise (for instance, a Camera cannot be safely flattened, because the
+ * Camera pointer itself is meaningful).
+ */
+bool FrozenNode::
+safe_to_flatten() const {
+  return false;
+}
+
+/**
+ * This function will be called during the cull traversal to perform any
+ * additional operations that should be performed at cull time.  This may
+ * include additional manipulation of render state or additional
+ * visible/invisible decisions, or any other arbitrary operation.
+ *
+ * By the time this function is called, the node has already passed the
+ * bounding-volume test for the viewing frustum, and the node's transform and
+ * state have already been applied to the indicated CullTraverserData object.
+ *
+ * The return value is true if this node should be visible, or false if it
+ * should be culled.
+ */
+bool FrozenNode::
+cull_callback(CullTraverser *trav, CullTraverserData &data) {
+  // The snapshot can't represent the per-camera tag states, and subclasses
+  // of CullTraverser may need to see every node.
+  if (trav->has_tag_state_key() ||
+      trav->get_type() != CullTraverser::get_class_type()) {
+    return true;
+  }
+
+  // Nor does it test the Geoms against any occluders or clip planes that
+  // apply here, so let the children be culled against those in the normal
+  // way.
+  if (!data._cull_planes->is_empty()) {
+    return true;
+  }
+
+  Thread *current_thread = trav->get_current_thread();
+  PT(Snapshot) snapshot = get_snapshot(current_thread);
+  if (!snapshot->_supported) {
+    // Traverse the children in the normal way.
+    return true;
+  }
+
+  // Fetch the planes of the view frustum, which has already been transformed
+  // into our coordinate space, so that the boxes can be tested against it
+  // directly.  Other kinds of frustums fall back to the general test.
+  const GeometricBoundingVolume *frustum = data._view_frustum;
+  const BoundingHexahedron *hexahedron = nullptr;
+  LPlane planes[6];
+  int num_planes = 0;
+  if (frustum != nullptr) {
+    hexahedron = frustum->as_bounding_hexahedron();
+    if (hexahedron != nullptr) {
+      num_planes = hexahedron->get_num_planes();
+      nassertr(num_planes <= 6, true);
+      for (int i = 0; i < num_planes; ++i) {
+        planes[i] = hexahedron->get_plane(i);
+      }
+    }
+  }
+
+  CPT(TransformState) internal_transform = data.get_internal_transform(trav);
+  CullHandler *cull_handler = trav->get_cull_handler();
+
+  // Consecutive Geoms often share the same transform, so remember the last
+  // composition.
+  const TransformState *last_transform = nullptr;
+  CPT(TransformState) last_net_transform;
+
+  size_t num_geoms = snapshot->_geoms.size();
+  int num_drawn = 0;
+  for (size_t i = 0; i < num_geoms; ++i) {
+    unsigned char flags = snapshot->_flags[i];
+    if ((flags & EF_empty) != 0 || snapshot->_geoms[i]->is_empty()) {
+      continue;
+    }
+
+    if ((flags & EF_cull) != 0 && frustum != nullptr) {
+      if (hexahedron != nullptr) {
+        if (is_outside(planes, num_planes, snapshot->_min[i], snapshot->_max[i])) {
+          continue;
+        }
+      } else {
+        BoundingBox box(snapshot->_min[i], snapshot->_max[i]);
+        box.local_object();
+        if (frustum->contains(&box) == BoundingVolume::IF_no_intersection) {
+          continue;
+        }
+      }
+    }
+
+    CPT(RenderState) state = data._state->compose(snapshot->_states[i]);
+    if (state->has_cull_callback() && !state->cull_callback(trav, data)) {
+      continue;
+    }
+
+    const TransformState *transform = snapshot->_transforms[i];
+    if (transform != last_transform) {
+      last_transform = transform;
+      last_net_transform = internal_transform->compose(transform);
+    }
+
+    CullableObject *object =
+      new CullableObject(snapshot->_geoms[i], std::move(state), last_net_transform);
+    cull_handler->record_object(object, trav);
+    ++num_drawn;
+  }
+  trav->count_geoms(num_drawn);
+
+  // We have already taken care of everything below this node.
+  return false;
+}
+
+/**
+ * Returns the number of Geoms below this node that are drawn from the
+ * compiled snapshot, compiling it first if necessary.  Returns -1 if the
+ * subgraph contains nodes that cannot be frozen, and is traversed normally.
+ */
+int FrozenNode::
+get_num_frozen_geoms(Thread *current_thread) const {
+  PT(Snapshot) snapshot = get_snapshot(current_thread);
+  if (!snapshot->_supported) {
+    return -1;
+  }
+  return (int)snapshot->_geoms.size();
+}
+
+/**
+ * Returns the compiled contents of the subgraph, rebuilding it if anything
+ * below this node has changed since it was last compiled.  Any such change
+ * marks our bounding volume stale, so we use the bounds sequence number to
+ * detect it.
+ */
+PT(FrozenNode::Snapshot) FrozenNode::
+get_snapshot(Thread *current_thread) const {
+  UpdateSeq seq;
+  get_bounds(seq, current_thread);
+
+  {
+    LightMutexHolder holder(_lock);
+    if (_snapshot != nullptr && _snapshot->_seq == seq) {
+      return _snapshot;
+    }
+  }
+
+  PStatTimer timer(_compile_pcollector, current_thread);
+
+  PT(Snapshot) snapshot = new Snapshot;
+  snapshot->_seq = seq;
+  snapshot->_supported = true;
+
+  CPT(TransformState) transform = TransformState::make_identity();
+  CPT(RenderState) state = RenderState::make_empty();
+  bool cull = !is_final(current_thread);
+
+  Children children = get_children(current_thread);
+  size_t num_children = children.get_num_children();
+  for (size_t i = 0; i < num_children && snapshot->_supported; ++i) {
+    snapshot->_supported = r_compile(snapshot, children.get_child(i),
+                                     transform, state, cull, current_thread);
+  }
+
+  if (!snapshot->_supported) {
+    // There's no point in keeping the partial contents.
+    snapshot->_geoms.clear();
+    snapshot->_states.clear();
+    snapshot->_transforms.clear();
+    snapshot->_min.clear();
+    snapshot->_max.clear();
+    snapshot->_flags.clear();
+  }
+
+  LightMutexHolder holder(_lock);
+  _snapshot = snapshot;
+  return snapshot;
+}
+
+/**
+ * Adds the Geoms of the indicated node and its descendants to the snapshot.
+ * Returns false if a node was encountered that cannot be frozen.
+ */
+bool FrozenNode::
+r_compile(Snapshot *snapshot, PandaNode *node,
+          const TransformState *parent_transform,
+          const RenderState *parent_state, bool cull,
+          Thread *current_thread) const {
+  TypeHandle type = node->get_type();
+  if (type != PandaNode::get_class_type() &&
+      type != ModelNode::get_class_type() &&
+      type != ModelRoot::get_class_type() &&
+      type != GeomNode::get_class_type()) {
+    return false;
+  }
+
+  int fancy_bits = node->get_fancy_bits(current_thread);
+  if ((fancy_bits & (FB_effects | FB_draw_mask | FB_cull_callback)) != 0) {
+    return false;
+  }
+
+  CPT(TransformState) transform =
+    parent_transform->compose(node->get_transform(current_thread));
+  CPT(RenderState) state =
+    parent_state->compose(node->get_state(current_thread));
+
+  if (node->is_final(current_thread)) {
+    // Nothing below a final node is culled individually.
+    cull = false;
+  }
+
+  if (type == GeomNode::get_class_type()) {
+    const GeomNode *gnode = (const GeomNode *)node;
+    GeomNode::Geoms geoms = gnode->get_geoms(current_thread);
+    int num_geoms = geoms.get_num_geoms();
+
+    // As in GeomNode::add_for_draw(), a lone Geom is only culled by the
+    // bounds of its node, which may have been set explicitly.
+    CPT(BoundingVolume) node_volume = gnode->get_internal_bounds(current_thread);
+    for (int i = 0; i < num_geoms; ++i) {
+      CPT(Geom) geom = geoms.get_geom(i);
+      CPT(BoundingVolume) volume = node_volume;
+      if (num_geoms > 1) {
+        volume = geom->get_bounds(current_thread);
+      }
+      add_entry(snapshot, geom, state->compose(geoms.get_geom_state(i)),
+                transform, volume, cull);
+    }
+  }
+
+  Children children = node->get_children(current_thread);
+  size_t num_children = children.get_num_children();
+  for (size_t i = 0; i < num_children; ++i) {
+    if (!r_compile(snapshot, children.get_child(i), transform, state, cull,
+                   current_thread)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Appends one Geom to the snapshot, along with the bounding box of the
+ * indicated volume, in the coordinate space of the FrozenNode.
+ */
+void FrozenNode::
+add_entry(Snapshot *snapshot, const Geom *geom, const RenderState *state,
+          const TransformState *transform, const BoundingVolume *volume,
+          bool cull) {
+  unsigned char flags = 0;
+  LPoint3 min_point(0, 0, 0);
+  LPoint3 max_point(0, 0, 0);
+
+  if (volume->is_empty()) {
+    // The cull traversal never draws anything with empty bounds.
+    flags |= EF_empty;
+
+  } else if (cull && !volume->is_infinite()) {
+    const FiniteBoundingVolume *fbv = volume->as_finite_bounding_volume();
+    if (fbv != nullptr) {
+      flags |= EF_cull;
+      BoundingBox box(fbv->get_min(), fbv->get_max());
+      box.local_object();
+      if (!transform->is_identity()) {
+        box.xform(transform->get_mat());
+      }
+      min_point = box.get_minq();
+      max_point = box.get_maxq();
+    }
+  }
+
+  snapshot->_geoms.push_back(geom);
+  snapshot->_states.push_back(state);
+  snapshot->_transforms.push_back(transform);
+  snapshot->_min.push_back(min_point);
+  snapshot->_max.push_back(max_point);
+  snapshot->_flags.push_back(flags);
+}
+
+/**
+ * Tells the BamReader how to create objects of type FrozenNode.
+ */
+void FrozenNode::
+register_with_read_factory() {
+  BamReader::get_factory()->register_factory(get_class_type(), make_from_bam);
+}
+
+/**
+ * This function is called by the BamReader's factory when a new object of
+ * type FrozenNode is encountered in the Bam file.  It should create the
+ * FrozenNode and extract its information from the file.
+ */
+TypedWritable *FrozenNode::
+make_from_bam(const FactoryParams &params) {
+  FrozenNode *node = new FrozenNode("");
+  DatagramIterator scan;
+  BamReader *manager;
+
+  parse_params(params, scan, manager);
+  node->fillin(scan, manager);
+
+  return node;
+}
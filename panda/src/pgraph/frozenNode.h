@@ -0,0 +1,132 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file frozenNode.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef FROZENNODE_H
+#define FROZENNODE_H
+
+#include "pandabase.h"
+
+#include "pandaNode.h"
+#include "geom.h"
+#include "renderState.h"
+#include "transformState.h"
+#include "updateSeq.h"
+#include "lightMutex.h"
+#include "pvector.h"
+#include "luse.h"
+
+/**
+ * A node that is placed above a static part of the scene graph, such as the
+ * walls and props of a level, to speed up the cull traversal of it.
+ *
+ * The first time the node is culled, the Geoms below it are compiled into a
+ * flat array that holds, for each Geom, its transform and state relative to
+ * the FrozenNode and its bounding box in the FrozenNode's coordinate space.
+ * The cull traversal then simply walks through this array instead of
+ * visiting the nodes one at a time.  The scene graph itself is not modified,
+ * unlike with flatten_strong(), so the nodes below may still be manipulated
+ * freely; any such change is detected and the array is rebuilt the next time
+ * the node is culled.  This is of course only worthwhile if such changes are
+ * rare.
+ *
+ * Only PandaNodes, ModelNodes and GeomNodes without render effects, draw
+ * masks or cull callbacks are compiled.  If any other kind of node is found
+ * below a FrozenNode, the subgraph is traversed normally.  The same goes for
+ * a FrozenNode that is culled while occluders or clip planes are in effect.
+ */
+class EXPCL_PANDA_PGRAPH FrozenNode : public PandaNode {
+PUBLISHED:
+  explicit FrozenNode(const std::string &name);
+
+protected:
+  FrozenNode(const FrozenNode &copy);
+
+public:
+  virtual PandaNode *make_copy() const;
+  virtual bool safe_to_combine() const;
+  virtual bool safe_to_flatten() const;
+
+  virtual bool cull_callback(CullTraverser *trav, CullTraverserData &data);
+
+PUBLISHED:
+  int get_num_frozen_geoms(Thread *current_thread = Thread::get_current_thread()) const;
+
+private:
+  enum EntryFlags {
+    EF_cull  = 0x01,
+    EF_empty = 0x02,
+  };
+
+  /**
+   * The compiled contents of the subgraph, stored as a set of parallel
+   * arrays, one element per Geom, in the order of a depth-first traversal.
+   */
+  class Snapshot : public ReferenceCount {
+  public:
+    UpdateSeq _seq;
+    bool _supported;
+
+    pvector<CPT(Geom)> _geoms;
+    pvector<CPT(RenderState)> _states;
+    pvector<CPT(TransformState)> _transforms;
+    pvector<LPoint3> _min;
+    pvector<LPoint3> _max;
+    pvector<unsigned char> _flags;
+  };
+
+  PT(Snapshot) get_snapshot(Thread *current_thread) const;
+  bool r_compile(Snapshot *snapshot, PandaNode *node,
+                 const TransformState *parent_transform,
+                 const RenderState *parent_state, bool cull,
+                 Thread *current_thread) const;
+  static void add_entry(Snapshot *snapshot, const Geom *geom,
+                        const RenderState *state,
+                        const TransformState *transform,
+                        const BoundingVolume *volume, bool cull);
+
+  INLINE static bool is_outside(const LPlane *planes, int num_planes,
+                                const LPoint3 &min_point,
+                                const LPoint3 &max_point);
+
+  mutable LightMutex _lock;
+  mutable PT(Snapshot) _snapshot;
+
+  static PStatCollector _compile_pcollector;
+
+public:
+  static void register_with_read_factory();
+
+protected:
+  static TypedWritable *make_from_bam(const FactoryParams &params);
+
+public:
+  static TypeHandle get_class_type() {
+    return _type_handle;
+  }
+  static void init_type() {
+    PandaNode::init_type();
+    register_type(_type_handle, "FrozenNode",
+                  PandaNode::get_class_type());
+  }
+  virtual TypeHandle get_type() const {
+    return get_class_type();
+  }
+  virtual TypeHandle force_init_type() {init_type(); return get_class_type();}
+
+private:
+  static TypeHandle _type_handle;
+};
+
+#include "frozenNode.I"
+
+#endif
@@ -499,7 +499,7 @@ is_renderable() const {
  */
 void GeomNode::
 add_for_draw(CullTraverser *trav, CullTraverserData &data) {
-  trav->_geom_nodes_pcollector.add_level(1);
+  trav->count_geom_nodes(1);
 
   if (pgraph_cat.is_spam()) {
     pgraph_cat.spam()
@@ -512,7 +512,7 @@ add_for_draw(CullTraverser *trav, CullTraverserData &data) {
   // Get all the Geoms, with no decalling.
   Geoms geoms = get_geoms(current_thread);
   int num_geoms = geoms.get_num_geoms();
-  trav->_geoms_pcollector.add_level(num_geoms);
+  trav->count_geoms(num_geoms);
   CPT(TransformState) internal_transform = data.get_internal_transform(trav);
 
   for (int i = 0; i < num_geoms; i++) {
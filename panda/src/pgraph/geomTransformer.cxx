@@ -625,6 +625,10 @@ apply_texture_colors(GeomNode *node, const RenderState *state) {
     }
   }
 
+  if (any_changed) {
+    node->mark_internal_bounds_stale();
+  }
+
   return any_changed;
 }
 
@@ -648,6 +652,10 @@ apply_state(GeomNode *node, const RenderState *state) {
     }
   }
 
+  if (any_changed) {
+    node->mark_internal_bounds_stale();
+  }
+
   return any_changed;
 }
 
@@ -809,6 +817,10 @@ make_compatible_state(GeomNode *node) {
     }
   }
 
+  if (any_changed) {
+    node->mark_internal_bounds_stale();
+  }
+
   return any_changed;
 }
 
@@ -902,6 +914,27 @@ reverse(GeomNode *node) {
   return (num_geoms != 0);
 }
 
+/**
+ * Reorders the triangles of the indicated Geom for better use of a
+ * post-transform vertex cache with the indicated number of entries, and
+ * records its GeomVertexData so that finish_apply() will reorder the vertices
+ * into the order in which they are first used.  Returns true if the Geom was
+ * changed, false otherwise.
+ */
+bool GeomTransformer::
+optimize_vertex_cache(Geom *geom, int cache_size) {
+  if (geom->get_primitive_type() != Geom::PT_polygons) {
+    return false;
+  }
+
+  geom->optimize_vertex_cache_in_place(cache_size);
+
+  VertexDataAssoc &assoc = _vdata_assoc[geom->get_vertex_data()];
+  assoc._geoms.push_back(geom);
+  assoc._reorder = true;
+  return true;
+}
+
 /**
  * Should be called after performing any operations--particularly
  * PandaNode::apply_attribs_to_vertices()--that might result in new
@@ -915,7 +948,9 @@ finish_apply() {
   for (vi = _vdata_assoc.begin(); vi != _vdata_assoc.end(); ++vi) {
     const GeomVertexData *vdata = (*vi).first;
     VertexDataAssoc &assoc = (*vi).second;
-    if (assoc._might_have_unused) {
+    if (assoc._reorder) {
+      assoc.reorder_vertices(vdata);
+    } else if (assoc._might_have_unused) {
       assoc.remove_unused_vertices(vdata);
     }
   }
@@ -1549,3 +1584,158 @@ remove_unused_vertices(const GeomVertexData *vdata) {
     geom->set_vertex_data(new_vdata);
   }
 }
+
+/**
+ * Reorders the vertices of the indicated GeomVertexData into the order in
+ * which they are first referenced by the Geoms that share it, so that the
+ * vertices are fetched from memory roughly sequentially, and reindexes the
+ * Geoms to match.  Vertices that are not referenced at all are moved to the
+ * end, or removed if _might_have_unused is set.
+ */
+void GeomTransformer::VertexDataAssoc::
+reorder_vertices(const GeomVertexData *vdata) {
+  if (_geoms.empty()) {
+    // Trivial case.
+    return;
+  }
+
+  if (vdata->get_slider_table() != nullptr) {
+    // The sliders refer to their rows by number; leave the order alone.
+    if (_might_have_unused) {
+      remove_unused_vertices(vdata);
+    }
+    return;
+  }
+
+  PT(Thread) current_thread = Thread::get_current_thread();
+
+  int num_vertices = vdata->get_num_rows();
+  vector_int remap_array(num_vertices, -1);
+  int new_index = 0;
+  bool any_referenced = false;
+  GeomList::iterator gi;
+  for (gi = _geoms.begin(); gi != _geoms.end(); ++gi) {
+    Geom *geom = (*gi);
+    if (geom->get_vertex_data() != vdata) {
+      continue;
+    }
+
+    any_referenced = true;
+    int num_primitives = geom->get_num_primitives();
+    for (int i = 0; i < num_primitives; ++i) {
+      CPT(GeomPrimitive) prim = geom->get_primitive(i);
+      if (!prim->is_indexed()) {
+        // A nonindexed primitive needs its vertices to stay consecutive.
+        if (_might_have_unused) {
+          remove_unused_vertices(vdata);
+        }
+        return;
+      }
+
+      GeomVertexReader index(prim->get_vertices(), 0, current_thread);
+      while (!index.is_at_end()) {
+        int vi = index.get_data1i();
+        // Skip the strip-cut index, if any.
+        if (vi >= 0 && vi < num_vertices && remap_array[vi] == -1) {
+          remap_array[vi] = new_index;
+          ++new_index;
+        }
+      }
+    }
+  }
+
+  if (!any_referenced) {
+    return;
+  }
+
+  int new_num_vertices = new_index;
+  if (!_might_have_unused) {
+    for (int vi = 0; vi < num_vertices; ++vi) {
+      if (remap_array[vi] == -1) {
+        remap_array[vi] = new_num_vertices;
+        ++new_num_vertices;
+      }
+    }
+  }
+
+  bool any_moved = (new_num_vertices != num_vertices);
+  for (int vi = 0; vi < num_vertices && !any_moved; ++vi) {
+    any_moved = (remap_array[vi] != vi);
+  }
+  if (!any_moved) {
+    // The vertices are already in order.
+    return;
+  }
+
+  // Now recopy the actual vertex data, one array at a time.
+  PT(GeomVertexData) new_vdata = new GeomVertexData(*vdata);
+  new_vdata->unclean_set_num_rows(new_num_vertices);
+
+  size_t num_arrays = vdata->get_num_arrays();
+  nassertv(num_arrays == new_vdata->get_num_arrays());
+
+  GeomVertexDataPipelineReader reader(vdata, current_thread);
+  reader.check_array_readers();
+  GeomVertexDataPipelineWriter writer(new_vdata, true, current_thread);
+  writer.check_array_writers();
+
+  for (size_t a = 0; a < num_arrays; ++a) {
+    const GeomVertexArrayDataHandle *array_reader = reader.get_array_reader(a);
+    GeomVertexArrayDataHandle *array_writer = writer.get_array_writer(a);
+
+    int stride = array_reader->get_array_format()->get_stride();
+    nassertv(stride == array_writer->get_array_format()->get_stride());
+
+    for (int vi = 0; vi < num_vertices; ++vi) {
+      if (remap_array[vi] != -1) {
+        array_writer->copy_subdata_from(remap_array[vi] * stride, stride,
+                                        array_reader,
+                                        vi * stride, stride);
+      }
+    }
+  }
+
+  // Update the rows in the TransformBlendTable, if any.  They are no longer
+  // necessarily contiguous.
+  PT(TransformBlendTable) tbtable = new_vdata->modify_transform_blend_table();
+  if (!tbtable.is_null()) {
+    const SparseArray &rows = tbtable->get_rows();
+    SparseArray new_rows;
+    int num_subranges = rows.get_num_subranges();
+    for (int si = 0; si < num_subranges; ++si) {
+      int from = rows.get_subrange_begin(si);
+      int to = std::min(rows.get_subrange_end(si), num_vertices);
+      for (int vi = std::max(from, 0); vi < to; ++vi) {
+        if (remap_array[vi] != -1) {
+          new_rows.set_bit(remap_array[vi]);
+        }
+      }
+    }
+    tbtable->set_rows(new_rows);
+  }
+
+  // Finally, reindex the Geoms.
+  for (gi = _geoms.begin(); gi != _geoms.end(); ++gi) {
+    Geom *geom = (*gi);
+    if (geom->get_vertex_data() != vdata) {
+      continue;
+    }
+
+    int num_primitives = geom->get_num_primitives();
+    for (int i = 0; i < num_primitives; ++i) {
+      PT(GeomPrimitive) prim = geom->modify_primitive(i);
+      PT(GeomVertexArrayData) vertices = prim->modify_vertices(prim->get_num_vertices());
+      GeomVertexRewriter rewriter(vertices, 0, current_thread);
+
+      while (!rewriter.is_at_end()) {
+        int vi = rewriter.get_data1i();
+        if (vi >= 0 && vi < num_vertices) {
+          nassertv(remap_array[vi] != -1);
+          rewriter.set_data1i(remap_array[vi]);
+        }
+      }
+    }
+
+    geom->set_vertex_data(new_vdata);
+  }
+}
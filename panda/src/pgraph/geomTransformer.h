@@ -82,6 +82,8 @@ public:
   bool doubleside(GeomNode *node);
   bool reverse(GeomNode *node);
 
+  bool optimize_vertex_cache(Geom *geom, int cache_size);
+
   void finish_apply();
 
   int collect_vertex_data(Geom *geom, int collect_bits, bool format_only);
@@ -97,13 +99,16 @@ private:
 
   // Keeps track of the Geoms that are associated with a particular
   // GeomVertexData.  Also tracks whether the vertex data might have unused
-  // vertices because of our actions.
+  // vertices because of our actions, or should have its vertices reordered
+  // to match the order in which the Geoms use them.
   class VertexDataAssoc {
   public:
     INLINE VertexDataAssoc();
     bool _might_have_unused;
+    bool _reorder;
     GeomList _geoms;
     void remove_unused_vertices(const GeomVertexData *vdata);
+    void reorder_vertices(const GeomVertexData *vdata);
   };
   typedef pmap<CPT(GeomVertexData), VertexDataAssoc> VertexDataAssocMap;
   VertexDataAssocMap _vdata_assoc;
@@ -0,0 +1,316 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file occlusionBuffer.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#include "occlusionBuffer.h"
+
+#include <float.h>
+
+#if defined(__SSE2__) || (_M_IX86_FP >= 2) || defined(_M_X64) || defined(_M_AMD64)
+#define HAVE_OCCLUSION_BUFFER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Vertices closer to the eye than this, in clip-space w, are clipped away.
+static const PN_stdfloat near_w = 1.0e-4f;
+
+/**
+ *
+ */
+OcclusionBuffer::
+OcclusionBuffer(int x_size, int y_size) :
+  _x_size(std::max(x_size, 1)),
+  _y_size(std::max(y_size, 1))
+{
+  _x_tiles = (_x_size + tile_size - 1) / tile_size;
+  _y_tiles = (_y_size + tile_size - 1) / tile_size;
+  _depth.resize((size_t)_x_size * _y_size);
+  _tile_depth.resize((size_t)_x_tiles * _y_tiles);
+  clear();
+}
+
+/**
+ * Removes all of the occluders from the buffer.
+ */
+void OcclusionBuffer::
+clear() {
+  std::fill(_depth.begin(), _depth.end(), FLT_MAX);
+  std::fill(_tile_depth.begin(), _tile_depth.end(), FLT_MAX);
+  _num_covered_pixels = 0;
+}
+
+/**
+ * Draws a single occluder triangle, whose vertices are given in clip space.
+ * The part of the triangle behind the eye is clipped away.  Triangles are
+ * drawn regardless of which way they face.
+ *
+ * finish() must be called after the last triangle has been drawn, before the
+ * buffer is used for testing.
+ */
+void OcclusionBuffer::
+draw_triangle(const LVecBase4 &a, const LVecBase4 &b, const LVecBase4 &c) {
+  // Clip the triangle against the w = near_w plane, which yields a polygon
+  // of up to four vertices.
+  const LVecBase4 *in[3] = { &a, &b, &c };
+  LVecBase4 clipped[4];
+  int num_clipped = 0;
+  for (int i = 0; i < 3; ++i) {
+    const LVecBase4 &p = *in[i];
+    const LVecBase4 &q = *in[(i + 1) % 3];
+    bool p_in = (p[3] >= near_w);
+    bool q_in = (q[3] >= near_w);
+    if (p_in) {
+      clipped[num_clipped++] = p;
+    }
+    if (p_in != q_in) {
+      PN_stdfloat t = (near_w - p[3]) / (q[3] - p[3]);
+      clipped[num_clipped++] = p + (q - p) * t;
+    }
+  }
+  if (num_clipped < 3) {
+    return;
+  }
+
+  // Convert the polygon to screen space, with pixel (x, y) covering the
+  // square from (x, y) to (x + 1, y + 1).
+  LPoint3 screen[4];
+  for (int i = 0; i < num_clipped; ++i) {
+    const LVecBase4 &p = clipped[i];
+    PN_stdfloat inv_w = 1.0f / p[3];
+    screen[i].set((p[0] * inv_w + 1.0f) * 0.5f * _x_size,
+                  (p[1] * inv_w + 1.0f) * 0.5f * _y_size,
+                  p[2] * inv_w);
+  }
+
+  draw_screen_triangle(screen[0], screen[1], screen[2]);
+  if (num_clipped == 4) {
+    draw_screen_triangle(screen[0], screen[2], screen[3]);
+  }
+}
+
+/**
+ * Must be called after all of the occluders have been drawn, to update the
+ * tile depths that is_occluded() relies on.
+ */
+void OcclusionBuffer::
+finish() {
+  _num_covered_pixels = 0;
+  for (int ty = 0; ty < _y_tiles; ++ty) {
+    int y_end = std::min((ty + 1) * (int)tile_size, _y_size);
+    for (int tx = 0; tx < _x_tiles; ++tx) {
+      int x_end = std::min((tx + 1) * (int)tile_size, _x_size);
+      float tile_max = 0.0f;
+      bool any_uncovered = false;
+      for (int y = ty * tile_size; y < y_end; ++y) {
+        const float *row = &_depth[(size_t)y * _x_size];
+        for (int x = tx * tile_size; x < x_end; ++x) {
+          if (row[x] == FLT_MAX) {
+            any_uncovered = true;
+          } else {
+            tile_max = std::max(tile_max, row[x]);
+            ++_num_covered_pixels;
+          }
+        }
+      }
+      _tile_depth[(size_t)ty * _x_tiles + tx] = any_uncovered ? FLT_MAX : tile_max;
+    }
+  }
+}
+
+/**
+ * Returns true if the indicated box, after transformation by the indicated
+ * matrix into clip space, is entirely hidden behind the occluders.  Returns
+ * false if it might be visible, which includes the case in which the box
+ * reaches behind the eye.
+ */
+bool OcclusionBuffer::
+is_occluded(const LPoint3 &min_point, const LPoint3 &max_point,
+            const LMatrix4 &mat) const {
+  if (_num_covered_pixels == 0) {
+    return false;
+  }
+
+  PN_stdfloat min_x = FLT_MAX, min_y = FLT_MAX, min_z = FLT_MAX;
+  PN_stdfloat max_x = -FLT_MAX, max_y = -FLT_MAX;
+  for (int i = 0; i < 8; ++i) {
+    LVecBase4 corner((i & 1) ? max_point[0] : min_point[0],
+                     (i & 2) ? max_point[1] : min_point[1],
+                     (i & 4) ? max_point[2] : min_point[2], 1.0f);
+    LVecBase4 p = mat.xform(corner);
+    if (p[3] < near_w) {
+      return false;
+    }
+    PN_stdfloat inv_w = 1.0f / p[3];
+    PN_stdfloat x = p[0] * inv_w;
+    PN_stdfloat y = p[1] * inv_w;
+    min_x = std::min(min_x, x);
+    max_x = std::max(max_x, x);
+    min_y = std::min(min_y, y);
+    max_y = std::max(max_y, y);
+    min_z = std::min(min_z, p[2] * inv_w);
+  }
+
+  // Find the pixels the box touches, plus a margin of one pixel.
+  int x_begin = (int)std::floor((min_x + 1.0f) * 0.5f * _x_size) - 1;
+  int x_end = (int)std::ceil((max_x + 1.0f) * 0.5f * _x_size) + 1;
+  int y_begin = (int)std::floor((min_y + 1.0f) * 0.5f * _y_size) - 1;
+  int y_end = (int)std::ceil((max_y + 1.0f) * 0.5f * _y_size) + 1;
+  x_begin = std::max(x_begin, 0);
+  y_begin = std::max(y_begin, 0);
+  x_end = std::min(x_end, _x_size);
+  y_end = std::min(y_end, _y_size);
+  if (x_begin >= x_end || y_begin >= y_end) {
+    // It's off the screen; leave that to the frustum test.
+    return false;
+  }
+
+  float near_z = (float)min_z;
+  int tx_begin = x_begin / tile_size;
+  int tx_end = (x_end - 1) / tile_size + 1;
+  int ty_begin = y_begin / tile_size;
+  int ty_end = (y_end - 1) / tile_size + 1;
+  for (int ty = ty_begin; ty < ty_end; ++ty) {
+    for (int tx = tx_begin; tx < tx_end; ++tx) {
+      if (_tile_depth[(size_t)ty * _x_tiles + tx] < near_z) {
+        // Everything in this tile is in front of the box.
+        continue;
+      }
+
+      // Otherwise, we have to look at the individual pixels.
+      int py_begin = std::max(ty * (int)tile_size, y_begin);
+      int py_end = std::min((ty + 1) * (int)tile_size, y_end);
+      int px_begin = std::max(tx * (int)tile_size, x_begin);
+      int px_end = std::min((tx + 1) * (int)tile_size, x_end);
+      for (int y = py_begin; y < py_end; ++y) {
+        const float *row = &_depth[(size_t)y * _x_size];
+        for (int x = px_begin; x < px_end; ++x) {
+          if (!(row[x] < near_z)) {
+            return false;
+          }
+        }
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * Returns true if the SSE2 implementation of the rasterizer has been
+ * compiled in.
+ */
+bool OcclusionBuffer::
+has_simd() {
+#ifdef HAVE_OCCLUSION_BUFFER_SSE2
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+ * Draws a triangle whose vertices have already been converted to screen
+ * space.  Each pixel whose center lies inside the triangle, or on its edge,
+ * receives the farthest depth that the triangle's plane reaches within the
+ * pixel, clamped to the farthest vertex, unless it already holds a nearer
+ * value.  This uses SSE2 instructions to process four pixels at once, if
+ * they are available.
+ */
+void OcclusionBuffer::
+draw_screen_triangle(const LPoint3 &a, const LPoint3 &b, const LPoint3 &c) {
+  PN_stdfloat area = (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+  if (area == 0.0f || cnan(area)) {
+    return;
+  }
+
+  // Orient the triangle counter-clockwise, so that the edge functions are
+  // positive on the inside.
+  const LPoint3 *v[3] = { &a, &b, &c };
+  if (area < 0.0f) {
+    std::swap(v[1], v[2]);
+    area = -area;
+  }
+
+  // Each edge function has the form e(x, y) = ex * x + ey * y + ec.
+  float ex[3], ey[3], ec[3];
+  for (int i = 0; i < 3; ++i) {
+    const LPoint3 &p = *v[i];
+    const LPoint3 &q = *v[(i + 1) % 3];
+    ex[i] = (float)(p[1] - q[1]);
+    ey[i] = (float)(q[0] - p[0]);
+    ec[i] = (float)-(ex[i] * p[0] + ey[i] * p[1]);
+  }
+
+  // The depth plane, z(x, y) = zx * x + zy * y + zc.
+  const LPoint3 &p0 = *v[0];
+  LVector3 normal = (*v[1] - p0).cross(*v[2] - p0);
+  float zx = (float)(-normal[0] / normal[2]);
+  float zy = (float)(-normal[1] / normal[2]);
+  float zc = (float)(p0[2] - zx * p0[0] - zy * p0[1]);
+
+  // The farthest depth of the plane within a pixel is at one of its
+  // corners, half a pixel away from the center in each direction.
+  float z_pad = 0.5f * (std::fabs(zx) + std::fabs(zy));
+  float z_limit = (float)std::max(std::max(a[2], b[2]), c[2]);
+
+  PN_stdfloat min_x = std::min(std::min(a[0], b[0]), c[0]);
+  PN_stdfloat max_x = std::max(std::max(a[0], b[0]), c[0]);
+  PN_stdfloat min_y = std::min(std::min(a[1], b[1]), c[1]);
+  PN_stdfloat max_y = std::max(std::max(a[1], b[1]), c[1]);
+  int x_begin = std::max((int)std::floor(min_x), 0);
+  int x_end = std::min((int)std::ceil(max_x), _x_size);
+  int y_begin = std::max((int)std::floor(min_y), 0);
+  int y_end = std::min((int)std::ceil(max_y), _y_size);
+
+  for (int y = y_begin; y < y_end; ++y) {
+    float *row = &_depth[(size_t)y * _x_size];
+    float cy = (float)y + 0.5f;
+    float e_row[3];
+    for (int i = 0; i < 3; ++i) {
+      e_row[i] = ey[i] * cy + ec[i];
+    }
+    float z_row = zy * cy + zc + z_pad;
+
+    int x = x_begin;
+#ifdef HAVE_OCCLUSION_BUFFER_SSE2
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 lane = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+    const __m128 limit = _mm_set1_ps(z_limit);
+    for (; x + 4 <= x_end; x += 4) {
+      __m128 cx = _mm_add_ps(_mm_set1_ps((float)x), lane);
+      __m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(ex[0]), cx), _mm_set1_ps(e_row[0])), zero);
+      inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(ex[1]), cx), _mm_set1_ps(e_row[1])), zero));
+      inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(ex[2]), cx), _mm_set1_ps(e_row[2])), zero));
+      if (_mm_movemask_ps(inside) == 0) {
+        continue;
+      }
+
+      __m128 z = _mm_min_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(zx), cx), _mm_set1_ps(z_row)), limit);
+      __m128 old_z = _mm_loadu_ps(row + x);
+      __m128 write = _mm_and_ps(inside, _mm_cmplt_ps(z, old_z));
+      __m128 new_z = _mm_or_ps(_mm_and_ps(write, z), _mm_andnot_ps(write, old_z));
+      _mm_storeu_ps(row + x, new_z);
+    }
+#endif  // HAVE_OCCLUSION_BUFFER_SSE2
+
+    for (; x < x_end; ++x) {
+      float cx = (float)x + 0.5f;
+      if (ex[0] * cx + e_row[0] >= 0.0f &&
+          ex[1] * cx + e_row[1] >= 0.0f &&
+          ex[2] * cx + e_row[2] >= 0.0f) {
+        float z = std::min(zx * cx + z_row, z_limit);
+        if (z < row[x]) {
+          row[x] = z;
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,79 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file occlusionBuffer.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef OCCLUSIONBUFFER_H
+#define OCCLUSIONBUFFER_H
+
+#include "pandabase.h"
+
+#include "referenceCount.h"
+#include "luse.h"
+#include "pvector.h"
+
+/**
+ * A small depth buffer, rendered on the CPU, that is used by the
+ * SoftwareOcclusionCullTraverser to decide whether an object is hidden
+ * behind the occluders that have been drawn into it.
+ *
+ * Triangles are given in clip space, as produced by a lens projection
+ * matrix.  A pixel is written when a triangle covers its center, with the
+ * farthest depth the triangle's plane reaches within the pixel.  Since a
+ * pixel on the edge of an occluder may be only partly covered, objects are
+ * tested with a margin of one pixel around their screen rectangle.  The
+ * buffer also keeps the farthest depth of each 8x8 tile of pixels, so that
+ * most tests can be decided without looking at individual pixels.
+ *
+ * Depth values are the post-projection z/w; smaller values are nearer.
+ */
+class EXPCL_PANDA_PGRAPH OcclusionBuffer : public ReferenceCount {
+PUBLISHED:
+  OcclusionBuffer(int x_size, int y_size);
+
+  void clear();
+  void draw_triangle(const LVecBase4 &a, const LVecBase4 &b,
+                     const LVecBase4 &c);
+  void finish();
+
+  bool is_occluded(const LPoint3 &min_point, const LPoint3 &max_point,
+                   const LMatrix4 &mat) const;
+
+  INLINE int get_x_size() const;
+  INLINE int get_y_size() const;
+  INLINE float get_depth(int x, int y) const;
+  INLINE int get_num_covered_pixels() const;
+  INLINE bool is_empty() const;
+
+  static bool has_simd();
+
+public:
+  enum {
+    tile_size = 8,
+  };
+
+private:
+  void draw_screen_triangle(const LPoint3 &a, const LPoint3 &b,
+                            const LPoint3 &c);
+
+  int _x_size;
+  int _y_size;
+  int _x_tiles;
+  int _y_tiles;
+  int _num_covered_pixels;
+
+  pvector<float> _depth;
+  pvector<float> _tile_depth;
+};
+
+#include "occlusionBuffer.I"
+
+#endif
@@ -20,6 +20,7 @@
 #include "nodePathComponent.cxx"
 #include "occluderEffect.cxx"
 #include "occluderNode.cxx"
+#include "occlusionBuffer.cxx"
 #include "pandaNode.cxx"
 #include "pandaNodeChain.cxx"
 #include "paramNodePath.cxx"
@@ -27,6 +27,7 @@
 #include "config_mathutil.h"
 #include "lightReMutexHolder.h"
 #include "graphicsStateGuardianBase.h"
+#include "jobPool.h"
 
 using std::ostream;
 using std::ostringstream;
@@ -45,6 +46,25 @@ DrawMask PandaNode::_overall_bit = DrawMask::bit(31);
 
 PStatCollector PandaNode::_reset_prev_pcollector("App:Collisions:Reset");
 PStatCollector PandaNode::_update_bounds_pcollector("*:Bounds");
+PStatCollector PandaNode::_bounds_nodes_pcollector("Bounds nodes");
+PStatCollector PandaNode::_bounds_parallel_nodes_pcollector("Bounds nodes:Parallel");
+
+/**
+ * Brings the bounds of a contiguous range of stale children up to date on a
+ * worker thread, on behalf of PandaNode::r_update_bounds().
+ */
+class PandaNode::BoundsJob : public JobPool::Job {
+public:
+  BoundsJob(int pipeline_stage) :
+    _pipeline_stage(pipeline_stage),
+    _num_revisited(0) {}
+
+  virtual void do_job(Thread *current_thread);
+
+  int _pipeline_stage;
+  pvector<PT(PandaNode) > _children;
+  int _num_revisited;
+};
 
 TypeHandle PandaNode::_type_handle;
 TypeHandle PandaNode::CData::_type_handle;
@@ -1006,6 +1026,7 @@ set_effect(const RenderEffect *effect) {
     cdata->set_fancy_bit(FB_effects, true);
   }
   CLOSE_ITERATE_CURRENT_AND_UPSTREAM(_cycler);
+  mark_bounds_stale(current_thread);
   mark_bam_modified();
 }
 
@@ -1021,6 +1042,7 @@ clear_effect(TypeHandle type) {
     cdata->set_fancy_bit(FB_effects, !cdata->_effects->is_empty());
   }
   CLOSE_ITERATE_CURRENT_AND_UPSTREAM(_cycler);
+  mark_bounds_stale(current_thread);
   mark_bam_modified();
 }
 
@@ -1069,6 +1091,10 @@ set_effects(const RenderEffects *effects, Thread *current_thread) {
     cdata->set_fancy_bit(FB_effects, !effects->is_empty());
   }
   CLOSE_ITERATE_CURRENT_AND_UPSTREAM(_cycler);
+
+  // Anything that caches the contents of the subgraph, such as a FrozenNode,
+  // notices changes through the bounds.
+  mark_bounds_stale(current_thread);
   mark_bam_modified();
 }
 
@@ -2010,6 +2036,42 @@ get_nested_vertices(Thread *current_thread) const {
   return cdata->_nested_vertices;
 }
 
+/**
+ * Recomputes the bounding volume of this node and of all of its descendants
+ * whose bounds have been marked stale, visiting only the stale parts of the
+ * graph.  Each node's bounds are recomputed after those of its children, so
+ * that every node is recomputed only once.  Subsequent calls to get_bounds()
+ * will then return the cached volume immediately.
+ *
+ * The return value is the number of nodes whose bounds were recomputed.
+ */
+int PandaNode::
+update_bounds(Thread *current_thread) {
+  return update_bounds(nullptr, current_thread);
+}
+
+/**
+ * This flavor of update_bounds() may hand off the work to the indicated
+ * JobPool: whenever a node has at least bounds-update-parallel-threshold
+ * children with stale bounds, these children are divided among the worker
+ * threads.  The pool may be nullptr to do all the work on this thread.
+ */
+int PandaNode::
+update_bounds(JobPool *job_pool, Thread *current_thread) {
+  if (job_pool != nullptr && job_pool->get_num_threads() == 0) {
+    job_pool = nullptr;
+  }
+
+  int num_revisited;
+  {
+    PStatTimer timer(_update_bounds_pcollector, current_thread);
+    num_revisited = r_update_bounds(job_pool, current_thread->get_pipeline_stage(),
+                                    current_thread);
+  }
+  _bounds_nodes_pcollector.add_level(num_revisited);
+  return num_revisited;
+}
+
 /**
  * Indicates that the bounding volume, or something that influences the
  * bounding volume (or any of the other things stored in CData, like
@@ -3186,6 +3248,91 @@ do_find_child(PandaNode *node, const PandaNode::Down *down) const {
   return -1;
 }
 
+/**
+ * The recursive implementation of update_bounds().  Returns the number of
+ * nodes that were recomputed.
+ */
+int PandaNode::
+r_update_bounds(JobPool *job_pool, int pipeline_stage, Thread *current_thread) {
+  Children children;
+  {
+    CDStageReader cdata(_cycler, pipeline_stage, current_thread);
+    if (cdata->_last_bounds_update == cdata->_next_update) {
+      // This subgraph is already up-to-date.
+      return 0;
+    }
+    children = Children(cdata);
+  }
+
+  int num_revisited = 0;
+  int num_children = children.get_num_children();
+  int threshold = bounds_update_parallel_threshold;
+
+  if (job_pool != nullptr && threshold > 0 && num_children >= threshold) {
+    pvector<PandaNode *> stale_children;
+    stale_children.reserve(num_children);
+    for (int i = 0; i < num_children; ++i) {
+      PandaNode *child = children.get_child(i);
+      CDStageReader child_cdata(child->_cycler, pipeline_stage, current_thread);
+      if (child_cdata->_last_bounds_update != child_cdata->_next_update) {
+        stale_children.push_back(child);
+      }
+    }
+
+    int num_stale = (int)stale_children.size();
+    if (num_stale >= threshold) {
+      // Divide the stale children into a few jobs per thread, so that the
+      // work is reasonably balanced even if the subgraphs differ in size.
+      int num_jobs = std::min(num_stale, (job_pool->get_num_threads() + 1) * 4);
+      pvector<BoundsJob> jobs(num_jobs, BoundsJob(pipeline_stage));
+      for (int i = 0; i < num_stale; ++i) {
+        jobs[(size_t)i * num_jobs / num_stale]._children.push_back(stale_children[i]);
+      }
+
+      JobPool::Batch batch(job_pool, current_thread);
+      for (BoundsJob &job : jobs) {
+        batch.add_job(&job);
+      }
+      batch.wait();
+
+      int num_parallel = 0;
+      for (const BoundsJob &job : jobs) {
+        num_parallel += job._num_revisited;
+      }
+      _bounds_parallel_nodes_pcollector.add_level(num_parallel);
+      num_revisited += num_parallel;
+
+      // The jobs took care of all of the stale children.
+      num_children = 0;
+    }
+  }
+
+  for (int i = 0; i < num_children; ++i) {
+    num_revisited += children.get_child(i)->r_update_bounds(job_pool, pipeline_stage, current_thread);
+  }
+
+  // Now that the children are fresh, recompute this node's bounds from
+  // theirs.  Someone else may have beaten us to it in the meantime.
+  CDLockedStageReader cdata(_cycler, pipeline_stage, current_thread);
+  if (cdata->_last_bounds_update != cdata->_next_update) {
+    update_cached(true, pipeline_stage, cdata);
+    ++num_revisited;
+  }
+  return num_revisited;
+}
+
+/**
+ * Recomputes the bounds of each of the job's children, and their stale
+ * descendants, on the current thread.
+ */
+void PandaNode::BoundsJob::
+do_job(Thread *current_thread) {
+  PStatTimer timer(_update_bounds_pcollector, current_thread);
+  for (PandaNode *child : _children) {
+    _num_revisited += child->r_update_bounds(nullptr, _pipeline_stage, current_thread);
+  }
+}
+
 /**
  * Updates the cached values of the node that are dependent on its children,
  * such as the external bounding volume, the _net_collide_mask, and the
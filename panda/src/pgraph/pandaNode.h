@@ -55,6 +55,7 @@ class FactoryParams;
 class AccumulatedAttribs;
 class GeomTransformer;
 class GraphicsStateGuardianBase;
+class JobPool;
 
 /**
  * A basic node of the scene graph or data graph.  This is the base class of
@@ -308,6 +309,7 @@ PUBLISHED:
   void mark_internal_bounds_stale(Thread *current_thread = Thread::get_current_thread());
   INLINE bool is_bounds_stale() const;
   MAKE_PROPERTY(bounds_stale, is_bounds_stale);
+  int update_bounds(Thread *current_thread = Thread::get_current_thread());
 
   INLINE void set_final(bool flag);
   INLINE bool is_final(Thread *current_thread = Thread::get_current_thread()) const;
@@ -371,6 +373,13 @@ public:
                                GeomTransformer &transformer,
                                Thread *current_thread);
 
+  int update_bounds(JobPool *job_pool, Thread *current_thread);
+  INLINE static void flush_level();
+
+  // Statistics
+  static PStatCollector _bounds_nodes_pcollector;
+  static PStatCollector _bounds_parallel_nodes_pcollector;
+
 protected:
   // This is a base class of CData, defined below.  It contains just the
   // protected (not private) part of CData that will be needed by derived
@@ -686,6 +695,10 @@ private:
   CDStageWriter update_cached(bool update_bounds, int pipeline_stage,
                               CDLockedStageReader &cdata);
 
+  class BoundsJob;
+  int r_update_bounds(JobPool *job_pool, int pipeline_stage,
+                      Thread *current_thread);
+
   static DrawMask _overall_bit;
 
   static PStatCollector _reset_prev_pcollector;
@@ -826,6 +839,7 @@ private:
   friend class EggLoader;
   friend class Extension<PandaNode>;
   friend class CullTraverserData;
+  friend class CollisionBroadphase;
 };
 
 /**
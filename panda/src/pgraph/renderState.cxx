@@ -12,6 +12,7 @@
  */
 
 #include "renderState.h"
+#include "threadCompositionCache.h"
 #include "transparencyAttrib.h"
 #include "cullBinAttrib.h"
 #include "cullBinManager.h"
@@ -57,6 +58,11 @@ CacheStats RenderState::_cache_stats;
 
 TypeHandle RenderState::_type_handle;
 
+#ifdef HAVE_THREAD_COMPOSITION_CACHE
+static thread_local ThreadCompositionCache<RenderState> _thread_compose_cache;
+static thread_local ThreadCompositionCache<RenderState> _thread_invert_compose_cache;
+#endif
+
 
 /**
  * Actually, this could be a private constructor, since no one inherits from
@@ -358,6 +364,32 @@ compose(const RenderState *other) const {
     return do_compose(other);
   }
 
+#ifdef HAVE_THREAD_COMPOSITION_CACHE
+  if (!thread_composition_cache) {
+    return do_cached_compose(other);
+  }
+
+  // Try the calling thread's own cache first, which requires no lock.
+  CPT(RenderState) result;
+  if (_thread_compose_cache.lookup(this, other, result)) {
+    _cache_stats.inc_thread_hits();
+    return result;
+  }
+  result = do_cached_compose(other);
+  _thread_compose_cache.store(this, other, result);
+  return result;
+#else
+  return do_cached_compose(other);
+#endif
+}
+
+/**
+ * The part of compose() that consults and updates the global composition
+ * cache.  This must be called only when the cache is enabled.
+ */
+CPT(RenderState) RenderState::
+do_cached_compose(const RenderState *other) const {
+  _cache_stats.check_contention(*_states_lock);
   LightReMutexHolder holder(*_states_lock);
 
   // Is this composition already cached?
@@ -447,6 +479,32 @@ invert_compose(const RenderState *other) const {
     return do_invert_compose(other);
   }
 
+#ifdef HAVE_THREAD_COMPOSITION_CACHE
+  if (!thread_composition_cache) {
+    return do_cached_invert_compose(other);
+  }
+
+  // Try the calling thread's own cache first, which requires no lock.
+  CPT(RenderState) result;
+  if (_thread_invert_compose_cache.lookup(this, other, result)) {
+    _cache_stats.inc_thread_hits();
+    return result;
+  }
+  result = do_cached_invert_compose(other);
+  _thread_invert_compose_cache.store(this, other, result);
+  return result;
+#else
+  return do_cached_invert_compose(other);
+#endif
+}
+
+/**
+ * The part of invert_compose() that consults and updates the global composition
+ * cache.  This must be called only when the cache is enabled.
+ */
+CPT(RenderState) RenderState::
+do_cached_invert_compose(const RenderState *other) const {
+  _cache_stats.check_contention(*_states_lock);
   LightReMutexHolder holder(*_states_lock);
 
   // Is this composition already cached?
@@ -817,6 +875,11 @@ int RenderState::
 clear_cache() {
   LightReMutexHolder holder(*_states_lock);
 
+#ifdef HAVE_THREAD_COMPOSITION_CACHE
+  // Each thread's own cache is flushed the next time that thread uses it.
+  ThreadCompositionCache<RenderState>::invalidate_all();
+#endif
+
   PStatTimer timer(_cache_update_pcollector);
   int orig_size = _states.get_num_entries();
 
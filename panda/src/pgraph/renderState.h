@@ -198,6 +198,8 @@ private:
   static CPT(RenderState) return_unique(RenderState *state);
   CPT(RenderState) do_compose(const RenderState *other) const;
   CPT(RenderState) do_invert_compose(const RenderState *other) const;
+  CPT(RenderState) do_cached_compose(const RenderState *other) const;
+  CPT(RenderState) do_cached_invert_compose(const RenderState *other) const;
   void detect_and_break_cycles();
   static bool r_detect_cycles(const RenderState *start_state,
                               const RenderState *current_state,
@@ -0,0 +1,261 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file softwareOcclusionCullTraverser.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#include "softwareOcclusionCullTraverser.h"
+#include "config_pgraph.h"
+#include "cullTraverserData.h"
+#include "sceneSetup.h"
+#include "lens.h"
+#include "geomNode.h"
+#include "occluderNode.h"
+#include "geomPrimitive.h"
+#include "geomVertexReader.h"
+#include "finiteBoundingVolume.h"
+#include "pStatTimer.h"
+
+TypeHandle SoftwareOcclusionCullTraverser::_type_handle;
+
+PStatCollector SoftwareOcclusionCullTraverser::_occluders_pcollector("Cull:Occlusion:Occluders");
+PStatCollector SoftwareOcclusionCullTraverser::_test_pcollector("Cull:Occlusion:Test");
+PStatCollector SoftwareOcclusionCullTraverser::_occluded_pcollector("Occlusion results:Occluded");
+
+/**
+ *
+ */
+SoftwareOcclusionCullTraverser::
+SoftwareOcclusionCullTraverser() {
+  _buffer = new OcclusionBuffer(software_occlusion_size[0],
+                                software_occlusion_size[1]);
+  _root_to_clip = LMatrix4::ident_mat();
+}
+
+/**
+ *
+ */
+SoftwareOcclusionCullTraverser::
+SoftwareOcclusionCullTraverser(const SoftwareOcclusionCullTraverser &copy) :
+  CullTraverser(copy),
+  _occluders(copy._occluders),
+  _root_to_clip(copy._root_to_clip)
+{
+  _buffer = new OcclusionBuffer(copy._buffer->get_x_size(),
+                                copy._buffer->get_y_size());
+}
+
+/**
+ * Adds the indicated node as an occluder.  The triangles of all of the
+ * GeomNodes and OccluderNodes at or below it will be drawn into the
+ * occlusion buffer before each traversal.
+ */
+void SoftwareOcclusionCullTraverser::
+add_occluder(const NodePath &occluder) {
+  nassertv(!occluder.is_empty());
+  Occluder record;
+  record._node_path = occluder;
+  record._collected = false;
+  _occluders.push_back(std::move(record));
+}
+
+/**
+ * Removes the indicated occluder.  Returns true if it was found, false if it
+ * had not been added.
+ */
+bool SoftwareOcclusionCullTraverser::
+remove_occluder(const NodePath &occluder) {
+  for (Occluders::iterator oi = _occluders.begin(); oi != _occluders.end(); ++oi) {
+    if ((*oi)._node_path == occluder) {
+      _occluders.erase(oi);
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Removes all of the occluders.
+ */
+void SoftwareOcclusionCullTraverser::
+clear_occluders() {
+  _occluders.clear();
+}
+
+/**
+ * Sets the SceneSetup object that indicates the initial camera position, etc.
+ * This must be called before traversal begins.  This also draws the
+ * occluders into the occlusion buffer, as seen from the new camera position.
+ */
+void SoftwareOcclusionCullTraverser::
+set_scene(SceneSetup *scene_setup, GraphicsStateGuardianBase *gsg,
+          bool dr_incomplete_render) {
+  CullTraverser::set_scene(scene_setup, gsg, dr_incomplete_render);
+
+  const Lens *lens = scene_setup->get_lens();
+  _root_to_clip = scene_setup->get_world_transform()->get_mat() *
+    lens->get_projection_mat();
+
+  draw_occluders();
+}
+
+/**
+ * Returns true if the current node is fully or partially within the viewing
+ * area and is not hidden behind the occluders, and should therefore be
+ * drawn, or false if it (and all of its children) should be pruned.
+ */
+bool SoftwareOcclusionCullTraverser::
+is_in_view(CullTraverserData &data) {
+  if (!CullTraverser::is_in_view(data)) {
+    return false;
+  }
+  if (_buffer->is_empty()) {
+    return true;
+  }
+
+  // The node's bounding volume is in the space of its parent, which is
+  // also the space of the net transform at this point.
+  CPT(BoundingVolume) bounds = data.node_reader()->get_bounds();
+  if (bounds->is_empty() || bounds->is_infinite()) {
+    return true;
+  }
+  const FiniteBoundingVolume *fbv = bounds->as_finite_bounding_volume();
+  if (fbv == nullptr) {
+    return true;
+  }
+
+  PStatTimer timer(_test_pcollector, get_current_thread());
+  LMatrix4 mat = data.get_net_transform(this)->get_mat() * _root_to_clip;
+  if (_buffer->is_occluded(fbv->get_min(), fbv->get_max(), mat)) {
+    _occluded_pcollector.add_level(1);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Clears the occlusion buffer and draws all of the occluders into it.
+ */
+void SoftwareOcclusionCullTraverser::
+draw_occluders() {
+  PStatTimer timer(_occluders_pcollector, get_current_thread());
+  _buffer->clear();
+
+  const NodePath &camera = get_scene()->get_camera_path();
+  const LMatrix4 &projection_mat = get_scene()->get_lens()->get_projection_mat();
+  Thread *current_thread = get_current_thread();
+
+  for (Occluder &occluder : _occluders) {
+    if (occluder._node_path.is_empty()) {
+      continue;
+    }
+    collect_triangles(occluder);
+    if (occluder._vertices.empty()) {
+      continue;
+    }
+
+    CPT(TransformState) transform =
+      occluder._node_path.get_transform(camera, current_thread);
+    if (transform->is_invalid()) {
+      continue;
+    }
+    LMatrix4 mat = transform->get_mat() * projection_mat;
+
+    size_t num_vertices = occluder._vertices.size();
+    for (size_t i = 0; i + 2 < num_vertices; i += 3) {
+      LVecBase4 a = mat.xform(LVecBase4(occluder._vertices[i], 1.0f));
+      LVecBase4 b = mat.xform(LVecBase4(occluder._vertices[i + 1], 1.0f));
+      LVecBase4 c = mat.xform(LVecBase4(occluder._vertices[i + 2], 1.0f));
+      _buffer->draw_triangle(a, b, c);
+    }
+  }
+
+  _buffer->finish();
+}
+
+/**
+ * Collects the triangles of the indicated occluder, unless they have been
+ * collected already and nothing below the occluder has changed since.
+ */
+void SoftwareOcclusionCullTraverser::
+collect_triangles(Occluder &occluder) {
+  Thread *current_thread = get_current_thread();
+  PandaNode *node = occluder._node_path.node();
+
+  UpdateSeq seq;
+  node->get_bounds(seq, current_thread);
+  if (occluder._collected && occluder._seq == seq) {
+    return;
+  }
+
+  occluder._vertices.clear();
+  occluder._seq = seq;
+  occluder._collected = true;
+
+  // The occluder's own transform is part of the transform to the camera, so
+  // we start below it.
+  r_collect_triangles(node, LMatrix4::ident_mat(), occluder._vertices,
+                      current_thread);
+}
+
+/**
+ * Appends the triangles of the indicated node and its descendants, in the
+ * space described by mat, to the list of vertices.
+ */
+void SoftwareOcclusionCullTraverser::
+r_collect_triangles(PandaNode *node, const LMatrix4 &mat,
+                    pvector<LPoint3> &vertices, Thread *current_thread) {
+  if (node->is_geom_node()) {
+    const GeomNode *gnode = (const GeomNode *)node;
+    GeomNode::Geoms geoms = gnode->get_geoms(current_thread);
+    int num_geoms = geoms.get_num_geoms();
+    for (int i = 0; i < num_geoms; ++i) {
+      CPT(Geom) geom = geoms.get_geom(i);
+      if (geom->get_primitive_type() != GeomPrimitive::PT_polygons) {
+        continue;
+      }
+      CPT(Geom) triangles = geom->decompose();
+      GeomVertexReader vertex(triangles->get_vertex_data(current_thread),
+                              InternalName::get_vertex(), current_thread);
+      if (!vertex.has_column()) {
+        continue;
+      }
+
+      int num_primitives = triangles->get_num_primitives();
+      for (int pi = 0; pi < num_primitives; ++pi) {
+        CPT(GeomPrimitive) prim = triangles->get_primitive(pi);
+        int num_vertices = prim->get_num_vertices();
+        for (int vi = 0; vi + 2 < num_vertices; vi += 3) {
+          for (int j = 0; j < 3; ++j) {
+            vertex.set_row_unsafe(prim->get_vertex(vi + j));
+            vertices.push_back(mat.xform_point(vertex.get_data3()));
+          }
+        }
+      }
+    }
+
+  } else if (node->is_of_type(OccluderNode::get_class_type())) {
+    const OccluderNode *onode = (const OccluderNode *)node;
+    if (onode->get_num_vertices() == 4) {
+      static const int quad_indices[6] = { 0, 1, 2, 0, 2, 3 };
+      for (int j = 0; j < 6; ++j) {
+        vertices.push_back(mat.xform_point(onode->get_vertex(quad_indices[j])));
+      }
+    }
+  }
+
+  PandaNode::Children children = node->get_children(current_thread);
+  size_t num_children = children.get_num_children();
+  for (size_t i = 0; i < num_children; ++i) {
+    PandaNode *child = children.get_child(i);
+    LMatrix4 child_mat = child->get_transform(current_thread)->get_mat() * mat;
+    r_collect_triangles(child, child_mat, vertices, current_thread);
+  }
+}
@@ -0,0 +1,121 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file softwareOcclusionCullTraverser.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef SOFTWAREOCCLUSIONCULLTRAVERSER_H
+#define SOFTWAREOCCLUSIONCULLTRAVERSER_H
+
+#include "pandabase.h"
+
+#include "cullTraverser.h"
+#include "occlusionBuffer.h"
+#include "nodePath.h"
+#include "updateSeq.h"
+#include "pvector.h"
+#include "pStatCollector.h"
+
+/**
+ * This specialization of CullTraverser performs occlusion culling entirely
+ * on the CPU, so unlike the PipeOcclusionCullTraverser it doesn't need a
+ * graphics pipe, and can be used in headless and software-rendered setups.
+ *
+ * At the start of each traversal, the triangles of the designated occluders
+ * are rasterized into a small OcclusionBuffer.  Each node that passes the
+ * view frustum test is then also tested against this buffer by its bounding
+ * box, and culled along with all of its descendants if it is completely
+ * hidden.
+ *
+ * Any GeomNode or OccluderNode at or below an occluder contributes its
+ * triangles.  Occluders are treated as solid and double-sided, so they
+ * should be chosen from large, opaque geometry such as walls and terrain,
+ * preferably in a simplified form.  Occluders are still rendered normally
+ * if they are part of the scene.
+ *
+ * To use it, assign an instance to a DisplayRegion with
+ * DisplayRegion::set_cull_traverser().
+ */
+class EXPCL_PANDA_PGRAPH SoftwareOcclusionCullTraverser : public CullTraverser {
+PUBLISHED:
+  SoftwareOcclusionCullTraverser();
+  SoftwareOcclusionCullTraverser(const SoftwareOcclusionCullTraverser &copy);
+
+  void add_occluder(const NodePath &occluder);
+  bool remove_occluder(const NodePath &occluder);
+  void clear_occluders();
+  INLINE size_t get_num_occluders() const;
+  INLINE NodePath get_occluder(size_t n) const;
+  MAKE_SEQ(get_occluders, get_num_occluders, get_occluder);
+
+  INLINE OcclusionBuffer *get_buffer() const;
+  MAKE_PROPERTY(buffer, get_buffer);
+
+  virtual void set_scene(SceneSetup *scene_setup,
+                         GraphicsStateGuardianBase *gsg,
+                         bool dr_incomplete_render);
+
+protected:
+  virtual bool is_in_view(CullTraverserData &data);
+
+private:
+  /**
+   * The triangles of one occluder, in the coordinate space of the occluder
+   * node, three vertices per triangle.  These are collected again whenever
+   * the occluder's bounds change.
+   */
+  class Occluder {
+  public:
+    NodePath _node_path;
+    UpdateSeq _seq;
+    bool _collected;
+    pvector<LPoint3> _vertices;
+  };
+  typedef pvector<Occluder> Occluders;
+
+  void draw_occluders();
+  void collect_triangles(Occluder &occluder);
+  static void r_collect_triangles(PandaNode *node, const LMatrix4 &mat,
+                                  pvector<LPoint3> &vertices,
+                                  Thread *current_thread);
+
+  Occluders _occluders;
+  PT(OcclusionBuffer) _buffer;
+
+  // Converts from the coordinate space of the scene root to clip space.
+  LMatrix4 _root_to_clip;
+
+public:
+  // Statistics
+  static PStatCollector _occluders_pcollector;
+  static PStatCollector _test_pcollector;
+  static PStatCollector _occluded_pcollector;
+
+public:
+  static TypeHandle get_class_type() {
+    return _type_handle;
+  }
+  static void init_type() {
+    CullTraverser::init_type();
+    register_type(_type_handle, "SoftwareOcclusionCullTraverser",
+                  CullTraverser::get_class_type());
+  }
+  virtual TypeHandle get_type() const {
+    return get_class_type();
+  }
+  virtual TypeHandle force_init_type() {init_type(); return get_class_type();}
+
+private:
+  static TypeHandle _type_handle;
+};
+
+#include "softwareOcclusionCullTraverser.I"
+
+#endif
@@ -0,0 +1,71 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file threadCompositionCache.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef THREADCOMPOSITIONCACHE_H
+#define THREADCOMPOSITIONCACHE_H
+
+#include "pandabase.h"
+#include "pointerTo.h"
+#include "atomicAdjust.h"
+
+// The per-thread caches are only useful, and only safe, when we have real
+// threads.  With simple threads, a context switch may occur while a cache is
+// being updated, and several threads would share the same cache.
+#if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS) && !defined(CPPPARSER)
+#define HAVE_THREAD_COMPOSITION_CACHE 1
+#endif
+
+/**
+ * A small, direct-mapped cache of recently computed compositions, of which
+ * one instance is kept for each thread.  TransformState and RenderState
+ * consult it in compose() and invert_compose() before taking the global
+ * states lock, so that hot compositions can be returned without any
+ * synchronization with other threads.
+ *
+ * Each entry holds a reference to both operands as well as the result, so an
+ * entry can never refer to a state that has since been destructed and whose
+ * address has been reused.  All caches of a given type can be flushed by
+ * calling invalidate_all(); each thread discards its entries the next time it
+ * touches its cache.
+ */
+template<class State>
+class ThreadCompositionCache {
+public:
+  INLINE ThreadCompositionCache();
+
+  INLINE bool lookup(const State *a, const State *b, CPT(State) &result);
+  INLINE void store(const State *a, const State *b, const State *result);
+
+  INLINE static void invalidate_all();
+
+private:
+  INLINE static size_t get_hash(const State *a, const State *b);
+  INLINE void check_epoch();
+
+  enum { num_entries = 256 };
+
+  class Entry {
+  public:
+    CPT(State) _a;
+    CPT(State) _b;
+    CPT(State) _result;
+  };
+  Entry _entries[num_entries];
+  AtomicAdjust::Integer _epoch;
+
+  static AtomicAdjust::Integer _global_epoch;
+};
+
+#include "threadCompositionCache.I"
+
+#endif
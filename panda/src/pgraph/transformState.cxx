@@ -12,6 +12,7 @@
  */
 
 #include "transformState.h"
+#include "threadCompositionCache.h"
 #include "compose_matrix.h"
 #include "bamReader.h"
 #include "bamWriter.h"
@@ -50,6 +51,11 @@ CacheStats TransformState::_cache_stats;
 
 TypeHandle TransformState::_type_handle;
 
+#ifdef HAVE_THREAD_COMPOSITION_CACHE
+static thread_local ThreadCompositionCache<TransformState> _thread_compose_cache;
+static thread_local ThreadCompositionCache<TransformState> _thread_invert_compose_cache;
+#endif
+
 /**
  * Actually, this could be a private constructor, since no one inherits from
  * TransformState, but gcc gives us a spurious warning if all constructors are
@@ -600,6 +606,32 @@ compose(const TransformState *other) const {
     return do_compose(other);
   }
 
+#ifdef HAVE_THREAD_COMPOSITION_CACHE
+  if (!thread_composition_cache) {
+    return do_cached_compose(other);
+  }
+
+  // Try the calling thread's own cache first, which requires no lock.
+  CPT(TransformState) result;
+  if (_thread_compose_cache.lookup(this, other, result)) {
+    _cache_stats.inc_thread_hits();
+    return result;
+  }
+  result = do_cached_compose(other);
+  _thread_compose_cache.store(this, other, result);
+  return result;
+#else
+  return do_cached_compose(other);
+#endif
+}
+
+/**
+ * The part of compose() that consults and updates the global composition
+ * cache.  This must be called only when the cache is enabled.
+ */
+CPT(TransformState) TransformState::
+do_cached_compose(const TransformState *other) const {
+  _cache_stats.check_contention(*_states_lock);
   LightReMutexHolder holder(*_states_lock);
 
   // Is this composition already cached?
@@ -707,6 +739,32 @@ invert_compose(const TransformState *other) const {
     return do_invert_compose(other);
   }
 
+#ifdef HAVE_THREAD_COMPOSITION_CACHE
+  if (!thread_composition_cache) {
+    return do_cached_invert_compose(other);
+  }
+
+  // Try the calling thread's own cache first, which requires no lock.
+  CPT(TransformState) result;
+  if (_thread_invert_compose_cache.lookup(this, other, result)) {
+    _cache_stats.inc_thread_hits();
+    return result;
+  }
+  result = do_cached_invert_compose(other);
+  _thread_invert_compose_cache.store(this, other, result);
+  return result;
+#else
+  return do_cached_invert_compose(other);
+#endif
+}
+
+/**
+ * The part of invert_compose() that consults and updates the global composition
+ * cache.  This must be called only when the cache is enabled.
+ */
+CPT(TransformState) TransformState::
+do_cached_invert_compose(const TransformState *other) const {
+  _cache_stats.check_contention(*_states_lock);
   LightReMutexHolder holder(*_states_lock);
 
   int index = _invert_composition_cache.find(other);
@@ -1089,6 +1147,11 @@ int TransformState::
 clear_cache() {
   LightReMutexHolder holder(*_states_lock);
 
+#ifdef HAVE_THREAD_COMPOSITION_CACHE
+  // Each thread's own cache is flushed the next time that thread uses it.
+  ThreadCompositionCache<TransformState>::invalidate_all();
+#endif
+
   PStatTimer timer(_cache_update_pcollector);
   int orig_size = _states.get_num_entries();
 
@@ -239,6 +239,8 @@ private:
 
   CPT(TransformState) do_compose(const TransformState *other) const;
   CPT(TransformState) do_invert_compose(const TransformState *other) const;
+  CPT(TransformState) do_cached_compose(const TransformState *other) const;
+  CPT(TransformState) do_cached_invert_compose(const TransformState *other) const;
   void detect_and_break_cycles();
   static bool r_detect_cycles(const TransformState *start_state,
                               const TransformState *current_state,
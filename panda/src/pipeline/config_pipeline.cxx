@@ -57,6 +57,15 @@ ConfigVariableInt thread_stack_size
           "created for each newly-created thread.  Not all thread "
           "implementations respect this value."));
 
+ConfigVariableInt job_pool_num_threads
+("job-pool-num-threads", -1,
+ PRC_DESC("Specifies the number of worker threads in the global JobPool, "
+          "which is used by the subsystems that can optionally spread their "
+          "work across multiple threads, such as the parallel cull.  The "
+          "default, -1, means to use one fewer than the number of hardware "
+          "threads, since the requesting thread also participates.  Set "
+          "this to 0 to run all jobs on the requesting thread."));
+
 /**
  * Initializes the library.  This must be called at least once before any of
  * the functions or classes in this library can be used.  Normally it will be
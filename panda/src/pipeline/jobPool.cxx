@@ -0,0 +1,264 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file jobPool.cxx
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#include "jobPool.h"
+#include "config_pipeline.h"
+#include "mutexHolder.h"
+
+#include <thread>
+
+/**
+ *
+ */
+JobPool::Job::
+~Job() {
+}
+
+/**
+ * Creates a new, empty batch of jobs that will be run at the pipeline stage
+ * of the indicated thread.
+ */
+JobPool::Batch::
+Batch(JobPool *pool, Thread *current_thread) :
+  _pool(pool),
+  _current_thread(current_thread),
+  _pipeline_stage(current_thread->get_pipeline_stage()),
+  _num_pending(0)
+{
+}
+
+/**
+ * Waits for any outstanding jobs before returning.
+ */
+JobPool::Batch::
+~Batch() {
+  wait();
+}
+
+/**
+ * Queues up the indicated job for execution.  It may begin running
+ * immediately on one of the worker threads.  The job pointer must remain
+ * valid until wait() has returned.
+ */
+void JobPool::Batch::
+add_job(Job *job) {
+  nassertv(job->_batch == nullptr);
+  job->_batch = this;
+
+  MutexHolder holder(_pool->_lock);
+  ++_num_pending;
+  ++_pool->_num_jobs_added;
+  _pool->_jobs.push_back(job);
+  _pool->_work_cvar.notify();
+}
+
+/**
+ * Blocks until all of the jobs that have been added to this batch have
+ * finished.  In the meantime, the calling thread helps out by running any
+ * jobs from this batch that have not yet been picked up by a worker.
+ */
+void JobPool::Batch::
+wait() {
+  MutexHolder holder(_pool->_lock);
+  while (_num_pending > 0) {
+    // Look for one of our own jobs that nobody has started yet.
+    Job *job = nullptr;
+    Jobs::iterator ji;
+    for (ji = _pool->_jobs.begin(); ji != _pool->_jobs.end(); ++ji) {
+      if ((*ji)->_batch == this) {
+        job = (*ji);
+        _pool->_jobs.erase(ji);
+        break;
+      }
+    }
+
+    if (job != nullptr) {
+      _pool->run_job(job, _current_thread);
+    } else {
+      // All of our remaining jobs are in progress on other threads.
+      _pool->_done_cvar.wait();
+    }
+  }
+}
+
+/**
+ * Creates a new pool with the indicated number of worker threads.  If
+ * num_threads is 0, or true threads are not available in this build, all
+ * jobs will be run by the thread that waits on them.
+ */
+JobPool::
+JobPool(const std::string &name, int num_threads) :
+  _name(name),
+  _shutdown(false),
+  _num_jobs_added(0),
+  _lock("JobPool::_lock"),
+  _work_cvar(_lock),
+  _done_cvar(_lock)
+{
+  if (Thread::is_true_threads() && support_threads) {
+    start_threads(num_threads);
+  }
+}
+
+/**
+ *
+ */
+JobPool::
+~JobPool() {
+  stop_threads();
+}
+
+/**
+ * Changes the number of worker threads in the pool.  The existing threads are
+ * stopped after finishing the jobs that are already queued, and new ones are
+ * started.  This should not be called while another thread is adding jobs to
+ * the pool.
+ */
+void JobPool::
+set_num_threads(int num_threads) {
+  nassertv(num_threads >= 0);
+
+  stop_threads();
+  if (Thread::is_true_threads() && support_threads) {
+    start_threads(num_threads);
+  }
+}
+
+/**
+ * Returns the total number of jobs that have been added to the pool since it
+ * was created.  This can be used to find out whether an operation that has a
+ * parallel mode actually used it.
+ */
+unsigned int JobPool::
+get_num_jobs_added() const {
+  MutexHolder holder(_lock);
+  return _num_jobs_added;
+}
+
+/**
+ * Returns the default JobPool, which is shared by the various subsystems that
+ * offer a parallel mode.  Its size is controlled by job-pool-num-threads, or
+ * by a later call to set_num_threads().
+ */
+JobPool *JobPool::
+get_global_ptr() {
+  // The pool may be requested by several threads at once, so we rely on the
+  // thread-safe initialization of function-local statics to make sure that
+  // only one of them creates it.
+  static PT(JobPool) global_ptr = make_global_pool();
+  return global_ptr;
+}
+
+/**
+ * Creates the pool returned by get_global_ptr().
+ */
+JobPool *JobPool::
+make_global_pool() {
+  int num_threads = job_pool_num_threads;
+  if (num_threads < 0) {
+    // Leave one hardware thread for the caller, who participates as well.
+    num_threads = std::max((int)std::thread::hardware_concurrency() - 1, 0);
+  }
+  return new JobPool("JobPool", num_threads);
+}
+
+/**
+ * Spawns the indicated number of worker threads.
+ */
+void JobPool::
+start_threads(int num_threads) {
+  MutexHolder holder(_lock);
+  _shutdown = false;
+  for (int i = 0; i < num_threads; ++i) {
+    std::ostringstream name_strm;
+    name_strm << _name << "_" << i;
+    PT(WorkerThread) thread = new WorkerThread(this, name_strm.str());
+    if (thread->start(TP_normal, true)) {
+      _threads.push_back(thread);
+    }
+  }
+}
+
+/**
+ * Signals all the worker threads to terminate, and waits for them to do so.
+ * Jobs that are still queued will be run by the threads that wait for them.
+ */
+void JobPool::
+stop_threads() {
+  Threads threads;
+  {
+    MutexHolder holder(_lock);
+    _shutdown = true;
+    _work_cvar.notify_all();
+    threads.swap(_threads);
+  }
+
+  for (WorkerThread *thread : threads) {
+    thread->join();
+  }
+}
+
+/**
+ * Runs the indicated job, which has already been removed from the queue.
+ * Assumes the lock is held; it is temporarily released while the job runs.
+ */
+void JobPool::
+run_job(Job *job, Thread *current_thread) {
+  Batch *batch = job->_batch;
+
+  _lock.release();
+  int stage = current_thread->get_pipeline_stage();
+  if (stage != batch->_pipeline_stage) {
+    current_thread->set_pipeline_stage(batch->_pipeline_stage);
+  }
+  job->do_job(current_thread);
+  if (stage != batch->_pipeline_stage) {
+    current_thread->set_pipeline_stage(stage);
+  }
+  _lock.acquire();
+
+  job->_batch = nullptr;
+  if (--batch->_num_pending == 0) {
+    _done_cvar.notify_all();
+  }
+}
+
+/**
+ *
+ */
+JobPool::WorkerThread::
+WorkerThread(JobPool *pool, const std::string &name) :
+  Thread(name, "Main"),
+  _pool(pool)
+{
+}
+
+/**
+ * The main processing loop for each worker thread.
+ */
+void JobPool::WorkerThread::
+thread_main() {
+  MutexHolder holder(_pool->_lock);
+  while (true) {
+    while (_pool->_jobs.empty()) {
+      if (_pool->_shutdown) {
+        return;
+      }
+      _pool->_work_cvar.wait();
+    }
+
+    Job *job = _pool->_jobs.front();
+    _pool->_jobs.pop_front();
+    _pool->run_job(job, this);
+  }
+}
@@ -0,0 +1,138 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file jobPool.h
+ * @author agent
+ * @date 2026-10-16
+ */
+
+#ifndef JOBPOOL_H
+#define JOBPOOL_H
+
+#include "pandabase.h"
+#include "referenceCount.h"
+#include "thread.h"
+#include "pmutex.h"
+#include "conditionVar.h"
+#include "pdeque.h"
+#include "pvector.h"
+
+/**
+ * A pool of worker threads that can be used to farm out small, independent
+ * units of work (Jobs) from a thread that needs them all finished before it
+ * can continue, such as the cull or the collision traversal.
+ *
+ * Jobs are collected into a Batch, which is owned by the calling thread.
+ * While the caller waits for the batch to finish, it participates in
+ * running the batch's own jobs, so a pool with no threads (or a build without
+ * true threads) simply runs every job serially in the calling thread.
+ *
+ * Jobs are run at the pipeline stage of the thread that created the batch.
+ */
+class EXPCL_PANDA_PIPELINE JobPool : public ReferenceCount {
+public:
+  class Batch;
+
+  /**
+   * A single unit of work.  The caller is responsible for keeping the Job
+   * object alive until the Batch it was added to has finished waiting.
+   */
+  class EXPCL_PANDA_PIPELINE Job {
+  public:
+    INLINE Job();
+    virtual ~Job();
+
+    virtual void do_job(Thread *current_thread)=0;
+
+  private:
+    Batch *_batch;
+    friend class JobPool;
+  };
+
+  /**
+   * Tracks the completion of a set of jobs added by one thread.  The
+   * destructor implicitly waits for any jobs that are still outstanding.
+   */
+  class EXPCL_PANDA_PIPELINE Batch {
+  public:
+    explicit Batch(JobPool *pool,
+                   Thread *current_thread = Thread::get_current_thread());
+    Batch(const Batch &copy) = delete;
+    ~Batch();
+
+    Batch &operator = (const Batch &copy) = delete;
+
+    void add_job(Job *job);
+    BLOCKING void wait();
+
+    INLINE JobPool *get_pool() const;
+
+  private:
+    JobPool *_pool;
+    Thread *_current_thread;
+    int _pipeline_stage;
+    int _num_pending;
+    friend class JobPool;
+  };
+
+PUBLISHED:
+  explicit JobPool(const std::string &name, int num_threads);
+  ~JobPool();
+
+  INLINE const std::string &get_name() const;
+  INLINE int get_num_threads() const;
+  void set_num_threads(int num_threads);
+  unsigned int get_num_jobs_added() const;
+
+  static JobPool *get_global_ptr();
+
+  MAKE_PROPERTY(name, get_name);
+  MAKE_PROPERTY(num_threads, get_num_threads, set_num_threads);
+  MAKE_PROPERTY(num_jobs_added, get_num_jobs_added);
+
+private:
+  static JobPool *make_global_pool();
+
+  void start_threads(int num_threads);
+  void stop_threads();
+
+  void run_job(Job *job, Thread *current_thread);
+
+  class EXPCL_PANDA_PIPELINE WorkerThread : public Thread {
+  public:
+    WorkerThread(JobPool *pool, const std::string &name);
+
+  protected:
+    virtual void thread_main();
+
+  private:
+    JobPool *_pool;
+  };
+  typedef pvector<PT(WorkerThread)> Threads;
+
+  std::string _name;
+  Threads _threads;
+
+  typedef pdeque<Job *> Jobs;
+  Jobs _jobs;
+  bool _shutdown;
+  unsigned int _num_jobs_added;
+
+  // Protects _jobs, _shutdown, _num_jobs_added and Batch::_num_pending.
+  Mutex _lock;
+
+  // Signaled when a new job is added or when _shutdown is set.
+  ConditionVar _work_cvar;
+
+  // Signaled when any job finishes.
+  ConditionVar _done_cvar;
+};
+
+#include "jobPool.I"
+
+#endif
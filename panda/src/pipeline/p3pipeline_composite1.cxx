@@ -17,6 +17,7 @@
 #include "cyclerHolder.cxx"
 #include "externalThread.cxx"
 #include "genericThread.cxx"
+#include "jobPool.cxx"
 #include "lightMutexDirect.cxx"
 #include "lightMutexHolder.cxx"
 #include "lightReMutexDirect.cxx"
@@ -204,9 +204,16 @@ static LevelCollectorProperties level_properties[] = {
   { 1, "Vertex Data:Pending",              { 0.6, 0.8, 1.0 } },
   { 1, "Vertex Data:Resident",             { 0.9, 1.0, 0.7 } },
   { 1, "Vertex Data:Compressed",           { 0.5, 0.1, 0.4 } },
+  { 1, "Vertex Data:Mapped",               { 0.3, 0.7, 0.8 } },
   { 1, "Vertex Data:Disk",                 { 0.6, 0.9, 0.1 } },
   { 1, "Vertex Data:Disk:Unused",          { 0.8, 0.4, 0.5 } },
   { 1, "Vertex Data:Disk:Used",            { 0.2, 0.1, 0.6 } },
+  { 1, "Model cache",                      { 0.4, 0.6, 0.9 },  "MB", 1024, 1048576 },
+  { 1, "Model cache lookups",              { 0.7, 0.7, 0.3 },  "", 10 },
+  { 1, "Model cache lookups:Hits",         { 0.2, 0.9, 0.3 } },
+  { 1, "Model cache lookups:Misses",       { 0.9, 0.2, 0.2 } },
+  { 1, "Model cache evictions",            { 0.6, 0.3, 0.8 },  "", 10 },
+  { 1, "Model cache lookup time",          { 0.9, 0.6, 0.1 },  "ms", 50 },
   { 1, "TransformStates",                  { 1.0, 0.5, 0.5 },  "", 5000 },
   { 1, "TransformStates:On nodes",         { 0.2, 0.8, 1.0 } },
   { 1, "TransformStates:Cached",           { 1.0, 0.0, 0.2 } },
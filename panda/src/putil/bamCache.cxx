@@ -26,6 +26,10 @@
 #include "configVariableString.h"
 #include "configVariableFilename.h"
 #include "virtualFileSystem.h"
+#include "trueClock.h"
+#include "indent.h"
+
+#include <algorithm>
 
 using std::istream;
 using std::ostream;
@@ -42,7 +46,13 @@ BamCache() :
   _active(true),
   _read_only(false),
   _index(new BamCacheIndex),
-  _index_stale_since(0)
+  _index_stale_since(0),
+  _num_hits(0),
+  _num_misses(0),
+  _num_stores(0),
+  _num_evictions(0),
+  _lookup_usec(0),
+  _cache_size(0)
 {
   ConfigVariableFilename model_cache_dir
     ("model-cache-dir", Filename(),
@@ -86,6 +96,17 @@ BamCache() :
     ("model-cache-max-kbytes", 10485760,
      PRC_DESC("This is the maximum size of the model cache, in kilobytes."));
 
+  ConfigVariableBool model_cache_index
+    ("model-cache-index", true,
+     PRC_DESC("Set this true to maintain a single index file listing all of "
+              "the files in the model cache, or false to store each cache "
+              "file in a subdirectory named for its hash, with no index at "
+              "all.  The latter is better suited to a model-cache-dir that "
+              "is shared by many processes at once, since they need not "
+              "contend over rewriting the index; the cache is then kept "
+              "below model-cache-max-kbytes by deleting the files that were "
+              "least recently used."));
+
   _cache_models = model_cache_models;
   _cache_textures = model_cache_textures;
   _cache_compressed_textures = model_cache_compressed_textures;
@@ -93,6 +114,7 @@ BamCache() :
 
   _flush_time = model_cache_flush;
   _max_kbytes = model_cache_max_kbytes;
+  _use_index = model_cache_index;
 
   if (!model_cache_dir.empty()) {
     set_root(model_cache_dir);
@@ -141,7 +163,9 @@ set_root(const Filename &root) {
     return;
   }
 
-  read_index();
+  if (_use_index) {
+    read_index();
+  }
   check_cache_size();
 }
 
@@ -163,9 +187,41 @@ set_root(const Filename &root) {
  */
 PT(BamCacheRecord) BamCache::
 lookup(const Filename &source_filename, const string &cache_extension) {
-  ReMutexHolder holder(_lock);
-  consider_flush_index();
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+
+  PT(BamCacheRecord) record;
+  if (_use_index) {
+    ReMutexHolder holder(_lock);
+    consider_flush_index();
+    record = do_lookup(source_filename, cache_extension);
+  } else {
+    // Without an index, there is no shared state to protect; the cache files
+    // are only ever replaced by an atomic rename, so other threads and
+    // processes may look up and store files at the same time.
+    consider_flush_index();
+    record = do_lookup(source_filename, cache_extension);
+  }
+
+  if (record != nullptr) {
+    if (record->has_data()) {
+      AtomicAdjust::inc(_num_hits);
+    } else {
+      AtomicAdjust::inc(_num_misses);
+    }
+  }
 
+  double elapsed = clock->get_short_time() - start;
+  AtomicAdjust::add(_lookup_usec, (AtomicAdjust::Integer)(elapsed * 1000000.0));
+  return record;
+}
+
+/**
+ * The implementation of lookup().  Assumes the lock is already held, if
+ * there is an index to protect.
+ */
+PT(BamCacheRecord) BamCache::
+do_lookup(const Filename &source_filename, const string &cache_extension) {
   VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
 
   Filename source_pathname(source_filename);
@@ -179,7 +235,15 @@ lookup(const Filename &source_filename, const string &cache_extension) {
     return nullptr;
   }
 
-  Filename cache_filename = hash_filename(source_pathname.get_fullpath());
+  Filename cache_filename;
+  if (_use_index) {
+    cache_filename = hash_filename(source_pathname.get_fullpath());
+  } else {
+    // Spread the files over a number of subdirectories, so that no single
+    // directory grows too large to scan efficiently.
+    string hash = hash_filename(source_pathname.get_fullpath());
+    cache_filename = Filename(hash.substr(0, 2), hash);
+  }
   cache_filename.set_extension(cache_extension);
 
   return find_and_read_record(source_pathname, cache_filename);
@@ -192,16 +256,49 @@ lookup(const Filename &source_filename, const string &cache_extension) {
  */
 bool BamCache::
 store(BamCacheRecord *record) {
-  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
-  ReMutexHolder holder(_lock);
   nassertr(!record->_cache_pathname.empty(), false);
   nassertr(record->has_data(), false);
 
-  if (_read_only) {
-    return false;
+  if (_use_index) {
+    ReMutexHolder holder(_lock);
+    if (_read_only) {
+      return false;
+    }
+
+    consider_flush_index();
+    if (!do_store(record)) {
+      return false;
+    }
+    add_to_index(record);
+
+  } else {
+    if (_read_only) {
+      return false;
+    }
+
+    // The file is written without holding the lock; we only need it to note
+    // that the cache directory has grown and may need trimming.
+    consider_flush_index();
+    if (!do_store(record)) {
+      return false;
+    }
+    AtomicAdjust::add(_cache_size, (AtomicAdjust::Integer)record->_record_size);
+
+    ReMutexHolder holder(_lock);
+    mark_index_stale();
   }
 
-  consider_flush_index();
+  AtomicAdjust::inc(_num_stores);
+  return true;
+}
+
+/**
+ * The implementation of store().  Writes the record to a temporary file and
+ * then moves it into place.
+ */
+bool BamCache::
+do_store(BamCacheRecord *record) {
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
 
 #ifndef NDEBUG
   // Ensure that the cache_pathname is within the _root directory tree.
@@ -223,6 +320,12 @@ store(BamCacheRecord *record) {
   temp_pathname.set_extension(extension);
   temp_pathname.set_binary();
 
+  if (!_use_index) {
+    // Make sure the hash subdirectory exists.  Another process may be
+    // creating it at the same time, so don't worry if this fails.
+    vfs->make_directory(cache_pathname.get_dirname());
+  }
+
   DatagramOutputFile dout;
   if (!dout.open(temp_pathname)) {
     util_cat.error()
@@ -298,8 +401,6 @@ store(BamCacheRecord *record) {
     }
   }
 
-  add_to_index(record);
-
   return true;
 }
 
@@ -352,6 +453,16 @@ flush_index() {
     return;
   }
 
+  if (!_use_index) {
+    // There is no index to write, but new files have been stored since we
+    // last checked the size of the cache directory.
+    _index_stale_since = 0;
+    if (!_read_only) {
+      check_cache_size();
+    }
+    return;
+  }
+
   while (true) {
     if (_read_only) {
       return;
@@ -398,6 +509,11 @@ flush_index() {
  */
 void BamCache::
 list_index(ostream &out, int indent_level) const {
+  if (!_use_index) {
+    indent(out, indent_level)
+      << "(no index is kept for " << _root << ")\n";
+    return;
+  }
   _index->write(out, indent_level);
 }
 
@@ -417,6 +533,7 @@ read_index() {
     BamCacheIndex *new_index = do_read_index(_index_pathname);
     if (new_index != nullptr) {
       merge_index(new_index);
+      AtomicAdjust::set(_cache_size, (AtomicAdjust::Integer)_index->_cache_size);
       return;
     }
 
@@ -626,6 +743,7 @@ add_to_index(const BamCacheRecord *record) {
   if (_index->add_record(new_record)) {
     mark_index_stale();
     check_cache_size();
+    AtomicAdjust::set(_cache_size, (AtomicAdjust::Integer)_index->_cache_size);
   }
 }
 
@@ -636,6 +754,7 @@ void BamCache::
 remove_from_index(const Filename &source_pathname) {
   if (_index->remove_record(source_pathname)) {
     mark_index_stale();
+    AtomicAdjust::set(_cache_size, (AtomicAdjust::Integer)_index->_cache_size);
   }
 }
 
@@ -645,6 +764,11 @@ remove_from_index(const Filename &source_pathname) {
  */
 void BamCache::
 check_cache_size() {
+  if (!_use_index) {
+    trim_cache_dir();
+    return;
+  }
+
   if (_index->_cache_size == 0) {
     // 0 means no limit.
     return;
@@ -665,11 +789,88 @@ check_cache_size() {
           << " to keep cache size below " << _max_kbytes << "K\n";
       }
       vfs->delete_file(cache_pathname);
+      AtomicAdjust::inc(_num_evictions);
     }
     mark_index_stale();
   }
 }
 
+/**
+ * Used in place of check_cache_size() when there is no index.  Scans the hash
+ * subdirectories of the cache to measure its total size, and if it exceeds
+ * the specified size limit, deletes the least-recently-used files until it no
+ * longer does.
+ *
+ * Other processes may be doing the same thing at the same time, so it is not
+ * an error if a file has already disappeared by the time we get to it.
+ */
+void BamCache::
+trim_cache_dir() {
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+
+  PT(VirtualFileList) subdirs = vfs->scan_directory(_root);
+  if (subdirs == nullptr) {
+    return;
+  }
+
+  typedef pvector<std::pair<time_t, PT(VirtualFile)> > Files;
+  Files files;
+  std::streamsize total_size = 0;
+  time_t now = time(nullptr);
+
+  int num_subdirs = subdirs->get_num_files();
+  for (int si = 0; si < num_subdirs; ++si) {
+    VirtualFile *subdir = subdirs->get_file(si);
+    if (!subdir->is_directory()) {
+      continue;
+    }
+    PT(VirtualFileList) contents = subdir->scan_directory();
+    if (contents == nullptr) {
+      continue;
+    }
+
+    int num_files = contents->get_num_files();
+    for (int ci = 0; ci < num_files; ++ci) {
+      VirtualFile *file = contents->get_file(ci);
+      time_t timestamp = file->get_timestamp();
+      if (file->get_filename().get_extension() == "tmp") {
+        // Another process is still writing this file; unless it is more than
+        // an hour old, in which case the writer must have died.
+        if (now - timestamp > 3600) {
+          file->delete_file();
+        }
+        continue;
+      }
+      total_size += file->get_file_size();
+      files.push_back(Files::value_type(timestamp, file));
+    }
+  }
+
+  if (_max_kbytes > 0 && total_size / 1024 > _max_kbytes) {
+    // The modification time is updated on every cache hit, so the oldest
+    // files are the least recently used ones.
+    std::sort(files.begin(), files.end());
+
+    Files::const_iterator fi;
+    for (fi = files.begin();
+         fi != files.end() && total_size / 1024 > _max_kbytes;
+         ++fi) {
+      VirtualFile *file = (*fi).second;
+      if (util_cat.is_debug()) {
+        util_cat.debug()
+          << "Deleting " << file->get_filename()
+          << " to keep cache size below " << _max_kbytes << "K\n";
+      }
+      total_size -= file->get_file_size();
+      if (file->delete_file()) {
+        AtomicAdjust::inc(_num_evictions);
+      }
+    }
+  }
+
+  AtomicAdjust::set(_cache_size, (AtomicAdjust::Integer)total_size);
+}
+
 /**
  * Reads the index data from the specified filename.  Returns a newly-
  * allocated BamCacheIndex object on success, or NULL on failure.
@@ -785,7 +986,13 @@ find_and_read_record(const Filename &source_pathname,
     PT(BamCacheRecord) record =
       read_record(source_pathname, cache_filename, pass);
     if (record != nullptr) {
-      add_to_index(record);
+      if (_use_index) {
+        add_to_index(record);
+      } else if (record->has_data()) {
+        // Without an index, the file's modification time is what records
+        // when it was last used.
+        record->_cache_pathname.touch();
+      }
       return record;
     }
     ++pass;
@@ -833,7 +1040,9 @@ read_record(const Filename &source_pathname,
         << "Deleting invalid cache file " << cache_pathname << "\n";
     }
     vfs->delete_file(cache_pathname);
-    remove_from_index(source_pathname);
+    if (_use_index) {
+      remove_from_index(source_pathname);
+    }
 
     PT(BamCacheRecord) record =
       new BamCacheRecord(source_pathname, cache_filename);
@@ -874,6 +1083,9 @@ do_read_record(const Filename &cache_pathname, bool read_data) {
     }
     return nullptr;
   }
+  // The record is not memory-mapped even if bam-mmap is set, since
+  // trim_cache_dir() may delete the cache file at any time while the objects
+  // read from it are still in use.
 
   string head;
   if (!din.read_header(head, _bam_header.size())) {
@@ -22,6 +22,7 @@
 #include "pvector.h"
 #include "reMutex.h"
 #include "reMutexHolder.h"
+#include "atomicAdjust.h"
 
 #include <time.h>
 
@@ -38,6 +39,14 @@ class BamCacheIndex;
  * multiple different processes writing to the same index, and without relying
  * too heavily on low-level os-provided file locks (which work poorly with C++
  * iostreams).
+ *
+ * If model-cache-index is set false, no index is kept at all.  Each cache
+ * file is instead stored in a subdirectory named for the first two characters
+ * of its hash, and is only ever replaced by an atomic rename; this allows
+ * many processes to share the same cache directory without contending over
+ * the index.  In this mode, the cache is trimmed to size by deleting the
+ * least-recently-used files, as determined by their modification time, which
+ * is updated on each cache hit.
  */
 class EXPCL_PANDA_PUTIL BamCache {
 PUBLISHED:
@@ -71,6 +80,8 @@ PUBLISHED:
   INLINE void set_read_only(bool ro);
   INLINE bool get_read_only() const;
 
+  INLINE bool get_use_index() const;
+
   PT(BamCacheRecord) lookup(const Filename &source_filename,
                             const std::string &cache_extension);
   bool store(BamCacheRecord *record);
@@ -80,6 +91,13 @@ PUBLISHED:
 
   void list_index(std::ostream &out, int indent_level = 0) const;
 
+  INLINE int get_num_hits() const;
+  INLINE int get_num_misses() const;
+  INLINE int get_num_stores() const;
+  INLINE int get_num_evictions() const;
+  INLINE double get_total_lookup_time() const;
+  INLINE size_t get_cache_size() const;
+
   INLINE static BamCache *get_global_ptr();
   INLINE static void consider_flush_global_index();
   INLINE static void flush_global_index();
@@ -96,8 +114,19 @@ PUBLISHED:
   MAKE_PROPERTY(flush_time, get_flush_time, set_flush_time);
   MAKE_PROPERTY(cache_max_kbytes, get_cache_max_kbytes, set_cache_max_kbytes);
   MAKE_PROPERTY(read_only, get_read_only, set_read_only);
+  MAKE_PROPERTY(use_index, get_use_index);
+  MAKE_PROPERTY(num_hits, get_num_hits);
+  MAKE_PROPERTY(num_misses, get_num_misses);
+  MAKE_PROPERTY(num_stores, get_num_stores);
+  MAKE_PROPERTY(num_evictions, get_num_evictions);
+  MAKE_PROPERTY(total_lookup_time, get_total_lookup_time);
+  MAKE_PROPERTY(cache_size, get_cache_size);
 
 private:
+  PT(BamCacheRecord) do_lookup(const Filename &source_filename,
+                               const std::string &cache_extension);
+  bool do_store(BamCacheRecord *record);
+
   void read_index();
   bool read_index_pathname(Filename &index_pathname,
                            std::string &index_ref_contents) const;
@@ -109,6 +138,7 @@ private:
   void remove_from_index(const Filename &source_filename);
 
   void check_cache_size();
+  void trim_cache_dir();
 
   void emergency_read_only();
 
@@ -132,6 +162,7 @@ private:
   bool _cache_compressed_textures;
   bool _cache_compiled_shaders;
   bool _read_only;
+  bool _use_index;
   Filename _root;
   int _flush_time;
   int _max_kbytes;
@@ -143,6 +174,13 @@ private:
   Filename _index_pathname;
   std::string _index_ref_contents;
 
+  AtomicAdjust::Integer _num_hits;
+  AtomicAdjust::Integer _num_misses;
+  AtomicAdjust::Integer _num_stores;
+  AtomicAdjust::Integer _num_evictions;
+  AtomicAdjust::Integer _lookup_usec;
+  AtomicAdjust::Integer _cache_size;
+
   ReMutex _lock;
 };
 
@@ -59,6 +59,25 @@ PUBLISHED:
     // May appear at any level and indicates the following datagram contains
     // auxiliary file data that may be referenced by a later object.
     BOC_file_data,
+
+    // Follows the BOC_pop that ends each top-level object, and lists a set of
+    // BamObjectIndexFlags for each object definition within it.
+    BOC_index,
+  };
+
+  // These bits are stored in the BOC_index record for each object definition.
+  // They describe the state the reader must be in to read the definition
+  // independently of the ones before it in the same top-level object.
+  enum BamObjectIndexFlags {
+    // Object ID's and PTA ID's at the start of the datagram are written
+    // with 32 bits instead of 16.
+    BOIF_long_object_id = 0x01,
+    BOIF_long_pta_id    = 0x02,
+
+    // The definition refers to a PTA, a type or a file data block that was
+    // written by an earlier object in the same top-level object, so it must
+    // be read after all of those.
+    BOIF_dependent      = 0x04,
   };
 
   // This enum is used to control how textures are written to a bam stream.
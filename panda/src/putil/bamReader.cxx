@@ -19,6 +19,7 @@
 #include "datagramIterator.h"
 #include "config_putil.h"
 #include "pipelineCyclerBase.h"
+#include "jobPool.h"
 
 using std::string;
 
@@ -33,6 +34,47 @@ BamReader::NewTypes BamReader::_new_types;
 const int BamReader::_cur_major = _bam_major_ver;
 const int BamReader::_cur_minor = _bam_minor_ver;
 
+// p_read_parallel() gives each job at least this many objects to create.
+static const size_t parallel_min_job_objects = 16;
+
+/**
+ * One of the object definitions collected by p_read_parallel().
+ */
+class BamReader::ParallelObject {
+public:
+  Datagram _datagram;
+  const unsigned char *_mapped_data;
+
+  // These are read from the header of the definition.  The ID widths are
+  // those at the end of the header, and are updated to those at the end of
+  // the definition once it has been read.
+  size_t _header_size;
+  TypeHandle _type;
+  int _object_id;
+  bool _long_object_id;
+  bool _long_pta_id;
+
+  // True if the object is to be created by a ParallelReadJob, which fills in
+  // the rest.
+  bool _parallel;
+  TypedWritable *_object;
+  bool _overrun;
+};
+
+/**
+ * Creates the objects in a range of those collected by p_read_parallel().
+ * The job has a BamReader of its own, which records the pointers and other
+ * requests made by the objects as they are read.
+ */
+class BamReader::ParallelReadJob : public JobPool::Job {
+public:
+  virtual void do_job(Thread *current_thread);
+
+  BamReader _reader;
+  ParallelObject *_begin;
+  ParallelObject *_end;
+};
+
 
 /**
  *
@@ -46,9 +88,12 @@ BamReader(DatagramGenerator *source)
   _nesting_level = 0;
   _now_creating = _created_objs.end();
   _reading_cycler = nullptr;
+  _mapped_datagram = nullptr;
+  _mapped_datagram_data = nullptr;
   _pta_id = -1;
   _long_object_id = false;
   _long_pta_id = false;
+  _parent = nullptr;
 }
 
 
@@ -248,25 +293,40 @@ read_object(TypedWritable *&ptr, ReferenceCount *&ref_ptr) {
   nassertr(_num_extra_objects == 0, false);
 
   int start_level = _nesting_level;
+  int object_id;
 
-  // First, read the base object.
-  int object_id = p_read_object();
+  if (bam_parallel_read && get_file_minor_ver() >= 47 &&
+      JobPool::get_global_ptr()->get_num_threads() > 0) {
+    // Read the object and all the objects it includes at once, so that they
+    // may be created in parallel.
+    object_id = p_read_parallel();
 
-  // Now that object might have included some pointers to other objects, which
-  // may still need to be read.  And those objects might in turn require
-  // reading additional objects.  Read all the remaining objects.
+  } else {
+    // First, read the base object.
+    object_id = p_read_object();
+
+    // Now that object might have included some pointers to other objects,
+    // which may still need to be read.  And those objects might in turn
+    // require reading additional objects.  Read all the remaining objects.
+
+    // Prior to 6.21, we kept track of _num_extra_objects to know when we're
+    // done.
+    while (_num_extra_objects > 0) {
+      p_read_object();
+      _num_extra_objects--;
+    }
 
-  // Prior to 6.21, we kept track of _num_extra_objects to know when we're
-  // done.
-  while (_num_extra_objects > 0) {
-    p_read_object();
-    _num_extra_objects--;
-  }
+    // Beginning with 6.21, we use explicit nesting commands to know when
+    // we're done.
+    while (_nesting_level > start_level) {
+      p_read_object();
+    }
 
-  // Beginning with 6.21, we use explicit nesting commands to know when we're
-  // done.
-  while (_nesting_level > start_level) {
-    p_read_object();
+    // Beginning with 6.47, this is followed by an index of the objects we
+    // just read, which we don't need when reading them one at a time.
+    if (object_id != 0 && get_file_minor_ver() >= 47) {
+      read_object_index(nullptr);
+    }
   }
 
   // Now look up the pointer of the object we read first.  It should be
@@ -507,6 +567,32 @@ change_pointer(const TypedWritable *orig_pointer, const TypedWritable *new_point
 }
 
 
+/**
+ * May be called by a class's fillin() method to find out whether the bytes at
+ * the current position of scan are also available in place, in a memory-
+ * mapped file that the bam file is being read from.  If so, returns a pointer
+ * to them, and stores the mapping in the indicated pointer; the memory remains
+ * valid for as long as a reference to the mapping is kept.  Otherwise, returns
+ * NULL, and the bytes must be copied out of the datagram as usual.
+ *
+ * This does not advance the iterator.  The returned memory may not be
+ * written to.
+ */
+const unsigned char *BamReader::
+get_mapped_pointer(const DatagramIterator &scan,
+                   PT(MemoryMappedFile) &mapping) const {
+  if (_mapped_datagram_data == nullptr ||
+      &scan.get_datagram() != _mapped_datagram) {
+    return nullptr;
+  }
+
+  nassertr(_source != nullptr, nullptr);
+  mapping = _source->get_mapped_file();
+  nassertr(mapping != nullptr, nullptr);
+
+  return _mapped_datagram_data + scan.get_current_index();
+}
+
 /**
  * Reads a TypeHandle out of the Datagram.
  */
@@ -538,6 +624,15 @@ read_handle(DatagramIterator &scan) {
     return type;
   }
 
+  if (_parent != nullptr) {
+    // We are creating objects on behalf of another BamReader, which has read
+    // all the types defined so far; see p_read_parallel().
+    mi = _parent->_index_map.find(id);
+    if (mi != _parent->_index_map.end()) {
+      return (*mi).second;
+    }
+  }
+
   // We haven't encountered this index number before.  This means it will be
   // immediately followed by the type definition.  This consists of the string
   // name, followed by the list of parent TypeHandles for this type.
@@ -942,6 +1037,15 @@ get_pta(DatagramIterator &scan) {
 
   PTAMap::iterator pi = _pta_map.find(id);
   if (pi == _pta_map.end()) {
+    if (_parent != nullptr) {
+      // It may have been read already by the BamReader we are creating
+      // objects for; see p_read_parallel().
+      PTAMap::const_iterator ppi = _parent->_pta_map.find(id);
+      if (ppi != _parent->_pta_map.end()) {
+        return (*ppi).second;
+      }
+    }
+
     // This is the first time we've encountered this particular ID, meaning we
     // need to read the data now and register it.
     _pta_id = id;
@@ -1063,6 +1167,10 @@ p_read_object() {
     return 0;
   }
 
+  // If the datagram was read from a mapped file, its contents may be referred
+  // to in place by the objects it defines; see get_mapped_pointer().
+  const unsigned char *mapped_data = _source->get_mapped_datagram();
+
   // Now extract the object definition from the datagram.
   DatagramIterator scan(dg);
 
@@ -1146,155 +1254,521 @@ p_read_object() {
   // we must read the definition to follow.
 
   if (type != TypeHandle::none()) {
-    // Now we are going to read and create a new object.
+    if (!p_read_definition(type, object_id, dg, scan, mapped_data)) {
+      return 0;
+    }
+  }
 
-    // First, we must add an entry into the map for this object ID, so that in
-    // case this function is called recursively during the object's factory
-    // constructor, we will have some definition for the object.  For now, we
-    // give it a NULL pointer.
-    CreatedObj new_created_obj;
-    CreatedObjs::iterator oi =
-      _created_objs.insert(CreatedObjs::value_type(object_id, new_created_obj)).first;
-    CreatedObj &created_obj = (*oi).second;
+  return object_id;
+}
+
+/**
+ * The second half of p_read_object(): reads the definition of the object
+ * with the indicated type and ID from the remainder of the datagram, either
+ * creating a new object or updating the existing one.  Returns false if the
+ * stream is invalid.
+ */
+bool BamReader::
+p_read_definition(TypeHandle type, int object_id, const Datagram &dg,
+                  DatagramIterator &scan, const unsigned char *mapped_data) {
+  // First, we must add an entry into the map for this object ID, so that in
+  // case this function is called recursively during the object's factory
+  // constructor, we will have some definition for the object.  For now, we
+  // give it a NULL pointer.
+  CreatedObj new_created_obj;
+  CreatedObjs::iterator oi =
+    _created_objs.insert(CreatedObjs::value_type(object_id, new_created_obj)).first;
+  CreatedObj &created_obj = (*oi).second;
+
+  if (created_obj._ptr != nullptr) {
+    // This object had already existed; thus, we are just receiving an update
+    // for it.
+
+    if (_object_pointers.find(object_id) != _object_pointers.end()) {
+      // Aieee! This object isn't even complete from the last time we
+      // encountered it in the stream! This should never happen. Something's
+      // corrupt or the stream was maliciously crafted.
+      bam_cat.error()
+        << "Found object " << object_id << " in bam stream again while "
+        << "trying to resolve its own pointers.\n";
+      return false;
+    }
 
-    if (created_obj._ptr != nullptr) {
-      // This object had already existed; thus, we are just receiving an
-      // update for it.
+    // Update _now_creating during this call so if this function calls
+    // read_pointer() or register_change_this() we'll match it up properly.
+    // This might recursively call back into this p_read_object(), so be sure
+    // to save and restore the original value of _now_creating.
+    CreatedObjs::iterator was_creating = _now_creating;
+    const Datagram *was_mapped_datagram = _mapped_datagram;
+    const unsigned char *was_mapped_datagram_data = _mapped_datagram_data;
+    _now_creating = oi;
+    _mapped_datagram = &dg;
+    _mapped_datagram_data = mapped_data;
+    created_obj._ptr->fillin(scan, this);
+    _now_creating = was_creating;
+    _mapped_datagram = was_mapped_datagram;
+    _mapped_datagram_data = was_mapped_datagram_data;
+
+    if (scan.get_remaining_size() > 0) {
+      bam_cat.warning()
+        << "Skipping " << scan.get_remaining_size() << " remaining bytes "
+        << "in datagram containing type " << type << "\n";
+    }
 
-      if (_object_pointers.find(object_id) != _object_pointers.end()) {
-        // Aieee! This object isn't even complete from the last time we
-        // encountered it in the stream! This should never happen. Something's
-        // corrupt or the stream was maliciously crafted.
-        bam_cat.error()
-          << "Found object " << object_id << " in bam stream again while "
-          << "trying to resolve its own pointers.\n";
-        return 0;
+  } else {
+    // We are receiving a new object.  Now we can call the factory to create
+    // the object.
+    TypedWritable *object = p_make_object(type, oi, dg, scan, mapped_data);
+    p_record_object(type, oi, object);
+  }
+
+  // Sanity check that we read the expected number of bytes.
+  if (scan.get_current_index() > dg.get_length()) {
+    bam_cat.error()
+      << "End of datagram reached while reading bam object "
+      << type << ": " << (void *)created_obj._ptr << "\n";
+  }
+
+  return true;
+}
+
+/**
+ * Calls the factory to create a new object of the indicated type from the
+ * remainder of the datagram, with _now_creating set to the indicated entry.
+ * Returns the new object, which has not yet been stored in the entry.
+ */
+TypedWritable *BamReader::
+p_make_object(TypeHandle type, CreatedObjs::iterator oi, const Datagram &dg,
+              DatagramIterator &scan, const unsigned char *mapped_data) {
+  // Define the parameters for passing to the object factory.
+  FactoryParams fparams;
+  fparams.add_param(new BamReaderParam(scan, this));
+
+  // As in p_read_definition(), we update and preserve _now_creating during
+  // this call.
+  CreatedObjs::iterator was_creating = _now_creating;
+  const Datagram *was_mapped_datagram = _mapped_datagram;
+  const unsigned char *was_mapped_datagram_data = _mapped_datagram_data;
+  _now_creating = oi;
+  _mapped_datagram = &dg;
+  _mapped_datagram_data = mapped_data;
+  TypedWritable *object =
+    _factory->make_instance_more_general(type, fparams);
+  _now_creating = was_creating;
+  _mapped_datagram = was_mapped_datagram;
+  _mapped_datagram_data = was_mapped_datagram_data;
+
+  return object;
+}
+
+/**
+ * Stores the object returned by p_make_object() in its entry in
+ * _created_objs, and replaces it right away if it asked to be replaced and
+ * has no pointers to wait for.
+ */
+void BamReader::
+p_record_object(TypeHandle type, CreatedObjs::iterator oi, TypedWritable *object) {
+  int object_id = (*oi).first;
+  CreatedObj &created_obj = (*oi).second;
+
+  // And now we can store the new object pointer in the map.
+  nassertv(created_obj._ptr == object || created_obj._ptr == nullptr);
+  if (object == nullptr) {
+    created_obj.set_ptr(nullptr, nullptr);
+  } else {
+    created_obj.set_ptr(object, object->as_reference_count());
+  }
+  created_obj._created = true;
+
+  if (created_obj._change_this_ref != nullptr) {
+    // If the pointer is scheduled to change after complete_pointers(), but we
+    // have no entry in _object_pointers for this object (and hence no plan to
+    // call complete_pointers()), then just change the pointer immediately.
+    ObjectPointers::const_iterator ri = _object_pointers.find(object_id);
+    if (ri == _object_pointers.end()) {
+      PT(TypedWritableReferenceCount) object_ref = (*created_obj._change_this_ref)((TypedWritableReferenceCount *)object, this);
+      TypedWritable *new_ptr = object_ref;
+      created_obj.set_ptr(object_ref, object_ref);
+      created_obj._change_this = nullptr;
+      created_obj._change_this_ref = nullptr;
+
+      // Remove the pointer from the finalize list (the new pointer presumably
+      // doesn't require finalizing).
+      if (new_ptr != object) {
+        _finalize_list.erase(object);
       }
+      object = new_ptr;
+    }
 
-      // Update _now_creating during this call so if this function calls
-      // read_pointer() or register_change_this() we'll match it up properly.
-      // This might recursively call back into this p_read_object(), so be
-      // sure to save and restore the original value of _now_creating.
-      CreatedObjs::iterator was_creating = _now_creating;
-      _now_creating = oi;
-      created_obj._ptr->fillin(scan, this);
-      _now_creating = was_creating;
+  } else if (created_obj._change_this != nullptr) {
+    // Non-reference-counting variant.
+    ObjectPointers::const_iterator ri = _object_pointers.find(object_id);
+    if (ri == _object_pointers.end()) {
+      TypedWritable *new_ptr = (*created_obj._change_this)(object, this);
+      created_obj.set_ptr(new_ptr, new_ptr->as_reference_count());
+      created_obj._change_this = nullptr;
+      created_obj._change_this_ref = nullptr;
+
+      if (new_ptr != object) {
+        _finalize_list.erase(object);
+      }
+      object = new_ptr;
+    }
+  }
+
+  _created_objs_by_pointer[created_obj._ptr].push_back(object_id);
+
+  // Just some sanity checks
+  if (object == nullptr) {
+    if (bam_cat.is_debug()) {
+      bam_cat.debug()
+        << "Unable to create an object of type " << type << std::endl;
+    }
 
-      if (scan.get_remaining_size() > 0) {
+  } else if (object->get_type() != type) {
+    if (_new_types.find(type) != _new_types.end()) {
+      // This was a type we hadn't heard of before, so it's not really
+      // surprising we didn't know how to create it.  Suppress the warning
+      // (make it a debug statement instead).
+      if (bam_cat.is_debug()) {
         bam_cat.warning()
-          << "Skipping " << scan.get_remaining_size() << " remaining bytes "
-          << "in datagram containing type " << type << "\n";
+          << "Attempted to create a " << type.get_name()    \
+          << " but a " << object->get_type()                \
+          << " was created instead." << std::endl;
       }
 
     } else {
-      // We are receiving a new object.  Now we can call the factory to create
-      // the object.
+      // This was a normal type that we should have known how to create.
+      // Report the error.
+      bam_cat.warning()
+        << "Attempted to create a " << type.get_name()      \
+        << " but a " << object->get_type()                  \
+        << " was created instead." << std::endl;
+    }
 
-      // Define the parameters for passing to the object factory.
-      FactoryParams fparams;
-      fparams.add_param(new BamReaderParam(scan, this));
+  } else {
+    if (bam_cat.is_spam()) {
+      bam_cat.spam()
+        << "Read a " << object->get_type() << ": " << (void *)object
+        << " (id=" << object_id << ")\n";
+    }
+  }
+}
 
-      // As above, we update and preserve _now_creating during this call.
-      CreatedObjs::iterator was_creating = _now_creating;
-      _now_creating = oi;
-      TypedWritable *object =
-        _factory->make_instance_more_general(type, fparams);
-      _now_creating = was_creating;
+/**
+ * Reads the BOC_index record that follows each top-level object in bam
+ * versions 6.47 and later.  If flags is not NULL, it is filled with the
+ * BamObjectIndexFlags of each object definition within the preceding object.
+ * Returns true on success, false if the record is missing or invalid.
+ */
+bool BamReader::
+read_object_index(vector_uchar *flags) {
+  Datagram dg;
+  if (!get_datagram(dg)) {
+    bam_cat.error()
+      << "Bam stream ends without an object index.\n";
+    return false;
+  }
+
+  DatagramIterator scan(dg);
+  BamObjectCode boc = (BamObjectCode)scan.get_uint8();
+  if (boc != BOC_index) {
+    bam_cat.error()
+      << "Expected an object index in bam stream, found " << boc << ".\n";
+    return false;
+  }
+
+  size_t num_objects = scan.get_uint32();
+  if (scan.get_remaining_size() != num_objects) {
+    bam_cat.error()
+      << "Found truncated object index in bam stream\n";
+    return false;
+  }
+
+  if (flags != nullptr) {
+    const unsigned char *data = (const unsigned char *)dg.get_data();
+    size_t start = scan.get_current_index();
+    flags->assign(data + start, data + start + num_objects);
+  }
+  return true;
+}
+
+/**
+ * An alternative to p_read_object() for bam versions 6.47 and later.  Reads
+ * all of the object definitions that make up the next top-level object, along
+ * with the index that follows them, and then creates the objects on the
+ * threads of the global JobPool.
+ *
+ * Each thread records the pointers, tags and so on that its objects ask for
+ * in a BamReader of its own, which are then merged into this one in the order
+ * the objects appear in the stream.  The definitions that the index marks as
+ * dependent on the ones before them are read afterwards, in this thread.
+ *
+ * Returns the object ID of the top-level object, or 0 on end of file or
+ * error.
+ */
+int BamReader::
+p_read_parallel() {
+  int start_level = _nesting_level;
+  pvector<ParallelObject> objects;
 
-      // And now we can store the new object pointer in the map.
-      nassertr(created_obj._ptr == object || created_obj._ptr == nullptr, object_id);
-      if (object == nullptr) {
-        created_obj.set_ptr(nullptr, nullptr);
+  // First, collect the datagrams, handling the special records as
+  // p_read_object() would.
+  do {
+    ParallelObject obj;
+    if (!get_datagram(obj._datagram)) {
+      if (objects.empty()) {
+        if (bam_cat.is_debug()) {
+          bam_cat.debug()
+            << "Reached end of bam source.\n";
+        }
       } else {
-        created_obj.set_ptr(object, object->as_reference_count());
+        bam_cat.error()
+          << "Bam stream ends in the middle of an object.\n";
       }
-      created_obj._created = true;
-
-      if (created_obj._change_this_ref != nullptr) {
-        // If the pointer is scheduled to change after complete_pointers(),
-        // but we have no entry in _object_pointers for this object (and hence
-        // no plan to call complete_pointers()), then just change the pointer
-        // immediately.
-        ObjectPointers::const_iterator ri = _object_pointers.find(object_id);
-        if (ri == _object_pointers.end()) {
-          PT(TypedWritableReferenceCount) object_ref = (*created_obj._change_this_ref)((TypedWritableReferenceCount *)object, this);
-          TypedWritable *new_ptr = object_ref;
-          created_obj.set_ptr(object_ref, object_ref);
-          created_obj._change_this = nullptr;
-          created_obj._change_this_ref = nullptr;
+      return 0;
+    }
+    obj._mapped_data = _source->get_mapped_datagram();
+
+    DatagramIterator scan(obj._datagram);
+    BamObjectCode boc = (BamObjectCode)scan.get_uint8();
+    switch (boc) {
+    case BOC_push:
+      ++_nesting_level;
+      objects.push_back(std::move(obj));
+      break;
 
-          // Remove the pointer from the finalize list (the new pointer
-          // presumably doesn't require finalizing).
-          if (new_ptr != object) {
-            _finalize_list.erase(object);
-          }
-          object = new_ptr;
+    case BOC_pop:
+      --_nesting_level;
+      break;
+
+    case BOC_adjunct:
+      objects.push_back(std::move(obj));
+      break;
+
+    case BOC_remove:
+      free_object_ids(scan);
+      break;
+
+    case BOC_file_data:
+      {
+        SubfileInfo info;
+        if (!_source->save_datagram(info)) {
+          bam_cat.error()
+            << "Failed to read file data.\n";
+          return 0;
         }
+        _file_data_records.push_back(info);
+      }
+      break;
 
-      } else if (created_obj._change_this != nullptr) {
-        // Non-reference-counting variant.
-        ObjectPointers::const_iterator ri = _object_pointers.find(object_id);
-        if (ri == _object_pointers.end()) {
-          TypedWritable *new_ptr = (*created_obj._change_this)(object, this);
-          created_obj.set_ptr(new_ptr, new_ptr->as_reference_count());
-          created_obj._change_this = nullptr;
-          created_obj._change_this_ref = nullptr;
+    default:
+      bam_cat.error()
+        << "Encountered invalid BamObjectCode 0x" << std::hex << (int)boc << std::dec << ".\n";
+      return 0;
+    }
+  } while (objects.empty() || _nesting_level > start_level);
 
-          if (new_ptr != object) {
-            _finalize_list.erase(object);
+  vector_uchar flags;
+  if (!read_object_index(&flags)) {
+    return 0;
+  }
+  if (flags.size() != objects.size()) {
+    bam_cat.error()
+      << "Bam object index lists " << flags.size() << " objects, expected "
+      << objects.size() << ".\n";
+    return 0;
+  }
+
+  // Now read the header of each definition.  The types they use are defined
+  // the first time they appear, so this part has to be done in order, but the
+  // index tells us how wide the ID's are at the start of each one.
+  size_t num_parallel = 0;
+  for (size_t i = 0; i < objects.size(); ++i) {
+    ParallelObject &obj = objects[i];
+    _long_object_id = (flags[i] & BOIF_long_object_id) != 0;
+    _long_pta_id = (flags[i] & BOIF_long_pta_id) != 0;
+
+    DatagramIterator scan(obj._datagram, 1);
+    obj._type = read_handle(scan);
+    obj._object_id = read_object_id(scan);
+
+    if (scan.get_current_index() > obj._datagram.get_length()) {
+      bam_cat.error()
+        << "Found truncated datagram in bam stream\n";
+      return 0;
+    }
+    obj._header_size = scan.get_current_index();
+    obj._long_object_id = _long_object_id;
+    obj._long_pta_id = _long_pta_id;
+
+    // Updates to objects we have already read are also left to this thread.
+    obj._parallel = false;
+    if (obj._type != TypeHandle::none() && (flags[i] & BOIF_dependent) == 0) {
+      CreatedObjs::const_iterator ci = _created_objs.find(obj._object_id);
+      if (ci == _created_objs.end() || (*ci).second._ptr == nullptr) {
+        obj._parallel = true;
+        ++num_parallel;
+      }
+    }
+  }
+
+  // Make a few jobs for each thread, including this one, so that the load is
+  // still balanced if some of the objects take much longer than others.
+  JobPool *pool = JobPool::get_global_ptr();
+  size_t num_jobs = std::min((size_t)(pool->get_num_threads() + 1) * 4,
+                             num_parallel / parallel_min_job_objects);
+
+  bool long_object_id = _long_object_id;
+  bool long_pta_id = _long_pta_id;
+
+  if (num_jobs > 1) {
+    pvector<ParallelReadJob> jobs(num_jobs);
+    {
+      JobPool::Batch batch(pool);
+      size_t begin = 0;
+      size_t num_assigned = 0;
+      for (size_t j = 0; j < num_jobs; ++j) {
+        ParallelReadJob &job = jobs[j];
+        BamReader &reader = job._reader;
+        reader._parent = this;
+        reader._source = _source;
+        reader._needs_init = false;
+        reader._loader_options = _loader_options;
+        reader._file_major = _file_major;
+        reader._file_minor = _file_minor;
+        reader._file_endian = _file_endian;
+        reader._file_stdfloat_double = _file_stdfloat_double;
+
+        // Give each job a contiguous range with its share of the objects that
+        // may be read in parallel.
+        size_t end = begin;
+        size_t target = num_parallel * (j + 1) / num_jobs;
+        while (end < objects.size() && num_assigned < target) {
+          if (objects[end]._parallel) {
+            ++num_assigned;
           }
-          object = new_ptr;
+          ++end;
+        }
+        if (j + 1 == num_jobs) {
+          end = objects.size();
         }
+        job._begin = objects.data() + begin;
+        job._end = objects.data() + end;
+        begin = end;
+
+        batch.add_job(&job);
       }
+      batch.wait();
+    }
 
-      _created_objs_by_pointer[created_obj._ptr].push_back(object_id);
+    // Now merge what the jobs recorded, in order.
+    for (ParallelReadJob &job : jobs) {
+      BamReader &reader = job._reader;
 
-      // Just some sanity checks
-      if (object == nullptr) {
-        if (bam_cat.is_debug()) {
-          bam_cat.debug()
-            << "Unable to create an object of type " << type << std::endl;
-        }
+      for (auto &item : reader._object_pointers) {
+        _object_pointers[item.first] = std::move(item.second);
+      }
+      reader._object_pointers.clear();
 
-      } else if (object->get_type() != type) {
-        if (_new_types.find(type) != _new_types.end()) {
-          // This was a type we hadn't heard of before, so it's not really
-          // surprising we didn't know how to create it.  Suppress the warning
-          // (make it a debug statement instead).
-          if (bam_cat.is_debug()) {
-            bam_cat.warning()
-              << "Attempted to create a " << type.get_name()    \
-              << " but a " << object->get_type()                \
-              << " was created instead." << std::endl;
-          }
+      _finalize_list.insert(reader._finalize_list.begin(), reader._finalize_list.end());
+      reader._finalize_list.clear();
+
+      _pta_map.insert(reader._pta_map.begin(), reader._pta_map.end());
+      reader._pta_map.clear();
 
-        } else {
-          // This was a normal type that we should have known how to create.
-          // Report the error.
-          bam_cat.warning()
-            << "Attempted to create a " << type.get_name()      \
-            << " but a " << object->get_type()                  \
-            << " was created instead." << std::endl;
+      for (auto &item : reader._aux_data) {
+        AuxDataNames &names = _aux_data[item.first];
+        for (auto &name : item.second) {
+          names[name.first] = std::move(name.second);
         }
+      }
+      reader._aux_data.clear();
 
-      } else {
-        if (bam_cat.is_spam()) {
-          bam_cat.spam()
-            << "Read a " << object->get_type() << ": " << (void *)object
-            << " (id=" << object_id << ")\n";
+      for (ParallelObject *obj = job._begin; obj != job._end; ++obj) {
+        if (!obj->_parallel) {
+          continue;
+        }
+        long_object_id = long_object_id || obj->_long_object_id;
+        long_pta_id = long_pta_id || obj->_long_pta_id;
+
+        CreatedObjs::iterator ri = reader._created_objs.find(obj->_object_id);
+        nassertr(ri != reader._created_objs.end(), 0);
+        CreatedObj &from = (*ri).second;
+
+        CreatedObjs::iterator oi =
+          _created_objs.insert(CreatedObjs::value_type(obj->_object_id, CreatedObj())).first;
+        CreatedObj &created_obj = (*oi).second;
+        created_obj.set_ptr(from._ptr, from._ref_ptr);
+        created_obj._change_this = from._change_this;
+        created_obj._change_this_ref = from._change_this_ref;
+        reader._created_objs.erase(ri);
+
+        p_record_object(obj->_type, oi, obj->_object);
+
+        if (obj->_overrun) {
+          bam_cat.error()
+            << "End of datagram reached while reading bam object "
+            << obj->_type << ": " << (void *)created_obj._ptr << "\n";
         }
       }
     }
 
-    // Sanity check that we read the expected number of bytes.
-    if (scan.get_current_index() > dg.get_length()) {
-      bam_cat.error()
-        << "End of datagram reached while reading bam object "
-        << type << ": " << (void *)created_obj._ptr << "\n";
+  } else {
+    // There aren't enough objects to be worth farming out.
+    for (ParallelObject &obj : objects) {
+      obj._parallel = false;
     }
   }
 
-  return object_id;
+  // Finally, read the remaining definitions in this thread.
+  for (ParallelObject &obj : objects) {
+    if (obj._parallel || obj._type == TypeHandle::none()) {
+      continue;
+    }
+    _long_object_id = obj._long_object_id;
+    _long_pta_id = obj._long_pta_id;
+
+    DatagramIterator scan(obj._datagram, obj._header_size);
+    if (!p_read_definition(obj._type, obj._object_id, obj._datagram, scan,
+                           obj._mapped_data)) {
+      return 0;
+    }
+    long_object_id = long_object_id || _long_object_id;
+    long_pta_id = long_pta_id || _long_pta_id;
+  }
+
+  // Once the ID's grow wide, they stay that way for the rest of the stream.
+  _long_object_id = long_object_id;
+  _long_pta_id = long_pta_id;
+
+  return objects[0]._object_id;
+}
+
+/**
+ * Creates the objects in the job's range that may be read in parallel.
+ */
+void BamReader::ParallelReadJob::
+do_job(Thread *current_thread) {
+  for (ParallelObject *obj = _begin; obj != _end; ++obj) {
+    if (!obj->_parallel) {
+      continue;
+    }
+    _reader._long_object_id = obj->_long_object_id;
+    _reader._long_pta_id = obj->_long_pta_id;
+
+    CreatedObjs::iterator oi =
+      _reader._created_objs.insert(CreatedObjs::value_type(obj->_object_id, CreatedObj())).first;
+
+    DatagramIterator scan(obj->_datagram, obj->_header_size);
+    obj->_object = _reader.p_make_object(obj->_type, oi, obj->_datagram, scan,
+                                         obj->_mapped_data);
+    obj->_overrun = (scan.get_current_index() > obj->_datagram.get_length());
+
+    // Remember whether the ID's grew wide while reading this object.
+    obj->_long_object_id = _reader._long_object_id;
+    obj->_long_pta_id = _reader._long_pta_id;
+  }
 }
 
 /**
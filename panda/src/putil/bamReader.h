@@ -28,12 +28,14 @@
 #include "loaderOptions.h"
 #include "factory.h"
 #include "vector_int.h"
+#include "vector_uchar.h"
 #include "pset.h"
 #include "pmap.h"
 #include "pdeque.h"
 #include "dcast.h"
 #include "pipelineCyclerBase.h"
 #include "referenceCount.h"
+#include "memoryMappedFile.h"
 
 #include <algorithm>
 
@@ -196,6 +198,9 @@ public:
   INLINE VirtualFile *get_vfile();
   INLINE std::streampos get_file_pos();
 
+  const unsigned char *get_mapped_pointer(const DatagramIterator &scan,
+                                          PT(MemoryMappedFile) &mapping) const;
+
 public:
   INLINE static void register_factory(TypeHandle type, WritableFactory::CreateFunc *func,
                                       void *user_data = nullptr);
@@ -209,11 +214,15 @@ private:
 
 private:
   class PointerReference;
+  class ParallelObject;
+  class ParallelReadJob;
 
   void free_object_ids(DatagramIterator &scan);
   int read_object_id(DatagramIterator &scan);
   int read_pta_id(DatagramIterator &scan);
   int p_read_object();
+  bool read_object_index(vector_uchar *flags);
+  int p_read_parallel();
   bool resolve_object_pointers(TypedWritable *object, PointerReference &pref);
   bool resolve_cycler_pointers(PipelineCyclerBase *cycler, const vector_int &pointer_ids,
                                bool require_fully_complete);
@@ -264,6 +273,15 @@ private:
   };
   typedef phash_map<int, CreatedObj, int_hash> CreatedObjs;
   CreatedObjs _created_objs;
+
+  bool p_read_definition(TypeHandle type, int object_id, const Datagram &dg,
+                         DatagramIterator &scan, const unsigned char *mapped_data);
+  TypedWritable *p_make_object(TypeHandle type, CreatedObjs::iterator oi,
+                               const Datagram &dg, DatagramIterator &scan,
+                               const unsigned char *mapped_data);
+  void p_record_object(TypeHandle type, CreatedObjs::iterator oi,
+                       TypedWritable *object);
+
   // This is the iterator into the above map for the object we are currently
   // reading in p_read_object().  It is carefully maintained during recursion.
   // We need this so we can associate read_pointer() calls with the proper
@@ -272,6 +290,12 @@ private:
   // This is the pointer to the current PipelineCycler we are reading, if we
   // are within a read_cdata() call.
   PipelineCyclerBase *_reading_cycler;
+  // This is the datagram whose object is currently being read in
+  // p_read_object(), along with the location of its contents within the
+  // mapped source file, if it was read from one.  It is maintained during
+  // recursion in the same way as _now_creating.
+  const Datagram *_mapped_datagram;
+  const unsigned char *_mapped_datagram_data;
 
   // This is the reverse lookup into the above map.
   typedef phash_map<const TypedWritable *, vector_int, pointer_hash> CreatedObjsByPointer;
@@ -337,6 +361,11 @@ private:
   bool _file_stdfloat_double;
   static const int _cur_major;
   static const int _cur_minor;
+
+  // This is set on the BamReaders that create objects on behalf of another
+  // one in p_read_parallel().  They consult it for the types and PTA's that
+  // it has already read.
+  const BamReader *_parent;
 };
 
 typedef BamReader::WritableFactory WritableFactory;
@@ -60,6 +60,11 @@ BamWriter(DatagramSink *target) :
   _next_pta_id = 1;
   _long_pta_id = false;
 
+  _index_first_pta_id = 1;
+  _object_first_pta_id = 1;
+  _writing_definition = false;
+  _object_dependent = false;
+
   // Check which version .bam files we should write.
   if (bam_version.get_num_words() > 0) {
     if (bam_version.get_num_words() != 2) {
@@ -228,6 +233,8 @@ write_object(const TypedWritable *object) {
 
   nassertr(_object_queue.empty(), false);
   _next_boc = BOC_push;
+  _index_flags.clear();
+  _index_first_pta_id = _next_pta_id;
 
   int object_id = enqueue_object(object);
   nassertr(object_id != 0, false);
@@ -244,6 +251,21 @@ write_object(const TypedWritable *object) {
         << "Unable to write data to output.\n";
       return false;
     }
+
+    // Beginning with 6.47, this is followed by an index of the object
+    // definitions we just wrote, which allows the BamReader to read them in
+    // parallel.
+    if (_file_minor >= 47) {
+      Datagram dg;
+      dg.add_uint8(BOC_index);
+      dg.add_uint32(_index_flags.size());
+      dg.append_data(_index_flags);
+      if (!_target->put_datagram(dg)) {
+        util_cat.error()
+          << "Unable to write data to output.\n";
+        return false;
+      }
+    }
   }
 
   return true;
@@ -361,6 +383,10 @@ write_pointer(Datagram &packet, const TypedWritable *object) {
  */
 void BamWriter::
 write_file_data(SubfileInfo &result, const Filename &filename) {
+  // The reader will hand out file data blocks in the order they appear, so
+  // the definitions that claim them must be read in order.
+  _object_dependent = _object_dependent || _writing_definition;
+
   // We write file data by preceding with a singleton datagram that contains
   // only the BOC_file_data token.
   Datagram dg;
@@ -392,6 +418,8 @@ write_file_data(SubfileInfo &result, const Filename &filename) {
  */
 void BamWriter::
 write_file_data(SubfileInfo &result, const SubfileInfo &source) {
+  _object_dependent = _object_dependent || _writing_definition;
+
   // We write file data by preceding with a singleton datagram that contains
   // only the BOC_file_data token.
   Datagram dg;
@@ -491,6 +519,11 @@ register_pta(Datagram &packet, const void *ptr) {
     int pta_id = (*pi).second;
     write_pta_id(packet, pta_id);
 
+    if (pta_id >= _index_first_pta_id && pta_id < _object_first_pta_id) {
+      // It was written by an earlier object within the same index.
+      _object_dependent = _object_dependent || _writing_definition;
+    }
+
     // Return true to indicate the caller need do nothing further.
     return true;
   }
@@ -522,7 +555,10 @@ write_handle(Datagram &packet, TypeHandle type) {
 
     if (inserted) {
       // This is the first time this TypeHandle has been written, so also
-      // write out its definition.
+      // write out its definition.  If that happens within an object
+      // definition, the reader must see it before any later definition that
+      // uses the same type.
+      _object_dependent = _object_dependent || _writing_definition;
 
       if (_file_major == _bam_major_ver && _file_minor == _bam_minor_ver) {
         packet.add_string(type.get_name());
@@ -544,6 +580,26 @@ write_handle(Datagram &packet, TypeHandle type) {
   }
 }
 
+/**
+ * Returns the number of padding bytes that should be written at the indicated
+ * offset within the datagram currently being prepared, so that the data that
+ * follows them lands on a multiple of the indicated alignment within the
+ * output file.  This allows a reader that maps the file into memory to use the
+ * data in place.  Returns 0 if the file position is not known.
+ */
+size_t BamWriter::
+get_alignment_padding(size_t offset, size_t alignment) {
+  nassertr(_target != nullptr, 0);
+  std::streampos pos = _target->get_file_pos();
+  if (pos <= 0) {
+    return 0;
+  }
+
+  // The datagram will be preceded in the file by its 32-bit length.
+  size_t file_offset = (size_t)pos + sizeof(uint32_t) + offset;
+  return (alignment - file_offset % alignment) % alignment;
+}
+
 /**
  * Returns the name that the given type had in an older .bam version.
  */
@@ -742,6 +798,14 @@ flush_queue() {
     dg.add_uint8(_next_boc);
     _next_boc = BOC_adjunct;
 
+    unsigned char index_flags = 0;
+    if (_long_object_id) {
+      index_flags |= BOIF_long_object_id;
+    }
+    if (_long_pta_id) {
+      index_flags |= BOIF_long_pta_id;
+    }
+
     if (!already_written) {
       // The first time we write a particular object, or when we update the
       // same object later, we do so by writing its TypeHandle (which had
@@ -780,7 +844,14 @@ flush_queue() {
       // update some transparent cache value during writing or something like
       // that, so it's more convenient to cheat and define it as a non-const
       // method.
+      _object_first_pta_id = _next_pta_id;
+      _object_dependent = false;
+      _writing_definition = true;
       ((TypedWritable *)object)->write_datagram(this, dg);
+      _writing_definition = false;
+      if (_object_dependent) {
+        index_flags |= BOIF_dependent;
+      }
 
       (*si).second._written_seq = _writing_seq;
       (*si).second._modified = object->get_bam_modified();
@@ -808,6 +879,8 @@ flush_queue() {
       ((TypedWritable *)object)->update_bam_nested(this);
     }
 
+    _index_flags.push_back(index_flags);
+
     if (!_target->put_datagram(dg)) {
       util_cat.error()
         << "Unable to write data to output.\n";
@@ -18,6 +18,7 @@
 #include "pnotify.h"
 #include "bamEnums.h"
 #include "typedWritable.h"
+#include "vector_uchar.h"
 #include "datagramSink.h"
 #include "pdeque.h"
 #include "pset.h"
@@ -111,6 +112,8 @@ public:
   bool register_pta(Datagram &packet, const void *ptr);
   void write_handle(Datagram &packet, TypeHandle type);
 
+  size_t get_alignment_padding(size_t offset, size_t alignment);
+
   static std::string get_obsolete_type_name(TypeHandle type, int major, int minor);
   static void record_obsolete_type_name(TypeHandle type, std::string name,
                                         int before_major, int before_minor);
@@ -184,6 +187,17 @@ private:
   int _next_pta_id;
   bool _long_pta_id;
 
+  // These are used to build the BOC_index record that follows each top-level
+  // object, for bam versions 6.47 and later.  _index_flags receives the
+  // BamObjectIndexFlags for each object definition as it is written, and
+  // _object_dependent is set while the definition is being written if it
+  // refers to something written by an earlier definition in the same index.
+  vector_uchar _index_flags;
+  int _index_first_pta_id;
+  int _object_first_pta_id;
+  bool _writing_definition;
+  bool _object_dependent;
+
   // The destination to write all the output to.
   DatagramSink *_target;
   bool _needs_init;
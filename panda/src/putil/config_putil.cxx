@@ -89,6 +89,27 @@ ConfigVariableEnum<BamEnums::BamTextureMode> bam_texture_mode
  PRC_DESC("Set this to specify how textures should be written into Bam files."
           "See the panda source or documentation for available options."));
 
+ConfigVariableBool bam_mmap
+("bam-mmap", false,
+ PRC_DESC("Set this true to map uncompressed bam files into memory when they "
+          "are loaded, rather than reading them through a stream.  Vertex "
+          "data that is loaded from a mapped file refers to the file "
+          "directly, instead of occupying memory of its own, until it is "
+          "modified; the operating system pages it in from the file as it "
+          "is used.  This only applies to vertex data that happens to be "
+          "suitably aligned within the file, which bam files written with "
+          "bam-version 6 46 or later arrange for.  Files that are read "
+          "from the model cache are never mapped."));
+
+ConfigVariableBool bam_parallel_read
+("bam-parallel-read", false,
+ PRC_DESC("Set this true to create the objects read from a bam file on the "
+          "threads of the global job pool, rather than one at a time.  The "
+          "pointers between the objects are still resolved in the calling "
+          "thread afterwards, so the result is the same either way.  This "
+          "only applies to bam files written with bam-version 6 47 or "
+          "later, which record the information needed to do this."));
+
 ConfigureFn(config_putil) {
   init_libputil();
 }
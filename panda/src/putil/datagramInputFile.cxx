@@ -18,6 +18,8 @@
 #include "config_putil.h"
 #include "config_express.h"
 #include "virtualFileSystem.h"
+#include "virtualFileSimple.h"
+#include "dcast.h"
 #include "streamReader.h"
 #include "thread.h"
 
@@ -85,6 +87,9 @@ close() {
   _in = nullptr;
   _owns_in = false;
 
+  _mapping.clear();
+  _mapped_datagram = nullptr;
+
   _file.clear();
   _filename = Filename();
   _timestamp = 0;
@@ -93,6 +98,58 @@ close() {
   _error = false;
 }
 
+/**
+ * Maps the opened file into memory, so that the datagrams subsequently read
+ * from it refer to their contents in place within the mapping, rather than
+ * being read from the stream; see get_mapped_datagram().  This
+ * is only possible if the file resides uncompressed on disk, either by itself
+ * or within an uncompressed, unencrypted Multifile subfile.
+ *
+ * Returns true if the file is now mapped, or false if it cannot be, in which
+ * case it will continue to be read normally.  The file should not be modified
+ * on disk while it remains mapped.
+ */
+bool DatagramInputFile::
+map_file() {
+  nassertr(_in != nullptr, false);
+  _mapping.clear();
+  _mapped_datagram = nullptr;
+
+  if (_vfile == nullptr) {
+    return false;
+  }
+
+  // If the stream is being decompressed on the fly, the file on disk doesn't
+  // contain the bytes we are reading.
+  std::string extension = _vfile->get_filename().get_extension();
+  if (extension == "pz" || extension == "gz") {
+    return false;
+  }
+  if (_vfile->is_of_type(VirtualFileSimple::get_class_type()) &&
+      DCAST(VirtualFileSimple, _vfile)->is_implicit_pz_file()) {
+    return false;
+  }
+
+  SubfileInfo info;
+  if (!_vfile->get_system_info(info) || info.is_empty()) {
+    return false;
+  }
+
+  PT(MemoryMappedFile) mapping = new MemoryMappedFile;
+  if (!mapping->map_file(info.get_filename(), (size_t)info.get_start(),
+                         (size_t)info.get_size())) {
+    return false;
+  }
+
+  if (util_cat.is_debug()) {
+    util_cat.debug()
+      << "Mapped " << mapping->get_size() << " bytes of " << _filename
+      << " into memory.\n";
+  }
+  _mapping = mapping;
+  return true;
+}
+
 /**
  * Reads a sequence of bytes from the beginning of the datagram file.  This
  * may be called any number of times after the file has been opened and before
@@ -125,6 +182,7 @@ bool DatagramInputFile::
 get_datagram(Datagram &data) {
   nassertr(_in != nullptr, false);
   _read_first_datagram = true;
+  _mapped_datagram = nullptr;
 
   // First, get the size of the upcoming datagram.
   StreamReader reader(_in, false);
@@ -172,6 +230,30 @@ get_datagram(Datagram &data) {
     }
   }
 
+  if (_mapping != nullptr) {
+    // The file is mapped, so the datagram is already in memory.  We let the
+    // datagram refer to it in place, and skip the stream past it.
+    std::streampos pos = _in->tellg();
+    size_t offset = (size_t)pos;
+    if (pos < 0 || offset > _mapping->get_size() ||
+        num_bytes > _mapping->get_size() - offset) {
+      _error = true;
+      return false;
+    }
+
+    const unsigned char *ptr = _mapping->get_data() + offset;
+    data.assign_external(ptr, num_bytes, _mapping);
+    _in->seekg((std::streamoff)num_bytes, std::ios::cur);
+    if (_in->fail()) {
+      _error = true;
+      return false;
+    }
+
+    _mapped_datagram = ptr;
+    Thread::consider_yield();
+    return true;
+  }
+
   // Now, read the datagram itself. We construct an empty datagram, use
   // pad_bytes to make it big enough, and read *directly* into the datagram's
   // internal buffer. Doing this saves us a copy operation.
@@ -223,6 +305,7 @@ bool DatagramInputFile::
 save_datagram(SubfileInfo &info) {
   nassertr(_in != nullptr, false);
   _read_first_datagram = true;
+  _mapped_datagram = nullptr;
 
   // First, get the size of the upcoming datagram.
   StreamReader reader(_in, false);
@@ -368,3 +451,22 @@ get_file_pos() {
   }
   return _in->tellg();
 }
+
+/**
+ * Returns the memory-mapped file that the datagrams are being read from, if
+ * map_file() has been called successfully, or NULL otherwise.
+ */
+MemoryMappedFile *DatagramInputFile::
+get_mapped_file() {
+  return _mapping;
+}
+
+/**
+ * If the file is mapped, returns a pointer to the contents of the datagram
+ * most recently returned by get_datagram() within the mapping.  Returns NULL
+ * if the file is not mapped.
+ */
+const unsigned char *DatagramInputFile::
+get_mapped_datagram() {
+  return _mapped_datagram;
+}
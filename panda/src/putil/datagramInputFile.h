@@ -20,6 +20,7 @@
 #include "filename.h"
 #include "fileReference.h"
 #include "virtualFile.h"
+#include "memoryMappedFile.h"
 
 /**
  * This class can be used to read a binary file that consists of an arbitrary
@@ -35,6 +36,9 @@ PUBLISHED:
   bool open(std::istream &in, const Filename &filename = Filename());
   INLINE std::istream &get_stream();
 
+  bool map_file();
+  INLINE bool is_mapped() const;
+
   void close();
 
   bool read_header(std::string &header, size_t num_bytes);
@@ -49,6 +53,10 @@ PUBLISHED:
   virtual VirtualFile *get_vfile();
   virtual std::streampos get_file_pos();
 
+public:
+  virtual MemoryMappedFile *get_mapped_file();
+  virtual const unsigned char *get_mapped_datagram();
+
 private:
   bool _read_first_datagram;
   bool _error;
@@ -58,6 +66,8 @@ private:
   bool _owns_in;
   Filename _filename;
   time_t _timestamp;
+  PT(MemoryMappedFile) _mapping;
+  const unsigned char *_mapped_datagram;
 };
 
 #include "datagramInputFile.I"
@@ -55,6 +55,61 @@ ConfigVariableBool td_perspective_textures
             "textures on the tinydisplay software renderer, for a small "
             "performance gain."));
 
+ConfigVariableBool td_tile_rendering
+  ("td-tile-rendering", true,
+   PRC_DESC("Configure this true to let the tinydisplay software renderer "
+            "draw triangles on the threads of the global JobPool (see "
+            "job-pool-num-threads).  The triangles are sorted into tiles of "
+            "td-tile-height rows each, and the tiles are drawn in parallel "
+            "whenever the frame buffer is needed.  The image is exactly the "
+            "same as when drawing each triangle immediately.  This has no "
+            "effect if the JobPool has no threads."));
+
+ConfigVariableInt td_tile_height
+  ("td-tile-height", 16,
+   PRC_DESC("The number of rows of the frame buffer in each tile, when "
+            "td-tile-rendering is enabled.  Smaller tiles spread the work "
+            "more evenly across the threads, but triangles that span "
+            "several tiles have to be set up once in each of them.  This is "
+            "rounded up to a multiple of 8, the height of the blocks used by "
+            "td-hierarchical-z."));
+
+ConfigVariableInt td_tile_max_triangles
+  ("td-tile-max-triangles", 65536,
+   PRC_DESC("The maximum number of triangles that are held back to be drawn "
+            "in parallel, when td-tile-rendering is enabled.  When this many "
+            "have accumulated, they are drawn right away, which limits the "
+            "memory needed to hold them."));
+
+ConfigVariableBool td_tiled_textures
+  ("td-tiled-textures", true,
+   PRC_DESC("Configure this true to let the tinydisplay software renderer "
+            "store each texture that is sampled with a bilinear filter in "
+            "4x4 tiles of texels, rather than row by row, so that the "
+            "texels that are filtered together are usually in the same "
+            "cache line.  A tiled texture is always sampled through the "
+            "general texture filter functions, even when it is later used "
+            "with nearest filtering.  Use Texture::set_minfilter() and "
+            "set_magfilter() or the texture quality level to choose which "
+            "textures are filtered."));
+
+ConfigVariableBool td_simd_vertices
+  ("td-simd-vertices", true,
+   PRC_DESC("Configure this true to let the tinydisplay software renderer "
+            "transform and light four vertices at a time with SSE2 "
+            "instructions, when it was compiled with them.  The image is "
+            "exactly the same either way.  This takes effect for GSGs "
+            "created after it is changed."));
+
+ConfigVariableBool td_hierarchical_z
+  ("td-hierarchical-z", true,
+   PRC_DESC("Configure this true to let the tinydisplay software renderer "
+            "keep the smallest depth value of each 8x8 block of the depth "
+            "buffer, so that it can skip the parts of depth-tested triangles "
+            "that are entirely hidden behind what has already been drawn.  "
+            "The image is exactly the same either way.  This takes effect "
+            "for frame buffers created after it is changed."));
+
 /**
  * Initializes the library.  This must be called at least once before any of
  * the functions or classes in this library can be used.  Normally it will be
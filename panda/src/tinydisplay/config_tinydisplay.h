@@ -29,5 +29,11 @@ extern ConfigVariableInt td_texture_ram;
 extern ConfigVariableBool td_ignore_mipmaps;
 extern ConfigVariableBool td_ignore_clamp;
 extern ConfigVariableBool td_perspective_textures;
+extern ConfigVariableBool td_tile_rendering;
+extern ConfigVariableInt td_tile_height;
+extern ConfigVariableInt td_tile_max_triangles;
+extern ConfigVariableBool td_tiled_textures;
+extern ConfigVariableBool td_simd_vertices;
+extern ConfigVariableBool td_hierarchical_z;
 
 #endif
@@ -8,6 +8,7 @@ void glInit(GLContext *c, ZBuffer *zbuffer)
   int i;
 
   c->zb=zbuffer;
+  c->tile_binner=nullptr;
   
   /* viewport */
   v=&c->viewport;
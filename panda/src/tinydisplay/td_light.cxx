@@ -1,6 +1,10 @@
 #include "zgl.h"
 #include <math.h>
 
+#ifdef HAVE_TINYDISPLAY_SSE2
+#include <emmintrin.h>
+#endif
+
 static inline PN_stdfloat clampf(PN_stdfloat a,PN_stdfloat min,PN_stdfloat max)
 {
   if (a<min) return min;
@@ -133,3 +137,184 @@ void gl_shade_vertex(GLContext *c,GLVertex *v)
   v->color.v[3]=clampf(A*v->color.v[3],0,1);
 }
 
+
+#ifdef HAVE_TINYDISPLAY_SSE2
+
+static inline __m128 select4(__m128 mask, __m128 a, __m128 b)
+{
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static inline __m128 abs4(__m128 a)
+{
+  return _mm_andnot_ps(_mm_set1_ps(-0.0f), a);
+}
+
+static inline __m128 clamp4(__m128 a)
+{
+  return _mm_min_ps(_mm_max_ps(a, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+}
+
+/* same as gl_shade_vertex(), for four vertices at once; spot lights are not
+   handled.  Each step is computed in the same order as in gl_shade_vertex(),
+   so the results are exactly the same. */
+static void gl_shade_vertex4(GLContext *c,GLVertex *v)
+{
+  GLMaterial *m;
+  GLLight *l;
+  GLSpecBuf *specbuf = nullptr;
+  int twoside = c->light_model_two_side;
+  int i;
+
+  /* the comparisons with 1E-3 are made in double precision, which is the
+     same as comparing with >= 1E-3f */
+  const __m128 min_dist = _mm_set1_ps(1E-3f);
+  const __m128 zero = _mm_setzero_ps();
+
+  m=&c->materials[0];
+
+  __m128 nx=_mm_set_ps(v[3].normal.v[0], v[2].normal.v[0], v[1].normal.v[0], v[0].normal.v[0]);
+  __m128 ny=_mm_set_ps(v[3].normal.v[1], v[2].normal.v[1], v[1].normal.v[1], v[0].normal.v[1]);
+  __m128 nz=_mm_set_ps(v[3].normal.v[2], v[2].normal.v[2], v[1].normal.v[2], v[0].normal.v[2]);
+  __m128 ex=_mm_set_ps(v[3].ec.v[0], v[2].ec.v[0], v[1].ec.v[0], v[0].ec.v[0]);
+  __m128 ey=_mm_set_ps(v[3].ec.v[1], v[2].ec.v[1], v[1].ec.v[1], v[0].ec.v[1]);
+  __m128 ez=_mm_set_ps(v[3].ec.v[2], v[2].ec.v[2], v[1].ec.v[2], v[0].ec.v[2]);
+
+  __m128 R=_mm_set1_ps(m->emission.v[0]+m->ambient.v[0]*c->ambient_light_model.v[0]);
+  __m128 G=_mm_set1_ps(m->emission.v[1]+m->ambient.v[1]*c->ambient_light_model.v[1]);
+  __m128 B=_mm_set1_ps(m->emission.v[2]+m->ambient.v[2]*c->ambient_light_model.v[2]);
+  PN_stdfloat A=clampf(m->diffuse.v[3],0,1);
+
+  /* normalized eye coordinates, for the local viewer model */
+  __m128 vx = zero;
+  if (c->local_light_model) {
+    __m128 n = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey)),
+                                      _mm_mul_ps(ez, ez)));
+    vx = select4(_mm_cmpneq_ps(n, zero), _mm_div_ps(ex, n), ex);
+  }
+
+  for(l=c->first_light;l!=nullptr;l=l->next) {
+    __m128 dx, dy, dz, att;
+
+    /* ambient */
+    __m128 lR=_mm_set1_ps(l->ambient.v[0] * m->ambient.v[0]);
+    __m128 lG=_mm_set1_ps(l->ambient.v[1] * m->ambient.v[1]);
+    __m128 lB=_mm_set1_ps(l->ambient.v[2] * m->ambient.v[2]);
+
+    if (l->position.v[3] == 0) {
+      /* light at infinity */
+      dx=_mm_set1_ps(l->position.v[0]);
+      dy=_mm_set1_ps(l->position.v[1]);
+      dz=_mm_set1_ps(l->position.v[2]);
+      att=_mm_set1_ps(1.0f);
+    } else {
+      /* distance attenuation */
+      dx=_mm_sub_ps(_mm_set1_ps(l->position.v[0]), ex);
+      dy=_mm_sub_ps(_mm_set1_ps(l->position.v[1]), ey);
+      dz=_mm_sub_ps(_mm_set1_ps(l->position.v[2]), ez);
+      __m128 dist=_mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)),
+                                         _mm_mul_ps(dz, dz)));
+      __m128 far_mask=_mm_cmpge_ps(dist, min_dist);
+      __m128 tmp=_mm_div_ps(_mm_set1_ps(1.0f), dist);
+      dx=select4(far_mask, _mm_mul_ps(dx, tmp), dx);
+      dy=select4(far_mask, _mm_mul_ps(dy, tmp), dy);
+      dz=select4(far_mask, _mm_mul_ps(dz, tmp), dz);
+      att=_mm_div_ps(_mm_set1_ps(1.0f),
+                     _mm_add_ps(_mm_set1_ps(l->attenuation[0]),
+                                _mm_mul_ps(dist, _mm_add_ps(_mm_set1_ps(l->attenuation[1]),
+                                                            _mm_mul_ps(dist, _mm_set1_ps(l->attenuation[2]))))));
+    }
+
+    __m128 dot=_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, nx), _mm_mul_ps(dy, ny)), _mm_mul_ps(dz, nz));
+    if (twoside) dot = abs4(dot);
+    __m128 lit=_mm_cmpgt_ps(dot, zero);
+
+    if (_mm_movemask_ps(lit) != 0) {
+      /* diffuse light */
+      lR=select4(lit, _mm_add_ps(lR, _mm_mul_ps(_mm_mul_ps(dot, _mm_set1_ps(l->diffuse.v[0])), _mm_set1_ps(m->diffuse.v[0]))), lR);
+      lG=select4(lit, _mm_add_ps(lG, _mm_mul_ps(_mm_mul_ps(dot, _mm_set1_ps(l->diffuse.v[1])), _mm_set1_ps(m->diffuse.v[1]))), lG);
+      lB=select4(lit, _mm_add_ps(lB, _mm_mul_ps(_mm_mul_ps(dot, _mm_set1_ps(l->diffuse.v[2])), _mm_set1_ps(m->diffuse.v[2]))), lB);
+
+      /* specular light */
+      __m128 sx, sy, sz;
+      if (c->local_light_model) {
+        /* (sic) as in gl_shade_vertex() */
+        sx=_mm_sub_ps(dx, vx);
+        sy=_mm_sub_ps(dy, vx);
+        sz=_mm_sub_ps(dz, vx);
+      } else {
+        sx=dx;
+        sy=dy;
+        sz=_mm_add_ps(dz, _mm_set1_ps(1.0f));
+      }
+      __m128 dot_spec=_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, sx), _mm_mul_ps(ny, sy)), _mm_mul_ps(nz, sz));
+      if (twoside) dot_spec = abs4(dot_spec);
+      int spec_mask=_mm_movemask_ps(_mm_and_ps(lit, _mm_cmpgt_ps(dot_spec, zero)));
+      if (spec_mask != 0) {
+        __m128 tmp=_mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, sx), _mm_mul_ps(sy, sy)),
+                                          _mm_mul_ps(sz, sz)));
+        dot_spec=select4(_mm_cmpge_ps(tmp, min_dist), _mm_div_ps(dot_spec, tmp), dot_spec);
+
+        if (specbuf == nullptr) {
+          specbuf = specbuf_get_buffer(c, m->shininess_i, m->shininess);
+        }
+        float ds[4], spec[4];
+        _mm_storeu_ps(ds, dot_spec);
+        for (i = 0; i < 4; ++i) {
+          spec[i] = 0.0f;
+          if (spec_mask & (1 << i)) {
+            int idx = (int)(ds[i]*SPECULAR_BUFFER_SIZE);
+            if (idx > SPECULAR_BUFFER_SIZE) idx = SPECULAR_BUFFER_SIZE;
+            spec[i] = specbuf->buf[idx];
+          }
+        }
+        __m128 specv=_mm_loadu_ps(spec);
+        __m128 has_spec=_mm_castsi128_ps(_mm_cmpgt_epi32(_mm_and_si128(_mm_set1_epi32(spec_mask), _mm_set_epi32(8, 4, 2, 1)), _mm_setzero_si128()));
+        lR=select4(has_spec, _mm_add_ps(lR, _mm_mul_ps(_mm_mul_ps(specv, _mm_set1_ps(l->specular.v[0])), _mm_set1_ps(m->specular.v[0]))), lR);
+        lG=select4(has_spec, _mm_add_ps(lG, _mm_mul_ps(_mm_mul_ps(specv, _mm_set1_ps(l->specular.v[1])), _mm_set1_ps(m->specular.v[1]))), lG);
+        lB=select4(has_spec, _mm_add_ps(lB, _mm_mul_ps(_mm_mul_ps(specv, _mm_set1_ps(l->specular.v[2])), _mm_set1_ps(m->specular.v[2]))), lB);
+      }
+    }
+
+    R=_mm_add_ps(R, _mm_mul_ps(att, lR));
+    G=_mm_add_ps(G, _mm_mul_ps(att, lG));
+    B=_mm_add_ps(B, _mm_mul_ps(att, lB));
+  }
+
+  float r[4], g[4], b[4];
+  _mm_storeu_ps(r, R);
+  _mm_storeu_ps(g, G);
+  _mm_storeu_ps(b, B);
+  for (i = 0; i < 4; ++i) {
+    v[i].color.v[0]=clampf(r[i]*v[i].color.v[0],0,1);
+    v[i].color.v[1]=clampf(g[i]*v[i].color.v[1],0,1);
+    v[i].color.v[2]=clampf(b[i]*v[i].color.v[2],0,1);
+    v[i].color.v[3]=clampf(A*v[i].color.v[3],0,1);
+  }
+}
+
+#endif  /* HAVE_TINYDISPLAY_SSE2 */
+
+/* gl_shade_vertex() for an array of vertices, which must all use the same
+   material */
+void gl_shade_vertex_batch(GLContext *c,GLVertex *v,int count)
+{
+  int i = 0;
+#ifdef HAVE_TINYDISPLAY_SSE2
+  GLLight *l;
+  bool has_spot = false;
+  for(l=c->first_light;l!=nullptr;l=l->next) {
+    if (l->spot_cutoff != 180) {
+      has_spot = true;
+    }
+  }
+  if (c->simd_vertices && !has_spot) {
+    for (; i + 4 <= count; i += 4) {
+      gl_shade_vertex4(c, v + i);
+    }
+  }
+#endif
+  for (; i < count; ++i) {
+    gl_shade_vertex(c, v + i);
+  }
+}
@@ -14,6 +14,7 @@
 #include "tinyGraphicsStateGuardian.h"
 #include "tinyGeomMunger.h"
 #include "tinyTextureContext.h"
+#include "tinyTileBinner.h"
 #include "config_tinydisplay.h"
 #include "pStatTimer.h"
 #include "geomVertexReader.h"
@@ -58,6 +59,7 @@ PStatCollector TinyGraphicsStateGuardian::_pixel_count_flat_perspective_pcollect
 PStatCollector TinyGraphicsStateGuardian::_pixel_count_smooth_perspective_pcollector("Pixels:Smooth perspective");
 PStatCollector TinyGraphicsStateGuardian::_pixel_count_smooth_multitex2_pcollector("Pixels:Smooth multitex 2");
 PStatCollector TinyGraphicsStateGuardian::_pixel_count_smooth_multitex3_pcollector("Pixels:Smooth multitex 3");
+PStatCollector TinyGraphicsStateGuardian::_pixel_count_occluded_pcollector("Pixels:Occluded");
 
 /**
  *
@@ -70,6 +72,7 @@ TinyGraphicsStateGuardian(GraphicsEngine *engine, GraphicsPipe *pipe,
   _current_frame_buffer = nullptr;
   _aux_frame_buffer = nullptr;
   _c = nullptr;
+  _tile_binner = nullptr;
   _vertices = nullptr;
   _vertices_size = 0;
 }
@@ -112,6 +115,15 @@ reset() {
 
   _c->draw_triangle_front = gl_draw_triangle_fill;
   _c->draw_triangle_back = gl_draw_triangle_fill;
+  _c->simd_vertices = td_simd_vertices;
+
+  if (td_tile_rendering) {
+    JobPool *pool = JobPool::get_global_ptr();
+    if (pool->get_num_threads() > 0) {
+      _tile_binner = new TinyTileBinner(pool, td_tile_height, td_tile_max_triangles);
+      _c->tile_binner = _tile_binner;
+    }
+  }
 
   _supported_geom_rendering =
     Geom::GR_point |
@@ -145,6 +157,14 @@ reset() {
  */
 void TinyGraphicsStateGuardian::
 free_pointers() {
+  if (_tile_binner != nullptr) {
+    delete _tile_binner;
+    _tile_binner = nullptr;
+    if (_c != nullptr) {
+      _c->tile_binner = nullptr;
+    }
+  }
+
   if (_aux_frame_buffer != nullptr) {
     ZB_close(_aux_frame_buffer);
     _aux_frame_buffer = nullptr;
@@ -166,6 +186,10 @@ void TinyGraphicsStateGuardian::
 close_gsg() {
   GraphicsStateGuardian::close_gsg();
 
+  if (_tile_binner != nullptr) {
+    _tile_binner->clear();
+  }
+
   if (_c != nullptr) {
     glClose(_c);
     _c = nullptr;
@@ -208,6 +232,7 @@ clear(DrawableRegion *clearable) {
     return;
   }
 
+  flush_tiles();
   set_state_and_transform(RenderState::make_empty(), _internal_transform);
 
   bool clear_color = false;
@@ -263,6 +288,7 @@ prepare_display_region(DisplayRegionPipelineReader *dr) {
     if (_aux_frame_buffer == nullptr) {
       _aux_frame_buffer = ZB_open(xsize, ysize, ZB_MODE_RGBA, 0, 0, 0, 0);
     } else if (_aux_frame_buffer->xsize < xsize || _aux_frame_buffer->ysize < ysize) {
+      flush_tiles();
       ZB_resize(_aux_frame_buffer, nullptr,
                 max(_aux_frame_buffer->xsize, xsize),
                 max(_aux_frame_buffer->ysize, ysize));
@@ -368,6 +394,7 @@ begin_frame(Thread *current_thread) {
   _pixel_count_smooth_perspective_pcollector.clear_level();
   _pixel_count_smooth_multitex2_pcollector.clear_level();
   _pixel_count_smooth_multitex3_pcollector.clear_level();
+  _pixel_count_occluded_pcollector.clear_level();
 #endif
 
   return true;
@@ -396,6 +423,8 @@ begin_scene() {
  */
 void TinyGraphicsStateGuardian::
 end_scene() {
+  flush_tiles();
+
   if (_c->zb == _aux_frame_buffer) {
     // Copy the aux frame buffer into the main scene now, zooming it up to the
     // appropriate size.
@@ -426,6 +455,8 @@ end_scene() {
  */
 void TinyGraphicsStateGuardian::
 end_frame(Thread *current_thread) {
+  flush_tiles();
+
   GraphicsStateGuardian::end_frame(current_thread);
 
 #ifndef NDEBUG
@@ -460,6 +491,7 @@ end_frame(Thread *current_thread) {
   _pixel_count_smooth_perspective_pcollector.flush_level();
   _pixel_count_smooth_multitex2_pcollector.flush_level();
   _pixel_count_smooth_multitex3_pcollector.flush_level();
+  _pixel_count_occluded_pcollector.flush_level();
 #endif  // DO_PSTATS
 }
 
@@ -708,40 +740,54 @@ begin_draw_primitives(const GeomPipelineReader *geom_reader,
       _c->current_color.v[1] = max(d[1] * s[1], (PN_stdfloat)0);
       _c->current_color.v[2] = max(d[2] * s[2], (PN_stdfloat)0);
       _c->current_color.v[3] = max(d[3] * s[3], (PN_stdfloat)0);
-
-      if (_color_material_flags) {
-        if (_color_material_flags & CMF_ambient) {
-          _c->materials[0].ambient = _c->current_color;
-          _c->materials[1].ambient = _c->current_color;
-        }
-        if (_color_material_flags & CMF_diffuse) {
-          _c->materials[0].diffuse = _c->current_color;
-          _c->materials[1].diffuse = _c->current_color;
-        }
-      }
     }
 
     v->color = _c->current_color;
 
     if (lighting_enabled) {
       const LVecBase3 &d = rnormal.get_data3();
-      _c->current_normal.v[0] = d[0];
-      _c->current_normal.v[1] = d[1];
-      _c->current_normal.v[2] = d[2];
-      _c->current_normal.v[3] = 0.0f;
+      v->normal.v[0] = d[0];
+      v->normal.v[1] = d[1];
+      v->normal.v[2] = d[2];
+
+    } else if (_c->lighting_enabled) {
+      v->normal.v[0] = _c->current_normal.v[0];
+      v->normal.v[1] = _c->current_normal.v[1];
+      v->normal.v[2] = _c->current_normal.v[2];
+    }
 
-      gl_vertex_transform(_c, v);
-      gl_shade_vertex(_c, v);
+    v->edge_flag = 1;
+  }
+
+  // The vertices are transformed and lit in batches, which lets these use
+  // SIMD instructions to process several vertices at once.
+  gl_vertex_transform_batch(_c, _vertices, num_used_vertices);
 
+  if (lighting_enabled) {
+    if (needs_color && _color_material_flags) {
+      // The material changes with each vertex.
+      for (i = 0; i < num_used_vertices; ++i) {
+        GLVertex *v = &_vertices[i];
+        if (_color_material_flags & CMF_ambient) {
+          _c->materials[0].ambient = v->color;
+          _c->materials[1].ambient = v->color;
+        }
+        if (_color_material_flags & CMF_diffuse) {
+          _c->materials[0].diffuse = v->color;
+          _c->materials[1].diffuse = v->color;
+        }
+        gl_shade_vertex(_c, v);
+      }
     } else {
-      gl_vertex_transform(_c, v);
+      gl_shade_vertex_batch(_c, _vertices, num_used_vertices);
     }
+  }
 
+  for (i = 0; i < num_used_vertices; ++i) {
+    GLVertex *v = &_vertices[i];
     if (v->clip_code == 0) {
       gl_transform_to_viewport(_c, v);
     }
-
-    v->edge_flag = 1;
   }
 
   // Set up the appropriate function callback for filling triangles, according
@@ -924,17 +970,7 @@ begin_draw_primitives(const GeomPipelineReader *geom_reader,
   _c->zb_fill_tri = fill_tri_funcs[depth_write_state][color_write_state][alpha_test_state][depth_test_state][texfilter_state][shade_model_state][texturing_state];
 
 #ifdef DO_PSTATS
-  pixel_count_white_untextured = 0;
-  pixel_count_flat_untextured = 0;
-  pixel_count_smooth_untextured = 0;
-  pixel_count_white_textured = 0;
-  pixel_count_flat_textured = 0;
-  pixel_count_smooth_textured = 0;
-  pixel_count_white_perspective = 0;
-  pixel_count_flat_perspective = 0;
-  pixel_count_smooth_perspective = 0;
-  pixel_count_smooth_multitex2 = 0;
-  pixel_count_smooth_multitex3 = 0;
+  memset(&_c->zb->pixel_counts, 0, sizeof(_c->zb->pixel_counts));
 #endif  // DO_PSTATS
 
   return true;
@@ -1169,6 +1205,9 @@ draw_tristrips(const GeomPrimitivePipelineReader *reader, bool force) {
 bool TinyGraphicsStateGuardian::
 draw_lines(const GeomPrimitivePipelineReader *reader, bool force) {
   PStatTimer timer(_draw_primitive_pcollector, reader->get_current_thread());
+  // These are drawn immediately, so any triangles that came before must be
+  // drawn first.
+  flush_tiles();
 #ifndef NDEBUG
   if (tinydisplay_cat.is_spam()) {
     tinydisplay_cat.spam() << "draw_lines: " << *(reader->get_object()) << "\n";
@@ -1246,6 +1285,7 @@ draw_lines(const GeomPrimitivePipelineReader *reader, bool force) {
 bool TinyGraphicsStateGuardian::
 draw_points(const GeomPrimitivePipelineReader *reader, bool force) {
   PStatTimer timer(_draw_primitive_pcollector, reader->get_current_thread());
+  flush_tiles();
 #ifndef NDEBUG
   if (tinydisplay_cat.is_spam()) {
     tinydisplay_cat.spam() << "draw_points: " << *(reader->get_object()) << "\n";
@@ -1320,19 +1360,9 @@ draw_points(const GeomPrimitivePipelineReader *reader, bool force) {
 void TinyGraphicsStateGuardian::
 end_draw_primitives() {
 
-#ifdef DO_PSTATS
-  _pixel_count_white_untextured_pcollector.add_level(pixel_count_white_untextured);
-  _pixel_count_flat_untextured_pcollector.add_level(pixel_count_flat_untextured);
-  _pixel_count_smooth_untextured_pcollector.add_level(pixel_count_smooth_untextured);
-  _pixel_count_white_textured_pcollector.add_level(pixel_count_white_textured);
-  _pixel_count_flat_textured_pcollector.add_level(pixel_count_flat_textured);
-  _pixel_count_smooth_textured_pcollector.add_level(pixel_count_smooth_textured);
-  _pixel_count_white_perspective_pcollector.add_level(pixel_count_white_perspective);
-  _pixel_count_flat_perspective_pcollector.add_level(pixel_count_flat_perspective);
-  _pixel_count_smooth_perspective_pcollector.add_level(pixel_count_smooth_perspective);
-  _pixel_count_smooth_multitex2_pcollector.add_level(pixel_count_smooth_multitex2);
-  _pixel_count_smooth_multitex3_pcollector.add_level(pixel_count_smooth_multitex3);
-#endif  // DO_PSTATS
+  // If the triangles were binned, these are all zero; their pixels are
+  // counted when the tiles are drawn.
+  add_pixel_counts(_c->zb->pixel_counts);
 
   GraphicsStateGuardian::end_draw_primitives();
 }
@@ -1348,6 +1378,7 @@ framebuffer_copy_to_texture(Texture *tex, int view, int z,
                             const DisplayRegion *dr,
                             const RenderBuffer &rb) {
   nassertr(tex != nullptr && dr != nullptr, false);
+  flush_tiles();
 
   int xo, yo, w, h;
   dr->get_region_pixels_i(xo, yo, w, h);
@@ -1376,6 +1407,7 @@ framebuffer_copy_to_texture(Texture *tex, int view, int z,
     memcpy(ip, fo, gltex->xsize * PSZB);
     fo += _c->zb->linesize / PSZB;
   }
+  tile_texture_level(&gltex->levels[0], gltex->xsize, gltex->ysize, 0);
 
   gtc->update_data_size_bytes(gltex->xsize * gltex->ysize * 4);
   gtc->mark_loaded();
@@ -1396,6 +1428,7 @@ framebuffer_copy_to_ram(Texture *tex, int view, int z,
                         const DisplayRegion *dr,
                         const RenderBuffer &rb) {
   nassertr(tex != nullptr && dr != nullptr, false);
+  flush_tiles();
 
   int xo, yo, w, h;
   dr->get_region_pixels_i(xo, yo, w, h);
@@ -1673,16 +1706,27 @@ update_texture(TextureContext *tc, bool force) {
  * fully uploaded.  If force is false, the function may choose to upload a
  * simple version of the texture instead, if the texture is not fully resident
  * (and if get_incomplete_render() is true).
+ *
+ * If tiled is true, the texture is switched over to tiled storage, which
+ * suits filtered sampling better.  A texture is never switched back, so that
+ * it doesn't get reloaded over and over if it is sampled both ways.
  */
 bool TinyGraphicsStateGuardian::
-update_texture(TextureContext *tc, bool force, int stage_index, bool uses_mipmaps) {
+update_texture(TextureContext *tc, bool force, int stage_index, bool uses_mipmaps, bool tiled) {
+  TinyTextureContext *gtc = DCAST(TinyTextureContext, tc);
+  GLTexture *gltex = &gtc->_gltex;
+
+  if (tiled && !gltex->tiled) {
+    // This takes effect the next time the texture is loaded, which had
+    // better be now.
+    gltex->tiled = 1;
+    gtc->mark_needs_reload();
+  }
+
   if (!update_texture(tc, force)) {
     return false;
   }
 
-  TinyTextureContext *gtc = DCAST(TinyTextureContext, tc);
-  GLTexture *gltex = &gtc->_gltex;
-
   if (uses_mipmaps && gltex->num_levels <= 1) {
     // We don't have mipmaps, yet we are sampling with mipmaps.
     Texture *tex = gtc->get_texture();
@@ -1724,6 +1768,9 @@ void TinyGraphicsStateGuardian::
 release_texture(TextureContext *tc) {
   _texturing_state = 0;  // just in case
 
+  // The triangles waiting to be drawn may still refer to the texture memory.
+  flush_tiles();
+
   TinyTextureContext *gtc = DCAST(TinyTextureContext, tc);
   delete gtc;
 }
@@ -2000,11 +2047,14 @@ do_issue_render_mode() {
     break;
 
   case RenderModeAttrib::M_wireframe:
+    // Only filled triangles are binned.
+    flush_tiles();
     _c->draw_triangle_front = gl_draw_triangle_line;
     _c->draw_triangle_back = gl_draw_triangle_line;
     break;
 
   case RenderModeAttrib::M_point:
+    flush_tiles();
     _c->draw_triangle_front = gl_draw_triangle_point;
     _c->draw_triangle_back = gl_draw_triangle_point;
     break;
@@ -2144,6 +2194,7 @@ do_issue_texture() {
   bool all_mipmap_nearest = true;
   bool any_mipmap = false;
   bool needs_general = false;
+  bool any_tiled = false;
   Texture::QualityLevel best_quality_level = Texture::QL_default;
 
   for (int si = 0; si < num_stages; ++si) {
@@ -2161,11 +2212,6 @@ do_issue_texture() {
     // Get the sampler state that we are supposed to use.
     const SamplerState &sampler = _target_texture->get_on_sampler(stage);
 
-    // Then, turn on the current texture mode.
-    if (!update_texture(tc, false, si, sampler.uses_mipmaps())) {
-      return;
-    }
-
     // M_replace means M_replace; anything else is treated the same as
     // M_modulate.
     if (stage->get_mode() != TextureStage::M_replace) {
@@ -2217,6 +2263,23 @@ do_issue_texture() {
       magfilter = sampler.get_effective_magfilter();
     }
 
+    // A texture that is bilinear filtered is better off stored in tiles.
+    bool tiled = td_tiled_textures &&
+      (minfilter == SamplerState::FT_linear ||
+       minfilter == SamplerState::FT_linear_mipmap_nearest ||
+       minfilter == SamplerState::FT_linear_mipmap_linear ||
+       magfilter == SamplerState::FT_linear);
+
+    // Then, turn on the current texture mode.
+    if (!update_texture(tc, false, si, sampler.uses_mipmaps(), tiled)) {
+      return;
+    }
+
+    if (_c->current_textures[si]->tiled) {
+      // The inlined filters can't sample a tiled texture.
+      any_tiled = true;
+    }
+
     texture_def->tex_minfilter_func = get_tex_filter_func(minfilter);
     texture_def->tex_magfilter_func = get_tex_filter_func(magfilter);
 
@@ -2320,6 +2383,10 @@ do_issue_texture() {
       _texfilter_state = 2;  // tgeneral
     }
   }
+
+  if (any_tiled) {
+    _texfilter_state = 2;  // tgeneral
+  }
 }
 
 /**
@@ -2415,7 +2482,8 @@ upload_texture(TinyTextureContext *gtc, bool force, bool uses_mipmaps) {
     tinydisplay_cat.debug()
       << "loading texture " << tex->get_name() << ", "
       << tex->get_x_size() << " x " << tex->get_y_size() << ", mipmaps = "
-      << num_levels << ", uses_mipmaps = " << uses_mipmaps << "\n";
+      << num_levels << ", uses_mipmaps = " << uses_mipmaps
+      << ", tiled = " << gltex->tiled << "\n";
   }
 
   if (!setup_gltex(gltex, tex->get_x_size(), tex->get_y_size(), num_levels)) {
@@ -2487,6 +2555,8 @@ upload_texture(TinyTextureContext *gtc, bool force, bool uses_mipmaps) {
           << tex->get_format() << "!\n";
         return false;
       }
+      tile_texture_level(dest, xsize, ysize, level);
+
     } else {
       // Fill the mipmap with a solid color.
       LColor scaled = tex->get_clear_color().fmin(LColor(1)).fmax(LColor::zero());
@@ -2557,6 +2627,7 @@ upload_simple_texture(TinyTextureContext *gtc) {
 
   ZTextureLevel *dest = &gltex->levels[0];
   memcpy(dest->pixmap, image_ptr, image_size);
+  tile_texture_level(dest, gltex->xsize, gltex->ysize, 0);
 
   gtc->mark_simple_loaded();
 
@@ -2567,9 +2638,15 @@ upload_simple_texture(TinyTextureContext *gtc) {
  * Sets the GLTexture size, bits, and masks appropriately, and allocates space
  * for a pixmap.  Does not fill the pixmap contents.  Returns true if the
  * texture is a valid size, false otherwise.
+ *
+ * The masks are set up for tiled storage if gltex->tiled is set.
  */
 bool TinyGraphicsStateGuardian::
 setup_gltex(GLTexture *gltex, int x_size, int y_size, int num_levels) {
+  // The triangles waiting to be drawn may still refer to the texture memory
+  // we are about to replace.
+  flush_tiles();
+
   if (x_size == 0 || y_size == 0) {
     // A texture without pixels gets turned into a 1x1 texture.
     x_size = 1;
@@ -2635,11 +2712,25 @@ setup_gltex(GLTexture *gltex, int x_size, int y_size, int num_levels) {
     next_buffer += bytecount;
     nassertr(next_buffer <= end_of_buffer, false);
 
-    dest->s_mask = ((1 << (s_bits + ZB_POINT_ST_FRAC_BITS)) - (1 << ZB_POINT_ST_FRAC_BITS)) << level;
-    dest->t_mask = ((1 << (t_bits + ZB_POINT_ST_FRAC_BITS)) - (1 << ZB_POINT_ST_FRAC_BITS)) << level;
-    dest->s_shift = (ZB_POINT_ST_FRAC_BITS + level);
+    // The number of bits of s and t that select the texel within a tile.  A
+    // texture stored row by row is like one that has 1x1 tiles.
+    int s_tile_bits = 0;
+    int t_tile_bits = 0;
+    if (gltex->tiled) {
+      s_tile_bits = min(s_bits, (int)ZB_TEXTURE_TILE_BITS);
+      t_tile_bits = min(t_bits, (int)ZB_TEXTURE_TILE_BITS);
+    }
+
+    dest->s_mask = ((1 << (s_bits + ZB_POINT_ST_FRAC_BITS)) - (1 << (s_tile_bits + ZB_POINT_ST_FRAC_BITS))) << level;
+    dest->t_mask = ((1 << (t_bits + ZB_POINT_ST_FRAC_BITS)) - (1 << (t_tile_bits + ZB_POINT_ST_FRAC_BITS))) << level;
+    dest->s_shift = (ZB_POINT_ST_FRAC_BITS - t_tile_bits + level);
     dest->t_shift = (ZB_POINT_ST_FRAC_BITS - s_bits + level);
 
+    dest->s_tile_mask = ((1 << (s_tile_bits + ZB_POINT_ST_FRAC_BITS)) - (1 << ZB_POINT_ST_FRAC_BITS)) << level;
+    dest->t_tile_mask = ((1 << (t_tile_bits + ZB_POINT_ST_FRAC_BITS)) - (1 << ZB_POINT_ST_FRAC_BITS)) << level;
+    dest->s_tile_shift = (ZB_POINT_ST_FRAC_BITS + level);
+    dest->t_tile_shift = (ZB_POINT_ST_FRAC_BITS - s_tile_bits + level);
+
     x_size = max((x_size >> 1), 1);
     y_size = max((y_size >> 1), 1);
     s_bits = max(s_bits - 1, 0);
@@ -2677,6 +2768,29 @@ get_tex_shift(int orig_size) {
   return count_bits_in_word((unsigned int)orig_size - 1);
 }
 
+/**
+ * Rearranges the texels of the indicated texture level, which have just been
+ * copied in row by row, into the tiled order described by its masks.  Does
+ * nothing if the level is not stored in tiles.
+ */
+void TinyGraphicsStateGuardian::
+tile_texture_level(ZTextureLevel *dest, int xsize, int ysize, int level) {
+  if (dest->s_tile_mask == 0 && dest->t_tile_mask == 0) {
+    return;
+  }
+
+  pvector<PIXEL> rows(dest->pixmap, dest->pixmap + xsize * ysize);
+  const PIXEL *src = &rows[0];
+
+  int shift = ZB_POINT_ST_FRAC_BITS + level;
+  for (int y = 0; y < ysize; ++y) {
+    for (int x = 0; x < xsize; ++x) {
+      dest->pixmap[ZB_TILED_TEXEL(*dest, x << shift, y << shift)] = *src;
+      ++src;
+    }
+  }
+}
+
 /**
  * Copies and scales the one-channel luminance image from the texture into the
  * indicated ZTexture pixmap.
@@ -3110,6 +3224,47 @@ get_tex_wrap_func(SamplerState::WrapMode wrap_mode) {
   return &texcoord_repeat;
 }
 
+/**
+ * If the triangles are being drawn in tiles, draws all of the triangles that
+ * have been binned so far.  This must be called before anything else touches
+ * the frame buffer, or any memory the binned triangles may refer to.
+ */
+void TinyGraphicsStateGuardian::
+flush_tiles() {
+  if (_tile_binner != nullptr && !_tile_binner->is_empty()) {
+    _tile_binner->flush();
+
+#ifdef DO_PSTATS
+    ZPixelCounts counts;
+    memset(&counts, 0, sizeof(counts));
+    _tile_binner->collect_pixel_counts(counts);
+    add_pixel_counts(counts);
+#endif  // DO_PSTATS
+  }
+}
+
+/**
+ * Adds the indicated number of pixels drawn by each kind of triangle function
+ * to the PStats collectors.
+ */
+void TinyGraphicsStateGuardian::
+add_pixel_counts(const ZPixelCounts &counts) {
+#ifdef DO_PSTATS
+  _pixel_count_white_untextured_pcollector.add_level(counts.white_untextured);
+  _pixel_count_flat_untextured_pcollector.add_level(counts.flat_untextured);
+  _pixel_count_smooth_untextured_pcollector.add_level(counts.smooth_untextured);
+  _pixel_count_white_textured_pcollector.add_level(counts.white_textured);
+  _pixel_count_flat_textured_pcollector.add_level(counts.flat_textured);
+  _pixel_count_smooth_textured_pcollector.add_level(counts.smooth_textured);
+  _pixel_count_white_perspective_pcollector.add_level(counts.white_perspective);
+  _pixel_count_flat_perspective_pcollector.add_level(counts.flat_perspective);
+  _pixel_count_smooth_perspective_pcollector.add_level(counts.smooth_perspective);
+  _pixel_count_smooth_multitex2_pcollector.add_level(counts.smooth_multitex2);
+  _pixel_count_smooth_multitex3_pcollector.add_level(counts.smooth_multitex3);
+  _pixel_count_occluded_pcollector.add_level(counts.occluded);
+#endif  // DO_PSTATS
+}
+
 /**
  * Generates invalid texture coordinates.  Used when texture coordinate params
  * are invalid or unsupported.
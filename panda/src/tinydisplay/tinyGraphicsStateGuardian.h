@@ -25,6 +25,7 @@
 #include "geomVertexReader.h"
 
 class TinyTextureContext;
+class TinyTileBinner;
 
 /**
  * An interface to the TinyPanda software rendering code within this module.
@@ -85,7 +86,7 @@ public:
 
   virtual TextureContext *prepare_texture(Texture *tex, int view);
   virtual bool update_texture(TextureContext *tc, bool force);
-  bool update_texture(TextureContext *tc, bool force, int stage_index, bool uses_mipmaps);
+  bool update_texture(TextureContext *tc, bool force, int stage_index, bool uses_mipmaps, bool tiled);
   virtual void release_texture(TextureContext *tc);
 
   virtual void do_issue_light();
@@ -113,6 +114,7 @@ private:
   bool upload_simple_texture(TinyTextureContext *gtc);
   bool setup_gltex(GLTexture *gltex, int x_size, int y_size, int num_levels);
   int get_tex_shift(int orig_size);
+  static void tile_texture_level(ZTextureLevel *dest, int xsize, int ysize, int level);
 
   static void copy_lum_image(ZTextureLevel *dest, int xsize, int ysize, TinyTextureContext *gtc, int level);
   static void copy_alpha_image(ZTextureLevel *dest, int xsize, int ysize, TinyTextureContext *gtc, int level);
@@ -130,6 +132,9 @@ private:
 
   INLINE void clear_light_state();
 
+  void flush_tiles();
+  void add_pixel_counts(const ZPixelCounts &counts);
+
   // Methods used to generate texture coordinates.
   class TexCoordData {
   public:
@@ -154,6 +159,9 @@ private:
 
   GLContext *_c;
 
+  // Set when the triangles are to be drawn in parallel, in tiles.
+  TinyTileBinner *_tile_binner;
+
   enum ColorMaterialFlags {
     CMF_ambient   = 0x001,
     CMF_diffuse   = 0x002,
@@ -192,6 +200,7 @@ private:
   static PStatCollector _pixel_count_smooth_perspective_pcollector;
   static PStatCollector _pixel_count_smooth_multitex2_pcollector;
   static PStatCollector _pixel_count_smooth_multitex3_pcollector;
+  static PStatCollector _pixel_count_occluded_pcollector;
 
 public:
   static TypeHandle get_class_type() {
@@ -0,0 +1,208 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file tinyTileBinner.cxx
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#include "tinyTileBinner.h"
+#include "pStatTimer.h"
+
+#include <string.h>
+
+PStatCollector TinyTileBinner::_flush_pcollector("Draw:Flush tiles");
+
+/**
+ * The tile height is rounded up to a multiple of ZB_HIZ_BLOCK_SIZE, so that
+ * each block of the hierarchical depth buffer is only ever touched by the
+ * thread drawing the tile it lies in.
+ */
+TinyTileBinner::
+TinyTileBinner(JobPool *pool, int tile_height, int max_triangles) :
+  _pool(pool),
+  _tile_height((std::max(tile_height, 1) + ZB_HIZ_BLOCK_SIZE - 1) & ~(ZB_HIZ_BLOCK_SIZE - 1)),
+  _max_triangles(std::max(max_triangles, 1))
+{
+  memset(&_counts, 0, sizeof(_counts));
+}
+
+/**
+ * Records a triangle to be drawn into the indicated ZBuffer with the
+ * indicated fill function at the next call to flush().  The ZBuffer state is
+ * copied, as are the points.
+ */
+void TinyTileBinner::
+add_triangle(ZBuffer *zb, ZB_fillTriangleFunc fill_tri,
+             const ZBufferPoint *p0, const ZBufferPoint *p1,
+             const ZBufferPoint *p2) {
+  // Usually, many triangles in a row are drawn with the same state.
+  if (_states.empty() ||
+      _states.back()._fill_tri != fill_tri ||
+      memcmp(&_states.back()._zb, zb, sizeof(ZBuffer)) != 0) {
+    _states.push_back(State());
+    State &state = _states.back();
+    memcpy(&state._zb, zb, sizeof(ZBuffer));
+    state._fill_tri = fill_tri;
+  }
+
+  int index = (int)_triangles.size();
+  _triangles.push_back(Triangle());
+  Triangle &tri = _triangles.back();
+  tri._p[0] = *p0;
+  tri._p[1] = *p1;
+  tri._p[2] = *p2;
+  tri._state = (int)_states.size() - 1;
+
+  // Sort it into each of the tiles spanned by its rows.  The triangle has
+  // already been clipped to the viewport.
+  int ymin = std::min(std::min(p0->y, p1->y), p2->y);
+  int ymax = std::max(std::max(p0->y, p1->y), p2->y);
+  int tmin = std::max(ymin, 0) / _tile_height;
+  int tmax = std::min(ymax, zb->ysize - 1) / _tile_height;
+  if (tmax >= (int)_bins.size()) {
+    _bins.resize(tmax + 1);
+  }
+  for (int ti = tmin; ti <= tmax; ++ti) {
+    _bins[ti].push_back(index);
+  }
+
+  if ((int)_triangles.size() >= _max_triangles) {
+    // Don't hold on to more triangles than we were asked to.
+    flush();
+  }
+}
+
+/**
+ * Draws all of the triangles that have been added so far, and empties the
+ * bins.  This returns when all of the tiles have been drawn.
+ */
+void TinyTileBinner::
+flush() {
+  if (_triangles.empty()) {
+    return;
+  }
+
+  PStatTimer timer(_flush_pcollector);
+
+  _jobs.clear();
+  for (int ti = 0; ti < (int)_bins.size(); ++ti) {
+    if (!_bins[ti].empty()) {
+      _jobs.push_back(TileJob());
+      TileJob &job = _jobs.back();
+      job._binner = this;
+      job._ti = ti;
+    }
+  }
+
+  if (_jobs.size() == 1) {
+    // Not worth handing off to another thread.
+    draw_tile(_jobs[0]._ti, _jobs[0]._counts);
+
+  } else {
+    // The jobs vector won't be resized again until they have all finished.
+    JobPool::Batch batch(_pool);
+    for (TileJob &job : _jobs) {
+      batch.add_job(&job);
+    }
+    batch.wait();
+  }
+
+  for (const TileJob &job : _jobs) {
+    add_pixel_counts(_counts, job._counts);
+  }
+  clear();
+}
+
+/**
+ * Discards all of the triangles that have been added so far without drawing
+ * them.
+ */
+void TinyTileBinner::
+clear() {
+  _states.clear();
+  _triangles.clear();
+  for (Bin &bin : _bins) {
+    bin.clear();
+  }
+  _jobs.clear();
+}
+
+/**
+ * Adds the number of pixels drawn by each kind of triangle function since the
+ * last call to this method to the indicated counts.
+ */
+void TinyTileBinner::
+collect_pixel_counts(ZPixelCounts &counts) {
+  add_pixel_counts(counts, _counts);
+  memset(&_counts, 0, sizeof(_counts));
+}
+
+/**
+ * Draws the part of each triangle in the indicated bin that falls within the
+ * corresponding tile, in the order in which they were added.  Called in one
+ * of the JobPool threads.
+ */
+void TinyTileBinner::
+draw_tile(int ti, ZPixelCounts &counts) const {
+  const Bin &bin = _bins[ti];
+  int band_ymin = ti * _tile_height;
+  int band_ymax = band_ymin + _tile_height;
+
+  ZBuffer zb;
+  memset(&zb.pixel_counts, 0, sizeof(zb.pixel_counts));
+  int state_index = -1;
+
+  for (int index : bin) {
+    const Triangle &tri = _triangles[index];
+    if (tri._state != state_index) {
+      state_index = tri._state;
+      ZPixelCounts pixel_counts = zb.pixel_counts;
+      zb = _states[state_index]._zb;
+      zb.band_ymin = band_ymin;
+      zb.band_ymax = band_ymax;
+      zb.pixel_counts = pixel_counts;
+    }
+
+    // The fill functions may write to the points, so they get their own
+    // copy.
+    ZBufferPoint p0 = tri._p[0];
+    ZBufferPoint p1 = tri._p[1];
+    ZBufferPoint p2 = tri._p[2];
+    (*_states[state_index]._fill_tri)(&zb, &p0, &p1, &p2);
+  }
+
+  counts = zb.pixel_counts;
+}
+
+/**
+ * Adds the counts in src to those in dest.
+ */
+void TinyTileBinner::
+add_pixel_counts(ZPixelCounts &dest, const ZPixelCounts &src) {
+  dest.white_untextured += src.white_untextured;
+  dest.flat_untextured += src.flat_untextured;
+  dest.smooth_untextured += src.smooth_untextured;
+  dest.white_textured += src.white_textured;
+  dest.flat_textured += src.flat_textured;
+  dest.smooth_textured += src.smooth_textured;
+  dest.white_perspective += src.white_perspective;
+  dest.flat_perspective += src.flat_perspective;
+  dest.smooth_perspective += src.smooth_perspective;
+  dest.smooth_multitex2 += src.smooth_multitex2;
+  dest.smooth_multitex3 += src.smooth_multitex3;
+  dest.occluded += src.occluded;
+}
+
+/**
+ *
+ */
+void TinyTileBinner::TileJob::
+do_job(Thread *current_thread) {
+  _binner->draw_tile(_ti, _counts);
+}
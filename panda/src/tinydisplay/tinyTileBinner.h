@@ -0,0 +1,106 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file tinyTileBinner.h
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#ifndef TINYTILEBINNER_H
+#define TINYTILEBINNER_H
+
+#include "pandabase.h"
+#include "jobPool.h"
+#include "pvector.h"
+#include "pStatCollector.h"
+#include "zbuffer.h"
+
+/**
+ * Collects the filled triangles drawn by the TinyGraphicsStateGuardian and
+ * sorts them into tiles of the frame buffer, so that the tiles can all be
+ * drawn at once on the threads of a JobPool.
+ *
+ * A tile is a band of complete rows, since the triangle functions draw one
+ * row at a time.  Each tile is drawn by a single thread, in the order in which
+ * the triangles were added, so the result is exactly the same as drawing each
+ * triangle immediately.
+ *
+ * The triangles refer to the frame buffer and textures they were added with,
+ * so flush() must be called before any of these are modified by anything
+ * other than a triangle.
+ */
+class EXPCL_TINYDISPLAY TinyTileBinner {
+public:
+  TinyTileBinner(JobPool *pool, int tile_height, int max_triangles);
+  TinyTileBinner(const TinyTileBinner &copy) = delete;
+
+  TinyTileBinner &operator = (const TinyTileBinner &copy) = delete;
+
+  INLINE bool is_empty() const;
+  INLINE int get_tile_height() const;
+
+  void add_triangle(ZBuffer *zb, ZB_fillTriangleFunc fill_tri,
+                    const ZBufferPoint *p0, const ZBufferPoint *p1,
+                    const ZBufferPoint *p2);
+  void flush();
+  void clear();
+
+  void collect_pixel_counts(ZPixelCounts &counts);
+
+private:
+  void draw_tile(int ti, ZPixelCounts &counts) const;
+
+  static void add_pixel_counts(ZPixelCounts &dest, const ZPixelCounts &src);
+
+  // The ZBuffer state and fill function with which one or more consecutive
+  // triangles were added.
+  class State {
+  public:
+    ZBuffer _zb;
+    ZB_fillTriangleFunc _fill_tri;
+  };
+  typedef pvector<State> States;
+
+  class Triangle {
+  public:
+    ZBufferPoint _p[3];
+    int _state;
+  };
+  typedef pvector<Triangle> Triangles;
+
+  // The indices of the triangles that touch each tile.
+  typedef pvector<int> Bin;
+  typedef pvector<Bin> Bins;
+
+  class TileJob : public JobPool::Job {
+  public:
+    virtual void do_job(Thread *current_thread);
+
+    const TinyTileBinner *_binner;
+    int _ti;
+    ZPixelCounts _counts;
+  };
+  typedef pvector<TileJob> Jobs;
+
+  JobPool *_pool;
+  int _tile_height;
+  int _max_triangles;
+
+  States _states;
+  Triangles _triangles;
+  Bins _bins;
+  Jobs _jobs;
+
+  ZPixelCounts _counts;
+
+  static PStatCollector _flush_pcollector;
+};
+
+#include "tinyTileBinner.I"
+
+#endif
@@ -1,6 +1,10 @@
 #include "zgl.h"
 #include <string.h>
 
+#ifdef HAVE_TINYDISPLAY_SSE2
+#include <emmintrin.h>
+#endif
+
 void gl_eval_viewport(GLContext * c) {
   GLViewport *v = &c->viewport;
   GLScissor *s = &c->scissor;
@@ -21,11 +25,13 @@ void gl_eval_viewport(GLContext * c) {
 }
 
 /* coords, tranformation , clip code and projection */
+/* the normal is read from v->normal, and replaced with the transformed
+   normal */
 /* TODO : handle all cases */
 void 
 gl_vertex_transform(GLContext * c, GLVertex * v) {
   PN_stdfloat *m;
-  V4 *n;
+  V3 n;
 
   if (c->lighting_enabled) {
     /* eye coordinates needed for lighting */
@@ -52,11 +58,11 @@ gl_vertex_transform(GLContext * c, GLVertex * v) {
                   v->ec.v[2] * m[14] + v->ec.v[3] * m[15]);
 
     m = &c->matrix_model_view_inv.m[0][0];
-    n = &c->current_normal;
+    n = v->normal;
 
-    v->normal.v[0] = (n->v[0] * m[0] + n->v[1] * m[1] + n->v[2] * m[2]) * c->normal_scale;
-    v->normal.v[1] = (n->v[0] * m[4] + n->v[1] * m[5] + n->v[2] * m[6]) * c->normal_scale;
-    v->normal.v[2] = (n->v[0] * m[8] + n->v[1] * m[9] + n->v[2] * m[10]) * c->normal_scale;
+    v->normal.v[0] = (n.v[0] * m[0] + n.v[1] * m[1] + n.v[2] * m[2]) * c->normal_scale;
+    v->normal.v[1] = (n.v[0] * m[4] + n.v[1] * m[5] + n.v[2] * m[6]) * c->normal_scale;
+    v->normal.v[2] = (n.v[0] * m[8] + n.v[1] * m[9] + n.v[2] * m[10]) * c->normal_scale;
 
     if (c->normalize_enabled) {
       gl_V3_Norm(&v->normal);
@@ -82,3 +88,146 @@ gl_vertex_transform(GLContext * c, GLVertex * v) {
 
   v->clip_code = gl_clipcode(v->pc.v[0], v->pc.v[1], v->pc.v[2], v->pc.v[3]);
 }
+
+#ifdef HAVE_TINYDISPLAY_SSE2
+
+/* the four vertices are held one per lane, so each row of a matrix is
+   applied with the same sequence of operations as in gl_vertex_transform(),
+   and the results are exactly the same */
+static inline __m128
+dot_row3(const PN_stdfloat *m, __m128 x, __m128 y, __m128 z) {
+  return _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(m[0])),
+                               _mm_mul_ps(y, _mm_set1_ps(m[1]))),
+                    _mm_mul_ps(z, _mm_set1_ps(m[2])));
+}
+
+static inline __m128
+mul_row3(const PN_stdfloat *m, __m128 x, __m128 y, __m128 z) {
+  return _mm_add_ps(dot_row3(m, x, y, z), _mm_set1_ps(m[3]));
+}
+
+static inline __m128
+mul_row4(const PN_stdfloat *m, __m128 x, __m128 y, __m128 z, __m128 w) {
+  return _mm_add_ps(dot_row3(m, x, y, z), _mm_mul_ps(w, _mm_set1_ps(m[3])));
+}
+
+#define LOAD4(v, field, i) \
+  _mm_set_ps((v)[3].field.v[i], (v)[2].field.v[i], (v)[1].field.v[i], (v)[0].field.v[i])
+
+#define STORE4(v, field, i, a)                  \
+  {                                             \
+    float tmp[4];                               \
+    _mm_storeu_ps(tmp, (a));                    \
+    (v)[0].field.v[i] = tmp[0];                 \
+    (v)[1].field.v[i] = tmp[1];                 \
+    (v)[2].field.v[i] = tmp[2];                 \
+    (v)[3].field.v[i] = tmp[3];                 \
+  }
+
+/* same as gl_vertex_transform(), for four vertices at once */
+static void
+gl_vertex_transform4(GLContext * c, GLVertex * v) {
+  const PN_stdfloat *m;
+  __m128 x = LOAD4(v, coord, 0);
+  __m128 y = LOAD4(v, coord, 1);
+  __m128 z = LOAD4(v, coord, 2);
+  __m128 px, py, pz, pw;
+
+  if (c->lighting_enabled) {
+    m = &c->matrix_model_view.m[0][0];
+    __m128 ex = mul_row3(m, x, y, z);
+    __m128 ey = mul_row3(m + 4, x, y, z);
+    __m128 ez = mul_row3(m + 8, x, y, z);
+    __m128 ew = mul_row3(m + 12, x, y, z);
+    STORE4(v, ec, 0, ex);
+    STORE4(v, ec, 1, ey);
+    STORE4(v, ec, 2, ez);
+    STORE4(v, ec, 3, ew);
+
+    m = &c->matrix_projection.m[0][0];
+    px = mul_row4(m, ex, ey, ez, ew);
+    py = mul_row4(m + 4, ex, ey, ez, ew);
+    pz = mul_row4(m + 8, ex, ey, ez, ew);
+    pw = mul_row4(m + 12, ex, ey, ez, ew);
+
+    m = &c->matrix_model_view_inv.m[0][0];
+    __m128 nx = LOAD4(v, normal, 0);
+    __m128 ny = LOAD4(v, normal, 1);
+    __m128 nz = LOAD4(v, normal, 2);
+    __m128 scale = _mm_set1_ps(c->normal_scale);
+    __m128 tx = _mm_mul_ps(dot_row3(m, nx, ny, nz), scale);
+    __m128 ty = _mm_mul_ps(dot_row3(m + 4, nx, ny, nz), scale);
+    __m128 tz = _mm_mul_ps(dot_row3(m + 8, nx, ny, nz), scale);
+
+    if (c->normalize_enabled) {
+      /* as gl_V3_Norm(): a zero-length normal is left alone */
+      __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, tx),
+                                                     _mm_mul_ps(ty, ty)),
+                                          _mm_mul_ps(tz, tz)));
+      __m128 nonzero = _mm_cmpneq_ps(len, _mm_setzero_ps());
+      tx = _mm_or_ps(_mm_and_ps(nonzero, _mm_div_ps(tx, len)), _mm_andnot_ps(nonzero, tx));
+      ty = _mm_or_ps(_mm_and_ps(nonzero, _mm_div_ps(ty, len)), _mm_andnot_ps(nonzero, ty));
+      tz = _mm_or_ps(_mm_and_ps(nonzero, _mm_div_ps(tz, len)), _mm_andnot_ps(nonzero, tz));
+    }
+    STORE4(v, normal, 0, tx);
+    STORE4(v, normal, 1, ty);
+    STORE4(v, normal, 2, tz);
+
+  } else {
+    m = &c->matrix_model_projection.m[0][0];
+    px = mul_row3(m, x, y, z);
+    py = mul_row3(m + 4, x, y, z);
+    pz = mul_row3(m + 8, x, y, z);
+    if (c->matrix_model_projection_no_w_transform) {
+      pw = _mm_set1_ps(m[15]);
+    } else {
+      pw = mul_row3(m + 12, x, y, z);
+    }
+  }
+
+  STORE4(v, pc, 0, px);
+  STORE4(v, pc, 1, py);
+  STORE4(v, pc, 2, pz);
+  STORE4(v, pc, 3, pw);
+
+  /* clip codes, as gl_clipcode() */
+  __m128 w = _mm_mul_ps(pw, _mm_set1_ps(1.0f + CLIP_EPSILON));
+  __m128 neg_w = _mm_sub_ps(_mm_setzero_ps(), w);
+  int bits[6];
+  bits[0] = _mm_movemask_ps(_mm_cmplt_ps(px, neg_w));
+  bits[1] = _mm_movemask_ps(_mm_cmpgt_ps(px, w));
+  bits[2] = _mm_movemask_ps(_mm_cmplt_ps(py, neg_w));
+  bits[3] = _mm_movemask_ps(_mm_cmpgt_ps(py, w));
+  bits[4] = _mm_movemask_ps(_mm_cmplt_ps(pz, neg_w));
+  bits[5] = _mm_movemask_ps(_mm_cmpgt_ps(pz, w));
+  for (int i = 0; i < 4; ++i) {
+    v[i].clip_code =
+      ((bits[0] >> i) & 1) |
+      (((bits[1] >> i) & 1) << 1) |
+      (((bits[2] >> i) & 1) << 2) |
+      (((bits[3] >> i) & 1) << 3) |
+      (((bits[4] >> i) & 1) << 4) |
+      (((bits[5] >> i) & 1) << 5);
+  }
+}
+
+#undef LOAD4
+#undef STORE4
+
+#endif  /* HAVE_TINYDISPLAY_SSE2 */
+
+/* gl_vertex_transform() for an array of vertices */
+void
+gl_vertex_transform_batch(GLContext * c, GLVertex * v, int count) {
+  int i = 0;
+#ifdef HAVE_TINYDISPLAY_SSE2
+  if (c->simd_vertices) {
+    for (; i + 4 <= count; i += 4) {
+      gl_vertex_transform4(c, v + i);
+    }
+  }
+#endif
+  for (; i < count; ++i) {
+    gl_vertex_transform(c, v + i);
+  }
+}
@@ -9,24 +9,27 @@
 #include <string.h>
 #include "zbuffer.h"
 #include "pnotify.h"
-
-#ifdef DO_PSTATS
-int pixel_count_white_untextured;
-int pixel_count_flat_untextured;
-int pixel_count_smooth_untextured;
-int pixel_count_white_textured;
-int pixel_count_flat_textured;
-int pixel_count_smooth_textured;
-int pixel_count_white_perspective;
-int pixel_count_flat_perspective;
-int pixel_count_smooth_perspective;
-int pixel_count_smooth_multitex2;
-int pixel_count_smooth_multitex3;
-#endif  // DO_PSTATS
+#include "config_tinydisplay.h"
 
 using std::max;
 using std::min;
 
+/* (Re)allocates the hierarchical depth buffer to match the size of the depth
+   buffer.  All of the blocks start out dirty. */
+static void
+ZB_hiz_alloc(ZBuffer *zb) {
+  if (zb->hiz_buf != nullptr) {
+    gl_free(zb->hiz_buf);
+    gl_free(zb->hiz_dirty);
+  }
+
+  zb->hiz_xsize = (zb->xsize + ZB_HIZ_BLOCK_SIZE - 1) >> ZB_HIZ_BLOCK_BITS;
+  zb->hiz_ysize = (zb->ysize + ZB_HIZ_BLOCK_SIZE - 1) >> ZB_HIZ_BLOCK_BITS;
+  zb->hiz_buf = (ZPOINT *)gl_malloc(zb->hiz_xsize * zb->hiz_ysize * sizeof(ZPOINT));
+  zb->hiz_dirty = (unsigned char *)gl_malloc(zb->hiz_xsize * zb->hiz_ysize);
+  memset(zb->hiz_dirty, 1, zb->hiz_xsize * zb->hiz_ysize);
+}
+
 ZBuffer *
 ZB_open(int xsize, int ysize, int mode,
         int nb_colors,
@@ -48,6 +51,8 @@ ZB_open(int xsize, int ysize, int mode,
   zb->ysize = ysize;
   zb->mode = mode;
   zb->linesize = (xsize * PSZB + 3) & ~3;
+  zb->band_ymin = 0;
+  zb->band_ymax = ysize;
 
   switch (mode) {
 #ifdef TGL_FEATURE_8_BITS
@@ -86,6 +91,9 @@ ZB_open(int xsize, int ysize, int mode,
     zb->pbuf = (PIXEL *)frame_buffer;
   }
 
+  zb->hiz_enabled = td_hierarchical_z;
+  ZB_hiz_alloc(zb);
+
   return zb;
  error:
   gl_free(zb);
@@ -103,6 +111,8 @@ ZB_close(ZBuffer * zb) {
     gl_free(zb->pbuf);
 
   gl_free(zb->zbuf);
+  gl_free(zb->hiz_buf);
+  gl_free(zb->hiz_dirty);
   gl_free(zb);
 }
 
@@ -118,6 +128,8 @@ ZB_resize(ZBuffer * zb, void *frame_buffer, int xsize, int ysize) {
   zb->xsize = xsize;
   zb->ysize = ysize;
   zb->linesize = (xsize * PSZB + 3) & ~3;
+  zb->band_ymin = 0;
+  zb->band_ymax = ysize;
 
   size = zb->xsize * zb->ysize * sizeof(ZPOINT);
   gl_free(zb->zbuf);
@@ -133,6 +145,8 @@ ZB_resize(ZBuffer * zb, void *frame_buffer, int xsize, int ysize) {
     zb->pbuf = (PIXEL *)frame_buffer;
     zb->frame_buffer_allocated = 0;
   }
+
+  ZB_hiz_alloc(zb);
 }
 
 static void
@@ -306,6 +320,9 @@ void ZB_zoomFrameBuffer(ZBuffer *dest, int dest_xmin, int dest_ymin, int dest_xs
       tz[tx] = fz[fx];
     }
   }
+
+  ZB_hiz_mark_dirty(dest, dest_xmin, dest_ymin,
+                    dest_xmin + dest_xsize - 1, dest_ymin + dest_ysize - 1);
 }
 
 
@@ -395,6 +412,8 @@ ZB_clear(ZBuffer * zb, int clear_z, ZPOINT z, int clear_color, PIXEL color) {
 
   if (clear_z) {
     memset(zb->zbuf, 0, zb->xsize * zb->ysize * sizeof(ZPOINT));
+    memset(zb->hiz_buf, 0, zb->hiz_xsize * zb->hiz_ysize * sizeof(ZPOINT));
+    memset(zb->hiz_dirty, 0, zb->hiz_xsize * zb->hiz_ysize);
   }
   if (clear_color) {
     pp = zb->pbuf;
@@ -423,6 +442,7 @@ ZB_clear_viewport(ZBuffer * zb, int clear_z, ZPOINT z, int clear_color, PIXEL co
       memset(zz, 0, xsize * sizeof(ZPOINT));
       zz += zb->xsize;
     }
+    ZB_hiz_mark_dirty(zb, xmin, ymin, xmin + xsize - 1, ymin + ysize - 1);
   }
   if (clear_color) {
     pp = zb->pbuf + xmin + ymin * (zb->linesize / PSZB);
@@ -433,6 +453,48 @@ ZB_clear_viewport(ZBuffer * zb, int clear_z, ZPOINT z, int clear_color, PIXEL co
   }
 }
 
+/* Marks the blocks of the hierarchical depth buffer that overlap the
+   indicated rectangle (inclusive) dirty, after something other than a
+   triangle function has written to the depth buffer there. */
+void
+ZB_hiz_mark_dirty(ZBuffer *zb, int xmin, int ymin, int xmax, int ymax) {
+  int by;
+
+  xmin = max(xmin, 0);
+  ymin = max(ymin, 0);
+  xmax = min(xmax, zb->xsize - 1);
+  ymax = min(ymax, zb->ysize - 1);
+  if (xmin > xmax || ymin > ymax) {
+    return;
+  }
+
+  for (by = ymin >> ZB_HIZ_BLOCK_BITS; by <= (ymax >> ZB_HIZ_BLOCK_BITS); ++by) {
+    ZB_hiz_mark_span(zb, xmin, xmax, by << ZB_HIZ_BLOCK_BITS);
+  }
+}
+
+/* Recomputes the smallest depth value in the indicated block of the
+   hierarchical depth buffer. */
+void
+ZB_hiz_update_block(ZBuffer *zb, int bx, int by) {
+  int xmin = bx << ZB_HIZ_BLOCK_BITS;
+  int ymin = by << ZB_HIZ_BLOCK_BITS;
+  int xmax = min(xmin + ZB_HIZ_BLOCK_SIZE, zb->xsize);
+  int ymax = min(ymin + ZB_HIZ_BLOCK_SIZE, zb->ysize);
+  ZPOINT zmin = ~(ZPOINT)0;
+  int x, y;
+
+  for (y = ymin; y < ymax; ++y) {
+    const ZPOINT *pz = zb->zbuf + y * zb->xsize;
+    for (x = xmin; x < xmax; ++x) {
+      zmin = min(zmin, pz[x]);
+    }
+  }
+
+  zb->hiz_buf[by * zb->hiz_xsize + bx] = zmin;
+  zb->hiz_dirty[by * zb->hiz_xsize + bx] = 0;
+}
+
 #define ZB_ST_FRAC_HIGH (1 << ZB_POINT_ST_FRAC_BITS)
 #define ZB_ST_FRAC_MASK (ZB_ST_FRAC_HIGH - 1)
 
@@ -445,27 +507,91 @@ ZB_clear_viewport(ZBuffer * zb, int clear_z, ZPOINT z, int clear_color, PIXEL co
 #define BILINEAR_FILTER(c1, c2, c3, c4, sf, tf) \
   (LINEAR_FILTER(LINEAR_FILTER(c1, c2, sf), LINEAR_FILTER(c3, c4, sf), tf))
 
-// Grab the nearest texel from the base level.  This is also
-// implemented inline as ZB_LOOKUP_TEXTURE_NEAREST.
-PIXEL
-lookup_texture_nearest(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx) {
-  return ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t);
+// The functions below are only ever called through the ZTextureDef
+// function pointers, so they use ZB_TILED_TEXEL, and work for tiled
+// textures as well as for textures stored row by row.
+
+// Returns the blend factor between mipmap level (level - 1), at 0, and
+// level, at ZB_ST_FRAC_HIGH, for a level and level_dx computed by
+// DO_CALC_MIPMAP_LEVEL.
+static inline unsigned int
+mipmap_blend_factor(unsigned int level, unsigned int level_dx) {
+  return level_dx >> (level - 1);
 }
 
-// Bilinear filter four texels in the base level.
-PIXEL
-lookup_texture_bilinear(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx) {
+#ifdef TGL_FEATURE_SSE2
+// With SSE2, the filters work on all four components of a texel at once.
+// The intermediate results are kept in the low 16 bits of each 32-bit lane,
+// as the 8-bit components with 7 fractional bits, so that _mm_madd_epi16 can
+// blend two of them in one go.
+
+// Blends c1 and c2 (each with 7 fractional bits), with the weight f of c2
+// having ZB_POINT_ST_FRAC_BITS bits.
+static inline __m128i
+linear_filter4(__m128i c1, __m128i c2, unsigned int f) {
+  __m128i w = _mm_set1_epi32((f << 16) | (ZB_ST_FRAC_HIGH - f));
+  __m128i c = _mm_or_si128(c1, _mm_slli_epi32(c2, 16));
+  return _mm_srli_epi32(_mm_madd_epi16(c, w), ZB_POINT_ST_FRAC_BITS);
+}
+
+// Bilinear filters the four texels around (s, t) in the indicated level.
+static inline __m128i
+bilinear_filter4(const ZTextureLevel *tl, int s, int t, unsigned int level) {
+  int one = ZB_ST_FRAC_HIGH << level;
+  PIXEL p1 = tl->pixmap[ZB_TILED_TEXEL(*tl, s - one, t - one)];
+  PIXEL p2 = tl->pixmap[ZB_TILED_TEXEL(*tl, s, t - one)];
+  PIXEL p3 = tl->pixmap[ZB_TILED_TEXEL(*tl, s - one, t)];
+  PIXEL p4 = tl->pixmap[ZB_TILED_TEXEL(*tl, s, t)];
+  unsigned int sf = (s >> level) & ZB_ST_FRAC_MASK;
+  unsigned int tf = (t >> level) & ZB_ST_FRAC_MASK;
+
+  // Widen the components to 16 bits: p1 and p2 in top, p3 and p4 in bottom.
+  __m128i zero = _mm_setzero_si128();
+  __m128i top = _mm_unpacklo_epi8(_mm_unpacklo_epi32(_mm_cvtsi32_si128(p1), _mm_cvtsi32_si128(p2)), zero);
+  __m128i bottom = _mm_unpacklo_epi8(_mm_unpacklo_epi32(_mm_cvtsi32_si128(p3), _mm_cvtsi32_si128(p4)), zero);
+
+  // Filter the two columns in t, keeping 7 of the fractional bits.
+  __m128i wt = _mm_set1_epi32((tf << 16) | (ZB_ST_FRAC_HIGH - tf));
+  __m128i c1 = _mm_srli_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(top, bottom), wt), ZB_POINT_ST_FRAC_BITS - 7);
+  __m128i c2 = _mm_srli_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(top, bottom), wt), ZB_POINT_ST_FRAC_BITS - 7);
+
+  // And then the results in s.
+  return linear_filter4(c1, c2, sf);
+}
+
+// Widens the texel to the format used by the above functions.
+static inline __m128i
+unpack_pixel4(PIXEL p) {
+  __m128i zero = _mm_setzero_si128();
+  __m128i c = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(p), zero), zero);
+  return _mm_slli_epi32(c, 7);
+}
+
+// Packs the result of the above functions back into a texel.
+static inline PIXEL
+pack_pixel4(__m128i c) {
+  c = _mm_srli_epi32(c, 7);
+  c = _mm_packs_epi32(c, c);
+  return (PIXEL)_mm_cvtsi128_si32(_mm_packus_epi16(c, c));
+}
+
+#else  // TGL_FEATURE_SSE2
+
+// Bilinear filters the four texels around (s, t) in the indicated level.
+static inline PIXEL
+bilinear_filter(const ZTextureLevel *tl, int s, int t, unsigned int level) {
+  int one = ZB_ST_FRAC_HIGH << level;
   PIXEL p1, p2, p3, p4;
   int sf, tf;
   int r, g, b, a;
 
-  p1 = ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s - ZB_ST_FRAC_HIGH, t - ZB_ST_FRAC_HIGH);
-  p2 = ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t - ZB_ST_FRAC_HIGH);
-  sf = s & ZB_ST_FRAC_MASK;
+  p1 = tl->pixmap[ZB_TILED_TEXEL(*tl, s - one, t - one)];
+  p2 = tl->pixmap[ZB_TILED_TEXEL(*tl, s, t - one)];
+  sf = (s >> level) & ZB_ST_FRAC_MASK;
 
-  p3 = ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s - ZB_ST_FRAC_HIGH, t);
-  p4 = ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t);
-  tf = t & ZB_ST_FRAC_MASK;
+  p3 = tl->pixmap[ZB_TILED_TEXEL(*tl, s - one, t)];
+  p4 = tl->pixmap[ZB_TILED_TEXEL(*tl, s, t)];
+  tf = (t >> level) & ZB_ST_FRAC_MASK;
 
   r = BILINEAR_FILTER(PIXEL_R(p1), PIXEL_R(p2), PIXEL_R(p3), PIXEL_R(p4), sf, tf);
   g = BILINEAR_FILTER(PIXEL_G(p1), PIXEL_G(p2), PIXEL_G(p3), PIXEL_G(p4), sf, tf);
@@ -475,24 +601,11 @@ lookup_texture_bilinear(ZTextureDef *texture_def, int s, int t, unsigned int lev
   return RGBA_TO_PIXEL(r, g, b, a);
 }
 
-// Grab the nearest texel from the nearest mipmap level.  This is also
-// implemented inline as ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST.
-PIXEL
-lookup_texture_mipmap_nearest(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx) {
-  return ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level);
-}
-
-// Linear filter the two texels from the two nearest mipmap levels.
-PIXEL
-lookup_texture_mipmap_linear(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx) {
-  PIXEL p1, p2;
+// Blends p1 and p2, with the weight f of p2.
+static inline PIXEL
+linear_filter(PIXEL p1, PIXEL p2, unsigned int f) {
   int r, g, b, a;
 
-  p1 = ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level);
-  level = max((int)level - 1, 0);
-  p2 = ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level);
-
-  unsigned int f = level_dx >> (level - 1);
   r = LINEAR_FILTER(PIXEL_R(p1), PIXEL_R(p2), f);
   g = LINEAR_FILTER(PIXEL_G(p1), PIXEL_G(p2), f);
   b = LINEAR_FILTER(PIXEL_B(p1), PIXEL_B(p2), f);
@@ -501,88 +614,81 @@ lookup_texture_mipmap_linear(ZTextureDef *texture_def, int s, int t, unsigned in
   return RGBA_TO_PIXEL(r, g, b, a);
 }
 
-// Bilinear filter four texels in the nearest mipmap level.
-PIXEL
-lookup_texture_mipmap_bilinear(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx) {
-  PIXEL p1, p2, p3, p4;
-  int sf, tf;
-  int r, g, b, a;
+#endif  // TGL_FEATURE_SSE2
 
-  p1 = ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s - ZB_ST_FRAC_HIGH, t - ZB_ST_FRAC_HIGH, level);
-  p2 = ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t - ZB_ST_FRAC_HIGH, level);
-  sf = (s >> level) & ZB_ST_FRAC_MASK;
-
-  p3 = ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s - ZB_ST_FRAC_HIGH, t, level);
-  p4 = ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level);
-  tf = (t >> level) & ZB_ST_FRAC_MASK;
+// Grab the nearest texel from the base level.  This is also
+// implemented inline as ZB_LOOKUP_TEXTURE_NEAREST, for textures that aren't tiled.
+PIXEL
+lookup_texture_nearest(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx) {
+  return ZB_LOOKUP_TEXTURE_TILED(texture_def, s, t, 0);
+}
 
-  r = BILINEAR_FILTER(PIXEL_R(p1), PIXEL_R(p2), PIXEL_R(p3), PIXEL_R(p4), sf, tf);
-  g = BILINEAR_FILTER(PIXEL_G(p1), PIXEL_G(p2), PIXEL_G(p3), PIXEL_G(p4), sf, tf);
-  b = BILINEAR_FILTER(PIXEL_B(p1), PIXEL_B(p2), PIXEL_B(p3), PIXEL_B(p4), sf, tf);
-  a = BILINEAR_FILTER(PIXEL_A(p1), PIXEL_A(p2), PIXEL_A(p3), PIXEL_A(p4), sf, tf);
+// Bilinear filter four texels in the base level.
+PIXEL
+lookup_texture_bilinear(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx) {
+#ifdef TGL_FEATURE_SSE2
+  return pack_pixel4(bilinear_filter4(&texture_def->levels[0], s, t, 0));
+#else
+  return bilinear_filter(&texture_def->levels[0], s, t, 0);
+#endif
+}
 
-  return RGBA_TO_PIXEL(r, g, b, a);
+// Grab the nearest texel from the nearest mipmap level.  This is also
+// implemented inline as ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST, for textures that aren't tiled.
+PIXEL
+lookup_texture_mipmap_nearest(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx) {
+  return ZB_LOOKUP_TEXTURE_TILED(texture_def, s, t, level);
 }
 
-// Bilinear filter four texels in each of the nearest two mipmap
-// levels, then linear filter them together.
+// Linear filter the two texels from the two nearest mipmap levels.
 PIXEL
-lookup_texture_mipmap_trilinear(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx) {
-  PIXEL p1a, p2a;
-
-  {
-    PIXEL p1, p2, p3, p4;
-    int sf, tf;
-    int r, g, b, a;
-
-    p1 = ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s - ZB_ST_FRAC_HIGH, t - ZB_ST_FRAC_HIGH, level);
-    p2 = ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t - ZB_ST_FRAC_HIGH, level);
-    sf = (s >> level) & ZB_ST_FRAC_MASK;
-
-    p3 = ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s - ZB_ST_FRAC_HIGH, t, level);
-    p4 = ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level);
-    tf = (t >> level) & ZB_ST_FRAC_MASK;
-
-    r = BILINEAR_FILTER(PIXEL_R(p1), PIXEL_R(p2), PIXEL_R(p3), PIXEL_R(p4), sf, tf);
-    g = BILINEAR_FILTER(PIXEL_G(p1), PIXEL_G(p2), PIXEL_G(p3), PIXEL_G(p4), sf, tf);
-    b = BILINEAR_FILTER(PIXEL_B(p1), PIXEL_B(p2), PIXEL_B(p3), PIXEL_B(p4), sf, tf);
-    a = BILINEAR_FILTER(PIXEL_A(p1), PIXEL_A(p2), PIXEL_A(p3), PIXEL_A(p4), sf, tf);
-    p1a = RGBA_TO_PIXEL(r, g, b, a);
+lookup_texture_mipmap_linear(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx) {
+  if (level == 0) {
+    return ZB_LOOKUP_TEXTURE_TILED(texture_def, s, t, 0);
   }
 
-  level = max((int)level - 1, 0);
-
-  {
-    PIXEL p1, p2, p3, p4;
-    int sf, tf;
-    int r, g, b, a;
+  PIXEL p1 = ZB_LOOKUP_TEXTURE_TILED(texture_def, s, t, level - 1);
+  PIXEL p2 = ZB_LOOKUP_TEXTURE_TILED(texture_def, s, t, level);
+  unsigned int f = mipmap_blend_factor(level, level_dx);
 
-    p1 = ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s - ZB_ST_FRAC_HIGH, t - ZB_ST_FRAC_HIGH, level);
-    p2 = ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t - ZB_ST_FRAC_HIGH, level);
-    sf = (s >> level) & ZB_ST_FRAC_MASK;
+#ifdef TGL_FEATURE_SSE2
+  return pack_pixel4(linear_filter4(unpack_pixel4(p1), unpack_pixel4(p2), f));
+#else
+  return linear_filter(p1, p2, f);
+#endif
+}
 
-    p3 = ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s - ZB_ST_FRAC_HIGH, t, level);
-    p4 = ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level);
-    tf = (t >> level) & ZB_ST_FRAC_MASK;
+// Bilinear filter four texels in the nearest mipmap level.
+PIXEL
+lookup_texture_mipmap_bilinear(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx) {
+#ifdef TGL_FEATURE_SSE2
+  return pack_pixel4(bilinear_filter4(&texture_def->levels[level], s, t, level));
+#else
+  return bilinear_filter(&texture_def->levels[level], s, t, level);
+#endif
+}
 
-    r = BILINEAR_FILTER(PIXEL_R(p1), PIXEL_R(p2), PIXEL_R(p3), PIXEL_R(p4), sf, tf);
-    g = BILINEAR_FILTER(PIXEL_G(p1), PIXEL_G(p2), PIXEL_G(p3), PIXEL_G(p4), sf, tf);
-    b = BILINEAR_FILTER(PIXEL_B(p1), PIXEL_B(p2), PIXEL_B(p3), PIXEL_B(p4), sf, tf);
-    a = BILINEAR_FILTER(PIXEL_A(p1), PIXEL_A(p2), PIXEL_A(p3), PIXEL_A(p4), sf, tf);
-    p2a = RGBA_TO_PIXEL(r, g, b, a);
+// Bilinear filter four texels in each of the nearest two mipmap
+// levels, then linear filter them together.
+PIXEL
+lookup_texture_mipmap_trilinear(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx) {
+  if (level == 0) {
+    return lookup_texture_mipmap_bilinear(texture_def, s, t, 0, 0);
   }
 
-  int r, g, b, a;
-  unsigned int f = level_dx >> (level - 1);
-  r = LINEAR_FILTER(PIXEL_R(p1a), PIXEL_R(p2a), f);
-  g = LINEAR_FILTER(PIXEL_G(p1a), PIXEL_G(p2a), f);
-  b = LINEAR_FILTER(PIXEL_B(p1a), PIXEL_B(p2a), f);
-  a = LINEAR_FILTER(PIXEL_A(p1a), PIXEL_A(p2a), f);
+  unsigned int f = mipmap_blend_factor(level, level_dx);
 
-  return RGBA_TO_PIXEL(r, g, b, a);
+#ifdef TGL_FEATURE_SSE2
+  __m128i c1 = bilinear_filter4(&texture_def->levels[level - 1], s, t, level - 1);
+  __m128i c2 = bilinear_filter4(&texture_def->levels[level], s, t, level);
+  return pack_pixel4(linear_filter4(c1, c2, f));
+#else
+  PIXEL p1 = bilinear_filter(&texture_def->levels[level - 1], s, t, level - 1);
+  PIXEL p2 = bilinear_filter(&texture_def->levels[level], s, t, level);
+  return linear_filter(p1, p2, f);
+#endif
 }
 
-
 // Apply the wrap mode to s and t coordinates by calling the generic
 // wrap mode function.
 PIXEL
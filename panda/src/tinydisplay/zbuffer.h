@@ -8,11 +8,21 @@
 #include "zfeatures.h"
 #include "pbitops.h"
 #include "srgb_tables.h"
+#include <string.h>
+#include <algorithm>
+
+#ifdef TGL_FEATURE_SSE2
+#include <emmintrin.h>
+#endif
 
 typedef unsigned int ZPOINT;
 #define ZB_Z_BITS 20
 #define ZB_POINT_Z_FRAC_BITS 10  // These must add to < 32.
 
+/* The size of the square blocks of the hierarchical depth buffer. */
+#define ZB_HIZ_BLOCK_BITS 3
+#define ZB_HIZ_BLOCK_SIZE (1 << ZB_HIZ_BLOCK_BITS)
+
 /* The number of fractional bits below the S and T texture coords.
    The more we have, the more precise the texel calculation will be
    when we zoom into small details of a texture; but the greater
@@ -26,6 +36,10 @@ typedef unsigned int ZPOINT;
    a 32-bit int.  We need to preallocate mipmap arrays of this size. */
 #define MAX_MIPMAP_LEVELS (32 - ZB_POINT_ST_FRAC_BITS + 1)
 
+/* The size of the square tiles in which a tiled texture is stored.  A
+   4x4 tile of 32-bit texels fills one 64-byte cache line. */
+#define ZB_TEXTURE_TILE_BITS 2
+
 /* Returns the index within a texture level for the given (s, t) texel. */
 #define ZB_TEXEL(texture_level, s, t)                                   \
   ((((t) & (texture_level).t_mask) >> (texture_level).t_shift) |      \
@@ -37,6 +51,17 @@ typedef unsigned int ZPOINT;
 #define ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level) \
   (texture_def)->levels[(level)].pixmap[ZB_TEXEL((texture_def)->levels[(level)], s, t)]
 
+/* Like ZB_TEXEL, but also works for a texture level that is stored in
+   tiles (see ZTextureLevel).  For a level stored row by row, the tile
+   masks are zero and this returns the same index as ZB_TEXEL. */
+#define ZB_TILED_TEXEL(texture_level, s, t)                             \
+  (ZB_TEXEL(texture_level, s, t) |                                      \
+   (((t) & (texture_level).t_tile_mask) >> (texture_level).t_tile_shift) | \
+   (((s) & (texture_level).s_tile_mask) >> (texture_level).s_tile_shift))
+
+#define ZB_LOOKUP_TEXTURE_TILED(texture_def, s, t, level) \
+  (texture_def)->levels[(level)].pixmap[ZB_TILED_TEXEL((texture_def)->levels[(level)], s, t)]
+
 /* A special abs() function which doesn't require any branching
    instructions.  Might not work on some exotic hardware. */
 
@@ -129,9 +154,17 @@ typedef unsigned int PIXEL;
   _BLEND_SRGB(PIXEL_SR(rgb), PIXEL_SG(rgb), PIXEL_SB(rgb), PIXEL_A(rgb), r, g, b, a)
 
 
+/* One mipmap level of a texture.  Normally the texels are stored row by
+   row, but a texture may also be stored in small square tiles of texels,
+   one row of tiles after the other, so that the four texels read by a
+   bilinear filter are usually in the same cache line.  In that case,
+   s_mask and t_mask select the tile, and s_tile_mask and t_tile_mask the
+   texel within the tile; otherwise, the tile masks are zero.  Tiled
+   textures may only be sampled with ZB_TILED_TEXEL. */
 typedef struct {
   PIXEL *pixmap;
   unsigned int s_mask, s_shift, t_mask, t_shift;
+  unsigned int s_tile_mask, s_tile_shift, t_tile_mask, t_tile_shift;
 } ZTextureLevel;
 
 typedef struct ZBuffer ZBuffer;
@@ -146,6 +179,22 @@ typedef PIXEL (*ZB_lookupTextureFunc)(ZTextureDef *texture_def, int s, int t, un
 
 typedef int (*ZB_texWrapFunc)(int coord, int max_coord);
 
+/* The number of pixels drawn by each kind of triangle function, for PStats. */
+typedef struct {
+  int white_untextured;
+  int flat_untextured;
+  int smooth_untextured;
+  int white_textured;
+  int flat_textured;
+  int smooth_textured;
+  int white_perspective;
+  int flat_perspective;
+  int smooth_perspective;
+  int smooth_multitex2;
+  int smooth_multitex3;
+  int occluded;
+} ZPixelCounts;
+
 struct ZTextureDef {
   ZTextureLevel *levels;
   ZB_lookupTextureFunc tex_minfilter_func;
@@ -174,6 +223,24 @@ struct ZBuffer {
   int reference_alpha;
   int blend_r, blend_g, blend_b, blend_a;
   ZB_storePixelFunc store_pix_func;
+
+  /* The triangle functions only draw the rows band_ymin <= y < band_ymax.
+     This is normally the whole buffer, but a copy of the ZBuffer may be
+     restricted to a band of rows, so that several threads can each draw
+     their own part of the same triangles. */
+  int band_ymin, band_ymax;
+
+  /* The hierarchical depth buffer holds the smallest depth value within each
+     block of ZB_HIZ_BLOCK_SIZE x ZB_HIZ_BLOCK_SIZE pixels, so that the
+     triangle functions can skip the rows of a depth-tested triangle that
+     can't pass the depth test anywhere.  Writing to the depth buffer just
+     marks a block dirty; its value is recomputed when it is next needed. */
+  int hiz_enabled;
+  int hiz_xsize, hiz_ysize;
+  ZPOINT *hiz_buf;
+  unsigned char *hiz_dirty;
+
+  ZPixelCounts pixel_counts;
 };
 
 struct ZBufferPoint {
@@ -193,24 +260,21 @@ struct ZBufferPoint {
 /* zbuffer.c */
 
 #ifdef DO_PSTATS
-extern int pixel_count_white_untextured;
-extern int pixel_count_flat_untextured;
-extern int pixel_count_smooth_untextured;
-extern int pixel_count_white_textured;
-extern int pixel_count_flat_textured;
-extern int pixel_count_smooth_textured;
-extern int pixel_count_white_perspective;
-extern int pixel_count_flat_perspective;
-extern int pixel_count_smooth_perspective;
-extern int pixel_count_smooth_multitex2;
-extern int pixel_count_smooth_multitex3;
-
-#define COUNT_PIXELS(pixel_count, p0, p1, p2) \
-  (pixel_count) += abs((p0)->x * ((p1)->y - (p2)->y) + (p1)->x * ((p2)->y - (p0)->y) + (p2)->x * ((p0)->y - (p1)->y)) / 2
+
+/* A triangle is counted only in the band that contains its topmost row, so
+   that the counts don't depend on how it was divided up. */
+#define COUNT_PIXELS(zb, pixel_count, p0, p1, p2)                       \
+  if ((p0)->y >= (zb)->band_ymin) {                                     \
+    (zb)->pixel_counts.pixel_count += abs((p0)->x * ((p1)->y - (p2)->y) + (p1)->x * ((p2)->y - (p0)->y) + (p2)->x * ((p0)->y - (p1)->y)) / 2; \
+  }
+
+#define COUNT_OCCLUDED_PIXELS(zb, count)         \
+  (zb)->pixel_counts.occluded += (count);
 
 #else
 
-#define COUNT_PIXELS(pixel_count, p0, p1, p2)
+#define COUNT_PIXELS(zb, pixel_count, p0, p1, p2)
+#define COUNT_OCCLUDED_PIXELS(zb, count)
 
 #endif  // DO_PSTATS
 
@@ -228,6 +292,121 @@ void ZB_clear(ZBuffer *zb, int clear_z, ZPOINT z, int clear_color, PIXEL color);
 void ZB_clear_viewport(ZBuffer * zb, int clear_z, ZPOINT z, int clear_color, PIXEL color,
                        int xmin, int ymin, int xsize, int ysize);
 
+void ZB_hiz_mark_dirty(ZBuffer *zb, int xmin, int ymin, int xmax, int ymax);
+void ZB_hiz_update_block(ZBuffer *zb, int bx, int by);
+
+/* Returns the greatest depth value, in depth buffer units, that the triangle
+   functions may write for a triangle with the given vertices and depth
+   gradients, or 0 if the hierarchical depth buffer shouldn't be used.  Each
+   depth value is computed exactly as p->z + dzdx * (x - p->x) +
+   dzdy * (y - p->y) from one of the vertices, and the pixels may extend up to
+   one column past the triangle's bounding box. */
+static inline ZPOINT
+ZB_hiz_triangle_limit(const ZBuffer *zb, const ZBufferPoint *p0,
+                      const ZBufferPoint *p1, const ZBufferPoint *p2,
+                      int dzdx, int dzdy) {
+  const ZBufferPoint *p[3] = { p0, p1, p2 };
+  long long zmin, zmax;
+  int xmin, xmax, ymin, ymax, i;
+
+  if (!zb->hiz_enabled) {
+    return 0;
+  }
+
+  xmin = std::min(std::min(p0->x, p1->x), p2->x) - 1;
+  xmax = std::max(std::max(p0->x, p1->x), p2->x) + 1;
+  ymin = std::min(std::min(p0->y, p1->y), p2->y);
+  ymax = std::max(std::max(p0->y, p1->y), p2->y);
+
+  zmin = zmax = p0->z;
+  for (i = 0; i < 3; ++i) {
+    long long dx0 = (long long)dzdx * (xmin - p[i]->x);
+    long long dx1 = (long long)dzdx * (xmax - p[i]->x);
+    long long dy0 = (long long)dzdy * (ymin - p[i]->y);
+    long long dy1 = (long long)dzdy * (ymax - p[i]->y);
+    zmin = std::min(zmin, p[i]->z + std::min(dx0, dx1) + std::min(dy0, dy1));
+    zmax = std::max(zmax, p[i]->z + std::max(dx0, dx1) + std::max(dy0, dy1));
+  }
+
+  if (zmin < 0 || zmax >= 0x80000000LL) {
+    /* the depth values might wrap around */
+    return 0;
+  }
+  return (ZPOINT)(zmax >> ZB_POINT_Z_FRAC_BITS);
+}
+
+/* Returns true if no pixel in the indicated rectangle (inclusive) can pass
+   a "less" depth test with a depth value of z or less, according to the
+   hierarchical depth buffer. */
+static inline int
+ZB_hiz_occluded(ZBuffer *zb, int xmin, int ymin, int xmax, int ymax, ZPOINT z) {
+  int bx, by, bxmin, bxmax, bymin, bymax;
+
+  xmin = std::max(xmin, 0);
+  ymin = std::max(ymin, 0);
+  xmax = std::min(xmax, zb->xsize - 1);
+  ymax = std::min(ymax, zb->ysize - 1);
+  if (xmin > xmax || ymin > ymax) {
+    return 0;
+  }
+
+  bxmin = xmin >> ZB_HIZ_BLOCK_BITS;
+  bxmax = xmax >> ZB_HIZ_BLOCK_BITS;
+  bymin = ymin >> ZB_HIZ_BLOCK_BITS;
+  bymax = ymax >> ZB_HIZ_BLOCK_BITS;
+  for (by = bymin; by <= bymax; ++by) {
+    int row = by * zb->hiz_xsize;
+    for (bx = bxmin; bx <= bxmax; ++bx) {
+      if (zb->hiz_dirty[row + bx]) {
+        ZB_hiz_update_block(zb, bx, by);
+      }
+      if (zb->hiz_buf[row + bx] < z) {
+        return 0;
+      }
+    }
+  }
+  return 1;
+}
+
+/* Marks the blocks touched by the indicated span of a row dirty, after the
+   depth values in it have been written. */
+static inline void
+ZB_hiz_mark_span(ZBuffer *zb, int xmin, int xmax, int y) {
+  xmin = std::max(xmin, 0);
+  xmax = std::min(xmax, zb->xsize - 1);
+  if (xmin <= xmax) {
+    int bxmin = xmin >> ZB_HIZ_BLOCK_BITS;
+    memset(zb->hiz_dirty + (y >> ZB_HIZ_BLOCK_BITS) * zb->hiz_xsize + bxmin, 1,
+           (xmax >> ZB_HIZ_BLOCK_BITS) - bxmin + 1);
+  }
+}
+
+#ifdef TGL_FEATURE_SSE2
+
+/* Helpers for the triangle functions that draw four pixels at once. */
+
+/* Returns v, v + dvdx, v + 2 * dvdx, v + 3 * dvdx. */
+static inline __m128i
+ZB_ramp4(unsigned int v, int dvdx) {
+  unsigned int d = (unsigned int)dvdx;
+  return _mm_set_epi32((int)(v + 3 * d), (int)(v + 2 * d), (int)(v + d), (int)v);
+}
+
+/* Returns a where mask is set, b elsewhere. */
+static inline __m128i
+ZB_select4(__m128i mask, __m128i a, __m128i b) {
+  return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+/* Compares the unsigned values a < b. */
+static inline __m128i
+ZB_cmplt4(__m128i a, __m128i b) {
+  const __m128i bias = _mm_set1_epi32((int)0x80000000);
+  return _mm_cmplt_epi32(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+}
+
+#endif  /* TGL_FEATURE_SSE2 */
+
 PIXEL lookup_texture_nearest(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx);
 PIXEL lookup_texture_bilinear(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx);
 PIXEL lookup_texture_mipmap_nearest(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx);
@@ -39,6 +39,12 @@
 /* Number of simultaneous texture stages supported (multitexture). */
 #define MAX_TEXTURE_STAGES 3
 
+/* SSE2 is used to process several vertices or pixels at once, when the
+   compiler is allowed to use it. */
+#if defined(__SSE2__) || (_M_IX86_FP >= 2) || defined(_M_X64) || defined(_M_AMD64)
+#define TGL_FEATURE_SSE2 1
+#endif
+
 #ifdef __GNUC__
 #define UNUSED __attribute__((unused))
 #else
@@ -11,6 +11,12 @@
 #include "zmath.h"
 #include "zfeatures.h"
 
+/* the batched vertex functions process four vertices at a time with SSE2,
+   when it is available and PN_stdfloat is a float */
+#if defined(TGL_FEATURE_SSE2) && !defined(STDFLOAT_DOUBLE)
+#define HAVE_TINYDISPLAY_SSE2 1
+#endif
+
 /* initially # of allocated GLVertexes (will grow when necessary) */
 #define POLYGON_MAX_VERTEX 16
 
@@ -129,9 +135,13 @@ typedef struct GLTexture {
 
   void *allocated_buffer;
   int total_bytecount;
+
+  /* True if the levels are stored in tiles; see ZTextureLevel. */
+  int tiled;
 } GLTexture;
 
 struct GLContext;
+class TinyTileBinner;
 
 typedef void (*gl_draw_triangle_func)(struct GLContext *c,
                                       GLVertex *p0,GLVertex *p1,GLVertex *p2);
@@ -180,6 +190,13 @@ typedef struct GLContext {
   gl_draw_triangle_func draw_triangle_front,draw_triangle_back;
   ZB_fillTriangleFunc zb_fill_tri;
 
+  /* if set, filled triangles are handed to this object to be drawn later by
+     several threads, rather than being drawn immediately */
+  TinyTileBinner *tile_binner;
+
+  /* if set, the batched vertex functions may use SIMD instructions */
+  int simd_vertices;
+
   /* current vertex state */
   V4 current_color;
   V4 current_normal;
@@ -217,10 +234,12 @@ void gl_draw_triangle_fill(GLContext *c,
 /* light.c */
 void gl_enable_disable_light(GLContext *c,int light,int v);
 void gl_shade_vertex(GLContext *c,GLVertex *v);
+void gl_shade_vertex_batch(GLContext *c,GLVertex *v,int count);
 
 /* vertex.c */
 void gl_eval_viewport(GLContext *c);
 void gl_vertex_transform(GLContext * c, GLVertex * v);
+void gl_vertex_transform_batch(GLContext * c, GLVertex * v, int count);
 
 /* image_util.c */
 void gl_convertRGB_to_5R6G5B(unsigned short *pixmap,unsigned char *rgb,
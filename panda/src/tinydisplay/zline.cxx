@@ -16,6 +16,7 @@ ZB_plot(ZBuffer * zb, ZBufferPoint * p) {
   if (ZCMP(zz, *pz)) {
     *pp = RGB_TO_PIXEL(p->r, p->g, p->b);
     *pz = zz;
+    ZB_hiz_mark_dirty(zb, p->x, p->y, p->x, p->y);
   }
 }
 
@@ -55,6 +56,9 @@ ZB_line_z(ZBuffer * zb, ZBufferPoint * p1, ZBufferPoint * p2) {
   color1 = RGBA_TO_PIXEL(p1->r, p1->g, p1->b, p1->a);
   color2 = RGBA_TO_PIXEL(p2->r, p2->g, p2->b, p2->a);
 
+  ZB_hiz_mark_dirty(zb, std::min(p1->x, p2->x), std::min(p1->y, p2->y),
+                    std::max(p1->x, p2->x), std::max(p1->y, p2->y));
+
   /* choose if the line should have its color interpolated or not */
   if (color1 == color2) {
     ZB_line_flat_z(zb, p1, p2, color1);
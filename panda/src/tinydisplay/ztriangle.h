@@ -8,6 +8,10 @@
   ZPOINT *pz1;
   PIXEL *pp1;
   int part, update_left, update_right;
+  int y, draw_row;
+#ifdef DEPTH_TEST
+  ZPOINT hiz_z = 0;
+#endif
 
   int nb_lines, dx1, dy1, tmp, dx2, dy2;
 
@@ -53,8 +57,6 @@
 
   EARLY_OUT();
 
-  COUNT_PIXELS(PIXEL_COUNT, p0, p1, p2);
-
   /* we sort the vertex with increasing y */
   if (p1->y < p0->y) {
     t = p0;
@@ -72,6 +74,10 @@
     p2 = t;
   }
 
+  /* skip the triangle if it doesn't touch the band of rows we may draw */
+  if (p0->y >= zb->band_ymax || p2->y < zb->band_ymin)
+    return;
+
   /* we compute dXdx and dXdy for all interpolated values */
   
   fdx1 = (PN_stdfloat) (p1->x - p0->x);
@@ -97,6 +103,22 @@
   dzdy = (int) (fdx1 * d2 - fdx2 * d1);
 #endif
 
+#if defined(INTERP_Z) && defined(DEPTH_TEST)
+  /* skip the triangle if it is hidden by what has already been drawn in the
+     rows of the band */
+  hiz_z = ZB_hiz_triangle_limit(zb, p0, p1, p2, dzdx, dzdy);
+  if (hiz_z != 0 &&
+      ZB_hiz_occluded(zb, std::min(std::min(p0->x, p1->x), p2->x) - 1,
+                      std::max(p0->y, zb->band_ymin),
+                      std::max(std::max(p0->x, p1->x), p2->x) + 1,
+                      std::min(p2->y, zb->band_ymax - 1), hiz_z)) {
+    COUNT_PIXELS(zb, occluded, p0, p1, p2);
+    return;
+  }
+#endif
+
+  COUNT_PIXELS(zb, PIXEL_COUNT, p0, p1, p2);
+
 #ifdef INTERP_RGB
   d1 = (PN_stdfloat) (p1->r - p0->r);
   d2 = (PN_stdfloat) (p2->r - p0->r);
@@ -213,6 +235,7 @@
 
   pp1 = (PIXEL *) ((char *) zb->pbuf + zb->linesize * p0->y);
   pz1 = zb->zbuf + p0->y * zb->xsize;
+  y = p0->y;
 
   DRAW_INIT();
 
@@ -341,9 +364,24 @@
 
     while (nb_lines>0) {
       nb_lines--;
+      if (y >= zb->band_ymax) {
+        /* the rest of the triangle is below the band */
+        return;
+      }
+      /* rows above the band are not drawn, but the edges are still stepped
+         across them so that the rows we do draw come out exactly the same */
+      draw_row = (y >= zb->band_ymin);
+#if defined(INTERP_Z) && defined(DEPTH_TEST)
+      if (draw_row && hiz_z != 0 &&
+          ZB_hiz_occluded(zb, x1, y, x2 >> 16, y, hiz_z)) {
+        /* every pixel of the row would fail the depth test */
+        COUNT_OCCLUDED_PIXELS(zb, (x2 >> 16) - x1 + 1);
+        draw_row = 0;
+      }
+#endif
 #ifndef DRAW_LINE
       /* generic draw line */
-      {
+      if (draw_row) {
         PIXEL *pp;
         int n;
 #ifdef INTERP_Z
@@ -395,10 +433,14 @@
         tzb=tzb1;
 #endif
         while (n>=3) {
+#ifdef PUT_PIXEL4
+          PUT_PIXEL4();
+#else
           PUT_PIXEL(0);
           PUT_PIXEL(1);
           PUT_PIXEL(2);
           PUT_PIXEL(3);
+#endif
 #ifdef INTERP_Z
           pz+=4;
 #endif
@@ -415,7 +457,14 @@
         }
       }
 #else
-      DRAW_LINE();
+      if (draw_row) {
+        DRAW_LINE();
+      }
+#endif
+#ifdef DEPTH_WRITE
+      if (draw_row) {
+        ZB_hiz_mark_span(zb, x1, x2 >> 16, y);
+      }
 #endif
       
       /* left edge */
@@ -483,6 +532,7 @@
       /* screen coordinates */
       pp1=(PIXEL *)((char *)pp1 + zb->linesize);
       pz1+=zb->xsize;
+      y++;
     }
   }
 }
@@ -499,4 +549,5 @@
 #undef DRAW_INIT
 #undef DRAW_LINE  
 #undef PUT_PIXEL
+#undef PUT_PIXEL4
 #undef PIXEL_COUNT
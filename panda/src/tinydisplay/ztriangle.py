@@ -56,11 +56,11 @@ FullOptions = Options + ExtraOptions
 
 CodeTable = {
     # depth write
-    'zon' : '#define STORE_Z(zpix, z) (zpix) = (z)',
+    'zon' : '#define STORE_Z(zpix, z) (zpix) = (z)\n#define DEPTH_WRITE',
     'zoff' : '#define STORE_Z(zpix, z)',
 
     # color write
-    'cstore' : '#define STORE_PIX(pix, rgb, r, g, b, a) (pix) = (rgb)',
+    'cstore' : '#define STORE_PIX(pix, rgb, r, g, b, a) (pix) = (rgb)\n#define COLOR_STORE',
     'cblend' : '#define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_RGB(pix, r, g, b, a)',
     'cgeneral' : '#define STORE_PIX(pix, rgb, r, g, b, a) zb->store_pix_func(zb, pix, r, g, b, a)',
     'coff' : '#define STORE_PIX(pix, rgb, r, g, b, a)',
@@ -70,13 +70,13 @@ CodeTable = {
     'csblend' : '#define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)',
 
     # alpha test
-    'anone' : '#define ACMP(zb, a) 1',
+    'anone' : '#define ACMP(zb, a) 1\n#define NO_ALPHA_TEST',
     'aless' : '#define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)',
     'amore' : '#define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)',
 
     # depth test
     'znone' : '#define ZCMP(zpix, z) 1',
-    'zless' : '#define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))',
+    'zless' : '#define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))\n#define DEPTH_TEST',
 
     # texture filters
     'tnearest' : '#define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)\n#define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)',
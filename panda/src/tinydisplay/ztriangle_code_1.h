@@ -1,8 +1,11 @@
 /* This file is generated code--do not edit.  See ztriangle.py. */
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = (rgb)
+#define COLOR_STORE
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) 1
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
@@ -10,8 +13,11 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = (rgb)
+#define COLOR_STORE
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) 1
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
@@ -20,8 +26,11 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = (rgb)
+#define COLOR_STORE
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) 1
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
@@ -30,18 +39,26 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = (rgb)
+#define COLOR_STORE
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zon_cstore_anone_zless_tnearest_ ## name
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = (rgb)
+#define COLOR_STORE
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -49,9 +66,13 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = (rgb)
+#define COLOR_STORE
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -59,7 +80,9 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = (rgb)
+#define COLOR_STORE
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
@@ -68,7 +91,9 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = (rgb)
+#define COLOR_STORE
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
@@ -78,7 +103,9 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = (rgb)
+#define COLOR_STORE
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
@@ -88,18 +115,24 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = (rgb)
+#define COLOR_STORE
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zon_cstore_aless_zless_tnearest_ ## name
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = (rgb)
+#define COLOR_STORE
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -107,9 +140,12 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = (rgb)
+#define COLOR_STORE
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -117,7 +153,9 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = (rgb)
+#define COLOR_STORE
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
@@ -126,7 +164,9 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = (rgb)
+#define COLOR_STORE
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
@@ -136,7 +176,9 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = (rgb)
+#define COLOR_STORE
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
@@ -146,18 +188,24 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = (rgb)
+#define COLOR_STORE
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zon_cstore_amore_zless_tnearest_ ## name
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = (rgb)
+#define COLOR_STORE
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -165,9 +213,12 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = (rgb)
+#define COLOR_STORE
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -175,8 +226,10 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_RGB(pix, r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) 1
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
@@ -184,8 +237,10 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_RGB(pix, r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) 1
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
@@ -194,8 +249,10 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_RGB(pix, r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) 1
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
@@ -204,18 +261,24 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_RGB(pix, r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zon_cblend_anone_zless_tnearest_ ## name
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_RGB(pix, r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -223,9 +286,12 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_RGB(pix, r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -233,6 +299,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_RGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -242,6 +309,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_RGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -252,6 +320,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_RGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -262,18 +331,22 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_RGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zon_cblend_aless_zless_tnearest_ ## name
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_RGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -281,9 +354,11 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_RGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -291,6 +366,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_RGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -300,6 +376,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_RGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -310,6 +387,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_RGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -320,18 +398,22 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_RGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zon_cblend_amore_zless_tnearest_ ## name
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_RGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -339,9 +421,11 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_RGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -349,8 +433,10 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) zb->store_pix_func(zb, pix, r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) 1
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
@@ -358,8 +444,10 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) zb->store_pix_func(zb, pix, r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) 1
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
@@ -368,8 +456,10 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) zb->store_pix_func(zb, pix, r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) 1
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
@@ -378,18 +468,24 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) zb->store_pix_func(zb, pix, r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zon_cgeneral_anone_zless_tnearest_ ## name
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) zb->store_pix_func(zb, pix, r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -397,9 +493,12 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) zb->store_pix_func(zb, pix, r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -407,6 +506,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) zb->store_pix_func(zb, pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -416,6 +516,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) zb->store_pix_func(zb, pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -426,6 +527,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) zb->store_pix_func(zb, pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -436,18 +538,22 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) zb->store_pix_func(zb, pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zon_cgeneral_aless_zless_tnearest_ ## name
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) zb->store_pix_func(zb, pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -455,9 +561,11 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) zb->store_pix_func(zb, pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -465,6 +573,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) zb->store_pix_func(zb, pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -474,6 +583,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) zb->store_pix_func(zb, pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -484,6 +594,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) zb->store_pix_func(zb, pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -494,18 +605,22 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) zb->store_pix_func(zb, pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zon_cgeneral_amore_zless_tnearest_ ## name
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) zb->store_pix_func(zb, pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -513,9 +628,11 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) zb->store_pix_func(zb, pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
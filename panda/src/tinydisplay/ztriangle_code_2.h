@@ -1,8 +1,10 @@
 /* This file is generated code--do not edit.  See ztriangle.py. */
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) 1
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
@@ -10,8 +12,10 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) 1
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
@@ -20,8 +24,10 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) 1
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
@@ -30,18 +36,24 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zon_coff_anone_zless_tnearest_ ## name
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -49,9 +61,12 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -59,6 +74,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -68,6 +84,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -78,6 +95,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -88,18 +106,22 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zon_coff_aless_zless_tnearest_ ## name
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -107,9 +129,11 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -117,6 +141,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -126,6 +151,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -136,6 +162,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -146,18 +173,22 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zon_coff_amore_zless_tnearest_ ## name
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -165,9 +196,11 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -175,8 +208,10 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) 1
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
@@ -184,8 +219,10 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) 1
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
@@ -194,8 +231,10 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) 1
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
@@ -204,18 +243,24 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zon_csstore_anone_zless_tnearest_ ## name
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -223,9 +268,12 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -233,6 +281,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -242,6 +291,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -252,6 +302,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -262,18 +313,22 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zon_csstore_aless_zless_tnearest_ ## name
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -281,9 +336,11 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -291,6 +348,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -300,6 +358,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -310,6 +369,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -320,18 +380,22 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zon_csstore_amore_zless_tnearest_ ## name
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -339,9 +403,11 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = SRGBA_TO_PIXEL(r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -349,8 +415,10 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) 1
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
@@ -358,8 +426,10 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) 1
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
@@ -368,8 +438,10 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) 1
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
@@ -378,18 +450,24 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zon_csblend_anone_zless_tnearest_ ## name
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -397,9 +475,12 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) 1
+#define NO_ALPHA_TEST
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -407,6 +488,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -416,6 +498,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -426,6 +509,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -436,18 +520,22 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zon_csblend_aless_zless_tnearest_ ## name
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -455,9 +543,11 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) < (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -465,6 +555,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -474,6 +565,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -484,6 +576,7 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) 1
@@ -494,18 +587,22 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
 #define FNAME(name) FB_triangle_zon_csblend_amore_zless_tnearest_ ## name
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
@@ -513,9 +610,11 @@
 #include "ztriangle_two.h"
 
 #define STORE_Z(zpix, z) (zpix) = (z)
+#define DEPTH_WRITE
 #define STORE_PIX(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_SRGB(pix, r, g, b, a)
 #define ACMP(zb, a) (((int)(a)) > (zb)->reference_alpha)
 #define ZCMP(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define DEPTH_TEST
 #define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
 #define INTERP_MIPMAP
 #define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
@@ -4,6 +4,40 @@
 #pragma GCC diagnostic ignored "-Wunused-but-set-variable"
 #endif
 
+/* When the color is simply stored, the untextured triangle functions draw
+   four pixels at a time with SSE2.  These do the same as four PUT_PIXEL()
+   calls. */
+#if defined(TGL_FEATURE_SSE2) && defined(COLOR_STORE)
+#ifdef DEPTH_TEST
+#define ZCMP4(zpix, z) ZB_cmplt4(zpix, z)
+#else
+#define ZCMP4(zpix, z) _mm_set1_epi32(-1)
+#endif
+
+#ifdef DEPTH_WRITE
+#define STORE_Z4(pz, zpix, z, mask) \
+  _mm_storeu_si128((__m128i *)(pz), ZB_select4(mask, z, zpix))
+#else
+#define STORE_Z4(pz, zpix, z, mask)
+#endif
+
+#define STORE_PIX4(pp, rgb, mask)                                       \
+  _mm_storeu_si128((__m128i *)(pp),                                     \
+                   ZB_select4(mask, rgb, _mm_loadu_si128((__m128i *)(pp))))
+
+#define PUT_PIXEL4_RGB(rgb4)                                            \
+  {                                                                     \
+    __m128i zpix4 = _mm_loadu_si128((__m128i *)pz);                     \
+    __m128i zz4 = _mm_srli_epi32(ZB_ramp4(z, dzdx), ZB_POINT_Z_FRAC_BITS); \
+    __m128i mask4 = ZCMP4(zpix4, zz4);                                  \
+    if (_mm_movemask_epi8(mask4) != 0) {                                \
+      STORE_PIX4(pp, (rgb4), mask4);                                    \
+      STORE_Z4(pz, zpix4, zz4, mask4);                                  \
+    }                                                                   \
+    z+=4*(unsigned int)dzdx;                                            \
+  }
+#endif
+
 static void
 FNAME(white_untextured) (ZBuffer *zb,
                          ZBufferPoint *p0,ZBufferPoint *p1,ZBufferPoint *p2)
@@ -28,7 +62,11 @@ FNAME(white_untextured) (ZBuffer *zb,
     z+=dzdx;                                                            \
   }
 
-#define PIXEL_COUNT pixel_count_white_untextured
+#ifdef PUT_PIXEL4_RGB
+#define PUT_PIXEL4() PUT_PIXEL4_RGB(_mm_set1_epi32(-1))
+#endif
+
+#define PIXEL_COUNT white_untextured
 
 #include "ztriangle.h"
 }
@@ -68,7 +106,11 @@ FNAME(flat_untextured) (ZBuffer *zb,
     z+=dzdx;                                            \
   }
 
-#define PIXEL_COUNT pixel_count_flat_untextured
+#ifdef PUT_PIXEL4_RGB
+#define PUT_PIXEL4() PUT_PIXEL4_RGB(_mm_set1_epi32(color))
+#endif
+
+#define PIXEL_COUNT flat_untextured
 
 #include "ztriangle.h"
 }
@@ -118,7 +160,28 @@ FNAME(smooth_untextured) (ZBuffer *zb,
     oa1+=dadx;                                                          \
   }
 
-#define PIXEL_COUNT pixel_count_smooth_untextured
+#if defined(PUT_PIXEL4_RGB) && defined(NO_ALPHA_TEST)
+/* RGBA_TO_PIXEL() of four pixels */
+#define PUT_PIXEL4()                                                    \
+  {                                                                     \
+    __m128i r4 = ZB_ramp4(or1, drdx);                                   \
+    __m128i g4 = ZB_ramp4(og1, dgdx);                                   \
+    __m128i b4 = ZB_ramp4(ob1, dbdx);                                   \
+    __m128i a4 = ZB_ramp4(oa1, dadx);                                   \
+    __m128i rgb4 =                                                      \
+      _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_slli_epi32(a4, 16), _mm_set1_epi32((int)0xff000000)), \
+                                _mm_and_si128(_mm_slli_epi32(r4, 8), _mm_set1_epi32(0xff0000))), \
+                   _mm_or_si128(_mm_and_si128(g4, _mm_set1_epi32(0xff00)), \
+                                _mm_srli_epi32(b4, 8)));                \
+    PUT_PIXEL4_RGB(rgb4);                                               \
+    og1+=4*(unsigned int)dgdx;                                          \
+    or1+=4*(unsigned int)drdx;                                          \
+    ob1+=4*(unsigned int)dbdx;                                          \
+    oa1+=4*(unsigned int)dadx;                                          \
+  }
+#endif
+
+#define PIXEL_COUNT smooth_untextured
 
 #include "ztriangle.h"
 }
@@ -156,7 +219,7 @@ FNAME(white_textured) (ZBuffer *zb,
     t+=dtdx;                                                            \
   }
 
-#define PIXEL_COUNT pixel_count_white_textured
+#define PIXEL_COUNT white_textured
 
 #include "ztriangle.h"
 }
@@ -212,7 +275,7 @@ FNAME(flat_textured) (ZBuffer *zb,
     t+=dtdx;                                                            \
   }
 
-#define PIXEL_COUNT pixel_count_flat_textured
+#define PIXEL_COUNT flat_textured
 
 #include "ztriangle.h"
 }
@@ -278,7 +341,7 @@ FNAME(smooth_textured) (ZBuffer *zb,
     t+=dtdx;                                                            \
   }
 
-#define PIXEL_COUNT pixel_count_smooth_textured
+#define PIXEL_COUNT smooth_textured
 
 #include "ztriangle.h"
 }
@@ -390,7 +453,7 @@ FNAME(white_perspective) (ZBuffer *zb,
     }                                                           \
   }
   
-#define PIXEL_COUNT pixel_count_white_perspective
+#define PIXEL_COUNT white_perspective
 
 #include "ztriangle.h"
 }
@@ -521,7 +584,7 @@ FNAME(flat_perspective) (ZBuffer *zb,
     }                                                           \
   }
 
-#define PIXEL_COUNT pixel_count_flat_perspective
+#define PIXEL_COUNT flat_perspective
 
 #include "ztriangle.h"
 }
@@ -661,7 +724,7 @@ FNAME(smooth_perspective) (ZBuffer *zb,
     }                                                           \
   }
 
-#define PIXEL_COUNT pixel_count_smooth_perspective
+#define PIXEL_COUNT smooth_perspective
 
 #include "ztriangle.h"
 }
@@ -816,7 +879,7 @@ FNAME(smooth_multitex2) (ZBuffer *zb,
     }                                                                   \
   }
 
-#define PIXEL_COUNT pixel_count_smooth_multitex2
+#define PIXEL_COUNT smooth_multitex2
 
 #include "ztriangle.h"
 }
@@ -1001,7 +1064,7 @@ FNAME(smooth_multitex3) (ZBuffer *zb,
     }                                                                   \
   }
 
-#define PIXEL_COUNT pixel_count_smooth_multitex3
+#define PIXEL_COUNT smooth_multitex3
 
 #include "ztriangle.h"
 }
@@ -1011,6 +1074,14 @@ FNAME(smooth_multitex3) (ZBuffer *zb,
 #undef STORE_PIX
 #undef STORE_Z
 #undef FNAME
+#undef DEPTH_WRITE
+#undef DEPTH_TEST
+#undef COLOR_STORE
+#undef NO_ALPHA_TEST
+#undef ZCMP4
+#undef STORE_Z4
+#undef STORE_PIX4
+#undef PUT_PIXEL4_RGB
 #undef INTERP_MIPMAP
 #undef CALC_MIPMAP_LEVEL
 #undef ZB_LOOKUP_TEXTURE
@@ -19,8 +19,11 @@
 #include "config_egg2pg.h"
 #include "config_gobj.h"
 #include "config_chan.h"
+#include "animBundleNode.h"
+#include "animBundle.h"
 #include "pandaNode.h"
 #include "geomNode.h"
+#include "sceneGraphReducer.h"
 #include "renderState.h"
 #include "textureAttrib.h"
 #include "dcast.h"
@@ -105,6 +108,36 @@ EggToBam() :
      "written exactly as they are, losslessly.",
      &EggToBam::dispatch_none, &_compression_off);
 
+  add_option
+    ("qanim", "", 0,
+     "Store the animation channels in a compact, quantized form, which "
+     "omits the keyframes that can be interpolated from their neighbors "
+     "and stores each remaining key in 16-bit values.  This is lossy, "
+     "within the tolerances given by -qtol.  Unlike -C, it also reduces "
+     "the memory used by the animation when it is loaded.",
+     &EggToBam::dispatch_none, &_quantize_anims);
+
+  add_option
+    ("qtol", "pos,hpr,scale", 0,
+     "Specify the greatest error allowed by -qanim in the translation, in "
+     "model units; in the rotation, in degrees; and in the scale and shear.  "
+     "The default is 0.001,0.05,0.001.",
+     &EggToBam::dispatch_double_triple, nullptr, _quantize_tolerance);
+
+  add_option
+    ("vcache", "", 0,
+     "Reorder the triangles and vertices of each Geom for better use of the "
+     "post-transform vertex cache of the graphics card.  Triangle strips "
+     "and fans are converted to triangle lists.  The average cache miss "
+     "ratio (ACMR) before and after is reported.",
+     &EggToBam::dispatch_none, &_optimize_vertex_cache);
+
+  add_option
+    ("vcsize", "size", 0,
+     "Specify the number of entries in the vertex cache assumed by -vcache.  "
+     "The default is 32.",
+     &EggToBam::dispatch_int, nullptr, &_vertex_cache_size);
+
   add_option
     ("rawtex", "", 0,
      "Record texture data directly in the bam file, instead of storing "
@@ -212,6 +245,10 @@ EggToBam() :
   _egg_suppress_hidden = 1;
   _tex_txopz = false;
   _ctex_quality = "best";
+  _quantize_tolerance[0] = 0.001;
+  _quantize_tolerance[1] = 0.05;
+  _quantize_tolerance[2] = 0.001;
+  _vertex_cache_size = 32;
 }
 
 /**
@@ -262,6 +299,14 @@ run() {
     exit(1);
   }
 
+  if (_quantize_anims) {
+    quantize_anims(root);
+  }
+
+  if (_optimize_vertex_cache) {
+    optimize_vertex_cache(root);
+  }
+
   if (_tex_ctex) {
 #ifndef HAVE_SQUISH
     if (!make_buffer()) {
@@ -358,6 +403,84 @@ handle_args(ProgramBase::Args &args) {
   return EggToSomething::handle_args(args);
 }
 
+/**
+ * Recursively walks the scene graph, replacing the channels of each
+ * AnimBundle with quantized channels.
+ */
+void EggToBam::
+quantize_anims(PandaNode *node) {
+  if (node->is_of_type(AnimBundleNode::get_class_type())) {
+    AnimBundle *bundle = DCAST(AnimBundleNode, node)->get_bundle();
+    if (bundle != nullptr) {
+      bundle->quantize_channels(_quantize_tolerance[0], _quantize_tolerance[1],
+                                _quantize_tolerance[2]);
+    }
+  }
+
+  PandaNode::Children children = node->get_children();
+  int num_children = children.get_num_children();
+  for (int i = 0; i < num_children; ++i) {
+    quantize_anims(children.get_child(i));
+  }
+}
+
+/**
+ * Reorders the Geoms in the scene graph for the vertex cache, and reports the
+ * resulting change in the average cache miss ratio.
+ */
+void EggToBam::
+optimize_vertex_cache(PandaNode *root) {
+  double orig_misses = 0.0;
+  int orig_triangles = 0;
+  collect_acmr(root, orig_misses, orig_triangles);
+
+  SceneGraphReducer gr;
+  int num_geoms = gr.optimize_vertex_cache(root, _vertex_cache_size);
+
+  double new_misses = 0.0;
+  int new_triangles = 0;
+  collect_acmr(root, new_misses, new_triangles);
+
+  nout << "Optimized " << num_geoms << " Geoms for the vertex cache";
+  if (orig_triangles != 0 && new_triangles != 0) {
+    nout << "; ACMR " << orig_misses / orig_triangles
+         << " -> " << new_misses / new_triangles;
+  }
+  nout << "\n";
+}
+
+/**
+ * Recursively walks the scene graph, accumulating the number of vertex cache
+ * misses and the number of triangles of each Geom.
+ */
+void EggToBam::
+collect_acmr(PandaNode *node, double &num_misses, int &num_triangles) {
+  if (node->is_geom_node()) {
+    GeomNode *geom_node = DCAST(GeomNode, node);
+    int num_geoms = geom_node->get_num_geoms();
+    for (int i = 0; i < num_geoms; ++i) {
+      const Geom *geom = geom_node->get_geom(i);
+      if (geom->get_primitive_type() != Geom::PT_polygons) {
+        continue;
+      }
+
+      int geom_triangles = 0;
+      int num_primitives = geom->get_num_primitives();
+      for (int j = 0; j < num_primitives; ++j) {
+        geom_triangles += geom->get_primitive(j)->get_num_faces();
+      }
+      num_misses += geom->calc_acmr(_vertex_cache_size) * geom_triangles;
+      num_triangles += geom_triangles;
+    }
+  }
+
+  PandaNode::Children children = node->get_children();
+  int num_children = children.get_num_children();
+  for (int i = 0; i < num_children; ++i) {
+    collect_acmr(children.get_child(i), num_misses, num_triangles);
+  }
+}
+
 /**
  * Recursively walks the scene graph, looking for Texture references.
  */
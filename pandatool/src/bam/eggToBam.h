@@ -43,6 +43,9 @@ private:
   void collect_textures(PandaNode *node);
   void collect_textures(const RenderState *state);
   void convert_txo(Texture *tex);
+  void quantize_anims(PandaNode *node);
+  void optimize_vertex_cache(PandaNode *root);
+  void collect_acmr(PandaNode *node, double &num_misses, int &num_triangles);
 
   bool make_buffer();
 
@@ -59,6 +62,10 @@ private:
   bool _has_compression_quality;
   int _compression_quality;
   bool _compression_off;
+  bool _quantize_anims;
+  double _quantize_tolerance[3];
+  bool _optimize_vertex_cache;
+  int _vertex_cache_size;
   bool _tex_rawdata;
   bool _tex_txo;
   bool _tex_txopz;
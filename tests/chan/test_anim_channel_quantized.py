@@ -0,0 +1,143 @@
+from panda3d import core
+import math
+
+
+NUM_FRAMES = 60
+
+
+def reconstruct(object):
+    buffer = core.DatagramBuffer()
+
+    writer = core.BamWriter(buffer)
+    writer.init()
+    writer.write_object(object)
+
+    reader = core.BamReader(buffer)
+    reader.init()
+    object = reader.read_object()
+    reader.resolve()
+    return object
+
+
+def make_bundle():
+    bundle = core.AnimBundle("bundle", 30, NUM_FRAMES)
+    root = core.AnimChannelMatrixXfmTable(bundle, "root")
+    child = core.AnimChannelMatrixXfmTable(root, "child")
+
+    # The root moves smoothly, with a sudden jump halfway through.
+    frames = range(NUM_FRAMES)
+    root.set_table('x', core.PTA_float([f * 0.1 for f in frames]))
+    root.set_table('y', core.PTA_float([0 if f < 30 else 5 for f in frames]))
+    root.set_table('h', core.PTA_float([f * 6.0 for f in frames]))
+    root.set_table('p', core.PTA_float([30 * math.sin(f * 0.2) for f in frames]))
+
+    # The child has a constant scale and rotation.
+    child.set_table('i', core.PTA_float([2.0]))
+    child.set_table('r', core.PTA_float([45.0]))
+    child.set_table('z', core.PTA_float([1.0]))
+    return bundle
+
+
+def check_channels(orig, quantized, pos_tolerance=0.001, hpr_tolerance=0.05):
+    mat_tolerance = pos_tolerance + math.radians(hpr_tolerance) + 1e-4
+    for frame in range(NUM_FRAMES * 2):
+        pos1 = core.LVecBase3()
+        pos2 = core.LVecBase3()
+        orig.get_pos(frame, pos1)
+        quantized.get_pos(frame, pos2)
+        assert pos1.almost_equal(pos2, pos_tolerance * 1.01)
+
+        quat1 = core.LQuaternion()
+        quat2 = core.LQuaternion()
+        orig.get_quat(frame, quat1)
+        quantized.get_quat(frame, quat2)
+        quat1.normalize()
+        if quat1.dot(quat2) < 0:
+            quat2 = -quat2
+        diff = (quat1 - quat2).length()
+        sum = (quat1 + quat2).length()
+        assert math.degrees(4 * math.atan2(diff, sum)) < hpr_tolerance * 1.01
+
+        mat1 = core.LMatrix4()
+        mat2 = core.LMatrix4()
+        orig.get_value(frame, mat1)
+        quantized.get_value(frame, mat2)
+        assert mat1.almost_equal(mat2, mat_tolerance)
+
+
+def test_quantize_channels():
+    bundle = make_bundle()
+    orig_root = bundle.find_child("root")
+    orig_child = bundle.find_child("child")
+
+    quantized = bundle.copy_bundle()
+    quantized.quantize_channels()
+    root = quantized.find_child("root")
+    child = quantized.find_child("child")
+    assert isinstance(root, core.AnimChannelMatrixQuantized)
+    assert isinstance(child, core.AnimChannelMatrixQuantized)
+    assert root.get_num_children() == 1
+    assert root.get_child(0) == child
+
+    assert root.get_num_frames() == NUM_FRAMES
+    check_channels(orig_root, root)
+    check_channels(orig_child, child)
+
+    # The constant channel needs no keys at all, and the smooth motion of the
+    # root channel needs fewer keys than there are frames.
+    assert child.get_num_keys() == 0
+    assert root.get_num_keys() < NUM_FRAMES * 2
+
+
+def test_quantize_channels_tolerance():
+    bundle = make_bundle()
+    coarse = bundle.copy_bundle()
+    coarse.quantize_channels(0.01, 1.0, 0.01)
+    fine = bundle.copy_bundle()
+    fine.quantize_channels(0.0001, 0.01, 0.0001)
+
+    coarse_root = coarse.find_child("root")
+    fine_root = fine.find_child("root")
+    assert coarse_root.get_num_keys() < fine_root.get_num_keys()
+    check_channels(bundle.find_child("root"), coarse_root, 0.01, 1.0)
+    check_channels(bundle.find_child("root"), fine_root, 0.0001, 0.01)
+
+
+def test_quantized_channel_bam():
+    bundle = make_bundle()
+    bundle.quantize_channels()
+    bundle2 = reconstruct(bundle)
+
+    root = bundle.find_child("root")
+    root2 = bundle2.find_child("root")
+    assert isinstance(root2, core.AnimChannelMatrixQuantized)
+    assert root2.get_num_frames() == root.get_num_frames()
+    assert root2.get_num_keys() == root.get_num_keys()
+
+    for frame in range(NUM_FRAMES):
+        mat = core.LMatrix4()
+        mat2 = core.LMatrix4()
+        root.get_value(frame, mat)
+        root2.get_value(frame, mat2)
+        assert mat == mat2
+
+
+def test_quantized_channel_bam_max_frames():
+    # The most frames a channel may have, with a key on every one of them.
+    num_frames = 0xffff
+    bundle = core.AnimBundle("bundle", 30, num_frames)
+    root = core.AnimChannelMatrixXfmTable(bundle, "root")
+    root.set_table('x', core.PTA_float([(f % 2) * 10.0 for f in range(num_frames)]))
+    bundle.quantize_channels()
+
+    root = bundle.find_child("root")
+    assert root.get_num_frames() == num_frames
+    assert root.get_num_keys() == num_frames
+
+    root2 = reconstruct(bundle).find_child("root")
+    assert root2.get_num_frames() == num_frames
+    assert root2.get_num_keys() == num_frames
+    for frame in (0, 1, num_frames - 2, num_frames - 1):
+        pos = core.LVecBase3()
+        root2.get_pos(frame, pos)
+        assert pos.almost_equal(((frame % 2) * 10.0, 0, 0), 0.001)
@@ -0,0 +1,108 @@
+from panda3d import core
+
+
+def make_character(name):
+    character = core.Character(name)
+    bundle = character.get_bundle(0)
+    root = core.CharacterJoint(character, bundle, bundle, "root",
+                               core.LMatrix4.translate_mat(0, 0, 1))
+    child = core.CharacterJoint(character, bundle, root, "child",
+                                core.LMatrix4.translate_mat(0, 2, 0))
+    leaf = core.CharacterJoint(character, bundle, child, "leaf",
+                               core.LMatrix4.translate_mat(3, 0, 0))
+    return character, (root, child, leaf)
+
+
+def get_net_pos(joint):
+    mat = core.LMatrix4()
+    joint.get_net_transform(mat)
+    return mat.get_row3(3)
+
+
+def test_character_joint_update():
+    character, (root, child, leaf) = make_character("char")
+    character.force_update()
+    assert get_net_pos(root).almost_equal((0, 0, 1))
+    assert get_net_pos(child).almost_equal((0, 2, 1))
+    assert get_net_pos(leaf).almost_equal((3, 2, 1))
+
+    # Changing a joint moves its descendants too.
+    bundle = character.get_bundle(0)
+    assert bundle.freeze_joint("child", core.TransformState.make_pos((0, 5, 0)))
+    character.force_update()
+    assert get_net_pos(root).almost_equal((0, 0, 1))
+    assert get_net_pos(child).almost_equal((0, 5, 1))
+    assert get_net_pos(leaf).almost_equal((3, 5, 1))
+
+    # Joints added later are picked up as well.
+    extra = core.CharacterJoint(character, bundle, leaf, "extra",
+                                core.LMatrix4.translate_mat(0, 0, 4))
+    character.force_update()
+    assert get_net_pos(extra).almost_equal((3, 5, 5))
+
+
+def test_character_merge_bundles():
+    character, (root, child, leaf) = make_character("char")
+
+    other = core.Character("other")
+    other_bundle = other.get_bundle(0)
+    other_root = core.CharacterJoint(other, other_bundle, other_bundle, "root",
+                                     core.LMatrix4.translate_mat(0, 0, 1))
+    core.CharacterJoint(other, other_bundle, other_root, "other",
+                        core.LMatrix4.translate_mat(1, 0, 0))
+
+    # This builds the bundle's list of parts before the merge.
+    other.force_update()
+
+    # The joints missing from the other bundle are copied into it.
+    character.merge_bundles(character.get_bundle_handle(0), other.get_bundle_handle(0))
+    bundle = character.get_bundle(0)
+    assert bundle == other_bundle
+    merged_child = character.find_joint("child")
+    merged_leaf = character.find_joint("leaf")
+    assert merged_child is not None and merged_child != child
+    assert merged_leaf is not None and merged_leaf != leaf
+
+    # The copied joints are animated along with the others.
+    assert bundle.freeze_joint("child", core.TransformState.make_pos((0, 5, 0)))
+    assert bundle.freeze_joint("other", core.TransformState.make_pos((2, 0, 0)))
+    character.force_update()
+    assert get_net_pos(character.find_joint("root")).almost_equal((0, 0, 1))
+    assert get_net_pos(character.find_joint("other")).almost_equal((2, 0, 1))
+    assert get_net_pos(merged_child).almost_equal((0, 5, 1))
+    assert get_net_pos(merged_leaf).almost_equal((3, 5, 1))
+
+
+def test_character_update_batch(job_pool):
+    def make_characters(prefix):
+        characters = []
+        for i in range(8):
+            character, joints = make_character("%s%d" % (prefix, i))
+            bundle = character.get_bundle(0)
+            bundle.freeze_joint("root", core.TransformState.make_pos((i, 0, 0)))
+            bundle.freeze_joint("child", core.TransformState.make_pos_hpr((0, i, 0), (i * 10, 0, 0)))
+            characters.append((character, joints))
+        return characters
+
+    # The same characters, updated one at a time.
+    expected = []
+    for character, joints in make_characters("serial"):
+        character.force_update()
+        expected.append([get_net_pos(joint) for joint in joints])
+
+    batch = core.CharacterUpdateBatch()
+    characters = make_characters("batch")
+    for character, joints in characters:
+        batch.add_character(character)
+    assert batch.get_num_characters() == 8
+
+    num_jobs = job_pool.num_jobs_added
+    batch.force_update()
+    assert job_pool.num_jobs_added > num_jobs
+
+    for (character, joints), positions in zip(characters, expected):
+        for joint, pos in zip(joints, positions):
+            assert get_net_pos(joint).almost_equal(pos)
+
+    batch.clear_characters()
+    assert batch.get_num_characters() == 0
@@ -0,0 +1,91 @@
+from panda3d import core
+from panda3d.core import CollisionNode, NodePath, GeomNode
+from panda3d.core import CollisionTraverser, CollisionHandlerQueue
+from panda3d.core import CollisionSphere, CollisionPolygon, CollisionRay
+from panda3d.core import GeomVertexData, GeomVertexFormat, GeomVertexWriter
+from panda3d.core import GeomTriangles, Geom
+import random
+
+
+def make_scene(rng):
+    root = NodePath("root")
+
+    # Enough solids and triangles to pass collision-bvh-threshold, so that
+    # they are filtered by the batch.
+    node = CollisionNode("solids")
+    for i in range(300):
+        p = core.Point3(rng.uniform(0, 40), rng.uniform(0, 40), rng.uniform(0, 4))
+        if i % 2 == 0:
+            node.add_solid(CollisionSphere(p, rng.uniform(0.5, 1.5)))
+        else:
+            u = core.Vec3(rng.uniform(0.5, 2), rng.uniform(-1, 1), rng.uniform(-0.5, 0.5))
+            v = core.Vec3(rng.uniform(-1, 1), rng.uniform(0.5, 2), rng.uniform(-0.5, 0.5))
+            node.add_solid(CollisionPolygon(p, p + u, p + u + v, p + v))
+    node.set_from_collide_mask(0)
+    root.attach_new_node(node)
+
+    vdata = GeomVertexData("tris", GeomVertexFormat.get_v3(), Geom.UH_static)
+    writer = GeomVertexWriter(vdata, "vertex")
+    tris = GeomTriangles(Geom.UH_static)
+    for i in range(300):
+        p = core.Point3(rng.uniform(0, 40), rng.uniform(0, 40), rng.uniform(0, 4))
+        writer.add_data3(p)
+        writer.add_data3(p + core.Vec3(rng.uniform(0.5, 2), rng.uniform(-1, 1), rng.uniform(-1, 1)))
+        writer.add_data3(p + core.Vec3(rng.uniform(-1, 1), rng.uniform(0.5, 2), rng.uniform(-1, 1)))
+        tris.add_vertices(i * 3, i * 3 + 1, i * 3 + 2)
+    geom = Geom(vdata)
+    geom.add_primitive(tris)
+    gnode = GeomNode("geom")
+    gnode.add_geom(geom)
+    gnode.set_into_collide_mask(GeomNode.get_default_collide_mask())
+    root.attach_new_node(gnode)
+
+    # A mix of spheres and rays, whose bounding volumes are tested as
+    # spheres and lines respectively.
+    colliders = []
+    for i in range(40):
+        node = CollisionNode("from%d" % (i))
+        x, y = rng.uniform(0, 40), rng.uniform(0, 40)
+        if i % 4 == 0:
+            node.add_solid(CollisionRay(x, y, 10, rng.uniform(-0.2, 0.2), rng.uniform(-0.2, 0.2), -1))
+        else:
+            node.add_solid(CollisionSphere(x, y, rng.uniform(0, 4), rng.uniform(1, 3)))
+        node.set_into_collide_mask(0)
+        node.set_from_collide_mask(CollisionNode.get_default_collide_mask() |
+                                   GeomNode.get_default_collide_mask())
+        colliders.append(root.attach_new_node(node))
+
+    return root, colliders
+
+
+def collide(root, colliders, config):
+    page = core.load_prc_file_data("", config)
+    try:
+        trav = CollisionTraverser()
+        queue = CollisionHandlerQueue()
+        for np in colliders:
+            trav.add_collider(np, queue)
+        trav.traverse(root)
+    finally:
+        core.unload_prc_file(page)
+
+    return sorted((e.get_from_node_path().get_name(),
+                   e.get_into_node_path().get_name(),
+                   tuple(e.get_surface_point(root)))
+                  for e in queue.get_entries())
+
+
+def test_collision_batch_matches_brute_force():
+    root, colliders = make_scene(random.Random(1))
+
+    # Without the hierarchies, every solid and triangle is tested.
+    brute = collide(root, colliders, "collision-bvh-threshold 0")
+    assert len(brute) > 0
+
+    scalar = collide(root, colliders,
+                     "collision-solid-batch 1\ncollision-solid-batch-simd 0")
+    assert scalar == brute
+
+    simd = collide(root, colliders,
+                   "collision-solid-batch 1\ncollision-solid-batch-simd 1")
+    assert simd == brute
@@ -0,0 +1,87 @@
+from panda3d.core import CollisionNode, NodePath, GeomNode
+from panda3d.core import CollisionTraverser, CollisionHandlerQueue
+from panda3d.core import CollisionSphere, CollisionRay
+from panda3d.core import GeomVertexData, GeomVertexFormat, GeomVertexWriter
+from panda3d.core import GeomTriangles, Geom
+
+
+def collide_ray(root, x, y):
+    node = CollisionNode("ray")
+    node.add_solid(CollisionRay(x, y, 10, 0, 0, -1))
+    node.set_into_collide_mask(0)
+    node.set_from_collide_mask(CollisionNode.get_default_collide_mask() |
+                               GeomNode.get_default_collide_mask())
+    np = root.attach_new_node(node)
+
+    trav = CollisionTraverser()
+    queue = CollisionHandlerQueue()
+    trav.add_collider(np, queue)
+    trav.traverse(root)
+    np.remove_node()
+
+    queue.sort_entries()
+    return list(queue.get_entries())
+
+
+def test_collision_node_many_solids():
+    root = NodePath("root")
+    node = CollisionNode("into")
+    for x in range(10):
+        for y in range(10):
+            node.add_solid(CollisionSphere(x * 3, y * 3, 0, 1))
+    root.attach_new_node(node)
+
+    entries = collide_ray(root, 6, 9)
+    assert len(entries) == 1
+    assert entries[0].get_into() == node.get_solid(23)
+
+    entries = collide_ray(root, 7.5, 9)
+    assert len(entries) == 0
+
+    # Modifying the node must be noticed.
+    node.set_solid(55, CollisionSphere(7.5, 9, 0, 1))
+    entries = collide_ray(root, 7.5, 9)
+    assert len(entries) == 1
+    assert entries[0].get_into() == node.get_solid(55)
+
+    node.remove_solid(23)
+    entries = collide_ray(root, 6, 9)
+    assert len(entries) == 0
+
+
+def test_geom_many_triangles():
+    vdata = GeomVertexData("grid", GeomVertexFormat.get_v3(), Geom.UH_static)
+    writer = GeomVertexWriter(vdata, "vertex")
+    for x in range(11):
+        for y in range(11):
+            writer.add_data3(x, y, (x + y) % 2)
+
+    tris = GeomTriangles(Geom.UH_static)
+    for x in range(10):
+        for y in range(10):
+            i = x * 11 + y
+            tris.add_vertices(i, i + 11, i + 12)
+            tris.add_vertices(i, i + 12, i + 1)
+
+    geom = Geom(vdata)
+    geom.add_primitive(tris)
+    gnode = GeomNode("grid")
+    gnode.add_geom(geom)
+    gnode.set_into_collide_mask(GeomNode.get_default_collide_mask())
+
+    root = NodePath("root")
+    root.attach_new_node(gnode)
+
+    entries = collide_ray(root, 4.25, 6.75)
+    assert len(entries) == 1
+    point = entries[0].get_surface_point(root)
+    assert point.x == 4.25 and point.y == 6.75
+
+    # Moving the vertices must be noticed.
+    writer = GeomVertexWriter(gnode.modify_geom(0).modify_vertex_data(), "vertex")
+    for x in range(11):
+        for y in range(11):
+            writer.set_data3(x + 20, y, 0)
+
+    assert len(collide_ray(root, 4.25, 6.75)) == 0
+    assert len(collide_ray(root, 24.25, 6.75)) == 1
@@ -0,0 +1,164 @@
+from panda3d.core import CollisionNode, NodePath, BitMask32
+from panda3d.core import CollisionTraverser, CollisionHandlerQueue
+from panda3d.core import CollisionHandlerPusher
+from panda3d.core import CollisionSphere, CollisionRay, CollisionPolygon
+from panda3d.core import Point3, BoundingSphere
+
+
+def describe_entries(queue):
+    return [(e.get_from_node_path().get_name(), e.get_into_node_path().get_name(),
+             tuple(e.get_surface_point(e.get_into_node_path())))
+            for e in queue.get_entries()]
+
+
+def make_crowd(root, trav, queue, count):
+    avatars = []
+    crowd = root.attach_new_node("crowd")
+    for i in range(count):
+        avatar = crowd.attach_new_node("avatar%d" % (i))
+        avatar.set_pos((i * 7) % 30, (i * 11) % 30, 1)
+        node = CollisionNode("collider%d" % (i))
+        node.add_solid(CollisionSphere(0, 0, 0, 1.5))
+        if i % 4 == 0:
+            node.add_solid(CollisionRay(0, 0, 0, 0, 0, -1))
+            node.set_into_collide_mask(0)
+        else:
+            node.set_into_collide_mask(BitMask32.bit(1))
+        node.set_from_collide_mask(BitMask32.bit(1))
+        trav.add_collider(avatar.attach_new_node(node), queue)
+        avatars.append(avatar)
+    return avatars
+
+
+def make_walls(root):
+    # Each wall is a few levels below the root, with transforms on the way.
+    walls = root.attach_new_node("walls")
+    for i in range(4):
+        group = walls.attach_new_node("group%d" % (i))
+        group.set_pos(i * 8, 0, 0)
+        inner = group.attach_new_node("inner")
+        inner.set_h(i * 10)
+        node = CollisionNode("wall%d" % (i))
+        node.add_solid(CollisionPolygon(Point3(-3, 2, -3), Point3(3, 2, -3),
+                                        Point3(3, 2, 3), Point3(-3, 2, 3)))
+        node.set_into_collide_mask(BitMask32.bit(1))
+        inner.attach_new_node(node)
+    return walls
+
+
+def make_pair(root, count):
+    serial_trav = CollisionTraverser()
+    broadphase_trav = CollisionTraverser()
+    broadphase_trav.broadphase = True
+
+    serial_queue = CollisionHandlerQueue()
+    broadphase_queue = CollisionHandlerQueue()
+    avatars = make_crowd(root, serial_trav, serial_queue, count)
+    for i in range(serial_trav.get_num_colliders()):
+        broadphase_trav.add_collider(serial_trav.get_collider(i), broadphase_queue)
+    return serial_trav, serial_queue, broadphase_trav, broadphase_queue, avatars
+
+
+def test_traverser_broadphase_matches_serial():
+    root = NodePath("root")
+    floor = CollisionNode("floor")
+    floor.add_solid(CollisionPolygon(Point3(0, 0, 0), Point3(30, 0, 0),
+                                     Point3(30, 30, 0), Point3(0, 30, 0)))
+    floor.set_into_collide_mask(BitMask32.bit(1))
+    root.attach_new_node(floor)
+
+    serial_trav = CollisionTraverser()
+    broadphase_trav = CollisionTraverser()
+    assert not broadphase_trav.broadphase
+    broadphase_trav.broadphase = True
+    assert broadphase_trav.broadphase
+
+    serial_queue = CollisionHandlerQueue()
+    broadphase_queue = CollisionHandlerQueue()
+    avatars = make_crowd(root, serial_trav, serial_queue, 60)
+    for i in range(serial_trav.get_num_colliders()):
+        broadphase_trav.add_collider(serial_trav.get_collider(i), broadphase_queue)
+
+    for frame in range(4):
+        # Move some of the avatars, so that the grid has to be updated.
+        for avatar in avatars[frame::3]:
+            avatar.set_x(avatar.get_x() + 0.75)
+        if frame == 2:
+            avatars[5].detach_node()
+
+        serial_trav.traverse(root)
+        broadphase_trav.traverse(root)
+        serial = describe_entries(serial_queue)
+        assert len(serial) > 0
+
+        # The collisions must be reported in exactly the same order.
+        assert describe_entries(broadphase_queue) == serial
+
+
+def test_traverser_broadphase_nested():
+    root = NodePath("root")
+    walls = make_walls(root)
+    serial_trav, serial_queue, broadphase_trav, broadphase_queue, avatars = \
+        make_pair(root, 20)
+
+    # Put a collider against each of the walls.
+    for avatar, group in zip(avatars, walls.get_children()):
+        avatar.set_pos(group.get_x(), 2.5, 0)
+
+    serial_trav.traverse(root)
+    broadphase_trav.traverse(root)
+    serial = describe_entries(serial_queue)
+    assert "wall2" in [into for from_name, into, point in serial]
+    assert describe_entries(broadphase_queue) == serial
+
+    # Now shrink the bounds of one of the groups, so that the serial
+    # traversal no longer reaches the wall inside it.
+    walls.find("group2").node().set_bounds(BoundingSphere(Point3(0, 0, 0), 0.5))
+
+    serial_trav.traverse(root)
+    broadphase_trav.traverse(root)
+    serial = describe_entries(serial_queue)
+    assert len(serial) > 0
+    assert "wall2" not in [into for from_name, into, point in serial]
+    assert describe_entries(broadphase_queue) == serial
+
+    walls.find("group2").node().clear_bounds()
+
+    serial_trav.traverse(root)
+    broadphase_trav.traverse(root)
+    serial = describe_entries(serial_queue)
+    assert "wall2" in [into for from_name, into, point in serial]
+    assert describe_entries(broadphase_queue) == serial
+
+
+def test_traverser_broadphase_pusher():
+    results = []
+    for broadphase in (False, True):
+        root = NodePath("root")
+        make_walls(root)
+
+        trav = CollisionTraverser()
+        trav.broadphase = broadphase
+        pusher = CollisionHandlerPusher()
+
+        avatars = []
+        for i in range(12):
+            avatar = root.attach_new_node("avatar%d" % (i))
+            avatar.set_pos(i * 2.5, 1 + (i % 3) * 0.5, 0)
+            node = CollisionNode("collider%d" % (i))
+            node.add_solid(CollisionSphere(0, 0, 0, 1.5))
+            node.set_from_collide_mask(BitMask32.bit(1))
+            node.set_into_collide_mask(BitMask32.bit(1))
+            collider = avatar.attach_new_node(node)
+            pusher.add_collider(collider, avatar)
+            trav.add_collider(collider, pusher)
+            avatars.append(avatar)
+
+        start = [tuple(avatar.get_pos()) for avatar in avatars]
+        for frame in range(3):
+            trav.traverse(root)
+        results.append([tuple(avatar.get_pos()) for avatar in avatars])
+        assert results[-1] != start
+
+    # The avatars must have been pushed to exactly the same places.
+    assert results[0] == results[1]
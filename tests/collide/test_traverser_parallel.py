@@ -0,0 +1,50 @@
+from panda3d.core import CollisionNode, NodePath
+from panda3d.core import CollisionTraverser, CollisionHandlerQueue
+from panda3d.core import CollisionSphere, CollisionRay
+
+
+def describe_entries(queue):
+    return [(e.get_from_node_path().get_name(), e.get_into_node_path().get_name(),
+             tuple(e.get_surface_point(e.get_into_node_path())))
+            for e in queue.get_entries()]
+
+
+def test_traverser_parallel_matches_serial(job_pool):
+    root = NodePath("root")
+    for g in range(5):
+        group = root.attach_new_node("group%d" % (g))
+        for i in range(10):
+            node = CollisionNode("into%d_%d" % (g, i))
+            node.add_solid(CollisionSphere(i * 2, g * 2, 0, 1.5))
+            node.set_from_collide_mask(0)
+            group.attach_new_node(node)
+
+    trav = CollisionTraverser()
+    assert not trav.parallel
+
+    queue1 = CollisionHandlerQueue()
+    queue2 = CollisionHandlerQueue()
+    for i in range(40):
+        node = CollisionNode("from%d" % (i))
+        node.add_solid(CollisionSphere(0, 0, 0, 2))
+        if i % 3 == 0:
+            node.add_solid(CollisionRay(0, 0, 5, 0, 0, -1))
+        node.set_into_collide_mask(0)
+        np = root.attach_new_node(node)
+        np.set_pos((i * 7) % 20, (i * 3) % 10, 0)
+        trav.add_collider(np, queue1 if i % 2 else queue2)
+
+    num_jobs = job_pool.num_jobs_added
+    trav.traverse(root)
+    serial = describe_entries(queue1), describe_entries(queue2)
+    assert job_pool.num_jobs_added == num_jobs
+    assert len(serial[0]) > 0 and len(serial[1]) > 0
+
+    trav.parallel = True
+    assert trav.parallel
+    trav.traverse(root)
+    parallel = describe_entries(queue1), describe_entries(queue2)
+    assert job_pool.num_jobs_added > num_jobs
+
+    # The collisions must be reported in exactly the same order.
+    assert parallel == serial
@@ -0,0 +1,52 @@
+import pytest
+
+
+def pytest_addoption(parser):
+    parser.addoption("--benchmark", action="store_true", default=False,
+                     help="also run the tests marked as benchmarks")
+
+
+def pytest_configure(config):
+    config.addinivalue_line("markers", "benchmark: measures performance; "
+                            "only run with --benchmark")
+
+
+def pytest_collection_modifyitems(config, items):
+    if config.getoption("--benchmark"):
+        return
+
+    skip = pytest.mark.skip(reason="benchmarks only run with --benchmark")
+    for item in items:
+        if "benchmark" in item.keywords:
+            item.add_marker(skip)
+
+
+@pytest.fixture
+def job_pool():
+    "Gives the global JobPool a fixed number of worker threads for the test."
+    from panda3d.core import JobPool
+
+    pool = JobPool.get_global_ptr()
+    num_threads = pool.num_threads
+    pool.num_threads = 3
+
+    if pool.num_threads != 3:
+        pool.num_threads = num_threads
+        pytest.skip("JobPool cannot start threads")
+
+    yield pool
+
+    pool.num_threads = num_threads
+
+
+@pytest.fixture(scope='session')
+def tiny_pipe():
+    "Returns the software renderer's pipe, which works without a display."
+    from panda3d.core import GraphicsPipeSelection
+
+    pipe = GraphicsPipeSelection.get_global_ptr().make_module_pipe('p3tinydisplay')
+
+    if pipe is None or not pipe.is_valid():
+        pytest.skip("tinydisplay is not available")
+
+    yield pipe
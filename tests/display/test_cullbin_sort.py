@@ -0,0 +1,167 @@
+import time
+
+import pytest
+from panda3d.core import NodePath, Camera, CardMaker, PythonCallbackObject
+from panda3d.core import GraphicsPipe, FrameBufferProperties, WindowProperties
+from panda3d.core import TransparencyAttrib, DepthOffsetAttrib
+from panda3d.core import GraphicsEngine, GraphicsThreadingModel
+from panda3d.core import load_prc_file_data, unload_prc_file
+
+
+@pytest.fixture
+def buffer(graphics_pipe, graphics_engine):
+    fbprops = FrameBufferProperties()
+    fbprops.force_hardware = True
+
+    buffer = graphics_engine.make_output(
+        graphics_pipe,
+        'buffer',
+        0,
+        fbprops,
+        WindowProperties.size(32, 32),
+        GraphicsPipe.BF_refuse_window
+    )
+    graphics_engine.open_windows()
+
+    if buffer is None:
+        pytest.skip("GraphicsPipe cannot make offscreen buffers")
+
+    yield buffer
+
+    if buffer is not None:
+        graphics_engine.remove_window(buffer)
+
+
+def render_result_graph(graphics_engine, buffer, scene):
+    "Renders the scene, and returns the bins from the cull result graph."
+
+    cam = scene.attach_new_node(Camera("camera"))
+    dr = buffer.make_display_region()
+    dr.camera = cam
+
+    results = {}
+
+    def draw_callback(cbdata):
+        graph = NodePath(cbdata.get_cull_result().make_result_graph())
+        for bin in graph.get_children():
+            results[bin.name] = bin.get_children()
+        cbdata.upcall()
+
+    dr.set_draw_callback(PythonCallbackObject(draw_callback))
+    graphics_engine.render_frame()
+    graphics_engine.sync_frame()
+    buffer.remove_display_region(dr)
+    return results
+
+
+def make_cards(scene, num_cards, num_states):
+    cm = CardMaker("card")
+    cm.set_frame(-0.1, 0.1, -0.1, 0.1)
+    for i in range(num_cards):
+        card = scene.attach_new_node(cm.generate())
+        # Scatter them in depth, in no particular order.
+        card.set_pos(0, 10 + (i * 7919) % num_cards, 0)
+        card.set_depth_offset(i % num_states)
+
+
+def test_cullbin_state_sorted(graphics_engine, buffer):
+    scene = NodePath("scene")
+    make_cards(scene, 500, 20)
+
+    results = render_result_graph(graphics_engine, buffer, scene)
+    objects = results["opaque"]
+    assert objects.get_num_paths() > 0
+
+    # Each state appears in one contiguous run.
+    seen = set()
+    prev = None
+    for obj in objects:
+        key = obj.get_state().get_attrib(DepthOffsetAttrib).get_offset()
+        if key != prev:
+            assert key not in seen
+            seen.add(key)
+            prev = key
+    assert len(seen) == 20
+
+
+def test_cullbin_back_to_front(graphics_engine, buffer):
+    scene = NodePath("scene")
+    scene.set_transparency(TransparencyAttrib.M_alpha)
+    make_cards(scene, 500, 1)
+
+    results = render_result_graph(graphics_engine, buffer, scene)
+    objects = results["transparent"]
+    assert objects.get_num_paths() > 0
+
+    dists = [obj.get_transform().get_pos().length() for obj in objects]
+    assert dists == sorted(dists, reverse=True)
+
+
+def test_cullbin_sort_parallel(tiny_pipe, job_pool):
+    scene = NodePath("scene")
+    make_cards(scene.attach_new_node("opaque"), 500, 20)
+    transparent = scene.attach_new_node("transparent")
+    transparent.set_transparency(TransparencyAttrib.M_alpha)
+    make_cards(transparent, 500, 3)
+
+    def describe(threading_model):
+        engine = GraphicsEngine()
+        engine.threading_model = GraphicsThreadingModel(threading_model)
+        buffer = engine.make_output(
+            tiny_pipe,
+            'buffer',
+            0,
+            FrameBufferProperties(),
+            WindowProperties.size(32, 32),
+            GraphicsPipe.BF_refuse_window
+        )
+        if buffer is None:
+            pytest.skip("tinydisplay cannot make offscreen buffers")
+
+        results = render_result_graph(engine, buffer, scene)
+        engine.remove_all_windows()
+        return sorted((name, [(obj.get_mat(), obj.get_state()) for obj in objects])
+                      for name, objects in results.items())
+
+    # Keep the cull traversal itself serial, so that the only jobs are the
+    # ones sorting the bins.
+    page = load_prc_file_data('', 'cull-parallel-depth 1000\ncull-update-bounds 0')
+    try:
+        num_jobs = job_pool.num_jobs_added
+        serial = describe("")
+        assert job_pool.num_jobs_added == num_jobs
+
+        parallel = describe("*")
+        assert job_pool.num_jobs_added == num_jobs + 2
+    finally:
+        unload_prc_file(page)
+
+    assert [name for name, objects in serial] == ["opaque", "transparent"]
+    assert len(serial[0][1]) == 500
+    assert len(serial[1][1]) == 500
+
+    # The objects are drawn in exactly the same order.
+    assert parallel == serial
+
+
+@pytest.mark.benchmark
+def test_cullbin_sort_benchmark(graphics_engine, buffer):
+    scene = NodePath("scene")
+    make_cards(scene, 20000, 200)
+
+    cam = scene.attach_new_node(Camera("camera"))
+    dr = buffer.make_display_region()
+    dr.camera = cam
+
+    # Render once to warm up the state caches.
+    graphics_engine.render_frame()
+
+    num_frames = 10
+    start = time.time()
+    for i in range(num_frames):
+        graphics_engine.render_frame()
+    graphics_engine.sync_frame()
+    elapsed = time.time() - start
+
+    buffer.remove_display_region(dr)
+    print("%d objects: %.2f ms per frame" % (20000, elapsed * 1000.0 / num_frames))
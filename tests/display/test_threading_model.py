@@ -0,0 +1,115 @@
+import pytest
+from panda3d import core
+
+
+def test_threading_model_default():
+    model = core.GraphicsThreadingModel("")
+    assert model.is_default()
+    assert model.is_single_threaded()
+    assert not model.get_cull_parallel()
+
+
+def test_threading_model_cull_draw():
+    model = core.GraphicsThreadingModel("Cull/Draw")
+    assert model.get_cull_name() == "Cull"
+    assert model.get_draw_name() == "Draw"
+    assert model.get_cull_stage() == 1
+    assert model.get_draw_stage() == 2
+    assert not model.get_cull_parallel()
+    assert model.get_model() == "Cull/Draw"
+
+
+def test_threading_model_cull_parallel():
+    model = core.GraphicsThreadingModel("Cull*/Draw")
+    assert model.get_cull_name() == "Cull"
+    assert model.get_draw_name() == "Draw"
+    assert model.get_cull_parallel()
+    assert model.get_model() == "Cull*/Draw"
+
+    model = core.GraphicsThreadingModel("*")
+    assert model.get_cull_name() == ""
+    assert model.is_single_threaded()
+    assert model.get_cull_parallel()
+    assert not model.is_default()
+
+    model.set_cull_parallel(False)
+    assert model.is_default()
+
+
+def make_cull_scene():
+    "Returns a scene a few levels deep, with objects in several bins."
+
+    scene = core.NodePath('scene')
+    card = core.CardMaker('card')
+    card.set_frame(-0.4, 0.4, -0.4, 0.4)
+
+    for i in range(4):
+        group = scene.attach_new_node('group')
+        for j in range(4):
+            subgroup = group.attach_new_node('subgroup')
+            for k in range(4):
+                np = subgroup.attach_new_node(card.generate())
+                np.set_pos(i * 2 - 3 + k * 0.1, 20 + j * 2 + k, j - 1.5)
+                if k == 1:
+                    np.set_transparency(core.TransparencyAttrib.M_alpha)
+                elif k == 2:
+                    np.set_bin('fixed', (i * 7 + j * 3) % 5)
+                elif k == 3:
+                    np.set_bin('unsorted', 0)
+                    np.set_color(i / 4.0, j / 4.0, 1, 1)
+
+    return scene
+
+
+def cull_scene(pipe, threading_model, scene):
+    """Culls the scene with the given threading model, returns a description of
+    the contents of the bins, and the JobPool used by the cull traverser."""
+
+    engine = core.GraphicsEngine()
+    engine.threading_model = core.GraphicsThreadingModel(threading_model)
+
+    buffer = engine.make_output(
+        pipe,
+        'buffer',
+        0,
+        core.FrameBufferProperties(),
+        core.WindowProperties.size(32, 32),
+        core.GraphicsPipe.BF_refuse_window
+    )
+    if buffer is None:
+        pytest.skip("tinydisplay cannot make offscreen buffers")
+
+    cam = scene.attach_new_node(core.Camera('camera', core.PerspectiveLens()))
+    dr = buffer.make_display_region()
+    dr.camera = cam
+    engine.render_frame()
+
+    bins = []
+    result = core.NodePath(dr.make_cull_result_graph())
+    for bin in result.get_children():
+        objects = []
+        for object in bin.get_children():
+            # Each object is identified by its unique transform.
+            objects.append((object.get_mat(), object.node().get_num_geoms()))
+        bins.append((bin.name, objects))
+
+    job_pool = dr.cull_traverser.job_pool
+    engine.remove_all_windows()
+    cam.remove_node()
+    return bins, job_pool
+
+
+def test_cull_parallel(tiny_pipe, job_pool):
+    scene = make_cull_scene()
+    serial, serial_pool = cull_scene(tiny_pipe, "", scene)
+    parallel, parallel_pool = cull_scene(tiny_pipe, "*", scene)
+
+    assert serial_pool is None
+    assert parallel_pool == job_pool
+
+    # Everything was drawn, in all of the bins.
+    assert [name for name, objects in serial] == ['opaque', 'transparent', 'fixed', 'unsorted']
+    assert sum(len(objects) for name, objects in serial) == 64
+
+    # The bins received the same objects, in the same order.
+    assert parallel == serial
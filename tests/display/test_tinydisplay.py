@@ -0,0 +1,316 @@
+import time
+
+import pytest
+from panda3d import core
+
+
+def make_scene(num_tris, lit):
+    "Returns a scene with many random, overlapping triangles."
+
+    rand = core.Randomizer(42)
+    vdata = core.GeomVertexData('tris', core.GeomVertexFormat.get_v3n3c4t2(), core.Geom.UH_static)
+    vertex = core.GeomVertexWriter(vdata, 'vertex')
+    normal = core.GeomVertexWriter(vdata, 'normal')
+    color = core.GeomVertexWriter(vdata, 'color')
+    texcoord = core.GeomVertexWriter(vdata, 'texcoord')
+
+    tris = core.GeomTriangles(core.Geom.UH_static)
+    for i in range(num_tris):
+        center = core.Point3(rand.random_real(20) - 10, 15 + rand.random_real(20), rand.random_real(14) - 7)
+        for j in range(3):
+            vertex.add_data3(center + core.Vec3(rand.random_real(6) - 3, rand.random_real(6) - 3, rand.random_real(6) - 3))
+            normal.add_data3(core.Vec3(rand.random_real(2) - 1, rand.random_real(2) - 1, rand.random_real(2) - 1))
+            color.add_data4(rand.random_real(1), rand.random_real(1), rand.random_real(1), 1)
+            texcoord.add_data2(rand.random_real(3), rand.random_real(3))
+        tris.add_next_vertices(3)
+
+    geom = core.Geom(vdata)
+    geom.add_primitive(tris)
+    node = core.GeomNode('tris')
+    node.add_geom(geom)
+
+    scene = core.NodePath('scene')
+    tris = scene.attach_new_node(node)
+    tris.set_two_sided(True)
+
+    tex = core.Texture('checker')
+    image = core.PNMImage(64, 64, 4)
+    for y in range(64):
+        for x in range(64):
+            image.set_xel_a(x, y, 1 if (x // 8 + y // 8) % 2 else 0.2, x / 64.0, y / 64.0, 1)
+    tex.load(image)
+    tris.set_texture(tex)
+
+    if lit:
+        mat = core.Material()
+        mat.ambient = (0.5, 0.6, 0.7, 1)
+        mat.diffuse = (0.8, 0.7, 0.6, 1)
+        mat.specular = (1, 1, 1, 1)
+        mat.shininess = 20
+        tris.set_material(mat)
+
+        point = core.PointLight('point')
+        point.color = (1, 0.9, 0.8, 1)
+        point.attenuation = (1, 0.01, 0.001)
+        point_np = scene.attach_new_node(point)
+        point_np.set_pos(2, 10, 3)
+        scene.set_light(point_np)
+
+        sun = core.DirectionalLight('sun')
+        sun.color = (0.3, 0.3, 0.5, 1)
+        sun_np = scene.attach_new_node(sun)
+        sun_np.set_hpr(30, -40, 0)
+        scene.set_light(sun_np)
+
+    return scene
+
+
+def make_buffer(pipe, engine, scene, size):
+    fbprops = core.FrameBufferProperties()
+    fbprops.rgb_color = True
+    fbprops.depth_bits = 1
+
+    buffer = engine.make_output(
+        pipe,
+        'buffer',
+        0,
+        fbprops,
+        core.WindowProperties.size(*size),
+        core.GraphicsPipe.BF_refuse_window
+    )
+    if buffer is None:
+        pytest.skip("tinydisplay cannot make offscreen buffers")
+
+    tex = core.Texture('result')
+    buffer.add_render_texture(tex, core.GraphicsOutput.RTM_copy_ram)
+    buffer.set_clear_color((0.1, 0.2, 0.3, 1))
+
+    lens = core.PerspectiveLens()
+    lens.set_fov(60)
+    lens.set_aspect_ratio(size[0] / float(size[1]))
+    cam = scene.attach_new_node(core.Camera('camera', lens))
+    buffer.make_display_region().camera = cam
+    return buffer, tex
+
+
+def render(pipe, prc, scene, size=(64, 48)):
+    "Renders the scene with the given config settings, returns the image."
+
+    page = core.load_prc_file_data('', prc)
+    try:
+        engine = core.GraphicsEngine()
+        buffer, tex = make_buffer(pipe, engine, scene, size)
+        engine.render_frame()
+        engine.render_frame()
+        image = core.PNMImage()
+        assert tex.store(image)
+        engine.remove_all_windows()
+    finally:
+        core.unload_prc_file(page)
+    return image
+
+
+def has_drawn(image):
+    "Returns true if something was drawn over the clear color."
+
+    background = core.LRGBColor(0.1, 0.2, 0.3)
+    return any((image.get_xel(x, y) - background).length() > 0.01
+               for y in range(image.get_y_size())
+               for x in range(image.get_x_size()))
+
+
+def assert_same_image(a, b):
+    assert a.get_x_size() == b.get_x_size()
+    assert a.get_y_size() == b.get_y_size()
+    for y in range(a.get_y_size()):
+        for x in range(a.get_x_size()):
+            assert a.get_xel_val(x, y) == b.get_xel_val(x, y)
+
+
+@pytest.mark.parametrize("lit", [False, True], ids=["unlit", "lit"])
+def test_tinydisplay_tiles(tiny_pipe, job_pool, lit):
+    scene = make_scene(300, lit)
+
+    num_jobs = job_pool.num_jobs_added
+    serial = render(tiny_pipe, 'td-tile-rendering 0', scene)
+    assert job_pool.num_jobs_added == num_jobs
+
+    tiled = render(tiny_pipe, 'td-tile-rendering 1\ntd-tile-height 7', scene)
+    assert job_pool.num_jobs_added > num_jobs
+
+    assert has_drawn(serial)
+
+    # The tiles don't change the result.
+    assert_same_image(serial, tiled)
+
+
+@pytest.mark.parametrize("lit", [False, True], ids=["unlit", "lit"])
+def test_tinydisplay_simd_vertices(tiny_pipe, lit):
+    scene = make_scene(301, lit)
+    if lit:
+        # A spot light makes the lighting fall back to the scalar code, so
+        # this only tests the transform.
+        spot_scene = make_scene(301, lit)
+        spot = core.Spotlight('spot')
+        spot.color = (0.5, 0.5, 0.5, 1)
+        spot_np = spot_scene.attach_new_node(spot)
+        spot_np.set_pos(0, 5, 0)
+        spot_np.look_at(0, 20, 0)
+        spot_scene.set_light(spot_np)
+        spot_scene.reparent_to(scene)
+        spot_scene.set_x(3)
+
+    prc = 'td-tile-rendering 0\n'
+    simd = render(tiny_pipe, prc + 'td-simd-vertices 1', scene)
+    scalar = render(tiny_pipe, prc + 'td-simd-vertices 0', scene)
+
+    assert has_drawn(scalar)
+    assert_same_image(simd, scalar)
+
+
+@pytest.mark.parametrize("lit", [False, True], ids=["unlit", "lit"])
+def test_tinydisplay_hierarchical_z(tiny_pipe, lit):
+    scene = make_scene(300, lit)
+
+    # Also draw some untextured triangles, which are drawn four pixels at a
+    # time, partly hidden behind the textured ones.
+    untextured = make_scene(300, lit)
+    untextured.set_texture_off(10)
+    untextured.set_y(5)
+    untextured.reparent_to(scene)
+
+    with_hiz = render(tiny_pipe, 'td-tile-rendering 0\ntd-hierarchical-z 1', scene)
+    without_hiz = render(tiny_pipe, 'td-tile-rendering 0\ntd-hierarchical-z 0', scene)
+
+    assert_same_image(with_hiz, without_hiz)
+
+
+@pytest.mark.parametrize("minfilter", [
+    core.SamplerState.FT_linear,
+    core.SamplerState.FT_linear_mipmap_nearest,
+    core.SamplerState.FT_linear_mipmap_linear,
+], ids=["bilinear", "mipmap_bilinear", "trilinear"])
+def test_tinydisplay_tiled_textures(tiny_pipe, minfilter):
+    scene = make_scene(300, False)
+    tex = scene.find_texture('checker')
+    tex.minfilter = minfilter
+    tex.magfilter = core.SamplerState.FT_linear
+
+    prc = 'td-tile-rendering 0\ntexture-quality-level best\n'
+    tiled = render(tiny_pipe, prc + 'td-tiled-textures 1', scene)
+    untiled = render(tiny_pipe, prc + 'td-tiled-textures 0', scene)
+
+    assert_same_image(tiled, untiled)
+
+
+@pytest.mark.benchmark
+def test_tinydisplay_benchmark(tiny_pipe):
+    num_tris = 20000
+    size = (640, 480)
+    scene = make_scene(num_tris, True)
+
+    engine = core.GraphicsEngine()
+    buffer, tex = make_buffer(tiny_pipe, engine, scene, size)
+
+    # Render once to warm up the state caches.
+    engine.render_frame()
+
+    num_frames = 10
+    start = time.time()
+    for i in range(num_frames):
+        engine.render_frame()
+    engine.sync_frame()
+    elapsed = time.time() - start
+    engine.remove_all_windows()
+
+    num_vertices = num_tris * 3 * num_frames
+    num_pixels = size[0] * size[1] * num_frames
+    print("%d triangles: %.2f ms per frame, %.0f vertices/sec, %.0f pixels/sec" % (
+        num_tris, elapsed * 1000.0 / num_frames,
+        num_vertices / elapsed, num_pixels / elapsed))
+
+
+def test_tinydisplay_render_batch(tiny_pipe, job_pool):
+    scene = make_scene(300, False)
+    size = (64, 48)
+    expected = render(tiny_pipe, '', scene, size)
+    cam = scene.find('**/+Camera')
+
+    engine = core.GraphicsEngine()
+    fbprops = core.FrameBufferProperties()
+    fbprops.rgb_color = True
+    fbprops.depth_bits = 1
+    batch = core.OffscreenRenderBatch(engine, tiny_pipe, 'batch', size[0], size[1], 3, fbprops)
+    if not batch.valid:
+        pytest.skip("tinydisplay cannot make offscreen buffers")
+    batch.clear_color = (0.1, 0.2, 0.3, 1)
+
+    # More images than buffers, from the same camera, the last one into a
+    # texture of our own.
+    tex = core.Texture('mine')
+    for i in range(4):
+        assert batch.add_camera(cam) == i
+    assert batch.add_camera(cam, tex) == 4
+    assert batch.get_texture(4) == tex
+
+    # The buffers are drawn on the pool's threads.
+    num_jobs = job_pool.num_jobs_added
+    batch.render()
+    assert job_pool.num_jobs_added > num_jobs
+
+    # The batch buffers are not rendered by the engine.
+    engine.render_frame()
+
+    for tex in batch.textures:
+        image = core.PNMImage()
+        assert tex.store(image)
+        assert image.get_x_size() == size[0]
+        assert image.get_y_size() == size[1]
+        for y in range(size[1]):
+            for x in range(size[0]):
+                assert image.get_xel_val(x, y) == expected.get_xel_val(x, y)
+
+    del batch
+    engine.remove_all_windows()
+
+
+def test_tinydisplay_render_batch_no_buffers(tiny_pipe):
+    engine = core.GraphicsEngine()
+    batch = core.OffscreenRenderBatch(engine, tiny_pipe, 'batch', 16, 16, 0)
+    assert not batch.valid
+    assert batch.get_num_buffers() == 0
+
+    # This reports an error, but doesn't fail an assertion.
+    batch.add_camera(core.NodePath(core.Camera('camera')))
+    batch.render()
+
+
+@pytest.mark.benchmark
+def test_tinydisplay_render_batch_benchmark(tiny_pipe):
+    scene = make_scene(300, False)
+    size = (64, 64)
+    num_images = 200
+
+    engine = core.GraphicsEngine()
+    batch = core.OffscreenRenderBatch(engine, tiny_pipe, 'batch', size[0], size[1], 4)
+    if not batch.valid:
+        pytest.skip("tinydisplay cannot make offscreen buffers")
+
+    lens = core.PerspectiveLens()
+    lens.set_fov(60)
+    for i in range(num_images):
+        cam = scene.attach_new_node(core.Camera('camera', lens))
+        cam.set_pos(0, 25 - i * 0.05, i % 7 - 3)
+        batch.add_camera(cam)
+
+    # Render once to warm up the state caches.
+    batch.render()
+
+    start = time.time()
+    batch.render()
+    elapsed = time.time() - start
+
+    del batch
+    engine.remove_all_windows()
+
+    print("%dx%d images: %.0f images/sec" % (size[0], size[1], num_images / elapsed))
@@ -0,0 +1,115 @@
+import pytest
+from panda3d import core
+
+# Skip these tests if we can't import egg.
+egg = pytest.importorskip("panda3d.egg")
+
+
+def make_egg_data(num_groups):
+    data = egg.EggData()
+    pool = egg.EggVertexPool("pool")
+    data.add_child(pool)
+
+    for i in range(num_groups):
+        group = egg.EggGroup("group{0}".format(i))
+        if i % 3 == 1:
+            group.add_translate3d((i, 0, 0))
+        if i % 7 == 2:
+            # A hidden group ends up stashed.
+            group.set_visibility_mode(egg.EggRenderMode.VM_hidden)
+        data.add_child(group)
+
+        # A grid of quads, which the mesher turns into strips.
+        size = 4 + i % 5
+        verts = {}
+        for y in range(size + 1):
+            for x in range(size + 1):
+                vertex = egg.EggVertex()
+                vertex.set_pos(core.Point3D(x, y, i))
+                vertex.set_normal(core.Vec3D(0, 0, 1))
+                vertex.set_uv(core.Point2D(x / size, y / size))
+                verts[x, y] = pool.add_vertex(vertex)
+
+        for y in range(size):
+            for x in range(size):
+                poly = egg.EggPolygon()
+                poly.set_color((i % 2, 0.5, 1, 1))
+                for corner in ((x, y), (x + 1, y), (x + 1, y + 1), (x, y + 1)):
+                    poly.add_vertex(verts[corner])
+                group.add_child(poly)
+
+        if i % 4 == 3:
+            # Some primitives directly under an otherwise empty group.
+            line = egg.EggLine()
+            line.add_vertex(verts[0, 0])
+            line.add_vertex(verts[size, size])
+            group.add_child(line)
+
+    return data
+
+
+def make_mixed_egg_data(num_bins):
+    # All of the polygons are in one group, which therefore becomes a single
+    # GeomNode, but their render states differ, so each gets its own polyset.
+    data = egg.EggData()
+    pool = egg.EggVertexPool("pool")
+    data.add_child(pool)
+    group = egg.EggGroup("group")
+    data.add_child(group)
+
+    # The vertices of every other polyset are members of this group, which
+    # means those polysets are built serially.
+    members = egg.EggGroup("members")
+    data.add_child(members)
+
+    for i in range(num_bins):
+        poly = egg.EggPolygon()
+        poly.set_depth_offset(i)
+        for x, y in ((0, 0), (1, 0), (1, 1), (0, 1)):
+            vertex = egg.EggVertex()
+            vertex.set_pos(core.Point3D(x + i, y, 0))
+            vertex = pool.add_vertex(vertex)
+            poly.add_vertex(vertex)
+            if i % 2 == 1:
+                members.ref_vertex(vertex)
+        group.add_child(poly)
+
+    return data
+
+
+def load(data, parallel):
+    page = core.load_prc_file_data('', 'egg-parallel-polysets {0}'.format(int(parallel)))
+    try:
+        return core.NodePath(egg.load_egg_data(data))
+    finally:
+        core.unload_prc_file(page)
+
+
+@pytest.mark.parametrize("num_groups", [1, 50])
+def test_egg_parallel_polysets(num_groups, job_pool):
+    num_jobs = job_pool.num_jobs_added
+    serial = load(make_egg_data(num_groups), False)
+    assert job_pool.num_jobs_added == num_jobs
+
+    parallel = load(make_egg_data(num_groups), True)
+    assert job_pool.num_jobs_added > num_jobs
+
+    assert parallel.get_num_children() == serial.get_num_children()
+    assert parallel.find_all_matches('**/+GeomNode').get_num_paths() == \
+        serial.find_all_matches('**/+GeomNode').get_num_paths()
+    assert parallel.encode_to_bam_stream() == serial.encode_to_bam_stream()
+
+
+def test_egg_parallel_polysets_mixed(job_pool):
+    num_jobs = job_pool.num_jobs_added
+    serial = load(make_mixed_egg_data(6), False)
+    parallel = load(make_mixed_egg_data(6), True)
+
+    # Only the polysets without group members went to the pool.
+    assert job_pool.num_jobs_added == num_jobs + 3
+
+    # The serial and parallel polysets share a GeomNode, in which the Geoms
+    # must still be in the same order.
+    geom_node = parallel.find('**/group').node()
+    assert geom_node.get_num_geoms() == 6
+    assert parallel.encode_to_bam_stream() == serial.encode_to_bam_stream()
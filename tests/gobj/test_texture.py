@@ -1,6 +1,7 @@
 from panda3d.core import Texture, PNMImage, LColor
 from array import array
 import math
+import pytest
 
 
 def image_from_stored_pixel(component_type, format, data):
@@ -134,3 +135,146 @@ def test_texture_clear_half():
     assert col.y == -inf
     assert col.z == -inf
     assert math.isnan(col.w)
+
+
+def filter_mipmap_level(data, x_size, y_size, num_components):
+    """ Computes the next mipmap level of an image, the way
+    Texture.generate_ram_mipmap_images() is expected to do it. """
+
+    to_x_size = max(x_size // 2, 1)
+    to_y_size = max(y_size // 2, 1)
+    x_step = num_components if x_size > 1 else 0
+    y_step = x_size * num_components if y_size > 1 else 0
+
+    result = array(data.typecode)
+    for y in range(to_y_size):
+        for x in range(to_x_size):
+            i = (y * 2 * x_size + x * 2) * num_components
+            for c in range(num_components):
+                j = i + c
+                total = data[j] + data[j + x_step] + data[j + y_step] + data[j + x_step + y_step]
+                if data.typecode == 'f':
+                    result.append(total / 4)
+                else:
+                    result.append(total >> 2)
+    return result
+
+
+def make_image_data(x_size, y_size, num_components, component_type=Texture.T_unsigned_byte):
+    count = x_size * y_size * num_components
+    if component_type == Texture.T_unsigned_short:
+        return array('H', ((i * 1543 + (i >> 5) * 13) & 0xffff for i in range(count)))
+    elif component_type == Texture.T_float:
+        # Small whole numbers, so that every level is exact in 32 bits.
+        return array('f', (float((i * 7 + (i >> 5) * 13) & 0x3f) for i in range(count)))
+    else:
+        return array('B', ((i * 7 + (i >> 5) * 13) & 0xff for i in range(count)))
+
+
+def check_mipmaps(x_size, y_size, format, num_components, component_type=Texture.T_unsigned_byte):
+    data = make_image_data(x_size, y_size, num_components, component_type)
+
+    tex = Texture("")
+    tex.setup_2d_texture(x_size, y_size, component_type, format)
+    tex.set_ram_image(data)
+    tex.generate_ram_mipmap_images()
+    assert tex.has_all_ram_mipmap_images()
+
+    level = 1
+    while x_size > 1 or y_size > 1:
+        data = filter_mipmap_level(data, x_size, y_size, num_components)
+        x_size = max(x_size // 2, 1)
+        y_size = max(y_size // 2, 1)
+        assert tex.get_expected_mipmap_x_size(level) == x_size
+        assert tex.get_expected_mipmap_y_size(level) == y_size
+        assert bytes(tex.get_ram_mipmap_image(level)) == data.tobytes()
+        level += 1
+
+
+def test_texture_mipmaps_small():
+    check_mipmaps(7, 5, Texture.F_rgba, 4)
+    check_mipmaps(9, 1, Texture.F_rgb, 3)
+    check_mipmaps(1, 6, Texture.F_luminance, 1)
+
+
+def test_texture_mipmaps_large():
+    # Large enough for the levels to be generated by multiple threads, if
+    # there are any in the job pool.
+    check_mipmaps(512, 258, Texture.F_rgba, 4)
+    check_mipmaps(513, 512, Texture.F_luminance, 1)
+
+
+def test_texture_mipmaps_16bit():
+    check_mipmaps(7, 5, Texture.F_rgba16, 4, Texture.T_unsigned_short)
+    check_mipmaps(9, 1, Texture.F_rgba16, 4, Texture.T_unsigned_short)
+    check_mipmaps(1, 6, Texture.F_r16, 1, Texture.T_unsigned_short)
+
+
+def test_texture_mipmaps_float():
+    check_mipmaps(7, 5, Texture.F_rgba32, 4, Texture.T_float)
+    check_mipmaps(11, 3, Texture.F_r32, 1, Texture.T_float)
+    check_mipmaps(1, 6, Texture.F_r32, 1, Texture.T_float)
+
+
+def test_texture_mipmaps_large_types(job_pool):
+    num_jobs = job_pool.num_jobs_added
+    check_mipmaps(512, 258, Texture.F_rgba16, 4, Texture.T_unsigned_short)
+    check_mipmaps(258, 512, Texture.F_rgba32, 4, Texture.T_float)
+    check_mipmaps(513, 512, Texture.F_r32, 1, Texture.T_float)
+    assert job_pool.num_jobs_added > num_jobs
+
+
+def test_texture_mipmaps_unsupported_type():
+    tex = Texture("")
+    tex.setup_2d_texture(256, 256, Texture.T_int, Texture.F_r32i)
+    tex.set_ram_image(array('i', range(256 * 256)))
+    tex.generate_ram_mipmap_images()
+
+    # No zero-filled levels are left behind.
+    assert tex.get_num_ram_mipmap_images() == 1
+    assert not tex.has_all_ram_mipmap_images()
+
+
+def compress_images(pool, num_threads, compression, format, num_components):
+    """ Compresses an image, with all of its mipmap levels, using the given
+    number of threads.  Returns the compressed levels and the number of jobs
+    that were added to the pool to compress them, or None if the compression
+    is not supported. """
+
+    pool.num_threads = num_threads
+    tex = Texture("")
+    tex.setup_2d_texture(512, 512, Texture.T_unsigned_byte, format)
+    tex.set_ram_image(make_image_data(512, 512, num_components))
+    tex.generate_ram_mipmap_images()
+
+    num_jobs = pool.num_jobs_added
+    if not tex.compress_ram_image(compression):
+        return None
+    num_jobs = pool.num_jobs_added - num_jobs
+
+    assert tex.get_ram_image_compression() == compression
+    images = [bytes(tex.get_ram_mipmap_image(n)) for n in range(tex.get_num_ram_mipmap_images())]
+    return images, num_jobs
+
+
+def check_compress_parallel(job_pool, compression, format, num_components):
+    serial = compress_images(job_pool, 0, compression, format, num_components)
+    if serial is None:
+        return False
+    parallel = compress_images(job_pool, 3, compression, format, num_components)
+
+    assert serial[1] == 0
+    assert parallel[1] > 0
+    assert parallel[0] == serial[0]
+    return True
+
+
+def test_texture_compress_rgtc_parallel(job_pool):
+    assert check_compress_parallel(job_pool, Texture.CM_rgtc, Texture.F_red, 1)
+    assert check_compress_parallel(job_pool, Texture.CM_rgtc, Texture.F_rg, 2)
+
+
+def test_texture_compress_squish_parallel(job_pool):
+    if not check_compress_parallel(job_pool, Texture.CM_dxt1, Texture.F_rgb, 3):
+        pytest.skip("squish is not available")
+    assert check_compress_parallel(job_pool, Texture.CM_dxt5, Texture.F_rgba, 4)
@@ -0,0 +1,116 @@
+from panda3d import core
+
+
+def make_animated_data(num_rows, joints):
+    array = core.GeomVertexArrayFormat()
+    array.add_column("vertex", 3, core.Geom.NT_float32, core.Geom.C_point)
+    array.add_column("normal", 3, core.Geom.NT_float32, core.Geom.C_normal)
+    blend_array = core.GeomVertexArrayFormat()
+    blend_array.add_column("transform_blend", 1, core.Geom.NT_uint16, core.Geom.C_index)
+
+    format = core.GeomVertexFormat()
+    format.add_array(array)
+    format.add_array(blend_array)
+    spec = core.GeomVertexAnimationSpec()
+    spec.set_panda()
+    format.set_animation(spec)
+    format = core.GeomVertexFormat.register_format(format)
+
+    table = core.TransformBlendTable()
+    blends = [
+        table.add_blend(core.TransformBlend(joints[0], 1.0)),
+        table.add_blend(core.TransformBlend(joints[1], 1.0)),
+        table.add_blend(core.TransformBlend(joints[0], 0.5, joints[1], 0.5)),
+    ]
+    table.set_rows(core.SparseArray.range(0, num_rows))
+
+    data = core.GeomVertexData("", format, core.Geom.UH_static)
+    data.set_transform_blend_table(table)
+    data.set_num_rows(num_rows)
+    vertex = core.GeomVertexWriter(data, "vertex")
+    normal = core.GeomVertexWriter(data, "normal")
+    blend = core.GeomVertexWriter(data, "transform_blend")
+    for i in range(num_rows):
+        vertex.add_data3(i, 1, 2)
+        normal.add_data3(0, 0, 1)
+        # Alternate between runs of the same blend and single vertices.
+        blend.add_data1i(blends[(i // 4) % 3 if i % 8 < 4 else i % 3])
+    return data
+
+
+def check_animated_data(data, force=True):
+    thread = core.Thread.get_current_thread()
+    animated = data.animate_vertices(force, thread)
+    assert animated != data
+
+    blend_table = data.get_transform_blend_table()
+    orig_vertex = core.GeomVertexReader(data, "vertex")
+    orig_normal = core.GeomVertexReader(data, "normal")
+    blend = core.GeomVertexReader(data, "transform_blend")
+    vertex = core.GeomVertexReader(animated, "vertex")
+    normal = core.GeomVertexReader(animated, "normal")
+    for i in range(data.get_num_rows()):
+        mat = core.LMatrix4()
+        blend_table.get_blend(blend.get_data1i()).get_blend(mat, thread)
+
+        expected = mat.xform_point(orig_vertex.get_data3())
+        assert vertex.get_data3().almost_equal(expected, 1e-4)
+
+        # Normals are transformed by the inverse transpose.
+        normal_mat = core.LMatrix4(mat)
+        normal_mat.invert_in_place()
+        normal_mat.transpose_in_place()
+        expected = normal_mat.xform_vec(orig_normal.get_data3()).normalized()
+        assert normal.get_data3().almost_equal(expected, 1e-4)
+
+
+def make_joints():
+    joint0 = core.UserVertexTransform("joint0")
+    joint0.set_matrix(core.LMatrix4.translate_mat(1, 2, 3))
+    joint1 = core.UserVertexTransform("joint1")
+    joint1.set_matrix(core.LMatrix4.rotate_mat(90, (0, 0, 1)))
+    return joint0, joint1
+
+
+def test_animate_vertices():
+    joints = make_joints()
+    data = make_animated_data(100, joints)
+    check_animated_data(data)
+
+    # Change the transforms, which should be reflected in the next result.
+    joints[0].set_matrix(core.LMatrix4.scale_mat(2))
+    joints[1].set_matrix(core.LMatrix4.scale_mat(1, 2, 3))
+    check_animated_data(data)
+
+
+def get_rows(data, column):
+    reader = core.GeomVertexReader(data, column)
+    return [tuple(reader.get_data3()) for i in range(data.get_num_rows())]
+
+
+def test_animate_vertices_batch(job_pool):
+    joints = make_joints()
+    datas = [make_animated_data(50 + i, joints) for i in range(8)]
+
+    batch = core.AnimateVerticesBatch()
+    for data in datas:
+        batch.add_data(data)
+    assert batch.get_num_datas() == len(datas)
+
+    batch.animate(True)
+
+    thread = core.Thread.get_current_thread()
+    for data in datas:
+        # Without force, this returns what the batch cached on the data.
+        check_animated_data(data, False)
+        animated = data.animate_vertices(False, thread)
+
+        # The batch must have computed exactly what animating the same data
+        # by itself, in this thread, does.
+        reference = make_animated_data(data.get_num_rows(), joints)
+        expected = reference.animate_vertices(True, thread)
+        assert get_rows(animated, "vertex") == get_rows(expected, "vertex")
+        assert get_rows(animated, "normal") == get_rows(expected, "normal")
+
+    batch.clear_datas()
+    assert batch.get_num_datas() == 0
@@ -0,0 +1,81 @@
+from panda3d import core
+import pytest
+
+
+def make_vertex_data(num_vertices):
+    vdata = core.GeomVertexData('test', core.GeomVertexFormat.get_v3n3(), core.Geom.UH_static)
+    vdata.set_num_rows(num_vertices)
+    vertex = core.GeomVertexWriter(vdata, 'vertex')
+    normal = core.GeomVertexWriter(vdata, 'normal')
+    for i in range(num_vertices):
+        vertex.add_data3(i, i * 2, i * 3)
+        normal.add_data3(0, 0, 1)
+    return vdata
+
+
+@pytest.fixture
+def mmap_pages():
+    page = core.load_prc_file_data('', 'vertex-data-mmap 1\nvertex-data-page-threads 0')
+    if not core.VertexDataPage.get_save_file().is_valid():
+        core.unload_prc_file(page)
+        pytest.skip("no vertex save file")
+    yield
+    core.unload_prc_file(page)
+
+
+def test_vertex_data_mmap_evict(tmp_path, mmap_pages):
+    # Round-trip the data through a bam file, so that it has been loaded the
+    # way a model would be.
+    filename = core.Filename.from_os_specific(str(tmp_path / 'vdata.bam'))
+    orig = make_vertex_data(1000)
+    bam_file = core.BamFile()
+    assert bam_file.open_write(filename)
+    assert bam_file.write_object(orig)
+    bam_file.close()
+
+    bam_file = core.BamFile()
+    assert bam_file.open_read(filename)
+    vdata = bam_file.read_object()
+    assert bam_file.resolve()
+    bam_file.close()
+    expected = orig.get_array(0).get_handle().get_data()
+    assert vdata.get_array(0).get_handle().get_data() == expected
+
+    resident_lru = core.VertexDataPage.get_global_lru(core.VertexDataPage.RC_resident)
+    mapped_lru = core.VertexDataPage.get_global_lru(core.VertexDataPage.RC_mapped)
+    disk_lru = core.VertexDataPage.get_global_lru(core.VertexDataPage.RC_disk)
+
+    # Page the array out into the book, and then evict its page, which is
+    # written to the save file and mapped back from there.
+    core.GeomVertexArrayData.get_independent_lru().evict_to(0)
+    core.GeomVertexArrayData.get_small_lru().evict_to(0)
+    resident_lru.evict_to(0)
+    assert resident_lru.get_total_size() == 0
+    assert mapped_lru.get_total_size() >= len(expected)
+
+    # It is read in place from the mapping.
+    assert vdata.get_array(0).get_handle().get_data() == expected
+    assert resident_lru.get_total_size() == 0
+    assert mapped_lru.get_total_size() >= len(expected)
+
+    # Evicting the mapped page only lets go of the mapping; it is mapped back
+    # from the file when it is read again.
+    mapped_lru.evict_to(0)
+    assert mapped_lru.get_total_size() == 0
+    assert disk_lru.get_total_size() >= len(expected)
+
+    assert vdata.get_array(0).get_handle().get_data() == expected
+    assert resident_lru.get_total_size() == 0
+    assert mapped_lru.get_total_size() >= len(expected)
+
+    # Modifying the data brings it back into memory of its own.
+    vertex = core.GeomVertexRewriter(vdata, 'vertex')
+    vertex.set_row(0)
+    vertex.set_data3(7, 8, 9)
+    del vertex
+
+    reader = core.GeomVertexReader(vdata, 'vertex')
+    reader.set_row(0)
+    assert reader.get_data3() == (7, 8, 9)
+    reader.set_row(999)
+    assert reader.get_data3() == (999, 1998, 2997)
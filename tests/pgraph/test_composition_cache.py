@@ -0,0 +1,65 @@
+from panda3d import core
+import pytest
+
+
+def make_transforms():
+    transforms = []
+    for i in range(8):
+        transforms.append(core.TransformState.make_pos((i, 0, 0)))
+        transforms.append(core.TransformState.make_hpr((i * 10, 0, 0)))
+        transforms.append(core.TransformState.make_scale(i + 1))
+    return transforms
+
+
+def make_states():
+    states = []
+    for i in range(8):
+        states.append(core.RenderState.make(core.ColorAttrib.make_flat((i / 8.0, 0, 0, 1))))
+        states.append(core.RenderState.make(core.DepthOffsetAttrib.make(i)))
+        states.append(core.RenderState.make(core.CullBinAttrib.make("fixed", i)))
+    return states
+
+
+def compose_all(items):
+    return [(a.compose(b), a.invert_compose(b)) for a in items for b in items]
+
+
+@pytest.mark.skipif(not core.Thread.is_threading_supported(),
+                    reason="Threading support disabled")
+def test_composition_cache_threads():
+    transforms = make_transforms()
+    states = make_states()
+
+    # Compose everything in this thread first, so that the global cache holds
+    # the reference results.
+    expected_transforms = compose_all(transforms)
+    expected_states = compose_all(states)
+
+    results = []
+
+    def compose_thread():
+        # Composing more than once makes the later rounds hit the thread's own
+        # cache, which must hand back the same states as the global cache.
+        for i in range(20):
+            results.append((compose_all(transforms), compose_all(states)))
+
+    threads = [core.PythonThread(compose_thread, (), "", "") for i in range(4)]
+    for thread in threads:
+        thread.start(core.TP_normal, True)
+
+    # Flushing the caches while the threads are running must not change any
+    # results either.
+    core.TransformState.clear_cache()
+    core.RenderState.clear_cache()
+
+    for thread in threads:
+        thread.join()
+
+    assert len(results) == 80
+    for result_transforms, result_states in results:
+        assert result_transforms == expected_transforms
+        assert result_states == expected_states
+
+    # And the global cache still agrees after all that.
+    assert compose_all(transforms) == expected_transforms
+    assert compose_all(states) == expected_states
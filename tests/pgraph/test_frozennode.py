@@ -0,0 +1,129 @@
+import pytest
+from panda3d import core
+from panda3d.core import NodePath, FrozenNode, CardMaker, LODNode
+
+
+def make_frozen_scene():
+    frozen = NodePath(FrozenNode("frozen"))
+    cm = CardMaker("card")
+    for i in range(3):
+        group = frozen.attach_new_node("group%d" % (i))
+        group.set_pos(i, 0, 0)
+        for j in range(4):
+            card = group.attach_new_node(cm.generate())
+            card.set_z(j)
+    return frozen
+
+
+def test_frozennode_compiles_geoms():
+    frozen = make_frozen_scene()
+    assert frozen.node().get_num_frozen_geoms() == 12
+
+    # Adding a Geom is noticed.
+    frozen.get_child(0).attach_new_node(CardMaker("extra").generate())
+    assert frozen.node().get_num_frozen_geoms() == 13
+
+    # Stashed nodes are not drawn.
+    frozen.get_child(1).stash()
+    assert frozen.node().get_num_frozen_geoms() == 9
+
+
+def test_frozennode_unsupported_nodes():
+    frozen = make_frozen_scene()
+    card = frozen.get_child(2).get_child(0)
+
+    # Nodes with effects, draw masks or special cull behavior prevent the
+    # subgraph from being compiled.
+    card.set_billboard_point_eye()
+    assert frozen.node().get_num_frozen_geoms() == -1
+    card.clear_billboard()
+    assert frozen.node().get_num_frozen_geoms() == 12
+
+    card.hide()
+    assert frozen.node().get_num_frozen_geoms() == -1
+    card.show()
+    assert frozen.node().get_num_frozen_geoms() == 12
+
+    frozen.attach_new_node(LODNode("lod"))
+    assert frozen.node().get_num_frozen_geoms() == -1
+
+
+def render_center(pipe, scene):
+    "Renders the scene from the origin and returns the center pixel."
+
+    engine = core.GraphicsEngine()
+    fbprops = core.FrameBufferProperties()
+    fbprops.rgb_color = True
+    fbprops.depth_bits = 1
+
+    buffer = engine.make_output(
+        pipe,
+        'buffer',
+        0,
+        fbprops,
+        core.WindowProperties.size(16, 16),
+        core.GraphicsPipe.BF_refuse_window
+    )
+    if buffer is None:
+        pytest.skip("tinydisplay cannot make offscreen buffers")
+
+    tex = core.Texture('result')
+    buffer.add_render_texture(tex, core.GraphicsOutput.RTM_copy_ram)
+    buffer.set_clear_color((0, 0, 0, 1))
+
+    cam = scene.attach_new_node(core.Camera('camera', core.PerspectiveLens()))
+    buffer.make_display_region().camera = cam
+    engine.render_frame()
+
+    image = core.PNMImage()
+    assert tex.store(image)
+    engine.remove_all_windows()
+    cam.remove_node()
+    return image.get_xel(8, 8)
+
+
+def test_frozennode_geom_state(tiny_pipe):
+    scene = NodePath("scene")
+    frozen = scene.attach_new_node(FrozenNode("frozen"))
+    cm = CardMaker("card")
+    cm.set_frame(-1, 1, -1, 1)
+    card = frozen.attach_new_node(cm.generate())
+    card.set_y(5)
+
+    red = core.RenderState.make(core.ColorAttrib.make_flat((1, 0, 0, 1)))
+    green = core.RenderState.make(core.ColorAttrib.make_flat((0, 1, 0, 1)))
+
+    card.node().set_geom_state(0, red)
+    assert render_center(tiny_pipe, scene).almost_equal((1, 0, 0), 0.01)
+
+    # Changing the state of a Geom below the FrozenNode is noticed.
+    card.node().set_geom_state(0, green)
+    assert render_center(tiny_pipe, scene).almost_equal((0, 1, 0), 0.01)
+    assert frozen.node().get_num_frozen_geoms() == 1
+
+
+def test_frozennode_occluder(tiny_pipe):
+    scene = NodePath("scene")
+    frozen = scene.attach_new_node(FrozenNode("frozen"))
+
+    # One card straight ahead, and another one off to the side, so that the
+    # FrozenNode itself is not entirely hidden by the occluder.
+    cm = CardMaker("card")
+    cm.set_frame(-0.5, 0.5, -0.5, 0.5)
+    card = frozen.attach_new_node(cm.generate())
+    card.set_y(10)
+    card.set_color((1, 0, 0, 1))
+    side = frozen.attach_new_node(cm.generate())
+    side.set_pos(-3, 10, 0)
+    assert frozen.node().get_num_frozen_geoms() == 2
+
+    assert render_center(tiny_pipe, scene).almost_equal((1, 0, 0), 0.01)
+
+    # An occluder in front of the first card culls it, just as it would if
+    # the subgraph were not frozen.
+    occluder = core.OccluderNode("occluder")
+    occluder.double_sided = True
+    occluder_np = scene.attach_new_node(occluder)
+    occluder_np.set_y(5)
+    scene.set_occluder(occluder_np)
+    assert render_center(tiny_pipe, scene).almost_equal((0, 0, 0), 0.01)
@@ -0,0 +1,119 @@
+from panda3d import core
+from panda3d.core import OcclusionBuffer, PerspectiveLens, Point3, Vec4
+import pytest
+
+
+def make_buffer():
+    # A 4x4 wall, 10 units in front of a camera at the origin.
+    lens = PerspectiveLens()
+    lens.set_near_far(1, 1000)
+    proj = lens.get_projection_mat()
+
+    def xform(x, y, z):
+        return proj.xform(Vec4(x, y, z, 1))
+
+    buffer = OcclusionBuffer(64, 64)
+    buffer.clear()
+    buffer.draw_triangle(xform(-2, 10, -2), xform(2, 10, -2), xform(2, 10, 2))
+    buffer.draw_triangle(xform(-2, 10, -2), xform(2, 10, 2), xform(-2, 10, 2))
+    buffer.finish()
+    return buffer, proj
+
+
+def test_occlusion_buffer_empty():
+    buffer = OcclusionBuffer(32, 16)
+    buffer.clear()
+    buffer.finish()
+    assert buffer.is_empty()
+    assert buffer.get_num_covered_pixels() == 0
+
+
+def test_occlusion_buffer_wall():
+    buffer, proj = make_buffer()
+    assert not buffer.is_empty()
+    assert buffer.get_num_covered_pixels() < 64 * 64
+
+    # Directly behind the wall.
+    assert buffer.is_occluded(Point3(-0.5, 20, -0.5), Point3(0.5, 21, 0.5), proj)
+
+    # In front of the wall.
+    assert not buffer.is_occluded(Point3(-0.5, 5, -0.5), Point3(0.5, 6, 0.5), proj)
+
+    # Intersecting the wall.
+    assert not buffer.is_occluded(Point3(-0.5, 9, -0.5), Point3(0.5, 11, 0.5), proj)
+
+    # Behind the wall, but peeking out past its edge.
+    assert not buffer.is_occluded(Point3(4, 20, -0.5), Point3(5, 21, 0.5), proj)
+
+    # Behind the camera.
+    assert not buffer.is_occluded(Point3(-0.5, -5, -0.5), Point3(0.5, 5, 0.5), proj)
+
+
+def render_image(pipe, scene, trav):
+    "Renders the scene from the origin with the indicated cull traverser."
+
+    engine = core.GraphicsEngine()
+    fbprops = core.FrameBufferProperties()
+    fbprops.rgb_color = True
+    fbprops.depth_bits = 1
+
+    buffer = engine.make_output(
+        pipe,
+        'buffer',
+        0,
+        fbprops,
+        core.WindowProperties.size(16, 16),
+        core.GraphicsPipe.BF_refuse_window
+    )
+    if buffer is None:
+        pytest.skip("tinydisplay cannot make offscreen buffers")
+
+    tex = core.Texture('result')
+    buffer.add_render_texture(tex, core.GraphicsOutput.RTM_copy_ram)
+    buffer.set_clear_color((0, 0, 0, 1))
+
+    cam = scene.attach_new_node(core.Camera('camera', PerspectiveLens()))
+    dr = buffer.make_display_region()
+    dr.camera = cam
+    dr.set_cull_traverser(trav)
+    engine.render_frame()
+
+    image = core.PNMImage()
+    assert tex.store(image)
+    engine.remove_all_windows()
+    cam.remove_node()
+    return image
+
+
+def test_software_occlusion_cull_traverser(tiny_pipe):
+    scene = core.NodePath("scene")
+    cm = core.CardMaker("card")
+    cm.set_frame(-0.5, 0.5, -0.5, 0.5)
+
+    # One card straight ahead, and another one off to the side.
+    hidden = scene.attach_new_node(cm.generate())
+    hidden.set_pos(0, 10, 0)
+    hidden.set_color((1, 0, 0, 1))
+    visible = scene.attach_new_node(cm.generate())
+    visible.set_pos(-2, 10, 0)
+    visible.set_color((0, 1, 0, 1))
+
+    # An OccluderNode is not drawn itself, so that anything it hides is only
+    # missing from the image if the traverser has culled it.
+    occluder = scene.attach_new_node(core.OccluderNode("occluder"))
+    occluder.set_y(5)
+
+    trav = core.SoftwareOcclusionCullTraverser()
+    image = render_image(tiny_pipe, scene, trav)
+    assert image.get_xel(8, 8).almost_equal((1, 0, 0), 0.01)
+    assert image.get_xel(3, 8).almost_equal((0, 1, 0), 0.01)
+
+    trav.add_occluder(occluder)
+    assert trav.get_num_occluders() == 1
+    image = render_image(tiny_pipe, scene, trav)
+    assert image.get_xel(8, 8).almost_equal((0, 0, 0), 0.01)
+    assert image.get_xel(3, 8).almost_equal((0, 1, 0), 0.01)
+
+    assert trav.remove_occluder(occluder)
+    image = render_image(tiny_pipe, scene, trav)
+    assert image.get_xel(8, 8).almost_equal((1, 0, 0), 0.01)
@@ -0,0 +1,48 @@
+from panda3d.core import NodePath, PandaNode, BoundingSphere, Point3
+
+
+def make_tree(num_groups, num_leaves):
+    root = NodePath("root")
+    leaves = []
+    for g in range(num_groups):
+        group = root.attach_new_node("group%d" % (g))
+        for i in range(num_leaves):
+            leaf = PandaNode("leaf")
+            leaf.set_bounds(BoundingSphere(Point3(0, 0, 0), 1))
+            path = group.attach_new_node(leaf)
+            path.set_pos(g, i, 0)
+            leaves.append(path)
+    return root, leaves
+
+
+def test_update_bounds_revisits_stale_nodes():
+    root, leaves = make_tree(4, 5)
+
+    # The first pass computes everything: the root, 4 groups and 20 leaves.
+    assert root.node().bounds_stale
+    assert root.node().update_bounds() == 25
+    assert not root.node().bounds_stale
+    assert root.node().update_bounds() == 0
+
+    # Moving a leaf only dirties the path from it to the root.
+    leaves[7].set_z(10)
+    assert root.node().update_bounds() == 3
+    for path in root.find_all_matches("**"):
+        assert not path.node().bounds_stale
+
+
+def test_update_bounds_matches_lazy_bounds():
+    root, leaves = make_tree(3, 6)
+    copy = root.copy_to(NodePath())
+    root.node().update_bounds()
+
+    for leaf in leaves[::4]:
+        leaf.set_x(leaf.get_x() + 5)
+    for leaf in copy.find_all_matches("**/leaf")[::4]:
+        leaf.set_x(leaf.get_x() + 5)
+
+    root.node().update_bounds()
+    for path, copy_path in zip(root.find_all_matches("**"),
+                               copy.find_all_matches("**")):
+        assert path.node().get_bounds().get_center() == copy_path.node().get_bounds().get_center()
+        assert path.node().get_bounds().get_radius() == copy_path.node().get_bounds().get_radius()
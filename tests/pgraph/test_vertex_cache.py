@@ -0,0 +1,116 @@
+from panda3d import core
+import random
+
+
+def make_grid(size):
+    vdata = core.GeomVertexData('grid', core.GeomVertexFormat.get_v3n3(), core.Geom.UH_static)
+    vertex = core.GeomVertexWriter(vdata, 'vertex')
+    normal = core.GeomVertexWriter(vdata, 'normal')
+    for y in range(size + 1):
+        for x in range(size + 1):
+            vertex.add_data3(x, y, 0)
+            normal.add_data3(0, 0, 1)
+
+    quads = [(x, y) for y in range(size) for x in range(size)]
+    random.Random(1).shuffle(quads)
+
+    tris = core.GeomTriangles(core.Geom.UH_static)
+    for x, y in quads:
+        v0 = y * (size + 1) + x
+        v1 = v0 + 1
+        v2 = v0 + size + 2
+        v3 = v0 + size + 1
+        tris.add_vertices(v0, v1, v2)
+        tris.add_vertices(v0, v2, v3)
+
+    geom = core.Geom(vdata)
+    geom.add_primitive(tris)
+    return geom
+
+
+def get_triangles(geom):
+    reader = core.GeomVertexReader(geom.get_vertex_data(), 'vertex')
+    triangles = set()
+    for prim in geom.get_primitives():
+        prim = prim.decompose()
+        verts = prim.get_vertex_list()
+        for i in range(0, len(verts), 3):
+            tri = []
+            for v in verts[i:i + 3]:
+                reader.set_row(v)
+                tri.append(tuple(reader.get_data3()))
+            # Normalize the rotation, but keep the winding order.
+            first = tri.index(min(tri))
+            triangles.add(tuple(tri[first:] + tri[:first]))
+    return triangles
+
+
+def test_geom_calc_acmr():
+    vdata = core.GeomVertexData('', core.GeomVertexFormat.get_v3(), core.Geom.UH_static)
+    vdata.set_num_rows(4)
+
+    tris = core.GeomTriangles(core.Geom.UH_static)
+    tris.add_vertices(0, 1, 2)
+    tris.add_vertices(2, 1, 3)
+    geom = core.Geom(vdata)
+    geom.add_primitive(tris)
+
+    assert tris.calc_acmr() == 2.0
+    assert geom.calc_acmr() == 2.0
+
+    lines = core.GeomLines(core.Geom.UH_static)
+    lines.add_vertices(0, 1)
+    assert lines.calc_acmr() == 0.0
+
+
+def test_geom_optimize_vertex_cache():
+    geom = make_grid(16)
+    orig_acmr = geom.calc_acmr(16)
+
+    new_geom = geom.optimize_vertex_cache(16)
+    assert new_geom.calc_acmr(16) < orig_acmr
+    assert get_triangles(new_geom) == get_triangles(geom)
+
+    # The original is unchanged.
+    assert geom.calc_acmr(16) == orig_acmr
+
+
+def test_reducer_optimize_vertex_cache():
+    root = core.PandaNode('root')
+    node = core.GeomNode('grid')
+    geom = make_grid(16)
+    node.add_geom(geom)
+    root.add_child(node)
+
+    # Strips are decomposed into triangles.
+    strips = core.Geom(geom.get_vertex_data())
+    strip = core.GeomTristrips(core.Geom.UH_static)
+    strip.add_vertices(0, 1, 17, 18)
+    strip.close_primitive()
+    strips.add_primitive(strip)
+    node.add_geom(strips)
+
+    orig_triangles = get_triangles(geom) | get_triangles(strips)
+    orig_acmr = geom.calc_acmr()
+
+    gr = core.SceneGraphReducer()
+    assert gr.optimize_vertex_cache(root, 32) == 2
+
+    geom = node.get_geom(0)
+    strips = node.get_geom(1)
+    assert geom.calc_acmr() < orig_acmr
+    assert get_triangles(geom) | get_triangles(strips) == orig_triangles
+    assert isinstance(strips.get_primitive(0), core.GeomTriangles)
+
+    # Both Geoms still share the same vertices, which are now stored in the
+    # order in which they are first used.
+    vdata = geom.get_vertex_data()
+    assert strips.get_vertex_data() == vdata
+    assert vdata.get_num_rows() == 17 * 17
+
+    seen = []
+    for g in (geom, strips):
+        for v in g.get_primitive(0).get_vertex_list():
+            if v not in seen:
+                seen.append(v)
+    assert seen == list(range(len(seen)))
@@ -0,0 +1,142 @@
+from panda3d import core
+import pytest
+
+
+def make_vertex_data(num_vertices):
+    vdata = core.GeomVertexData('test', core.GeomVertexFormat.get_v3n3(), core.Geom.UH_static)
+    vdata.set_num_rows(num_vertices)
+    vertex = core.GeomVertexWriter(vdata, 'vertex')
+    normal = core.GeomVertexWriter(vdata, 'normal')
+    for i in range(num_vertices):
+        vertex.add_data3(i, i * 2, i * 3)
+        normal.add_data3(0, 0, 1)
+    return vdata
+
+
+def write_bam(filename, obj, minor_ver):
+    page = core.load_prc_file_data('', 'bam-version 6 {0}'.format(minor_ver))
+    try:
+        bam_file = core.BamFile()
+        assert bam_file.open_write(filename)
+        assert bam_file.get_writer().get_file_minor_ver() == minor_ver
+        assert bam_file.write_object(obj)
+        bam_file.close()
+    finally:
+        core.unload_prc_file(page)
+
+
+def read_bam(filename, mmap):
+    page = core.load_prc_file_data('', 'bam-mmap {0}'.format(int(mmap)))
+    try:
+        bam_file = core.BamFile()
+        assert bam_file.open_read(filename)
+        obj = bam_file.read_object()
+        assert bam_file.resolve()
+        bam_file.close()
+    finally:
+        core.unload_prc_file(page)
+    return obj
+
+
+@pytest.mark.parametrize("minor_ver", [44, 46])
+@pytest.mark.parametrize("mmap", [False, True])
+def test_bam_mmap_vertex_data(tmp_path, minor_ver, mmap):
+    filename = core.Filename.from_os_specific(str(tmp_path / 'vdata.bam'))
+    orig = make_vertex_data(1000)
+    write_bam(filename, orig, minor_ver)
+
+    # The data is only used in place if the file is mapped, and if it was
+    # written with the padding that aligns it within the file.
+    in_place = mmap and minor_ver >= 46
+
+    vdata = read_bam(filename, mmap)
+    assert vdata.get_num_rows() == 1000
+    assert vdata.get_array(0).get_handle().is_mapped() == in_place
+    assert vdata.get_array(0).get_handle().get_data() == orig.get_array(0).get_handle().get_data()
+
+    # Modifying the data must not affect the file it was read from.
+    vertex = core.GeomVertexRewriter(vdata, 'vertex')
+    vertex.set_row(0)
+    vertex.set_data3(7, 8, 9)
+    del vertex
+
+    assert not vdata.get_array(0).get_handle().is_mapped()
+    reader = core.GeomVertexReader(vdata, 'vertex')
+    reader.set_row(0)
+    assert reader.get_data3() == (7, 8, 9)
+
+    again = read_bam(filename, mmap)
+    assert again.get_array(0).get_handle().is_mapped() == in_place
+    assert again.get_array(0).get_handle().get_data() == orig.get_array(0).get_handle().get_data()
+
+
+def test_datagram_input_file_map(tmp_path):
+    filename = core.Filename.from_os_specific(str(tmp_path / 'dg.bin'))
+
+    dout = core.DatagramOutputFile()
+    assert dout.open(filename)
+    for i in range(3):
+        dg = core.Datagram()
+        dg.add_uint32(i)
+        dg.add_string('datagram {0}'.format(i))
+        assert dout.put_datagram(dg)
+    dout.close()
+
+    din = core.DatagramInputFile()
+    assert din.open(filename)
+    assert din.map_file()
+    assert din.is_mapped()
+
+    datagrams = []
+    for i in range(3):
+        dg = core.Datagram()
+        assert din.get_datagram(dg)
+        datagrams.append(dg)
+
+    assert not din.get_datagram(core.Datagram())
+    assert din.is_eof()
+
+    # The datagrams refer to the mapping, which they must keep alive.
+    din.close()
+    del din
+
+    for i, dg in enumerate(datagrams):
+        scan = core.DatagramIterator(dg)
+        assert scan.get_uint32() == i
+        assert scan.get_string() == 'datagram {0}'.format(i)
+
+    # Modifying one of them must not affect the file.
+    datagrams[0].add_uint8(1)
+    assert datagrams[0].get_length() == datagrams[1].get_length() + 1
+
+
+def test_bam_mmap_cache_record(tmp_path):
+    # Records read from the model cache are never mapped, since the cache may
+    # evict the file while the data is still in use.
+    page = core.load_prc_file_data('', 'model-cache-index 0\nbam-version 6 46\nbam-mmap 1')
+    try:
+        cache = core.BamCache()
+        cache.root = core.Filename.from_os_specific(str(tmp_path / 'cache'))
+        source_path = tmp_path / 'vdata.egg'
+        source_path.write_text('vdata')
+        source = core.Filename.from_os_specific(str(source_path))
+
+        orig = make_vertex_data(1000)
+        record = cache.lookup(source, 'bam')
+        record.add_dependent_file(source)
+        record.set_data(orig)
+        assert cache.store(record)
+
+        other = core.BamCache()
+        other.root = cache.root
+        record = other.lookup(source, 'bam')
+    finally:
+        core.unload_prc_file(page)
+
+    assert record is not None
+    assert record.has_data()
+    vdata = record.get_data()
+    assert not vdata.get_array(0).get_handle().is_mapped()
+
+    (tmp_path / 'cache' / record.cache_filename.get_fullpath()).unlink()
+    assert vdata.get_array(0).get_handle().get_data() == orig.get_array(0).get_handle().get_data()
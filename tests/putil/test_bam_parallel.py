@@ -0,0 +1,125 @@
+from panda3d import core
+import pytest
+
+
+def make_scene(num_nodes):
+    root = core.NodePath('root')
+
+    # All of the strips share the same ends array, which is only written with
+    # the first one.
+    shared = core.GeomVertexData('shared', core.GeomVertexFormat.get_v3(), core.Geom.UH_static)
+    vertex = core.GeomVertexWriter(shared, 'vertex')
+    vertex.add_data3(0, 0, 0)
+    vertex.add_data3(1, 0, 0)
+    vertex.add_data3(0, 1, 0)
+    strip = core.GeomTristrips(core.Geom.UH_static)
+    strip.add_vertices(0, 1, 2)
+    strip.close_primitive()
+    strip.add_vertices(0, 2, 1)
+    strip.close_primitive()
+
+    for i in range(num_nodes):
+        vdata = core.GeomVertexData('vdata', core.GeomVertexFormat.get_v3n3(), core.Geom.UH_static)
+        vertex = core.GeomVertexWriter(vdata, 'vertex')
+        normal = core.GeomVertexWriter(vdata, 'normal')
+        for j in range(6):
+            vertex.add_data3(i, j, i + j)
+            normal.add_data3(0, 0, 1)
+        tris = core.GeomTriangles(core.Geom.UH_static)
+        tris.add_vertices(0, 1, 2)
+        tris.add_vertices(3, 4, 5)
+        geom = core.Geom(vdata)
+        geom.add_primitive(tris)
+
+        node = core.GeomNode('node{0}'.format(i))
+        node.add_geom(geom, core.RenderState.make(core.ColorAttrib.make_flat((i % 5, 0, 1, 1))))
+
+        geom = core.Geom(shared)
+        geom.add_primitive(core.GeomTristrips(strip))
+        node.add_geom(geom)
+        node.set_tag('index', str(i))
+        root.attach_new_node(node)
+
+    return root
+
+
+def write_bam(filename, obj):
+    page = core.load_prc_file_data('', 'bam-version 6 47')
+    try:
+        bam_file = core.BamFile()
+        assert bam_file.open_write(filename)
+        assert bam_file.write_object(obj)
+        bam_file.close()
+    finally:
+        core.unload_prc_file(page)
+
+
+def read_bam(filename, parallel):
+    page = core.load_prc_file_data('', 'bam-parallel-read {0}'.format(int(parallel)))
+    try:
+        bam_file = core.BamFile()
+        assert bam_file.open_read(filename)
+        assert bam_file.get_reader().get_file_version() == (6, 47)
+        obj = bam_file.read_object()
+        assert bam_file.resolve()
+        assert bam_file.read_object() is None
+        assert bam_file.is_eof()
+        bam_file.close()
+    finally:
+        core.unload_prc_file(page)
+    return obj
+
+
+@pytest.mark.parametrize("num_nodes", [1, 500])
+def test_bam_parallel_read(tmp_path, num_nodes, job_pool):
+    filename = core.Filename.from_os_specific(str(tmp_path / 'scene.bam'))
+    orig = make_scene(num_nodes)
+    write_bam(filename, orig.node())
+
+    num_jobs = job_pool.num_jobs_added
+    serial = core.NodePath(read_bam(filename, False))
+    assert job_pool.num_jobs_added == num_jobs
+
+    parallel = core.NodePath(read_bam(filename, True))
+    if num_nodes > 1:
+        # There are enough objects to be worth dividing among the threads.
+        assert job_pool.num_jobs_added > num_jobs
+
+    assert parallel.get_num_children() == num_nodes
+    assert parallel.encode_to_bam_stream() == serial.encode_to_bam_stream()
+    assert parallel.encode_to_bam_stream() == orig.encode_to_bam_stream()
+
+
+def test_bam_parallel_read_multiple_objects(tmp_path, job_pool):
+    filename = core.Filename.from_os_specific(str(tmp_path / 'multi.boo'))
+    scenes = [make_scene(50), make_scene(100)]
+
+    page = core.load_prc_file_data('', 'bam-version 6 47')
+    try:
+        bam_file = core.BamFile()
+        assert bam_file.open_write(filename)
+        for scene in scenes:
+            assert bam_file.write_object(scene.node())
+        bam_file.close()
+    finally:
+        core.unload_prc_file(page)
+
+    page = core.load_prc_file_data('', 'bam-parallel-read 1')
+    try:
+        bam_file = core.BamFile()
+        assert bam_file.open_read(filename)
+        num_jobs = job_pool.num_jobs_added
+        objs = [bam_file.read_object()]
+        assert job_pool.num_jobs_added > num_jobs
+        num_jobs = job_pool.num_jobs_added
+        objs.append(bam_file.read_object())
+        assert job_pool.num_jobs_added > num_jobs
+        assert bam_file.resolve()
+        assert bam_file.read_object() is None
+        assert bam_file.is_eof()
+        bam_file.close()
+    finally:
+        core.unload_prc_file(page)
+
+    for scene, obj in zip(scenes, objs):
+        assert core.NodePath(obj).encode_to_bam_stream() == scene.encode_to_bam_stream()
@@ -0,0 +1,87 @@
+from panda3d import core
+import os
+
+
+def make_cache(tmp_path, max_kbytes=10485760):
+    page = core.load_prc_file_data('', 'model-cache-index 0')
+    try:
+        cache = core.BamCache()
+    finally:
+        core.unload_prc_file(page)
+
+    assert not cache.use_index
+    cache.cache_max_kbytes = max_kbytes
+    cache.root = core.Filename.from_os_specific(str(tmp_path / 'cache'))
+    return cache
+
+
+def make_source(tmp_path, name):
+    path = tmp_path / name
+    path.write_text(name)
+    return core.Filename.from_os_specific(str(path))
+
+
+def store(cache, source, data):
+    record = cache.lookup(source, 'bam')
+    assert record is not None
+    assert not record.has_data()
+    record.add_dependent_file(source)
+    record.set_data(data)
+    assert cache.store(record)
+    return record
+
+
+def test_bamcache_unindexed_lookup(tmp_path):
+    cache = make_cache(tmp_path)
+    source = make_source(tmp_path, 'model.egg')
+
+    record = store(cache, source, core.PandaNode('model'))
+    assert cache.num_misses == 1
+    assert cache.num_stores == 1
+    assert cache.num_hits == 0
+
+    # The cache file lives in a subdirectory named for its hash, and no index
+    # is written next to it.
+    cache_filename = record.cache_filename
+    assert len(cache_filename.get_dirname()) == 2
+    assert cache_filename.get_basename().startswith(cache_filename.get_dirname())
+    assert (tmp_path / 'cache' / cache_filename.get_fullpath()).is_file()
+    cache.flush_index()
+    assert not (tmp_path / 'cache' / 'index_name.txt').exists()
+
+    # A different BamCache, as another process would have, finds it.
+    other = make_cache(tmp_path)
+    record = other.lookup(source, 'bam')
+    assert record is not None
+    assert record.has_data()
+    assert record.get_data().name == 'model'
+    assert other.num_hits == 1
+    assert other.num_misses == 0
+    assert other.total_lookup_time >= 0.0
+
+
+def test_bamcache_unindexed_evict(tmp_path):
+    cache = make_cache(tmp_path, max_kbytes=16)
+
+    records = []
+    for i in range(10):
+        source = make_source(tmp_path, 'model{0}.egg'.format(i))
+        node = core.PandaNode('model{0}'.format(i))
+        node.set_tag('padding', 'x' * 4096)
+        records.append(store(cache, source, node))
+
+    # Give each file a distinct modification time, as though model0 was used
+    # least recently and model9 most recently.
+    paths = [tmp_path / 'cache' / record.cache_filename.get_fullpath() for record in records]
+    for i, path in enumerate(paths):
+        os.utime(str(path), (1000000 + i * 10, 1000000 + i * 10))
+
+    cache.flush_index()
+    assert cache.num_evictions > 0
+    assert cache.cache_size <= 16 * 1024
+
+    # The files that were used most recently survive.
+    kept = [path.exists() for path in paths]
+    assert kept[-1]
+    assert not kept[0]
+    assert kept == sorted(kept)